@@ -172,6 +172,19 @@ CONF_mInt32(doris_scan_range_row_count, "524288");
 CONF_mInt32(doris_scanner_queue_size, "1024");
 // single read execute fragment row size
 CONF_mInt32(doris_scanner_row_num, "16384");
+// max number of scanner threads of one broker scan node
+CONF_mInt32(broker_scanner_thread_num, "4");
+// uncompressed csv files and line-delimited json files larger than this are split into
+// byte ranges of this size, which are scanned by the scanner threads of a broker scan node
+CONF_mInt64(broker_scan_morsel_bytes, "67108864");
+// if true, a broker scan node returns the rows of its scan ranges in file order even if
+// they are scanned by several threads, which keeps the last-row-wins result of loading
+// duplicate keys into a unique key table deterministic
+CONF_mBool(broker_scan_keep_order, "true");
+// if true, parquet row groups and orc stripes of a broker load are skipped when their min/max
+// statistics show that no row matches the filter of the load. The error rows of the skipped
+// data are not reported then, which may let a load pass its max_filter_ratio.
+CONF_mBool(enable_broker_load_min_max_pruning, "false");
 // number of max scan keys
 CONF_mInt32(doris_max_scan_key_num, "1024");
 // the max number of push down values of a single column.
@@ -181,6 +194,9 @@ CONF_mInt32(max_pushdown_conditions_per_column, "1024");
 CONF_mInt32(doris_max_pushdown_conjuncts_return_rate, "90");
 // (Advanced) Maximum size of per-query receive-side buffer
 CONF_mInt32(exchg_node_buffer_size_bytes, "10485760");
+// max number of transmit requests of a vectorized data stream sender channel which are in
+// flight at the same time
+CONF_mInt32(exchange_max_in_flight_requests, "4");
 // push_write_mbytes_per_sec
 CONF_mInt32(push_write_mbytes_per_sec, "10");
 
@@ -188,6 +204,12 @@ CONF_mInt64(column_dictionary_key_ratio_threshold, "0");
 CONF_mInt64(column_dictionary_key_size_threshold, "0");
 // memory_limitation_per_thread_for_schema_change unit GB
 CONF_mInt32(memory_limitation_per_thread_for_schema_change, "2");
+// Number of threads shared by all schema changes and rollups to convert the historical rowsets
+// of their tablets, several rowsets of a tablet are converted at the same time. All the rowsets
+// being converted sort within one budget of
+// memory_limitation_per_thread_for_schema_change * alter_tablet_worker_count, which is set at
+// startup, and each of them within memory_limitation_per_thread_for_schema_change.
+CONF_Int32(schema_change_convert_thread_num, "8");
 
 CONF_mInt32(file_descriptor_cache_clean_interval, "3600");
 CONF_mInt32(disk_stat_monitor_interval, "5");
@@ -228,6 +250,9 @@ CONF_String(storage_page_cache_limit, "20%");
 CONF_Int32(index_page_cache_percentage, "10");
 // whether to disable page cache feature in storage
 CONF_Bool(disable_storage_page_cache, "false");
+// Bytes of the metadata of the opened segments of beta rowsets kept in the segment cache,
+// the segments not used by any reader are evicted beyond it
+CONF_Int64(segment_cache_capacity, "2147483648");
 
 // be policy
 // whether disable automatic compaction task
@@ -402,6 +427,15 @@ CONF_Bool(use_mmap_allocate_chunk, "false");
 // acquire more free memory which can not be used by other modules
 CONF_Int64(chunk_reserved_bytes_limit, "2147483648");
 
+// Whether the vectorized engine allocates its large column buffers from the chunk allocator,
+// so that the buffers freed by a batch are reused by the next ones instead of going back
+// to system. Only read at the first allocation.
+CONF_Bool(enable_vec_chunk_cache, "true");
+
+// Whether to advise transparent huge pages for the mmap'd hash tables of the vectorized
+// engine, which reduces TLB misses of hash table probes on large builds.
+CONF_mBool(enable_vec_hash_table_huge_pages, "false");
+
 // The probing algorithm of partitioned hash table.
 // Enable quadratic probing hash table
 CONF_Bool(enable_quadratic_probing, "false");
@@ -456,6 +490,10 @@ CONF_mInt64(write_buffer_size, "104857600");
 // user should set these configs properly if necessary.
 CONF_Int64(load_process_max_memory_limit_bytes, "107374182400"); // 100GB
 CONF_Int32(load_process_max_memory_limit_percent, "80");         // 80%
+// When the load mem consumption of a Backend exceeds this percent of the above limit, the
+// largest memtables of all loads are submitted to flush without blocking load requests.
+// Load requests only wait for memtable flushes after the limit itself is exceeded.
+CONF_mInt32(load_process_soft_mem_limit_percent, "80");
 
 // update interval of tablet stat cache
 CONF_mInt32(tablet_stat_cache_update_interval_second, "300");
@@ -558,6 +596,10 @@ CONF_Int32(txn_shard_size, "1024");
 // Whether to continue to start be when load tablet from header failed.
 CONF_Bool(ignore_load_tablet_failure, "false");
 
+// Number of threads shared by all data dirs to parse and load tablet metas and rowset metas
+// at BE startup. Each data dir traverses its meta store in its own thread.
+CONF_Int32(load_tablet_meta_thread_num, "16");
+
 // Whether to continue to start be when load tablet from header failed.
 CONF_mBool(ignore_rowset_stale_unconsistent_delete, "false");
 
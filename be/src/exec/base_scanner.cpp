@@ -17,6 +17,7 @@
 
 #include "base_scanner.h"
 
+#include "common/config.h"
 #include "common/logging.h"
 #include "exec/exec_node.h"
 #include "exprs/expr_context.h"
@@ -57,6 +58,10 @@ BaseScanner::BaseScanner(RuntimeState* state, RuntimeProfile* profile,
 
 Status BaseScanner::open() {
     RETURN_IF_ERROR(init_expr_ctxes());
+    if (_conjunct_ctxs != nullptr && config::enable_broker_load_min_max_pruning) {
+        MinMaxPredicate::create_predicates(*_conjunct_ctxs, _params, _src_slot_descs,
+                                           _dest_tuple_desc, &_min_max_predicates);
+    }
     if (_params.__isset.strict_mode) {
         _strict_mode = _params.strict_mode;
     }
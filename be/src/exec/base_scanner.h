@@ -19,6 +19,7 @@
 #define BE_SRC_EXEC_BASE_SCANNER_H_
 
 #include "common/status.h"
+#include "exec/min_max_predicate.h"
 #include "exprs/expr.h"
 #include "runtime/tuple.h"
 #include "util/runtime_profile.h"
@@ -50,6 +51,12 @@ public:
     virtual ~BaseScanner() { Expr::close(_dest_expr_ctx, _state); };
 
     virtual Status init_expr_ctxes();
+
+    // Conjuncts of the scan node on the dest tuple. The scanners of the formats with
+    // statistics use them to skip data, see MinMaxPredicate. Must be set before open().
+    void set_conjunct_ctxs(const std::vector<ExprContext*>* conjunct_ctxs) {
+        _conjunct_ctxs = conjunct_ctxs;
+    }
     // Open this scanner, will initialize information need to
     virtual Status open();
 
@@ -91,6 +98,9 @@ protected:
     // to filter src tuple directly
 	const std::vector<ExprContext*>& _pre_filter_ctxs;
 
+    const std::vector<ExprContext*>* _conjunct_ctxs = nullptr;
+    std::vector<MinMaxPredicate> _min_max_predicates;
+
     bool _strict_mode;
 
     int32_t _line_counter;
@@ -17,9 +17,11 @@
 
 #include "exec/broker_scan_node.h"
 
+#include <algorithm>
 #include <chrono>
 #include <sstream>
 
+#include "common/config.h"
 #include "common/object_pool.h"
 #include "exec/broker_scanner.h"
 #include "exec/json_scanner.h"
@@ -39,9 +41,14 @@ BrokerScanNode::BrokerScanNode(ObjectPool* pool, const TPlanNode& tnode, const D
           _tuple_id(tnode.broker_scan_node.tuple_id),
           _runtime_state(nullptr),
           _tuple_desc(nullptr),
+          _next_morsel(0),
+          _head_morsel(0),
+          _keep_order(true),
           _num_running_scanners(0),
           _scan_finished(false),
           _max_buffered_batches(32),
+          _max_buffered_batches_per_morsel(32),
+          _num_buffered_batches(0),
           _wait_scanner_timer(nullptr) {}
 
 BrokerScanNode::~BrokerScanNode() {}
@@ -105,15 +112,134 @@ Status BrokerScanNode::open(RuntimeState* state) {
     return Status::OK();
 }
 
+// Only uncompressed csv files and line-delimited json files can be read from the middle.
+static bool is_splittable(const TBrokerRangeDesc& range) {
+    if (!range.splittable || range.file_type == TFileType::FILE_STREAM || range.size <= 0) {
+        return false;
+    }
+    switch (range.format_type) {
+    case TFileFormatType::FORMAT_CSV_PLAIN:
+        return true;
+    case TFileFormatType::FORMAT_JSON:
+        return range.__isset.read_json_by_line && range.read_json_by_line;
+    default:
+        return false;
+    }
+}
+
+void BrokerScanNode::split_scan_ranges() {
+    const int64_t morsel_bytes = std::max<int64_t>(config::broker_scan_morsel_bytes, 1);
+    for (const auto& scan_range_params : _scan_ranges) {
+        const TBrokerScanRange& scan_range = scan_range_params.scan_range.broker_scan_range;
+        // Files which are not split are grouped into morsels of about morsel_bytes, so that
+        // a lot of small files don't create a lot of scanners.
+        ScanMorsel morsel {&scan_range, {}};
+        int64_t morsel_size = 0;
+        for (const auto& range : scan_range.ranges) {
+            if (!is_splittable(range) || range.size <= morsel_bytes) {
+                morsel.ranges.push_back(range);
+                // The size of a range read to the end of file is unknown
+                morsel_size += range.size >= 0 ? range.size : morsel_bytes;
+                if (morsel_size >= morsel_bytes) {
+                    _morsels.push_back(std::move(morsel));
+                    morsel = ScanMorsel {&scan_range, {}};
+                    morsel_size = 0;
+                }
+                continue;
+            }
+            for (int64_t offset = 0; offset < range.size; offset += morsel_bytes) {
+                TBrokerRangeDesc part = range;
+                part.start_offset = range.start_offset + offset;
+                part.size = std::min(morsel_bytes, range.size - offset);
+                _morsels.push_back(ScanMorsel {&scan_range, {part}});
+            }
+        }
+        if (!morsel.ranges.empty()) {
+            _morsels.push_back(std::move(morsel));
+        }
+    }
+}
+
 Status BrokerScanNode::start_scanners() {
+    split_scan_ranges();
+    int num_scanners = std::max(
+            1, std::min<int>(config::broker_scanner_thread_num, _morsels.size()));
     {
         std::unique_lock<std::mutex> l(_batch_queue_lock);
-        _num_running_scanners = 1;
+        _morsel_queues.resize(_morsels.size());
+        _keep_order = config::broker_scan_keep_order;
+        _max_buffered_batches_per_morsel = std::max(1, _max_buffered_batches / num_scanners);
+        _num_running_scanners = num_scanners;
+    }
+    for (int i = 0; i < num_scanners; ++i) {
+        RuntimeProfile* profile = runtime_profile()->create_child("Scanner" + std::to_string(i));
+        ScannerProfile scanner_profile;
+        scanner_profile.rows_read = ADD_COUNTER(profile, "RowsRead", TUnit::UNIT);
+        scanner_profile.morsels_scanned = ADD_COUNTER(profile, "MorselsScanned", TUnit::UNIT);
+        scanner_profile.scan_timer = ADD_TIMER(profile, "ScanTime");
+        scanner_profile.rows_read_rate =
+                ADD_COUNTER(profile, "RowsReadRate", TUnit::UNIT_PER_SECOND);
+        _scanner_profiles.push_back(scanner_profile);
+    }
+    for (int i = 0; i < num_scanners; ++i) {
+        _scanner_threads.emplace_back(&BrokerScanNode::scanner_worker, this, i);
     }
-    _scanner_threads.emplace_back(&BrokerScanNode::scanner_worker, this, 0, _scan_ranges.size());
     return Status::OK();
 }
 
+std::shared_ptr<RowBatch> BrokerScanNode::pop_batch() {
+    // Skip the morsels whose batches are all returned
+    int head_morsel = _head_morsel;
+    while (_head_morsel < _morsel_queues.size() && _morsel_queues[_head_morsel].finished &&
+           _morsel_queues[_head_morsel].batches.empty()) {
+        ++_head_morsel;
+    }
+    if (_head_morsel != head_morsel) {
+        // the scanner of the new head morsel may wait for the total limit
+        _queue_writer_cond.notify_all();
+    }
+    // Only the morsels taken by scanners may have batches
+    int end = _keep_order ? std::min(_head_morsel + 1, _next_morsel) : _next_morsel;
+    for (int i = _head_morsel; i < end; ++i) {
+        auto& batches = _morsel_queues[i].batches;
+        if (!batches.empty()) {
+            std::shared_ptr<RowBatch> batch = batches.front();
+            batches.pop_front();
+            --_num_buffered_batches;
+            return batch;
+        }
+    }
+    return nullptr;
+}
+
+bool BrokerScanNode::batch_queue_full(int morsel_idx) {
+    const auto& batches = _morsel_queues[morsel_idx].batches;
+    if (batches.size() >= _max_buffered_batches_per_morsel) {
+        return true;
+    }
+    // at least one batch in queue and memory exceed limit
+    if (mem_tracker()->AnyLimitExceeded(MemLimit::HARD) && !batches.empty()) {
+        return true;
+    }
+    // in ordered mode the head morsel must go on, or the reader could wait for it forever
+    if (_keep_order && morsel_idx == _head_morsel) {
+        return false;
+    }
+    return _num_buffered_batches >= _max_buffered_batches;
+}
+
+bool BrokerScanNode::all_batches_returned() {
+    if (_num_running_scanners > 0) {
+        return false;
+    }
+    for (int i = _head_morsel; i < _morsel_queues.size(); ++i) {
+        if (!_morsel_queues[i].batches.empty()) {
+            return false;
+        }
+    }
+    return true;
+}
+
 Status BrokerScanNode::get_next(RuntimeState* state, RowBatch* row_batch, bool* eos) {
     SCOPED_TIMER(_runtime_profile->total_time_counter());
     // check if CANCELLED.
@@ -134,7 +260,7 @@ Status BrokerScanNode::get_next(RuntimeState* state, RowBatch* row_batch, bool*
     {
         std::unique_lock<std::mutex> l(_batch_queue_lock);
         while (_process_status.ok() && !_runtime_state->is_cancelled() &&
-               _num_running_scanners > 0 && _batch_queue.empty()) {
+               (scanner_batch = pop_batch()) == nullptr && !all_batches_returned()) {
             SCOPED_TIMER(_wait_scanner_timer);
             _queue_reader_cond.wait_for(l, std::chrono::seconds(1));
         }
@@ -148,10 +274,6 @@ Status BrokerScanNode::get_next(RuntimeState* state, RowBatch* row_batch, bool*
             }
             return _process_status;
         }
-        if (!_batch_queue.empty()) {
-            scanner_batch = _batch_queue.front();
-            _batch_queue.pop_front();
-        }
     }
 
     // All scanner has been finished, and all cached batch has been read
@@ -161,8 +283,8 @@ Status BrokerScanNode::get_next(RuntimeState* state, RowBatch* row_batch, bool*
         return Status::OK();
     }
 
-    // notify one scanner
-    _queue_writer_cond.notify_one();
+    // notify scanners, only the one of the popped morsel can go on
+    _queue_writer_cond.notify_all();
 
     // get scanner's batch memory
     row_batch->acquire_state(scanner_batch.get());
@@ -213,7 +335,8 @@ Status BrokerScanNode::close(RuntimeState* state) {
     }
 
     // Close
-    _batch_queue.clear();
+    _morsel_queues.clear();
+    _num_buffered_batches = 0;
 
     return ExecNode::close(state);
 }
@@ -228,41 +351,44 @@ void BrokerScanNode::debug_string(int ident_level, std::stringstream* out) const
     (*out) << "BrokerScanNode";
 }
 
-std::unique_ptr<BaseScanner> BrokerScanNode::create_scanner(const TBrokerScanRange& scan_range,
+std::unique_ptr<BaseScanner> BrokerScanNode::create_scanner(const ScanMorsel& morsel,
                                                             const std::vector<ExprContext*>& pre_filter_ctxs,
                                                             ScannerCounter* counter) {
+    const TBrokerScanRange& scan_range = *morsel.scan_range;
     BaseScanner* scan = nullptr;
-    switch (scan_range.ranges[0].format_type) {
+    switch (morsel.ranges[0].format_type) {
     case TFileFormatType::FORMAT_PARQUET:
         scan = new ParquetScanner(_runtime_state, runtime_profile(), scan_range.params,
-                                  scan_range.ranges, scan_range.broker_addresses,
+                                  morsel.ranges, scan_range.broker_addresses,
                                   pre_filter_ctxs, counter);
         break;
     case TFileFormatType::FORMAT_ORC:
         scan = new ORCScanner(_runtime_state, runtime_profile(), scan_range.params,
-                              scan_range.ranges, scan_range.broker_addresses,
+                              morsel.ranges, scan_range.broker_addresses,
                               pre_filter_ctxs, counter);
         break;
     case TFileFormatType::FORMAT_JSON:
         scan = new JsonScanner(_runtime_state, runtime_profile(), scan_range.params,
-                               scan_range.ranges, scan_range.broker_addresses,
+                               morsel.ranges, scan_range.broker_addresses,
                                pre_filter_ctxs, counter);
         break;
     default:
         scan = new BrokerScanner(_runtime_state, runtime_profile(), scan_range.params,
-                                 scan_range.ranges, scan_range.broker_addresses,
+                                 morsel.ranges, scan_range.broker_addresses,
                                  pre_filter_ctxs, counter);
     }
     std::unique_ptr<BaseScanner> scanner(scan);
     return scanner;
 }
 
-Status BrokerScanNode::scanner_scan(const TBrokerScanRange& scan_range,
+Status BrokerScanNode::scanner_scan(int morsel_idx,
                                     const std::vector<ExprContext*>& pre_filter_ctxs,
                                     const std::vector<ExprContext*>& conjunct_ctxs,
-                                    ScannerCounter* counter) {
+                                    ScannerCounter* counter, const ScannerProfile& profile) {
     //create scanner object and open
-    std::unique_ptr<BaseScanner> scanner = create_scanner(scan_range, pre_filter_ctxs, counter);
+    std::unique_ptr<BaseScanner> scanner =
+            create_scanner(_morsels[morsel_idx], pre_filter_ctxs, counter);
+    scanner->set_conjunct_ctxs(&conjunct_ctxs);
     RETURN_IF_ERROR(scanner->open());
     bool scanner_eof = false;
 
@@ -280,6 +406,7 @@ Status BrokerScanNode::scanner_scan(const TBrokerScanRange& scan_range,
         }
 
         Tuple* tuple = reinterpret_cast<Tuple*>(tuple_buffer);
+        int64_t rows_read = 0;
         while (!scanner_eof) {
             RETURN_IF_CANCELLED(_runtime_state);
             // If we have finished all works
@@ -303,6 +430,7 @@ Status BrokerScanNode::scanner_scan(const TBrokerScanRange& scan_range,
             if (scanner_eof) {
                 continue;
             }
+            ++rows_read;
 
             // eval conjuncts of this row.
             if (eval_conjuncts(&conjunct_ctxs[0], conjunct_ctxs.size(), row)) {
@@ -316,16 +444,13 @@ Status BrokerScanNode::scanner_scan(const TBrokerScanRange& scan_range,
             }
         }
 
+        COUNTER_UPDATE(profile.rows_read, rows_read);
+
         // Row batch has been filled, push this to the queue
         if (row_batch->num_rows() > 0) {
             std::unique_lock<std::mutex> l(_batch_queue_lock);
             while (_process_status.ok() && !_scan_finished.load() &&
-                   !_runtime_state->is_cancelled() &&
-                   // stop pushing more batch if
-                   // 1. too many batches in queue, or
-                   // 2. at least one batch in queue and memory exceed limit.
-                   (_batch_queue.size() >= _max_buffered_batches ||
-                    (mem_tracker()->AnyLimitExceeded(MemLimit::HARD) && !_batch_queue.empty()))) {
+                   !_runtime_state->is_cancelled() && batch_queue_full(morsel_idx)) {
                 _queue_writer_cond.wait_for(l, std::chrono::seconds(1));
             }
             // Process already set failed, so we just return OK
@@ -340,8 +465,9 @@ Status BrokerScanNode::scanner_scan(const TBrokerScanRange& scan_range,
             if (_runtime_state->is_cancelled()) {
                 return Status::Cancelled("Cancelled");
             }
-            // Queue size Must be smaller than _max_buffered_batches
-            _batch_queue.push_back(row_batch);
+            // Queue size Must be smaller than _max_buffered_batches_per_morsel
+            _morsel_queues[morsel_idx].batches.push_back(row_batch);
+            ++_num_buffered_batches;
 
             // Notify reader to
             _queue_reader_cond.notify_one();
@@ -351,7 +477,7 @@ Status BrokerScanNode::scanner_scan(const TBrokerScanRange& scan_range,
     return Status::OK();
 }
 
-void BrokerScanNode::scanner_worker(int start_idx, int length) {
+void BrokerScanNode::scanner_worker(int scanner_id) {
     // Clone expr context
     std::vector<ExprContext*> scanner_expr_ctxs;
     auto status = Expr::clone_if_not_exists(_conjunct_ctxs, _runtime_state, &scanner_expr_ctxs);
@@ -365,14 +491,37 @@ void BrokerScanNode::scanner_worker(int start_idx, int length) {
     }
 
     ScannerCounter counter;
-    for (int i = 0; i < length && status.ok(); ++i) {
-        const TBrokerScanRange& scan_range =
-                _scan_ranges[start_idx + i].scan_range.broker_scan_range;
-        status = scanner_scan(scan_range, pre_filter_ctxs, scanner_expr_ctxs, &counter);
+    const ScannerProfile& profile = _scanner_profiles[scanner_id];
+    while (status.ok()) {
+        int morsel_idx = 0;
+        {
+            std::lock_guard<std::mutex> l(_batch_queue_lock);
+            if (_next_morsel >= _morsels.size() || _scan_finished.load() ||
+                !_process_status.ok()) {
+                break;
+            }
+            morsel_idx = _next_morsel++;
+        }
+        {
+            SCOPED_TIMER(profile.scan_timer);
+            status = scanner_scan(morsel_idx, pre_filter_ctxs, scanner_expr_ctxs, &counter,
+                                  profile);
+        }
+        COUNTER_UPDATE(profile.morsels_scanned, 1);
         if (!status.ok()) {
-            LOG(WARNING) << "Scanner[" << start_idx + i
-                         << "] process failed. status=" << status.get_error_msg();
+            LOG(WARNING) << "Scanner[" << scanner_id << "] process morsel " << morsel_idx
+                         << " failed. status=" << status.get_error_msg();
         }
+        {
+            std::lock_guard<std::mutex> l(_batch_queue_lock);
+            _morsel_queues[morsel_idx].finished = true;
+        }
+        // The reader may be waiting for the end of this morsel
+        _queue_reader_cond.notify_all();
+    }
+    if (profile.scan_timer->value() > 0) {
+        COUNTER_SET(profile.rows_read_rate,
+                    profile.rows_read->value() * 1000000000 / profile.scan_timer->value());
     }
 
     // Update stats
@@ -19,6 +19,7 @@
 
 #include <atomic>
 #include <condition_variable>
+#include <deque>
 #include <map>
 #include <mutex>
 #include <string>
@@ -75,33 +76,78 @@ private:
         return false;
     }
 
+    // A part of a scan range which is scanned by one scanner: a run of whole files, or a
+    // byte range of a large splittable file. A byte range starting in the middle of a
+    // line leaves that line to the previous range, see BrokerScanner::open_line_reader().
+    struct ScanMorsel {
+        const TBrokerScanRange* scan_range;
+        std::vector<TBrokerRangeDesc> ranges;
+    };
+
+    // The batches of one morsel, in scan order.
+    struct MorselBatchQueue {
+        std::deque<std::shared_ptr<RowBatch>> batches;
+        bool finished = false;
+    };
+
+    // Profile counters of one scanner thread.
+    struct ScannerProfile {
+        RuntimeProfile::Counter* rows_read = nullptr;
+        RuntimeProfile::Counter* morsels_scanned = nullptr;
+        RuntimeProfile::Counter* scan_timer = nullptr;
+        RuntimeProfile::Counter* rows_read_rate = nullptr;
+    };
+
+    // Split _scan_ranges into _morsels
+    void split_scan_ranges();
+
     // Create scanners to do scan job
     Status start_scanners();
 
-    // One scanner worker, This scanner will handle 'length' ranges start from start_idx
-    void scanner_worker(int start_idx, int length);
+    // One scanner worker, takes the next morsel to scan until all morsels are taken
+    void scanner_worker(int scanner_id);
 
-    // Scan one range
-    Status scanner_scan(const TBrokerScanRange& scan_range,
-                        const std::vector<ExprContext*>& pre_filter_ctxs,
-                        const std::vector<ExprContext*>& conjunct_ctxs,
-                        ScannerCounter* counter);
+    // Scan one morsel, and push its batches to _morsel_queues[morsel_idx]
+    Status scanner_scan(int morsel_idx, const std::vector<ExprContext*>& pre_filter_ctxs,
+                        const std::vector<ExprContext*>& conjunct_ctxs, ScannerCounter* counter,
+                        const ScannerProfile& profile);
 
-    std::unique_ptr<BaseScanner> create_scanner(const TBrokerScanRange& scan_range,
+    std::unique_ptr<BaseScanner> create_scanner(const ScanMorsel& morsel,
                                                 const std::vector<ExprContext*>& pre_filter_ctxs,
                                                 ScannerCounter* counter);
 
+    // Pop the next batch to return. In ordered mode only the batches of the first
+    // unfinished morsel can be returned, otherwise the batches of any morsel.
+    // Return nullptr if there is no batch ready.
+    // NOTE: Must hold the mutex of this scan node
+    std::shared_ptr<RowBatch> pop_batch();
+
+    // Return true if a scanner of morsel_idx must wait before pushing one more batch.
+    // NOTE: Must hold the mutex of this scan node
+    bool batch_queue_full(int morsel_idx);
+
+    // Return true if all morsels are scanned and all their batches are returned.
+    // NOTE: Must hold the mutex of this scan node
+    bool all_batches_returned();
+
 private:
     TupleId _tuple_id;
     RuntimeState* _runtime_state;
     TupleDescriptor* _tuple_desc;
     std::map<std::string, SlotDescriptor*> _slots_map;
     std::vector<TScanRangeParams> _scan_ranges;
+    std::vector<ScanMorsel> _morsels;
 
     std::mutex _batch_queue_lock;
     std::condition_variable _queue_reader_cond;
     std::condition_variable _queue_writer_cond;
-    std::deque<std::shared_ptr<RowBatch>> _batch_queue;
+    // One queue per morsel
+    std::vector<MorselBatchQueue> _morsel_queues;
+    // Index of the next morsel to be taken by a scanner
+    int _next_morsel;
+    // Index of the first morsel whose batches are not all returned
+    int _head_morsel;
+    bool _keep_order;
 
     int _num_running_scanners;
     // Indicate if all scanners have been finished scan worker
@@ -112,8 +158,16 @@ private:
     Status _process_status;
 
     std::vector<std::thread> _scanner_threads;
+    std::vector<ScannerProfile> _scanner_profiles;
 
+    // Max number of batches buffered in all morsel queues, each morsel queue buffers at
+    // most _max_buffered_batches / number of scanners of them. In ordered mode the scanner
+    // of the head morsel may go past the total limit by its own queue, as the batches of
+    // the other morsels can only be returned after those of the head morsel.
     int _max_buffered_batches;
+    int _max_buffered_batches_per_morsel;
+    // Number of batches in all morsel queues
+    int _num_buffered_batches;
 
     std::vector<ExprContext*> _pre_filter_ctxs;
 
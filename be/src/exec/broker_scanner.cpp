@@ -259,6 +259,7 @@ Status BrokerScanner::open_line_reader() {
     if (_cur_line_reader != nullptr) {
         delete _cur_line_reader;
         _cur_line_reader = nullptr;
+        _cur_text_line_reader = nullptr;
     }
 
     const TBrokerRangeDesc& range = _ranges[_next_range];
@@ -288,8 +289,13 @@ Status BrokerScanner::open_line_reader() {
     case TFileFormatType::FORMAT_CSV_LZ4FRAME:
     case TFileFormatType::FORMAT_CSV_LZOP:
     case TFileFormatType::FORMAT_CSV_DEFLATE:
-        _cur_line_reader = new PlainTextLineReader(_profile, _cur_file_reader, _cur_decompressor,
-                                                   size, _line_delimiter, _line_delimiter_length);
+        _cur_text_line_reader =
+                new PlainTextLineReader(_profile, _cur_file_reader, _cur_decompressor, size,
+                                        _line_delimiter, _line_delimiter_length);
+        if (_value_separator_length == 1) {
+            _cur_text_line_reader->save_field_pos(_value_separator[0]);
+        }
+        _cur_line_reader = _cur_text_line_reader;
         break;
     case TFileFormatType::FORMAT_PROTO:
         _cur_line_reader = new PlainBinaryLineReader(_cur_file_reader);
@@ -315,6 +321,7 @@ void BrokerScanner::close() {
     if (_cur_line_reader != nullptr) {
         delete _cur_line_reader;
         _cur_line_reader = nullptr;
+        _cur_text_line_reader = nullptr;
     }
 
     if (_cur_file_reader != nullptr) {
@@ -341,6 +348,25 @@ void BrokerScanner::split_line(const Slice& line) {
         }
         delete row;
         delete ptr;
+    } else if (_cur_text_line_reader != nullptr && _cur_text_line_reader->field_pos() != nullptr) {
+        // The line reader found the separators while looking for the end of the line.
+        const char* value = line.data;
+        size_t start = 0;
+        for (size_t pos : *_cur_text_line_reader->field_pos()) {
+            _split_values.emplace_back(value + start, pos - start);
+            start = pos + 1;
+        }
+        _split_values.emplace_back(value + start, line.size - start);
+    } else if (_value_separator_length == 1) {
+        const char* value = line.data;
+        const char* end = line.data + line.size;
+        const char* start = value;
+        const char* pos = nullptr;
+        while ((pos = (const char*)memchr(start, _value_separator[0], end - start)) != nullptr) {
+            _split_values.emplace_back(start, pos - start);
+            start = pos + 1;
+        }
+        _split_values.emplace_back(start, end - start);
     } else {
         const char *value = line.data;
         size_t start = 0;  // point to the start pos of next col value.
@@ -40,6 +40,7 @@ class Slice;
 class TextConverter;
 class FileReader;
 class LineReader;
+class PlainTextLineReader;
 class Decompressor;
 class RuntimeState;
 class ExprContext;
@@ -107,6 +108,9 @@ private:
     // Reader
     FileReader* _cur_file_reader;
     LineReader* _cur_line_reader;
+    // _cur_line_reader if it reads csv text, which saves the positions of the value
+    // separators of every line when it is a single byte.
+    PlainTextLineReader* _cur_text_line_reader = nullptr;
     Decompressor* _cur_decompressor;
     int _next_range;
     bool _cur_line_reader_eof;
@@ -37,6 +37,7 @@
 #include "util/logging.h"
 #include "vec/sink/result_sink.h"
 #include "vec/sink/vdata_stream_sender.h"
+#include "vec/sink/vmemory_scratch_sink.h"
 
 namespace doris {
 
@@ -89,7 +90,12 @@ Status DataSink::create_data_sink(ObjectPool* pool, const TDataSink& thrift_sink
             return Status::InternalError("Missing data buffer sink.");
         }
 
-        tmp_sink = new MemoryScratchSink(row_desc, output_exprs, thrift_sink.memory_scratch_sink);
+        if (is_vec) {
+            tmp_sink = new doris::vectorized::VMemoryScratchSink(row_desc, output_exprs,
+                                                                 thrift_sink.memory_scratch_sink);
+        } else {
+            tmp_sink = new MemoryScratchSink(row_desc, output_exprs, thrift_sink.memory_scratch_sink);
+        }
         sink->reset(tmp_sink);
         break;
     case TDataSinkType::MYSQL_TABLE_SINK: {
@@ -65,11 +65,14 @@
 #include "vec/exec/join/vhash_join_node.h"
 #include "vec/exec/vaggregation_node.h"
 #include "vec/exec/vcross_join_node.h"
+#include "vec/exec/vexcept_node.h"
 #include "vec/exec/vexchange_node.h"
+#include "vec/exec/vintersect_node.h"
 #include "vec/exec/vmysql_scan_node.h"
 #include "vec/exec/vodbc_scan_node.h"
 #include "vec/exec/volap_scan_node.h"
 #include "vec/exec/vsort_node.h"
+#include "vec/exec/vtopn_node.h"
 #include "vec/exec/vunion_node.h"
 #include "vec/exprs/vexpr.h"
 namespace doris {
@@ -368,6 +371,8 @@ Status ExecNode::create_node(RuntimeState* state, ObjectPool* pool, const TPlanN
         case TPlanNodeType::HASH_JOIN_NODE:
         case TPlanNodeType::AGGREGATION_NODE:
         case TPlanNodeType::UNION_NODE:
+        case TPlanNodeType::INTERSECT_NODE:
+        case TPlanNodeType::EXCEPT_NODE:
         case TPlanNodeType::CROSS_JOIN_NODE:
         case TPlanNodeType::SORT_NODE:
         case TPlanNodeType::EXCHANGE_NODE:
@@ -480,7 +485,11 @@ Status ExecNode::create_node(RuntimeState* state, ObjectPool* pool, const TPlanN
 
     case TPlanNodeType::SORT_NODE:
         if (state->enable_vectorized_exec()) {
-            *node = pool->add(new vectorized::VSortNode(pool, tnode, descs));
+            if (tnode.sort_node.use_top_n && tnode.limit >= 0) {
+                *node = pool->add(new vectorized::VTopNNode(pool, tnode, descs));
+            } else {
+                *node = pool->add(new vectorized::VSortNode(pool, tnode, descs));
+            }
         } else {
             if (tnode.sort_node.use_top_n) {
                 *node = pool->add(new TopNNode(pool, tnode, descs));
@@ -507,11 +516,19 @@ Status ExecNode::create_node(RuntimeState* state, ObjectPool* pool, const TPlanN
         return Status::OK();
 
     case TPlanNodeType::INTERSECT_NODE:
-        *node = pool->add(new IntersectNode(pool, tnode, descs));
+        if (state->enable_vectorized_exec()) {
+            *node = pool->add(new vectorized::VIntersectNode(pool, tnode, descs));
+        } else {
+            *node = pool->add(new IntersectNode(pool, tnode, descs));
+        }
         return Status::OK();
 
     case TPlanNodeType::EXCEPT_NODE:
-        *node = pool->add(new ExceptNode(pool, tnode, descs));
+        if (state->enable_vectorized_exec()) {
+            *node = pool->add(new vectorized::VExceptNode(pool, tnode, descs));
+        } else {
+            *node = pool->add(new ExceptNode(pool, tnode, descs));
+        }
         return Status::OK();
 
     case TPlanNodeType::BROKER_SCAN_NODE:
@@ -34,6 +34,9 @@
 
 namespace doris {
 
+// Initial size of the buffer of a streamed outer array
+static const size_t STREAM_BUFFER_SIZE = 1024 * 1024;
+
 JsonScanner::JsonScanner(RuntimeState* state, RuntimeProfile* profile,
                          const TBrokerScanRangeParams& params,
                          const std::vector<TBrokerRangeDesc>& ranges,
@@ -233,6 +236,8 @@ Status JsonScanner::open_json_reader() {
     if (range.__isset.fuzzy_parse) {
         fuzzy_parse = range.fuzzy_parse;
     }
+    // the data of routine load is read message by message, which can not be streamed
+    bool streaming = false;
     if (_read_json_by_line) {
         _cur_json_reader =
                 new JsonReader(_state, _counter, _profile, strip_outer_array, num_as_string,
@@ -240,9 +245,10 @@ Status JsonScanner::open_json_reader() {
     } else {
         _cur_json_reader =  new JsonReader(_state, _counter, _profile, strip_outer_array, num_as_string,
                                            fuzzy_parse, _cur_file_reader);
+        streaming = _stream_load_pipe == nullptr || _stream_load_pipe->total_length() != -1;
     }
 
-    RETURN_IF_ERROR(_cur_json_reader->init(jsonpath, json_root));
+    RETURN_IF_ERROR(_cur_json_reader->init(jsonpath, json_root, streaming));
     return Status::OK();
 }
 
@@ -305,7 +311,8 @@ JsonReader::~JsonReader() {
     _close();
 }
 
-Status JsonReader::init(const std::string& jsonpath, const std::string& json_root) {
+Status JsonReader::init(const std::string& jsonpath, const std::string& json_root,
+                        bool streaming) {
     // parse jsonpath
     if (!jsonpath.empty()) {
         Status st = _generate_json_paths(jsonpath, &_parsed_jsonpaths);
@@ -314,9 +321,13 @@ Status JsonReader::init(const std::string& jsonpath, const std::string& json_roo
     if (!json_root.empty()) {
         JsonFunctions::parse_json_paths(json_root, &_parsed_json_root);
     }
+    _build_jsonpath_trie();
 
     //improve performance
-    if (_parsed_jsonpaths.empty()) { // input is a simple json-string
+    if (streaming && _strip_outer_array && _parsed_json_root.empty() &&
+        _file_reader != nullptr) {
+        _handle_json_callback = &JsonReader::_handle_streaming_array_json;
+    } else if (_parsed_jsonpaths.empty()) { // input is a simple json-string
         _handle_json_callback = &JsonReader::_handle_simple_json;
     } else { // input is a complex json-string and a json-path
         if (_strip_outer_array) {
@@ -351,6 +362,44 @@ Status JsonReader::_generate_json_paths(const std::string& jsonpath,
     }
 }
 
+void JsonReader::_build_jsonpath_trie() {
+    _in_jsonpath_trie.assign(_parsed_jsonpaths.size(), false);
+    _jsonpath_values.assign(_parsed_jsonpaths.size(), nullptr);
+    for (int i = 0; i < _parsed_jsonpaths.size(); ++i) {
+        const std::vector<JsonPath>& path = _parsed_jsonpaths[i];
+        // path[0] is "$"
+        if (path.size() < 2 || !path[0].is_valid) {
+            continue;
+        }
+        bool keys_only = true;
+        for (int j = 1; j < path.size(); ++j) {
+            if (!path[j].is_valid || path[j].key.empty() || path[j].key == "*" ||
+                path[j].idx != -1) {
+                keys_only = false;
+                break;
+            }
+        }
+        if (!keys_only) {
+            continue;
+        }
+        JsonPathTrieNode* node = &_jsonpath_trie;
+        for (int j = 1; j < path.size(); ++j) {
+            auto it = std::find_if(node->children.begin(), node->children.end(),
+                                   [&](const JsonPathTrieNode& child) {
+                                       return child.key == path[j].key;
+                                   });
+            if (it == node->children.end()) {
+                node->children.emplace_back();
+                node->children.back().key = path[j].key;
+                it = node->children.end() - 1;
+            }
+            node = &(*it);
+        }
+        node->columns.push_back(i);
+        _in_jsonpath_trie[i] = true;
+    }
+}
+
 void JsonReader::_close() {
     if (_closed) {
         return;
@@ -379,35 +428,12 @@ Status JsonReader::_parse_json_doc(size_t* size, bool* eof) {
         }
     }
 
-    _bytes_read_counter += *size;
+    COUNTER_UPDATE(_bytes_read_counter, *size);
     if (*eof) {
         return Status::OK();
     }
 
-    bool has_parse_error = false;
-    // parse jsondata to JsonDoc
-
-    // As the issue: https://github.com/Tencent/rapidjson/issues/1458
-    // Now, rapidjson only support uint64_t, So lagreint load cause bug. We use kParseNumbersAsStringsFlag.
-    if (_num_as_string) {
-        has_parse_error =
-                _origin_json_doc
-                        .Parse<rapidjson::kParseNumbersAsStringsFlag>((char*)json_str, *size)
-                        .HasParseError();
-    } else {
-        has_parse_error = _origin_json_doc.Parse((char*)json_str, *size).HasParseError();
-    }
-
-    if (has_parse_error) {
-        std::stringstream str_error;
-        str_error << "Parse json data for JsonDoc failed. code = "
-                  << _origin_json_doc.GetParseError() << ", error-info:"
-                  << rapidjson::GetParseError_En(_origin_json_doc.GetParseError());
-        _state->append_error_msg_to_file(std::string((char*)json_str, *size),
-                                         str_error.str());
-        _counter->num_rows_filtered++;
-        return Status::DataQualityError(str_error.str());
-    }
+    RETURN_IF_ERROR(_parse_json_str(json_str, *size));
 
     // set json root
     if (_parsed_json_root.size() != 0) {
@@ -443,6 +469,203 @@ Status JsonReader::_parse_json_doc(size_t* size, bool* eof) {
     return Status::OK();
 }
 
+// parse one json string to _origin_json_doc.
+// The memory of the previous document is reused, so that reading many json strings
+// does not grow the allocator of the document.
+Status JsonReader::_parse_json_str(const uint8_t* json_str, size_t size) {
+    _origin_json_doc.SetNull();
+    _origin_json_doc.GetAllocator().Clear();
+
+    bool has_parse_error = false;
+    // parse jsondata to JsonDoc
+
+    // As the issue: https://github.com/Tencent/rapidjson/issues/1458
+    // Now, rapidjson only support uint64_t, So lagreint load cause bug. We use kParseNumbersAsStringsFlag.
+    if (_num_as_string) {
+        has_parse_error =
+                _origin_json_doc
+                        .Parse<rapidjson::kParseNumbersAsStringsFlag>((char*)json_str, size)
+                        .HasParseError();
+    } else {
+        has_parse_error = _origin_json_doc.Parse((char*)json_str, size).HasParseError();
+    }
+
+    if (has_parse_error) {
+        std::stringstream str_error;
+        str_error << "Parse json data for JsonDoc failed. code = "
+                  << _origin_json_doc.GetParseError() << ", error-info:"
+                  << rapidjson::GetParseError_En(_origin_json_doc.GetParseError());
+        _state->append_error_msg_to_file(std::string((char*)json_str, size),
+                                         str_error.str());
+        _counter->num_rows_filtered++;
+        return Status::DataQualityError(str_error.str());
+    }
+    return Status::OK();
+}
+
+// Move the unconsumed data to the head of _stream_buf, and read more data after it.
+// The buffer is doubled when it is full of unconsumed data, i.e. an element is larger
+// than the buffer.
+Status JsonReader::_fill_stream_buf() {
+    size_t remaining = _stream_end - _stream_pos;
+    if (_stream_buf == nullptr) {
+        _stream_buf_capacity = STREAM_BUFFER_SIZE;
+        _stream_buf.reset(new uint8_t[_stream_buf_capacity]);
+    } else if (remaining == _stream_buf_capacity) {
+        std::unique_ptr<uint8_t[]> buf(new uint8_t[_stream_buf_capacity * 2]);
+        memcpy(buf.get(), _stream_buf.get() + _stream_pos, remaining);
+        _stream_buf = std::move(buf);
+        _stream_buf_capacity *= 2;
+    } else if (_stream_pos > 0) {
+        memmove(_stream_buf.get(), _stream_buf.get() + _stream_pos, remaining);
+    }
+    _stream_pos = 0;
+    _stream_end = remaining;
+
+    SCOPED_TIMER(_file_read_timer);
+    int64_t bytes_read = 0;
+    RETURN_IF_ERROR(_file_reader->read(_stream_buf.get() + _stream_end,
+                                       _stream_buf_capacity - _stream_end, &bytes_read,
+                                       &_stream_eof));
+    _stream_end += bytes_read;
+    COUNTER_UPDATE(_bytes_read_counter, bytes_read);
+    return Status::OK();
+}
+
+// Find the next element of the outer array and parse it to _origin_json_doc.
+// Only the brackets, braces and strings are tracked to find where an element ends,
+// the element itself is checked by rapidjson.
+// return Status::DataQualityError() if data has quality error.
+// return Status::OK() if parse succeed or reach EOF.
+Status JsonReader::_parse_next_array_element(bool* eof) {
+    while (true) {
+        // skip the blanks
+        while (_stream_pos < _stream_end && isspace(_stream_buf[_stream_pos])) {
+            ++_stream_pos;
+        }
+        if (_stream_pos == _stream_end) {
+            if (_stream_eof) {
+                break;
+            }
+            RETURN_IF_ERROR(_fill_stream_buf());
+            continue;
+        }
+
+        uint8_t c = _stream_buf[_stream_pos];
+        if (_stream_state != IN_ARRAY) {
+            if (c != '[') {
+                std::string str_error =
+                        "JSON data is not an array-object, `strip_outer_array` must be FALSE.";
+                _state->append_error_msg_to_file(
+                        std::string((char*)_stream_buf.get() + _stream_pos,
+                                    _stream_end - _stream_pos),
+                        str_error);
+                _counter->num_rows_filtered++;
+                // the rest of the data can not be parsed, drain it
+                while (!_stream_eof) {
+                    _stream_pos = _stream_end;
+                    RETURN_IF_ERROR(_fill_stream_buf());
+                }
+                _stream_pos = _stream_end;
+                return Status::DataQualityError(str_error);
+            }
+            ++_stream_pos;
+            _stream_state = IN_ARRAY;
+            _stream_elements = 0;
+            _stream_after_element = false;
+            continue;
+        }
+        if (c == ',') {
+            ++_stream_pos;
+            if (!_stream_after_element) {
+                // such as "[1,,2]" or "[,1]"
+                std::string str_error = "Empty element in the JSON outer array.";
+                _state->append_error_msg_to_file(",", str_error);
+                _counter->num_rows_filtered++;
+                return Status::DataQualityError(str_error);
+            }
+            _stream_after_element = false;
+            continue;
+        }
+        if (c == ']') {
+            ++_stream_pos;
+            _stream_state = AFTER_ARRAY;
+            if (_stream_elements > 0 && !_stream_after_element) {
+                // such as "[1,2,]"
+                std::string str_error = "Empty element at the end of the JSON outer array.";
+                _state->append_error_msg_to_file(",]", str_error);
+                _counter->num_rows_filtered++;
+                return Status::DataQualityError(str_error);
+            }
+            if (_stream_elements == 0 && _parsed_jsonpaths.empty()) {
+                // may be passing an empty json, such as "[]"
+                std::string str_error = "Empty json line";
+                _state->append_error_msg_to_file("[]", str_error);
+                _counter->num_rows_filtered++;
+                return Status::DataQualityError(str_error);
+            }
+            continue;
+        }
+
+        // an element ends at a ',' or the ']' of the outer array
+        size_t end = _stream_pos;
+        int depth = 0;
+        bool in_string = false;
+        bool escaped = false;
+        while (true) {
+            if (end == _stream_end) {
+                if (_stream_eof) {
+                    break;
+                }
+                size_t offset = end - _stream_pos;
+                RETURN_IF_ERROR(_fill_stream_buf());
+                end = _stream_pos + offset;
+                continue;
+            }
+            c = _stream_buf[end];
+            if (in_string) {
+                if (escaped) {
+                    escaped = false;
+                } else if (c == '\\') {
+                    escaped = true;
+                } else if (c == '"') {
+                    in_string = false;
+                }
+            } else if (c == '"') {
+                in_string = true;
+            } else if (c == '{' || c == '[') {
+                ++depth;
+            } else if (c == '}' || c == ']') {
+                if (depth > 0) {
+                    --depth;
+                } else if (c == ']') {
+                    break;
+                }
+                // an unbalanced '}' is left in the element and reported by rapidjson
+            } else if (c == ',' && depth == 0) {
+                break;
+            }
+            ++end;
+        }
+        const uint8_t* element = _stream_buf.get() + _stream_pos;
+        size_t size = end - _stream_pos;
+        _stream_pos = end;
+        ++_stream_elements;
+        _stream_after_element = true;
+        return _parse_json_str(element, size);
+    }
+
+    if (_stream_state == IN_ARRAY) {
+        _stream_state = AFTER_ARRAY;
+        std::string str_error = "JSON data ends before the outer array is closed.";
+        _state->append_error_msg_to_file("", str_error);
+        _counter->num_rows_filtered++;
+        return Status::DataQualityError(str_error);
+    }
+    *eof = true;
+    return Status::OK();
+}
+
 std::string JsonReader::_print_json_value(const rapidjson::Value& value) {
     rapidjson::StringBuffer buffer;
     buffer.Clear();
@@ -608,7 +831,6 @@ Status JsonReader::_handle_simple_json(Tuple* tuple, const std::vector<SlotDescr
                 *is_empty_row = true;
                 return Status::OK();
             }
-            _name_map.clear();
             rapidjson::Value* objectValue = nullptr;
             if (_json_doc->IsArray()) {
                 _total_lines = _json_doc->Size();
@@ -628,15 +850,7 @@ Status JsonReader::_handle_simple_json(Tuple* tuple, const std::vector<SlotDescr
             }
             _next_line = 0;
             if (_fuzzy_parse) {
-                for (auto v : slot_descs) {
-                    for (int i = 0; i < objectValue->MemberCount(); ++i) {
-                        auto it = objectValue->MemberBegin() + i;
-                        if (v->col_name() == it->name.GetString()) {
-                            _name_map[v->col_name()] = i;
-                            break;
-                        }
-                    }
-                }
+                _init_name_map(*objectValue, slot_descs);
             }
         }
 
@@ -656,18 +870,71 @@ Status JsonReader::_handle_simple_json(Tuple* tuple, const std::vector<SlotDescr
     return Status::OK();
 }
 
+// the positions of the columns in the first object, which are used for the following objects
+// when `fuzzy_parse` is set.
+void JsonReader::_init_name_map(const rapidjson::Value& objectValue,
+                                const std::vector<SlotDescriptor*>& slot_descs) {
+    _name_map.clear();
+    if (!objectValue.IsObject()) {
+        return;
+    }
+    for (auto v : slot_descs) {
+        for (int i = 0; i < objectValue.MemberCount(); ++i) {
+            auto it = objectValue.MemberBegin() + i;
+            if (v->col_name() == it->name.GetString()) {
+                _name_map[v->col_name()] = i;
+                break;
+            }
+        }
+    }
+}
+
+// Look up the keys of the jsonpaths in _jsonpath_trie and save the values to _jsonpath_values.
+// Return false if an array is met before the end of a jsonpath, the keys are then looked up in
+// every object of the array by JsonFunctions::get_json_array_from_parsed_json().
+bool JsonReader::_match_jsonpath_trie(const JsonPathTrieNode& node, rapidjson::Value* value) {
+    for (int column : node.columns) {
+        _jsonpath_values[column] = value;
+    }
+    if (node.children.empty()) {
+        return true;
+    }
+    if (value != nullptr && value->IsArray()) {
+        return false;
+    }
+    bool is_object = value != nullptr && value->IsObject();
+    for (const JsonPathTrieNode& child : node.children) {
+        rapidjson::Value* child_value = nullptr;
+        if (is_object) {
+            auto it = value->FindMember(rapidjson::Value(child.key.c_str(), child.key.size()));
+            if (it != value->MemberEnd()) {
+                child_value = &it->value;
+            }
+        }
+        if (!_match_jsonpath_trie(child, child_value)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 bool JsonReader::_write_values_by_jsonpath(rapidjson::Value& objectValue, MemPool* tuple_pool,
                                            Tuple* tuple,
                                            const std::vector<SlotDescriptor*>& slot_descs) {
     int nullcount = 0;
     bool valid = true;
     size_t column_num = slot_descs.size();
+    bool trie_matched = _match_jsonpath_trie(_jsonpath_trie, &objectValue);
 
     for (size_t i = 0; i < column_num; i++) {
         rapidjson::Value* json_values = nullptr;
         if (LIKELY(i < _parsed_jsonpaths.size())) {
-            json_values = JsonFunctions::get_json_array_from_parsed_json(
-                    _parsed_jsonpaths[i], &objectValue, _origin_json_doc.GetAllocator());
+            if (trie_matched && _in_jsonpath_trie[i]) {
+                json_values = _jsonpath_values[i];
+            } else {
+                json_values = JsonFunctions::get_json_array_from_parsed_json(
+                        _parsed_jsonpaths[i], &objectValue, _origin_json_doc.GetAllocator());
+            }
         }
 
         if (json_values == nullptr) {
@@ -685,12 +952,12 @@ bool JsonReader::_write_values_by_jsonpath(rapidjson::Value& objectValue, MemPoo
                 break;
             }
         } else {
-            CHECK(json_values->IsArray());
-            CHECK(json_values->Size() >= 1);
-            if (json_values->Size() == 1) {
+            if (json_values->IsArray() && json_values->Size() == 1) {
                 // NOTICE1: JsonFunctions::get_json_array_from_parsed_json() will wrap the single json object with an array.
                 // so here we unwrap the array to get the real element.
                 // if json_values' size > 1, it means we just match an array, not a wrapped one, so no need to unwrap.
+                // The values matched by _jsonpath_trie are not wrapped, and are unwrapped the same
+                // way if they are arrays of one element, as the ones matched by JsonFunctions.
                 json_values = &((*json_values)[0]);
             }
             _write_data_to_tuple(json_values, slot_descs[i], tuple, tuple_pool, &valid);
@@ -785,6 +1052,49 @@ Status JsonReader::_handle_flat_array_complex_json(Tuple* tuple,
     return Status::OK();
 }
 
+/**
+ * Stream the outer array of the json read from the file reader.
+ * For example:
+ *  [{"column1":"value1", "column2":10}, {"column1":"value2", "column2":30}]
+ * Unlike _handle_simple_json() and _handle_flat_array_complex_json(), which parse the whole
+ * array into one document, the elements are parsed one at a time into a document whose
+ * memory is reused, so a large file is loaded with the memory of its largest element.
+ */
+Status JsonReader::_handle_streaming_array_json(Tuple* tuple,
+                                                const std::vector<SlotDescriptor*>& slot_descs,
+                                                MemPool* tuple_pool, bool* is_empty_row,
+                                                bool* eof) {
+    while (true) {
+        Status st = _parse_next_array_element(eof);
+        if (st.is_data_quality_error()) {
+            continue; // continue to read next
+        }
+        RETURN_IF_ERROR(st); // terminate if encounter other errors
+        if (*eof) {          // read all data, then return
+            *is_empty_row = true;
+            return Status::OK();
+        }
+        _json_doc = &_origin_json_doc;
+
+        bool valid = false;
+        if (_parsed_jsonpaths.empty()) {
+            // the map is built from the first element which is an object, a malformed
+            // first element must not leave the columns of all the rows unresolved
+            if (_fuzzy_parse && !_name_map_inited && _json_doc->IsObject()) {
+                _init_name_map(*_json_doc, slot_descs);
+                _name_map_inited = true;
+            }
+            _set_tuple_value(*_json_doc, tuple, slot_descs, tuple_pool, &valid);
+        } else {
+            valid = _write_values_by_jsonpath(*_json_doc, tuple_pool, tuple, slot_descs);
+        }
+        if (valid) {
+            *is_empty_row = false;
+            return Status::OK(); // get a valid row
+        }
+    }
+}
+
 Status JsonReader::read_json_row(Tuple* tuple, const std::vector<SlotDescriptor*>& slot_descs,
                         MemPool* tuple_pool, bool* is_empty_row, bool* eof) {
     return (this->*_handle_json_callback)(tuple, slot_descs, tuple_pool, is_empty_row, eof);
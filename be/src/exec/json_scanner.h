@@ -116,6 +116,16 @@ private:
 };
 
 struct JsonPath;
+
+// The jsonpaths made of keys only, like "$.a.b", merged into a trie, so that the
+// jsonpaths sharing a prefix look up its keys once per row.
+struct JsonPathTrieNode {
+    std::string key;
+    // Indexes of the jsonpaths ending at this node
+    std::vector<int> columns;
+    std::vector<JsonPathTrieNode> children;
+};
+
 // Reader to parse the json.
 // For most of its methods which return type is Status,
 // return Status::OK() if process succeed or encounter data quality error.
@@ -128,7 +138,13 @@ public:
 
     ~JsonReader();
 
-    Status init(const std::string& jsonpath, const std::string& json_root); // must call before use
+    // must call before use.
+    // If `streaming` is true, an outer array read from the file reader is tokenized chunk by
+    // chunk and parsed one element at a time, so the memory used is bounded by the size of
+    // the largest element instead of the whole file. It only takes effect with
+    // `strip_outer_array` and without `json_root`.
+    Status init(const std::string& jsonpath, const std::string& json_root,
+                bool streaming = false);
 
     Status read_json_row(Tuple* tuple, const std::vector<SlotDescriptor*>& slot_descs, MemPool* tuple_pool,
                 bool* is_empty_row, bool* eof);
@@ -144,10 +160,20 @@ private:
                                            MemPool* tuple_pool, bool* is_empy_row, bool* eof);
     Status _handle_nested_complex_json(Tuple* tuple, const std::vector<SlotDescriptor*>& slot_descs,
                                        MemPool* tuple_pool, bool* is_empty_row, bool* eof);
+    Status _handle_streaming_array_json(Tuple* tuple,
+                                        const std::vector<SlotDescriptor*>& slot_descs,
+                                        MemPool* tuple_pool, bool* is_empty_row, bool* eof);
 
     void _fill_slot(Tuple* tuple, SlotDescriptor* slot_desc, MemPool* mem_pool,
                     const uint8_t* value, int32_t len);
     Status _parse_json_doc(size_t* size, bool* eof);
+    Status _parse_json_str(const uint8_t* json_str, size_t size);
+    Status _parse_next_array_element(bool* eof);
+    Status _fill_stream_buf();
+    void _init_name_map(const rapidjson::Value& objectValue,
+                        const std::vector<SlotDescriptor*>& slot_descs);
+    void _build_jsonpath_trie();
+    bool _match_jsonpath_trie(const JsonPathTrieNode& node, rapidjson::Value* value);
     void _set_tuple_value(rapidjson::Value& objectValue, Tuple* tuple,
                           const std::vector<SlotDescriptor*>& slot_descs, MemPool* tuple_pool,
                           bool* valid);
@@ -180,10 +206,30 @@ private:
 
     std::vector<std::vector<JsonPath>> _parsed_jsonpaths;
     std::vector<JsonPath> _parsed_json_root;
+    JsonPathTrieNode _jsonpath_trie;
+    // Whether the jsonpath is matched by _jsonpath_trie
+    std::vector<bool> _in_jsonpath_trie;
+    // Values matched by each jsonpath in the current row, nullptr if not found
+    std::vector<rapidjson::Value*> _jsonpath_values;
+
+    // Tokenizer state of _handle_streaming_array_json()
+    enum StreamState { BEFORE_ARRAY, IN_ARRAY, AFTER_ARRAY };
+    StreamState _stream_state = BEFORE_ARRAY;
+    std::unique_ptr<uint8_t[]> _stream_buf;
+    size_t _stream_buf_capacity = 0;
+    size_t _stream_pos = 0;
+    size_t _stream_end = 0;
+    bool _stream_eof = false;
+    // Number of elements of the current outer array
+    int64_t _stream_elements = 0;
+    // Whether an element was read since the last ',' of the current outer array
+    bool _stream_after_element = false;
 
     rapidjson::Document _origin_json_doc; // origin json document object from parsed json string
     rapidjson::Value* _json_doc; // _json_doc equals _final_json_doc iff not set `json_root`
     std::unordered_map<std::string, int> _name_map;
+    // Whether _name_map is built from an object of the streamed outer array
+    bool _name_map_inited = false;
 };
 
 } // namespace doris
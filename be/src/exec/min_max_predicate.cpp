@@ -0,0 +1,172 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "exec/min_max_predicate.h"
+
+#include "exprs/expr.h"
+#include "exprs/expr_context.h"
+#include "exprs/slot_ref.h"
+#include "runtime/descriptors.h"
+#include "runtime/string_value.h"
+
+namespace doris {
+
+// Return the opcode of "b op a" for "a op b"
+static TExprOpcode::type swap_operands(TExprOpcode::type op) {
+    switch (op) {
+    case TExprOpcode::LT:
+        return TExprOpcode::GT;
+    case TExprOpcode::LE:
+        return TExprOpcode::GE;
+    case TExprOpcode::GT:
+        return TExprOpcode::LT;
+    case TExprOpcode::GE:
+        return TExprOpcode::LE;
+    default:
+        return op;
+    }
+}
+
+static int int_type_bytes(PrimitiveType type) {
+    switch (type) {
+    case TYPE_TINYINT:
+        return 1;
+    case TYPE_SMALLINT:
+        return 2;
+    case TYPE_INT:
+        return 4;
+    case TYPE_BIGINT:
+        return 8;
+    default:
+        return 0;
+    }
+}
+
+static int64_t int_value(PrimitiveType type, const void* value) {
+    switch (type) {
+    case TYPE_TINYINT:
+        return *reinterpret_cast<const int8_t*>(value);
+    case TYPE_SMALLINT:
+        return *reinterpret_cast<const int16_t*>(value);
+    case TYPE_INT:
+        return *reinterpret_cast<const int32_t*>(value);
+    default:
+        return *reinterpret_cast<const int64_t*>(value);
+    }
+}
+
+void MinMaxPredicate::create_predicates(const std::vector<ExprContext*>& conjunct_ctxs,
+                                        const TBrokerScanRangeParams& params,
+                                        const std::vector<SlotDescriptor*>& src_slot_descs,
+                                        const TupleDescriptor* dest_tuple_desc,
+                                        std::vector<MinMaxPredicate>* predicates) {
+    if (!params.__isset.dest_sid_to_src_sid_without_trans) {
+        return;
+    }
+    for (ExprContext* ctx : conjunct_ctxs) {
+        Expr* pred = ctx->root();
+        if (pred->node_type() != TExprNodeType::BINARY_PRED) {
+            continue;
+        }
+        TExprOpcode::type op = pred->op();
+        if (op != TExprOpcode::EQ && op != TExprOpcode::LT && op != TExprOpcode::LE &&
+            op != TExprOpcode::GT && op != TExprOpcode::GE) {
+            continue;
+        }
+        DCHECK_EQ(pred->get_num_children(), 2);
+        for (int child_idx = 0; child_idx < 2; ++child_idx) {
+            Expr* slot_expr = pred->get_child(child_idx);
+            Expr* value_expr = pred->get_child(1 - child_idx);
+            // for case: where col_a > col_b
+            if (slot_expr->node_type() != TExprNodeType::SLOT_REF ||
+                !value_expr->is_constant()) {
+                continue;
+            }
+            SlotId dest_slot_id = static_cast<SlotRef*>(slot_expr)->slot_id();
+            const SlotDescriptor* dest_slot_desc = nullptr;
+            for (auto slot_desc : dest_tuple_desc->slots()) {
+                if (slot_desc->id() == dest_slot_id) {
+                    dest_slot_desc = slot_desc;
+                    break;
+                }
+            }
+            auto it = params.dest_sid_to_src_sid_without_trans.find(dest_slot_id);
+            if (dest_slot_desc == nullptr ||
+                it == params.dest_sid_to_src_sid_without_trans.end()) {
+                continue;
+            }
+            int src_slot_idx = 0;
+            while (src_slot_idx < src_slot_descs.size() &&
+                   src_slot_descs[src_slot_idx]->id() != it->second) {
+                ++src_slot_idx;
+            }
+            if (src_slot_idx == src_slot_descs.size()) {
+                continue;
+            }
+
+            void* value = ctx->get_value(value_expr, nullptr);
+            // for case: where col > null
+            if (value == nullptr) {
+                continue;
+            }
+            TExprOpcode::type slot_op = child_idx == 0 ? op : swap_operands(op);
+            PrimitiveType dest_type = dest_slot_desc->type().type;
+            PrimitiveType value_type = value_expr->type().type;
+            if (int_type_bytes(dest_type) > 0 && int_type_bytes(value_type) > 0) {
+                predicates->emplace_back(src_slot_idx, slot_op, dest_slot_desc->is_nullable(),
+                                         int_type_bytes(dest_type),
+                                         int_value(value_type, value));
+            } else if (dest_type == TYPE_VARCHAR &&
+                       (value_type == TYPE_VARCHAR || value_type == TYPE_CHAR)) {
+                // CHAR is not used because of its padding
+                const StringValue* str = reinterpret_cast<const StringValue*>(value);
+                predicates->emplace_back(src_slot_idx, slot_op, dest_slot_desc->is_nullable(),
+                                         std::string(str->ptr, str->len));
+            }
+        }
+    }
+}
+
+template <typename T>
+bool MinMaxPredicate::_may_match(const T& min, const T& max, const T& value) const {
+    switch (_op) {
+    case TExprOpcode::EQ:
+        return !(value < min) && !(max < value);
+    case TExprOpcode::LT:
+        return min < value;
+    case TExprOpcode::LE:
+        return !(value < min);
+    case TExprOpcode::GT:
+        return value < max;
+    case TExprOpcode::GE:
+        return !(max < value);
+    default:
+        return true;
+    }
+}
+
+bool MinMaxPredicate::may_match(int64_t min, int64_t max) const {
+    DCHECK_EQ(_value_type, INT_VALUE);
+    return _may_match(min, max, _int_value);
+}
+
+bool MinMaxPredicate::may_match(const std::string& min, const std::string& max) const {
+    DCHECK_EQ(_value_type, STRING_VALUE);
+    return _may_match(min, max, _string_value);
+}
+
+} // namespace doris
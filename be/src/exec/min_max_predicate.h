@@ -0,0 +1,102 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "gen_cpp/Opcodes_types.h"
+#include "gen_cpp/PlanNodes_types.h"
+
+namespace doris {
+
+class ExprContext;
+class SlotDescriptor;
+class TupleDescriptor;
+
+// A comparison "column op constant" on a column read from a file, extracted from the
+// conjuncts of a broker scan node. Scanners of the formats with statistics check it against
+// the min/max values of a parquet row group or an orc stripe, and skip the ones in which no
+// row can match. The rows of the skipped data which would have been error rows are not
+// reported, so the scanners only use them if enable_broker_load_min_max_pruning is set.
+class MinMaxPredicate {
+public:
+    enum ValueType { INT_VALUE, STRING_VALUE };
+
+    MinMaxPredicate(int src_slot_idx, TExprOpcode::type op, bool is_nullable, int int_bytes,
+                    int64_t int_value)
+            : _src_slot_idx(src_slot_idx),
+              _op(op),
+              _is_nullable(is_nullable),
+              _value_type(INT_VALUE),
+              _int_bytes(int_bytes),
+              _int_value(int_value) {}
+
+    MinMaxPredicate(int src_slot_idx, TExprOpcode::type op, bool is_nullable,
+                    std::string string_value)
+            : _src_slot_idx(src_slot_idx),
+              _op(op),
+              _is_nullable(is_nullable),
+              _value_type(STRING_VALUE),
+              _string_value(std::move(string_value)) {}
+
+    // Extract the predicates from the conjuncts on the dest tuple of a broker scan.
+    // Only the conjuncts "slot op constant" are used, where op is one of =, <, <=, >, >=
+    // and the dest slot is an integer or varchar column loaded from a src slot without
+    // transformation, see TBrokerScanRangeParams.dest_sid_to_src_sid_without_trans.
+    static void create_predicates(const std::vector<ExprContext*>& conjunct_ctxs,
+                                  const TBrokerScanRangeParams& params,
+                                  const std::vector<SlotDescriptor*>& src_slot_descs,
+                                  const TupleDescriptor* dest_tuple_desc,
+                                  std::vector<MinMaxPredicate>* predicates);
+
+    // Index of the column in the src slots of the scanner
+    int src_slot_idx() const { return _src_slot_idx; }
+
+    ValueType value_type() const { return _value_type; }
+
+    // Whether the dest slot is nullable. Nulls loaded into a not nullable slot are reported
+    // as error rows, so the data of such a slot is only skipped if it has no null.
+    bool is_nullable() const { return _is_nullable; }
+
+    // Bytes of the integer type of the dest slot. The data of an integer column of a file is
+    // only skipped if its type fits in it, otherwise some values may fail to be loaded.
+    int int_bytes() const { return _int_bytes; }
+
+    // Return false if no value in [min, max] can match.
+    bool may_match(int64_t min, int64_t max) const;
+
+    // Strings are compared as unsigned bytes.
+    bool may_match(const std::string& min, const std::string& max) const;
+
+private:
+    template <typename T>
+    bool _may_match(const T& min, const T& max, const T& value) const;
+
+    int _src_slot_idx;
+    // The column is on the left side
+    TExprOpcode::type _op;
+    bool _is_nullable;
+    ValueType _value_type;
+    int _int_bytes = 0;
+    int64_t _int_value = 0;
+    std::string _string_value;
+};
+
+} // namespace doris
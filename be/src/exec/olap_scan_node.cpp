@@ -18,6 +18,7 @@
 #include "exec/olap_scan_node.h"
 
 #include <algorithm>
+#include <boost/algorithm/string.hpp>
 #include <boost/variant.hpp>
 #include <iostream>
 #include <string>
@@ -29,6 +30,7 @@
 #include "exprs/expr.h"
 #include "exprs/expr_context.h"
 #include "exprs/runtime_filter.h"
+#include "exprs/slot_ref.h"
 #include "gen_cpp/PlanNodes_types.h"
 #include "runtime/exec_env.h"
 #include "runtime/row_batch.h"
@@ -124,6 +126,9 @@ void OlapScanNode::_init_counter(RuntimeState* state) {
     _vec_cond_timer = ADD_TIMER(_segment_profile, "VectorPredEvalTime");
 
     _stats_filtered_counter = ADD_COUNTER(_segment_profile, "RowsStatsFiltered", TUnit::UNIT);
+    _topn_filtered_counter = ADD_COUNTER(_segment_profile, "RowsTopNFiltered", TUnit::UNIT);
+    _ngram_bf_filtered_counter =
+            ADD_COUNTER(_segment_profile, "RowsNgramBfFiltered", TUnit::UNIT);
     _bf_filtered_counter = ADD_COUNTER(_segment_profile, "RowsBloomFilterFiltered", TUnit::UNIT);
     _del_filtered_counter = ADD_COUNTER(_scanner_profile, "RowsDelFiltered", TUnit::UNIT);
     _conditions_filtered_counter =
@@ -452,6 +457,7 @@ Status OlapScanNode::start_scan(RuntimeState* state) {
     VLOG_CRITICAL << "BuildOlapFilters";
     // 3. Using ColumnValueRange to Build StorageEngine filters
     RETURN_IF_ERROR(build_olap_filters());
+    build_substring_filters();
 
     VLOG_CRITICAL << "Filter idle conjuncts";
     // 4. Filter idle conjunct which already trans to olap filters
@@ -640,6 +646,121 @@ Status OlapScanNode::build_olap_filters() {
     return Status::OK();
 }
 
+// Get the integer value of a constant expr, return false if it is not an integer.
+static bool get_int_value(ExprContext* ctx, Expr* expr, int64_t* value) {
+    if (!expr->is_constant()) {
+        return false;
+    }
+    void* v = ctx->get_value(expr, nullptr);
+    if (v == nullptr) {
+        return false;
+    }
+    switch (expr->type().type) {
+    case TYPE_TINYINT:
+        *value = *reinterpret_cast<int8_t*>(v);
+        return true;
+    case TYPE_SMALLINT:
+        *value = *reinterpret_cast<int16_t*>(v);
+        return true;
+    case TYPE_INT:
+        *value = *reinterpret_cast<int32_t*>(v);
+        return true;
+    case TYPE_BIGINT:
+        *value = *reinterpret_cast<int64_t*>(v);
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Return the instr() or locate() call of the predicates "position > 0" and "position >= 1",
+// which hold if the string contains the substring, nullptr for other predicates.
+static Expr* get_contains_call(ExprContext* ctx, Expr* pred) {
+    if (pred->node_type() != TExprNodeType::BINARY_PRED) {
+        return nullptr;
+    }
+    TExprOpcode::type op = pred->op();
+    Expr* call = pred->get_child(0);
+    Expr* bound = pred->get_child(1);
+    if (call->node_type() != TExprNodeType::FUNCTION_CALL) {
+        std::swap(call, bound);
+        if (op == TExprOpcode::LT) {
+            op = TExprOpcode::GT;
+        } else if (op == TExprOpcode::LE) {
+            op = TExprOpcode::GE;
+        } else {
+            return nullptr;
+        }
+    }
+    int64_t value = 0;
+    if (call->node_type() != TExprNodeType::FUNCTION_CALL || call->get_num_children() != 2 ||
+        !get_int_value(ctx, bound, &value)) {
+        return nullptr;
+    }
+    if ((op == TExprOpcode::GT && value == 0) || (op == TExprOpcode::GE && value == 1)) {
+        return call;
+    }
+    return nullptr;
+}
+
+void OlapScanNode::build_substring_filters() {
+    std::map<std::string, std::vector<std::string>> column_substrings;
+    for (ExprContext* ctx : _conjunct_ctxs) {
+        Expr* root = ctx->root();
+        Expr* slot_expr = nullptr;
+        Expr* value_expr = nullptr;
+        bool is_like = false;
+        if (root->node_type() == TExprNodeType::FUNCTION_CALL && root->get_num_children() == 2 &&
+            boost::iequals(root->fn().name.function_name, "like")) {
+            slot_expr = root->get_child(0);
+            value_expr = root->get_child(1);
+            is_like = true;
+        } else if (Expr* call = get_contains_call(ctx, root)) {
+            const std::string& fn_name = call->fn().name.function_name;
+            if (boost::iequals(fn_name, "instr")) {
+                slot_expr = call->get_child(0);
+                value_expr = call->get_child(1);
+            } else if (boost::iequals(fn_name, "locate")) {
+                slot_expr = call->get_child(1);
+                value_expr = call->get_child(0);
+            }
+        }
+        if (slot_expr == nullptr || slot_expr->node_type() != TExprNodeType::SLOT_REF ||
+            !value_expr->is_constant() || !value_expr->type().is_string_type()) {
+            continue;
+        }
+        SlotId slot_id = static_cast<SlotRef*>(slot_expr)->slot_id();
+        const SlotDescriptor* slot = nullptr;
+        for (auto slot_desc : _tuple_desc->slots()) {
+            if (slot_desc->id() == slot_id) {
+                slot = slot_desc;
+                break;
+            }
+        }
+        if (slot == nullptr ||
+            (slot->type().type != TYPE_CHAR && slot->type().type != TYPE_VARCHAR)) {
+            continue;
+        }
+        const StringValue* value =
+                reinterpret_cast<const StringValue*>(ctx->get_value(value_expr, nullptr));
+        if (value == nullptr) {
+            continue;
+        }
+        std::string str(value->ptr, value->len);
+        std::vector<std::string>& substrings = column_substrings[slot->col_name()];
+        if (is_like) {
+            SubstringFilter::parse_like_pattern(str, &substrings);
+        } else if (!str.empty()) {
+            substrings.push_back(std::move(str));
+        }
+    }
+    for (auto& it : column_substrings) {
+        if (!it.second.empty()) {
+            _substring_filters.push_back({it.first, std::move(it.second)});
+        }
+    }
+}
+
 Status OlapScanNode::build_scan_key() {
     const std::vector<std::string>& column_names = _olap_scan_node.key_column_name;
     const std::vector<TPrimitiveType::type>& column_types = _olap_scan_node.key_column_type;
@@ -29,6 +29,8 @@
 #include "exec/scan_node.h"
 #include "exprs/bloomfilter_predicate.h"
 #include "exprs/in_predicate.h"
+#include "olap/substring_filter.h"
+#include "olap/topn_filter.h"
 #include "runtime/descriptors.h"
 #include "runtime/row_batch_interface.hpp"
 #include "runtime/vectorized_row_batch.h"
@@ -62,6 +64,10 @@ public:
     virtual Status close(RuntimeState* state);
     virtual Status set_scan_ranges(const std::vector<TScanRangeParams>& scan_ranges);
     inline void set_no_agg_finalize() { _need_agg_finalize = false; }
+    // Called by the TopN above this node before open(), the scanners skip pages by its bound.
+    void set_topn_filter(std::shared_ptr<TopNFilter> topn_filter) {
+        _topn_filter = std::move(topn_filter);
+    }
 
 protected:
     typedef struct {
@@ -149,6 +155,9 @@ protected:
     void eval_const_conjuncts();
     Status normalize_conjuncts();
     Status build_olap_filters();
+    // collect the substrings required by LIKE '%substr%', instr() and locate() conjuncts on
+    // string columns, used by the ngram bloom filter index. the conjuncts are not removed.
+    void build_substring_filters();
     Status build_scan_key();
     virtual Status start_scan_thread(RuntimeState* state);
 
@@ -315,6 +324,10 @@ protected:
     std::vector<RuntimeFilterContext> _runtime_filter_ctxs;
     std::map<int, RuntimeFilterContext*> _conjunctid_to_runtime_filter_ctxs;
 
+    std::shared_ptr<TopNFilter> _topn_filter;
+
+    std::vector<SubstringFilter> _substring_filters;
+
     std::unique_ptr<RuntimeProfile> _scanner_profile;
     std::unique_ptr<RuntimeProfile> _segment_profile;
 
@@ -329,6 +342,8 @@ protected:
     RuntimeProfile::Counter* _vec_cond_timer = nullptr;
 
     RuntimeProfile::Counter* _stats_filtered_counter = nullptr;
+    RuntimeProfile::Counter* _topn_filtered_counter = nullptr;
+    RuntimeProfile::Counter* _ngram_bf_filtered_counter = nullptr;
     RuntimeProfile::Counter* _bf_filtered_counter = nullptr;
     RuntimeProfile::Counter* _del_filtered_counter = nullptr;
     RuntimeProfile::Counter* _conditions_filtered_counter = nullptr;
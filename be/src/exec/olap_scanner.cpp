@@ -155,6 +155,10 @@ Status OlapScanner::_init_params(
     }
     std::copy(bloom_filters.cbegin(), bloom_filters.cend(),
               std::inserter(_params.bloom_filters, _params.bloom_filters.begin()));
+    _params.topn_filter = _parent->_topn_filter.get();
+    if (!_parent->_substring_filters.empty()) {
+        _params.substring_filters = &_parent->_substring_filters;
+    }
 
     // Range
     for (auto key_range : key_ranges) {
@@ -523,6 +527,8 @@ void OlapScanner::update_counter() {
     COUNTER_UPDATE(_parent->_rows_vec_cond_counter, _reader->stats().rows_vec_cond_filtered);
 
     COUNTER_UPDATE(_parent->_stats_filtered_counter, _reader->stats().rows_stats_filtered);
+    COUNTER_UPDATE(_parent->_topn_filtered_counter, _reader->stats().rows_topn_filtered);
+    COUNTER_UPDATE(_parent->_ngram_bf_filtered_counter, _reader->stats().rows_ngram_bf_filtered);
     COUNTER_UPDATE(_parent->_bf_filtered_counter, _reader->stats().rows_bf_filtered);
     COUNTER_UPDATE(_parent->_del_filtered_counter, _reader->stats().rows_del_filtered);
     COUNTER_UPDATE(_parent->_del_filtered_counter, _reader->stats().rows_vec_del_cond_filtered);
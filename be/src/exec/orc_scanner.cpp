@@ -128,13 +128,16 @@ ORCScanner::ORCScanner(RuntimeState* state, RuntimeProfile* profile,
           _total_groups(0),
           _current_group(0),
           _rows_of_group(0),
-          _current_line_of_group(0) {}
+          _current_line_of_group(0),
+          _first_row_of_group(0),
+          _skipped_stripes_counter(nullptr) {}
 
 ORCScanner::~ORCScanner() {
     close();
 }
 
 Status ORCScanner::open() {
+    _skipped_stripes_counter = ADD_COUNTER(_profile, "SkippedStripes", TUnit::UNIT);
     RETURN_IF_ERROR(BaseScanner::open());
     if (!_ranges.empty()) {
         std::list<std::string> include_cols;
@@ -167,10 +170,24 @@ Status ORCScanner::get_next(Tuple* tuple, MemPool* tuple_pool, bool* eof) {
                 }
             }
             if (_current_line_of_group >= _rows_of_group) { // read next stripe
+                _first_row_of_group += _rows_of_group;
+                bool skipped = false;
+                while (_current_group < _total_groups && !stripe_may_match(_current_group)) {
+                    int64_t rows = _reader->getStripe(_current_group)->getNumberOfRows();
+                    // Rows of the skipped stripes are filtered by predicates
+                    _counter->num_rows_unselected += rows;
+                    COUNTER_UPDATE(_skipped_stripes_counter, 1);
+                    _first_row_of_group += rows;
+                    ++_current_group;
+                    skipped = true;
+                }
                 if (_current_group >= _total_groups) {
                     _cur_file_eof = true;
                     continue;
                 }
+                if (skipped) {
+                    _row_reader->seekToRow(_first_row_of_group);
+                }
                 _rows_of_group = _reader->getStripe(_current_group)->getNumberOfRows();
                 _batch = _row_reader->createRowBatch(_rows_of_group);
                 _row_reader->next(*_batch.get());
@@ -426,8 +443,19 @@ Status ORCScanner::open_next_reader() {
         _current_group = 0;
         _rows_of_group = 0;
         _current_line_of_group = 0;
+        _first_row_of_group = 0;
         _row_reader = _reader->createRowReader(_row_reader_options);
 
+        _orc_field_indices.assign(_num_of_columns_from_file, -1);
+        const orc::Type& file_type = _reader->getType();
+        for (int i = 0; i < file_type.getSubtypeCount(); ++i) {
+            for (int j = 0; j < _num_of_columns_from_file; ++j) {
+                if (file_type.getFieldName(i) == _src_slot_descs[j]->col_name()) {
+                    _orc_field_indices[j] = i;
+                }
+            }
+        }
+
         //include_colus is in loader columns order, and batch is in the orc order
         _position_in_orc_original.clear();
         _position_in_orc_original.resize(_num_of_columns_from_file);
@@ -443,6 +471,63 @@ Status ORCScanner::open_next_reader() {
     }
 }
 
+bool ORCScanner::stripe_may_match(int stripe) {
+    if (_min_max_predicates.empty() ||
+        static_cast<uint64_t>(stripe) >= _reader->getNumberOfStripeStatistics()) {
+        return true;
+    }
+    std::unique_ptr<orc::StripeStatistics> stripe_stats = _reader->getStripeStatistics(stripe);
+    for (const auto& predicate : _min_max_predicates) {
+        // columns from path are not in file
+        if (predicate.src_slot_idx() >= _num_of_columns_from_file ||
+            _orc_field_indices[predicate.src_slot_idx()] < 0) {
+            continue;
+        }
+        const orc::Type* field_type =
+                _reader->getType().getSubtype(_orc_field_indices[predicate.src_slot_idx()]);
+        const orc::ColumnStatistics* stats =
+                stripe_stats->getColumnStatistics(field_type->getColumnId());
+        if (stats == nullptr || (!predicate.is_nullable() && stats->hasNull())) {
+            continue;
+        }
+        int int_bytes = 0;
+        switch (field_type->getKind()) {
+        case orc::BYTE:
+            int_bytes = 1;
+            break;
+        case orc::SHORT:
+            int_bytes = 2;
+            break;
+        case orc::INT:
+            int_bytes = 4;
+            break;
+        case orc::LONG:
+            int_bytes = 8;
+            break;
+        case orc::STRING:
+        case orc::VARCHAR: {
+            auto str_stats = dynamic_cast<const orc::StringColumnStatistics*>(stats);
+            if (predicate.value_type() == MinMaxPredicate::STRING_VALUE && str_stats != nullptr &&
+                str_stats->hasMinimum() && str_stats->hasMaximum() &&
+                !predicate.may_match(str_stats->getMinimum(), str_stats->getMaximum())) {
+                return false;
+            }
+            continue;
+        }
+        default:
+            continue;
+        }
+        auto int_stats = dynamic_cast<const orc::IntegerColumnStatistics*>(stats);
+        if (predicate.value_type() == MinMaxPredicate::INT_VALUE &&
+            predicate.int_bytes() >= int_bytes && int_stats != nullptr &&
+            int_stats->hasMinimum() && int_stats->hasMaximum() &&
+            !predicate.may_match(int_stats->getMinimum(), int_stats->getMaximum())) {
+            return false;
+        }
+    }
+    return true;
+}
+
 void ORCScanner::close() {
     _batch = nullptr;
     _reader.reset(nullptr);
@@ -48,6 +48,9 @@ private:
     // Read next buffer from reader
     Status open_next_reader();
 
+    // Return false if no row of the stripe can match _min_max_predicates
+    bool stripe_may_match(int stripe);
+
 private:
     const std::vector<TBrokerRangeDesc>& _ranges;
     const std::vector<TNetworkAddress>& _broker_addresses;
@@ -66,12 +69,18 @@ private:
     // The batch after reading from orc data is arranged in the original order,
     // so we need to record the index in the original order to correspond the column names to the order
     std::vector<int> _position_in_orc_original;
+    // The index in the orc file schema of each column from file, -1 if it is not found
+    std::vector<int> _orc_field_indices;
     int _num_of_columns_from_file;
 
     int _total_groups; // groups in a orc file
     int _current_group;
     int64_t _rows_of_group; // rows in a group.
     int64_t _current_line_of_group;
+    // the row number of the first row of _current_group in file
+    int64_t _first_row_of_group;
+
+    RuntimeProfile::Counter* _skipped_stripes_counter;
 };
 
 } // namespace doris
@@ -42,7 +42,10 @@ ParquetReaderWrap::ParquetReaderWrap(FileReader* file_reader, int32_t num_of_col
           _current_group(0),
           _rows_of_group(0),
           _current_line_of_group(0),
-          _current_line_of_batch(0) {
+          _current_line_of_batch(0),
+          _predicates(nullptr),
+          _num_skipped_groups(0),
+          _num_skipped_rows(0) {
     _parquet = std::shared_ptr<ParquetFile>(new ParquetFile(file_reader));
     _properties = parquet::ReaderProperties();
     _properties.enable_buffered_stream();
@@ -53,7 +56,8 @@ ParquetReaderWrap::~ParquetReaderWrap() {
     close();
 }
 Status ParquetReaderWrap::init_parquet_reader(const std::vector<SlotDescriptor*>& tuple_slot_descs,
-                                              const std::string& timezone) {
+                                              const std::string& timezone,
+                                              const std::vector<MinMaxPredicate>* predicates) {
     try {
         // new file reader for parquet file
         auto st = parquet::arrow::FileReader::Make(
@@ -70,7 +74,6 @@ Status ParquetReaderWrap::init_parquet_reader(const std::vector<SlotDescriptor*>
         if (_total_groups == 0) {
             return Status::EndOfFile("Empty Parquet File");
         }
-        _rows_of_group = _file_metadata->RowGroup(0)->num_rows();
 
         // map
         auto* schemaDescriptor = _file_metadata->schema();
@@ -84,9 +87,15 @@ Status ParquetReaderWrap::init_parquet_reader(const std::vector<SlotDescriptor*>
         }
 
         _timezone = timezone;
+        _predicates = predicates;
 
         if (_current_line_of_group == 0) { // the first read
             RETURN_IF_ERROR(column_indices(tuple_slot_descs));
+            _current_group = next_row_group(0);
+            if (_current_group >= _total_groups) {
+                return Status::EndOfFile("All row groups are skipped");
+            }
+            _rows_of_group = _file_metadata->RowGroup(_current_group)->num_rows();
             // read batch
             arrow::Status status = _reader->GetRecordBatchReader({_current_group},
                                                                  _parquet_column_ids, &_rb_batch);
@@ -158,6 +167,96 @@ Status ParquetReaderWrap::column_indices(const std::vector<SlotDescriptor*>& tup
     return Status::OK();
 }
 
+int ParquetReaderWrap::next_row_group(int group) {
+    if (_predicates == nullptr || _predicates->empty()) {
+        return group;
+    }
+    for (; group < _total_groups; ++group) {
+        if (row_group_may_match(group)) {
+            break;
+        }
+        _num_skipped_groups++;
+        _num_skipped_rows += _file_metadata->RowGroup(group)->num_rows();
+    }
+    return group;
+}
+
+// Integers without a logical type which changes their order or meaning
+static bool is_plain_int(const parquet::ColumnDescriptor* column) {
+    switch (column->converted_type()) {
+    case parquet::ConvertedType::NONE:
+    case parquet::ConvertedType::INT_8:
+    case parquet::ConvertedType::INT_16:
+    case parquet::ConvertedType::INT_32:
+    case parquet::ConvertedType::INT_64:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool ParquetReaderWrap::row_group_may_match(int group) {
+    auto row_group = _file_metadata->RowGroup(group);
+    for (const auto& predicate : *_predicates) {
+        // columns from path are not in file
+        if (predicate.src_slot_idx() >= _parquet_column_ids.size()) {
+            continue;
+        }
+        int column_id = _parquet_column_ids[predicate.src_slot_idx()];
+        const parquet::ColumnDescriptor* column = _file_metadata->schema()->Column(column_id);
+        auto column_chunk = row_group->ColumnChunk(column_id);
+        if (column->max_repetition_level() > 0 || !column_chunk->is_stats_set()) {
+            continue;
+        }
+        std::shared_ptr<parquet::Statistics> stats = column_chunk->statistics();
+        if (!stats->HasMinMax() || (!predicate.is_nullable() && stats->null_count() > 0)) {
+            continue;
+        }
+        switch (column->physical_type()) {
+        case parquet::Type::INT32: {
+            if (predicate.value_type() != MinMaxPredicate::INT_VALUE || !is_plain_int(column) ||
+                predicate.int_bytes() < 4) {
+                break;
+            }
+            auto int_stats = std::static_pointer_cast<parquet::Int32Statistics>(stats);
+            if (!predicate.may_match(int_stats->min(), int_stats->max())) {
+                return false;
+            }
+            break;
+        }
+        case parquet::Type::INT64: {
+            if (predicate.value_type() != MinMaxPredicate::INT_VALUE || !is_plain_int(column) ||
+                predicate.int_bytes() < 8) {
+                break;
+            }
+            auto int_stats = std::static_pointer_cast<parquet::Int64Statistics>(stats);
+            if (!predicate.may_match(int_stats->min(), int_stats->max())) {
+                return false;
+            }
+            break;
+        }
+        case parquet::Type::BYTE_ARRAY: {
+            if (predicate.value_type() != MinMaxPredicate::STRING_VALUE ||
+                column->sort_order() != parquet::SortOrder::UNSIGNED) {
+                break;
+            }
+            auto str_stats = std::static_pointer_cast<parquet::ByteArrayStatistics>(stats);
+            const parquet::ByteArray& min = str_stats->min();
+            const parquet::ByteArray& max = str_stats->max();
+            std::string min_value(reinterpret_cast<const char*>(min.ptr), min.len);
+            std::string max_value(reinterpret_cast<const char*>(max.ptr), max.len);
+            if (!predicate.may_match(min_value, max_value)) {
+                return false;
+            }
+            break;
+        }
+        default:
+            break;
+        }
+    }
+    return true;
+}
+
 inline Status ParquetReaderWrap::set_field_null(Tuple* tuple, const SlotDescriptor* slot_desc) {
     if (!slot_desc->is_nullable()) {
         std::stringstream str_error;
@@ -177,7 +276,7 @@ Status ParquetReaderWrap::read_record_batch(const std::vector<SlotDescriptor*>&
                 << " current line of group:" << _current_line_of_group
                 << " is larger than rows group size:" << _rows_of_group
                 << ". start to read next row group";
-        _current_group++;
+        _current_group = next_row_group(_current_group + 1);
         if (_current_group >= _total_groups) { // read completed.
             _parquet_column_ids.clear();
             *eof = true;
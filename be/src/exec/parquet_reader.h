@@ -33,6 +33,7 @@
 #include <string>
 
 #include "common/status.h"
+#include "exec/min_max_predicate.h"
 #include "gen_cpp/PaloBrokerService_types.h"
 #include "gen_cpp/PlanNodes_types.h"
 #include "gen_cpp/Types_types.h"
@@ -77,13 +78,21 @@ public:
                 MemPool* mem_pool, bool* eof);
     void close();
     Status size(int64_t* size);
+    // The row groups in which no row can match 'predicates' are skipped.
     Status init_parquet_reader(const std::vector<SlotDescriptor*>& tuple_slot_descs,
-                               const std::string& timezone);
+                               const std::string& timezone,
+                               const std::vector<MinMaxPredicate>* predicates = nullptr);
+
+    int num_skipped_groups() const { return _num_skipped_groups; }
+    int64_t num_skipped_rows() const { return _num_skipped_rows; }
 
 private:
     void fill_slot(Tuple* tuple, SlotDescriptor* slot_desc, MemPool* mem_pool, const uint8_t* value,
                    int32_t len);
     Status column_indices(const std::vector<SlotDescriptor*>& tuple_slot_descs);
+    // Return the first row group from 'group' which may have matched rows
+    int next_row_group(int group);
+    bool row_group_may_match(int group);
     Status set_field_null(Tuple* tuple, const SlotDescriptor* slot_desc);
     Status read_record_batch(const std::vector<SlotDescriptor*>& tuple_slot_descs, bool* eof);
     Status handle_timestamp(const std::shared_ptr<arrow::TimestampArray>& ts_array, uint8_t* buf,
@@ -110,6 +119,10 @@ private:
     int _current_line_of_batch;
 
     std::string _timezone;
+
+    const std::vector<MinMaxPredicate>* _predicates;
+    int _num_skipped_groups;
+    int64_t _num_skipped_rows;
 };
 
 } // namespace doris
@@ -61,13 +61,15 @@ ParquetScanner::ParquetScanner(RuntimeState* state, RuntimeProfile* profile,
           _cur_file_reader(nullptr),
           _next_range(0),
           _cur_file_eof(false),
-          _scanner_eof(false) {}
+          _scanner_eof(false),
+          _skipped_row_groups_counter(nullptr) {}
 
 ParquetScanner::~ParquetScanner() {
     close();
 }
 
 Status ParquetScanner::open() {
+    _skipped_row_groups_counter = ADD_COUNTER(_profile, "SkippedRowGroups", TUnit::UNIT);
     return BaseScanner::open();
 }
 
@@ -108,15 +110,7 @@ Status ParquetScanner::get_next(Tuple* tuple, MemPool* tuple_pool, bool* eof) {
 
 Status ParquetScanner::open_next_reader() {
     // open_file_reader
-    if (_cur_file_reader != nullptr) {
-        if (_stream_load_pipe != nullptr) {
-            _stream_load_pipe.reset();
-            _cur_file_reader = nullptr;
-        } else {
-            delete _cur_file_reader;
-            _cur_file_reader = nullptr;
-        }
-    }
+    close_reader();
 
     while (true) {
         if (_next_range >= _ranges.size()) {
@@ -184,9 +178,11 @@ Status ParquetScanner::open_next_reader() {
             _cur_file_reader = new ParquetReaderWrap(file_reader.release(), _src_slot_descs.size());
         }
 
-        Status status = _cur_file_reader->init_parquet_reader(_src_slot_descs, _state->timezone());
+        Status status = _cur_file_reader->init_parquet_reader(_src_slot_descs, _state->timezone(),
+                                                              &_min_max_predicates);
 
         if (status.is_end_of_file()) {
+            close_reader();
             continue;
         } else {
             if (!status.ok()) {
@@ -201,7 +197,14 @@ Status ParquetScanner::open_next_reader() {
 }
 
 void ParquetScanner::close() {
+    close_reader();
+}
+
+void ParquetScanner::close_reader() {
     if (_cur_file_reader != nullptr) {
+        // Rows of the skipped row groups are filtered by predicates
+        COUNTER_UPDATE(_skipped_row_groups_counter, _cur_file_reader->num_skipped_groups());
+        _counter->num_rows_unselected += _cur_file_reader->num_skipped_rows();
         if (_stream_load_pipe != nullptr) {
             _stream_load_pipe.reset();
             _cur_file_reader = nullptr;
@@ -70,6 +70,8 @@ private:
     // Read next buffer from reader
     Status open_next_reader();
 
+    void close_reader();
+
 private:
     //const TBrokerScanRangeParams& _params;
     const std::vector<TBrokerRangeDesc>& _ranges;
@@ -83,6 +85,8 @@ private:
 
     // used to hold current StreamLoadPipe
     std::shared_ptr<StreamLoadPipe> _stream_load_pipe;
+
+    RuntimeProfile::Counter* _skipped_row_groups_counter;
 };
 
 } // namespace doris
@@ -17,6 +17,10 @@
 
 #include "exec/plain_text_line_reader.h"
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 #include "common/status.h"
 #include "exec/decompressor.h"
 #include "exec/file_reader.h"
@@ -91,10 +95,60 @@ inline bool PlainTextLineReader::update_eof() {
     return _eof;
 }
 
+void PlainTextLineReader::save_field_pos(char value_separator) {
+    _save_field_pos = _line_delimiter_length == 1;
+    _value_separator = value_separator;
+}
+
 uint8_t* PlainTextLineReader::update_field_pos_and_find_line_delimiter(const uint8_t* start,
                                                                        size_t len) {
-    // TODO: meanwhile find and save field pos
-    return (uint8_t*)memmem(start, len, _line_delimiter.c_str(), _line_delimiter_length);
+    if (!_save_field_pos) {
+        return (uint8_t*)memmem(start, len, _line_delimiter.c_str(), _line_delimiter_length);
+    }
+
+    // The positions are relative to the start of the line, so they stay valid when the
+    // output buf is moved. A line which was not complete is scanned on from where it ended.
+    const uint8_t* line_start = _output_buf + _output_buf_pos;
+    if (start == line_start) {
+        _field_pos.clear();
+    }
+    const uint8_t* p = start;
+    const uint8_t* end = start + len;
+    const uint8_t line_delimiter = _line_delimiter[0];
+    const uint8_t value_separator = _value_separator;
+#ifdef __SSE2__
+    // Compare 16 bytes at a time against both delimiters, the bits set in the masks are the
+    // positions they are found at.
+    const __m128i line_delimiter16 = _mm_set1_epi8(line_delimiter);
+    const __m128i value_separator16 = _mm_set1_epi8(value_separator);
+    for (; p + 16 <= end; p += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        uint32_t line_mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, line_delimiter16));
+        uint32_t field_mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, value_separator16));
+        if (line_mask != 0) {
+            // Only the separators before the line delimiter belong to this line.
+            int line_pos = __builtin_ctz(line_mask);
+            field_mask &= (1u << line_pos) - 1;
+        }
+        size_t base = p - line_start;
+        while (field_mask != 0) {
+            _field_pos.push_back(base + __builtin_ctz(field_mask));
+            field_mask &= field_mask - 1;
+        }
+        if (line_mask != 0) {
+            return const_cast<uint8_t*>(p + __builtin_ctz(line_mask));
+        }
+    }
+#endif
+    for (; p < end; ++p) {
+        if (*p == line_delimiter) {
+            return const_cast<uint8_t*>(p);
+        }
+        if (*p == value_separator) {
+            _field_pos.push_back(p - line_start);
+        }
+    }
+    return nullptr;
 }
 
 // extend input buf if necessary only when _more_input_bytes > 0
@@ -17,6 +17,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "exec/line_reader.h"
 #include "util/runtime_profile.h"
 
@@ -38,6 +40,17 @@ public:
 
     virtual void close() override;
 
+    // Also saves the positions of value_separator in every line read, found in the same pass
+    // as the line delimiter. Only a single byte line delimiter is supported, otherwise no
+    // position is saved.
+    void save_field_pos(char value_separator);
+
+    // Positions of the value separators in the last line read, relative to its start, or
+    // nullptr if they are not saved.
+    const std::vector<size_t>* field_pos() const {
+        return _save_field_pos ? &_field_pos : nullptr;
+    }
+
 private:
     bool update_eof();
 
@@ -49,8 +62,7 @@ private:
 
     // find line delimiter from 'start' to 'start' + len,
     // return line delimiter pos if found, otherwise return nullptr.
-    // TODO:
-    //  save to positions of field separator
+    // If _save_field_pos is set, meanwhile saves the positions of the value separators.
     uint8_t* update_field_pos_and_find_line_delimiter(const uint8_t* start, size_t len);
 
     void extend_input_buf();
@@ -77,6 +89,10 @@ private:
     size_t _output_buf_pos;
     size_t _output_buf_limit;
 
+    bool _save_field_pos = false;
+    char _value_separator = '\0';
+    std::vector<size_t> _field_pos;
+
     bool _file_eof;
     bool _eof;
     bool _stream_end;
@@ -50,6 +50,8 @@
 #include "util/file_utils.h"
 #include "util/monotime.h"
 #include "util/string_util.h"
+#include "util/stopwatch.hpp"
+#include "util/threadpool.h"
 
 using strings::Substitute;
 
@@ -61,9 +63,14 @@ DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(disks_data_used_capacity, MetricUnit::BYTES);
 DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(disks_state, MetricUnit::BYTES);
 DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(disks_compaction_score, MetricUnit::NOUNIT);
 DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(disks_compaction_num, MetricUnit::NOUNIT);
+DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(disks_load_rowset_metas_ms, MetricUnit::MILLISECONDS);
+DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(disks_load_tablets_ms, MetricUnit::MILLISECONDS);
+DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(disks_load_rowsets_ms, MetricUnit::MILLISECONDS);
 
 static const char* const kMtabPath = "/etc/mtab";
 static const char* const kTestFilePath = "/.testfile";
+// number of the metas parsed and loaded by a task of the load pool
+static const size_t kLoadMetaBatchSize = 1024;
 
 DataDir::DataDir(const std::string& path, int64_t capacity_bytes,
                  TStorageMedium::type storage_medium, TabletManager* tablet_manager,
@@ -88,6 +95,9 @@ DataDir::DataDir(const std::string& path, int64_t capacity_bytes,
     INT_GAUGE_METRIC_REGISTER(_data_dir_metric_entity, disks_state);
     INT_GAUGE_METRIC_REGISTER(_data_dir_metric_entity, disks_compaction_score);
     INT_GAUGE_METRIC_REGISTER(_data_dir_metric_entity, disks_compaction_num);
+    INT_GAUGE_METRIC_REGISTER(_data_dir_metric_entity, disks_load_rowset_metas_ms);
+    INT_GAUGE_METRIC_REGISTER(_data_dir_metric_entity, disks_load_tablets_ms);
+    INT_GAUGE_METRIC_REGISTER(_data_dir_metric_entity, disks_load_rowsets_ms);
 }
 
 DataDir::~DataDir() {
@@ -490,7 +500,7 @@ OLAPStatus DataDir::_check_incompatible_old_format_tablet() {
 }
 
 // TODO(ygl): deal with rowsets and tablets when load failed
-OLAPStatus DataDir::load() {
+OLAPStatus DataDir::load(ThreadPool* load_pool) {
     LOG(INFO) << "start to load tablets from " << _path;
     // load rowset meta from meta env and create rowset
     // COMMITTED: add to txn manager
@@ -500,64 +510,130 @@ OLAPStatus DataDir::load() {
     // necessarily check incompatible old format. when there are old metas, it may load to data missing
     _check_incompatible_old_format_tablet();
 
+    // The meta store is traversed by this thread, while the metas read from it are parsed and
+    // loaded in batches by the tasks of this data dir in load_pool.
+    std::unique_ptr<ThreadPoolToken> load_token;
+    if (load_pool != nullptr) {
+        load_token = load_pool->new_token(ThreadPool::ExecutionMode::CONCURRENT);
+    }
+    auto submit_load_task = [&load_token](std::function<void()> task) {
+        if (load_token == nullptr || !load_token->submit_func(task).ok()) {
+            task();
+        }
+    };
+    auto wait_load_tasks = [&load_token]() {
+        if (load_token != nullptr) {
+            load_token->wait();
+        }
+    };
+    MonotonicStopWatch watch;
+    watch.start();
+
     std::vector<RowsetMetaSharedPtr> dir_rowset_metas;
+    std::mutex rowset_metas_lock;
+    using RowsetMetaBatch = std::vector<std::pair<RowsetId, std::string>>;
+    auto parse_rowset_metas = [&dir_rowset_metas, &rowset_metas_lock](const RowsetMetaBatch& batch) {
+        std::vector<RowsetMetaSharedPtr> rowset_metas;
+        for (auto& [rowset_id, meta_str] : batch) {
+            RowsetMetaSharedPtr rowset_meta(new AlphaRowsetMeta());
+            bool parsed = rowset_meta->init(meta_str);
+            if (!parsed) {
+                LOG(WARNING) << "parse rowset meta string failed for rowset_id:" << rowset_id;
+                // skip this error
+                continue;
+            }
+            rowset_metas.push_back(std::move(rowset_meta));
+        }
+        std::lock_guard<std::mutex> l(rowset_metas_lock);
+        dir_rowset_metas.insert(dir_rowset_metas.end(), rowset_metas.begin(), rowset_metas.end());
+    };
     LOG(INFO) << "begin loading rowset from meta";
-    auto load_rowset_func = [&dir_rowset_metas](TabletUid tablet_uid, RowsetId rowset_id,
-                                                const std::string& meta_str) -> bool {
-        RowsetMetaSharedPtr rowset_meta(new AlphaRowsetMeta());
-        bool parsed = rowset_meta->init(meta_str);
-        if (!parsed) {
-            LOG(WARNING) << "parse rowset meta string failed for rowset_id:" << rowset_id;
-            // return false will break meta iterator, return true to skip this error
-            return true;
+    auto rowset_meta_batch = std::make_shared<RowsetMetaBatch>();
+    auto load_rowset_func = [&](TabletUid tablet_uid, RowsetId rowset_id,
+                                const std::string& meta_str) -> bool {
+        rowset_meta_batch->emplace_back(rowset_id, meta_str);
+        if (rowset_meta_batch->size() >= kLoadMetaBatchSize) {
+            submit_load_task([batch = std::move(rowset_meta_batch), &parse_rowset_metas] {
+                parse_rowset_metas(*batch);
+            });
+            rowset_meta_batch = std::make_shared<RowsetMetaBatch>();
         }
-        dir_rowset_metas.push_back(rowset_meta);
         return true;
     };
     OLAPStatus load_rowset_status =
             RowsetMetaManager::traverse_rowset_metas(_meta, load_rowset_func);
+    parse_rowset_metas(*rowset_meta_batch);
+    wait_load_tasks();
 
     if (load_rowset_status != OLAP_SUCCESS) {
         LOG(WARNING) << "errors when load rowset meta from meta env, skip this data dir:" << _path;
     } else {
-        LOG(INFO) << "load rowset from meta finished, data dir: " << _path;
+        LOG(INFO) << "load rowset from meta finished, data dir: " << _path
+                  << ", cost(ms): " << watch.elapsed_time() / 1000000;
     }
+    disks_load_rowset_metas_ms->set_value(watch.elapsed_time() / 1000000);
 
     // load tablet
     // create tablet from tablet meta and add it to tablet mgr
     LOG(INFO) << "begin loading tablet from meta";
+    watch.reset();
+    watch.start();
     std::set<int64_t> tablet_ids;
     std::set<int64_t> failed_tablet_ids;
-    auto load_tablet_func = [this, &tablet_ids, &failed_tablet_ids](
-                                    int64_t tablet_id, int32_t schema_hash,
-                                    const std::string& value) -> bool {
-        OLAPStatus status = _tablet_manager->load_tablet_from_meta(this, tablet_id, schema_hash,
-                                                                   value, false, false, false, false);
-        if (status != OLAP_SUCCESS && status != OLAP_ERR_TABLE_ALREADY_DELETED_ERROR
-            && status != OLAP_ERR_ENGINE_INSERT_OLD_TABLET) {
-            // load_tablet_from_meta() may return OLAP_ERR_TABLE_ALREADY_DELETED_ERROR
-            // which means the tablet status is DELETED
-            // This may happen when the tablet was just deleted before the BE restarted,
-            // but it has not been cleared from rocksdb. At this time, restarting the BE
-            // will read the tablet in the DELETE state from rocksdb. These tablets have been
-            // added to the garbage collection queue and will be automatically deleted afterwards.
-            // Therefore, we believe that this situation is not a failure.
-
-            // Besides, load_tablet_from_meta() may return OLAP_ERR_ENGINE_INSERT_OLD_TABLET
-            // when BE is restarting and the older tablet have been added to the 
-            // garbage collection queue but not deleted yet.
-            // In this case, since the data_dirs are parallel loaded, a later loaded tablet 
-            // may be older than previously loaded one, which should not be acknowledged as a
-            // failure.
-            LOG(WARNING) << "load tablet from header failed. status:" << status
-                         << ", tablet=" << tablet_id << "." << schema_hash;
-            failed_tablet_ids.insert(tablet_id);
-        } else {
-            tablet_ids.insert(tablet_id);
+    std::mutex tablet_ids_lock;
+    struct TabletMetaEntry {
+        int64_t tablet_id;
+        int32_t schema_hash;
+        std::string value;
+    };
+    using TabletMetaBatch = std::vector<TabletMetaEntry>;
+    auto load_tablets = [this, &tablet_ids, &failed_tablet_ids,
+                         &tablet_ids_lock](const TabletMetaBatch& batch) {
+        for (const TabletMetaEntry& entry : batch) {
+            int64_t tablet_id = entry.tablet_id;
+            int32_t schema_hash = entry.schema_hash;
+            OLAPStatus status = _tablet_manager->load_tablet_from_meta(
+                    this, tablet_id, schema_hash, entry.value, false, false, false, false);
+            std::lock_guard<std::mutex> l(tablet_ids_lock);
+            if (status != OLAP_SUCCESS && status != OLAP_ERR_TABLE_ALREADY_DELETED_ERROR
+                && status != OLAP_ERR_ENGINE_INSERT_OLD_TABLET) {
+                // load_tablet_from_meta() may return OLAP_ERR_TABLE_ALREADY_DELETED_ERROR
+                // which means the tablet status is DELETED
+                // This may happen when the tablet was just deleted before the BE restarted,
+                // but it has not been cleared from rocksdb. At this time, restarting the BE
+                // will read the tablet in the DELETE state from rocksdb. These tablets have been
+                // added to the garbage collection queue and will be automatically deleted afterwards.
+                // Therefore, we believe that this situation is not a failure.
+
+                // Besides, load_tablet_from_meta() may return OLAP_ERR_ENGINE_INSERT_OLD_TABLET
+                // when BE is restarting and the older tablet have been added to the 
+                // garbage collection queue but not deleted yet.
+                // In this case, since the data_dirs are parallel loaded, a later loaded tablet 
+                // may be older than previously loaded one, which should not be acknowledged as a
+                // failure.
+                LOG(WARNING) << "load tablet from header failed. status:" << status
+                             << ", tablet=" << tablet_id << "." << schema_hash;
+                failed_tablet_ids.insert(tablet_id);
+            } else {
+                tablet_ids.insert(tablet_id);
+            }
+        }
+    };
+    auto tablet_meta_batch = std::make_shared<TabletMetaBatch>();
+    auto load_tablet_func = [&](int64_t tablet_id, int32_t schema_hash,
+                                const std::string& value) -> bool {
+        tablet_meta_batch->push_back({tablet_id, schema_hash, value});
+        if (tablet_meta_batch->size() >= kLoadMetaBatchSize) {
+            submit_load_task([batch = std::move(tablet_meta_batch), &load_tablets] {
+                load_tablets(*batch);
+            });
+            tablet_meta_batch = std::make_shared<TabletMetaBatch>();
         }
         return true;
     };
     OLAPStatus load_tablet_status = TabletMetaManager::traverse_headers(_meta, load_tablet_func);
+    load_tablets(*tablet_meta_batch);
+    wait_load_tasks();
     if (failed_tablet_ids.size() != 0) {
         LOG(WARNING) << "load tablets from header failed"
                      << ", loaded tablet: " << tablet_ids.size()
@@ -573,71 +649,88 @@ OLAPStatus DataDir::load() {
     } else {
         LOG(INFO) << "load tablet from meta finished"
                   << ", loaded tablet: " << tablet_ids.size()
-                  << ", error tablet: " << failed_tablet_ids.size() << ", path: " << _path;
+                  << ", error tablet: " << failed_tablet_ids.size() << ", path: " << _path
+                  << ", cost(ms): " << watch.elapsed_time() / 1000000;
     }
+    disks_load_tablets_ms->set_value(watch.elapsed_time() / 1000000);
 
     // traverse rowset
     // 1. add committed rowset to txn map
     // 2. add visible rowset to tablet
     // ignore any errors when load tablet or rowset, because fe will repair them after report
-    for (auto rowset_meta : dir_rowset_metas) {
-        TabletSharedPtr tablet = _tablet_manager->get_tablet(rowset_meta->tablet_id(),
-                                                             rowset_meta->tablet_schema_hash());
-        // tablet maybe dropped, but not drop related rowset meta
-        if (tablet == nullptr) {
-            LOG(WARNING) << "could not find tablet id: " << rowset_meta->tablet_id()
-                         << ", schema hash: " << rowset_meta->tablet_schema_hash()
-                         << ", for rowset: " << rowset_meta->rowset_id() << ", skip this rowset";
-            continue;
-        }
-        RowsetSharedPtr rowset;
-        OLAPStatus create_status = RowsetFactory::create_rowset(
-                &tablet->tablet_schema(), tablet->tablet_path(), rowset_meta, &rowset);
-        if (create_status != OLAP_SUCCESS) {
-            LOG(WARNING) << "could not create rowset from rowsetmeta: "
-                         << " rowset_id: " << rowset_meta->rowset_id()
-                         << " rowset_type: " << rowset_meta->rowset_type()
-                         << " rowset_state: " << rowset_meta->rowset_state();
-            continue;
-        }
-        if (rowset_meta->rowset_state() == RowsetStatePB::COMMITTED &&
-            rowset_meta->tablet_uid() == tablet->tablet_uid()) {
-            OLAPStatus commit_txn_status = _txn_manager->commit_txn(
-                    _meta, rowset_meta->partition_id(), rowset_meta->txn_id(),
-                    rowset_meta->tablet_id(), rowset_meta->tablet_schema_hash(),
-                    rowset_meta->tablet_uid(), rowset_meta->load_id(), rowset, true);
-            if (commit_txn_status != OLAP_SUCCESS &&
-                commit_txn_status != OLAP_ERR_PUSH_TRANSACTION_ALREADY_EXIST) {
-                LOG(WARNING) << "failed to add committed rowset: " << rowset_meta->rowset_id()
-                             << " to tablet: " << rowset_meta->tablet_id()
-                             << " for txn: " << rowset_meta->txn_id();
-            } else {
-                LOG(INFO) << "successfully to add committed rowset: " << rowset_meta->rowset_id()
-                          << " to tablet: " << rowset_meta->tablet_id()
-                          << " schema hash: " << rowset_meta->tablet_schema_hash()
-                          << " for txn: " << rowset_meta->txn_id();
-            }
-        } else if (rowset_meta->rowset_state() == RowsetStatePB::VISIBLE &&
-                   rowset_meta->tablet_uid() == tablet->tablet_uid()) {
-            OLAPStatus publish_status = tablet->add_rowset(rowset, false);
-            if (publish_status != OLAP_SUCCESS &&
-                publish_status != OLAP_ERR_PUSH_VERSION_ALREADY_EXIST) {
-                LOG(WARNING) << "add visible rowset to tablet failed rowset_id:"
-                             << rowset->rowset_id() << " tablet id: " << rowset_meta->tablet_id()
-                             << " txn id:" << rowset_meta->txn_id()
-                             << " start_version: " << rowset_meta->version().first
-                             << " end_version: " << rowset_meta->version().second;
+    watch.reset();
+    watch.start();
+    for (size_t begin = 0; begin < dir_rowset_metas.size(); begin += kLoadMetaBatchSize) {
+        size_t end = std::min(begin + kLoadMetaBatchSize, dir_rowset_metas.size());
+        submit_load_task([this, &dir_rowset_metas, begin, end] {
+            for (size_t i = begin; i < end; ++i) {
+                _load_rowset_from_meta(dir_rowset_metas[i]);
             }
+        });
+    }
+    wait_load_tasks();
+    LOG(INFO) << "load rowsets to tablets finished, rowsets: " << dir_rowset_metas.size()
+              << ", path: " << _path << ", cost(ms): " << watch.elapsed_time() / 1000000;
+    disks_load_rowsets_ms->set_value(watch.elapsed_time() / 1000000);
+    return OLAP_SUCCESS;
+}
+
+void DataDir::_load_rowset_from_meta(const RowsetMetaSharedPtr& rowset_meta) {
+    TabletSharedPtr tablet = _tablet_manager->get_tablet(rowset_meta->tablet_id(),
+                                                         rowset_meta->tablet_schema_hash());
+    // tablet maybe dropped, but not drop related rowset meta
+    if (tablet == nullptr) {
+        LOG(WARNING) << "could not find tablet id: " << rowset_meta->tablet_id()
+                     << ", schema hash: " << rowset_meta->tablet_schema_hash()
+                     << ", for rowset: " << rowset_meta->rowset_id() << ", skip this rowset";
+        return;
+    }
+    RowsetSharedPtr rowset;
+    OLAPStatus create_status = RowsetFactory::create_rowset(
+            &tablet->tablet_schema(), tablet->tablet_path(), rowset_meta, &rowset);
+    if (create_status != OLAP_SUCCESS) {
+        LOG(WARNING) << "could not create rowset from rowsetmeta: "
+                     << " rowset_id: " << rowset_meta->rowset_id()
+                     << " rowset_type: " << rowset_meta->rowset_type()
+                     << " rowset_state: " << rowset_meta->rowset_state();
+        return;
+    }
+    if (rowset_meta->rowset_state() == RowsetStatePB::COMMITTED &&
+        rowset_meta->tablet_uid() == tablet->tablet_uid()) {
+        OLAPStatus commit_txn_status = _txn_manager->commit_txn(
+                _meta, rowset_meta->partition_id(), rowset_meta->txn_id(),
+                rowset_meta->tablet_id(), rowset_meta->tablet_schema_hash(),
+                rowset_meta->tablet_uid(), rowset_meta->load_id(), rowset, true);
+        if (commit_txn_status != OLAP_SUCCESS &&
+            commit_txn_status != OLAP_ERR_PUSH_TRANSACTION_ALREADY_EXIST) {
+            LOG(WARNING) << "failed to add committed rowset: " << rowset_meta->rowset_id()
+                         << " to tablet: " << rowset_meta->tablet_id()
+                         << " for txn: " << rowset_meta->txn_id();
         } else {
-            LOG(WARNING) << "find invalid rowset: " << rowset_meta->rowset_id()
-                         << " with tablet id: " << rowset_meta->tablet_id()
-                         << " tablet uid: " << rowset_meta->tablet_uid()
-                         << " schema hash: " << rowset_meta->tablet_schema_hash()
-                         << " txn: " << rowset_meta->txn_id()
-                         << " current valid tablet uid: " << tablet->tablet_uid();
+            LOG(INFO) << "successfully to add committed rowset: " << rowset_meta->rowset_id()
+                      << " to tablet: " << rowset_meta->tablet_id()
+                      << " schema hash: " << rowset_meta->tablet_schema_hash()
+                      << " for txn: " << rowset_meta->txn_id();
+        }
+    } else if (rowset_meta->rowset_state() == RowsetStatePB::VISIBLE &&
+               rowset_meta->tablet_uid() == tablet->tablet_uid()) {
+        OLAPStatus publish_status = tablet->add_rowset(rowset, false);
+        if (publish_status != OLAP_SUCCESS &&
+            publish_status != OLAP_ERR_PUSH_VERSION_ALREADY_EXIST) {
+            LOG(WARNING) << "add visible rowset to tablet failed rowset_id:"
+                         << rowset->rowset_id() << " tablet id: " << rowset_meta->tablet_id()
+                         << " txn id:" << rowset_meta->txn_id()
+                         << " start_version: " << rowset_meta->version().first
+                         << " end_version: " << rowset_meta->version().second;
         }
+    } else {
+        LOG(WARNING) << "find invalid rowset: " << rowset_meta->rowset_id()
+                     << " with tablet id: " << rowset_meta->tablet_id()
+                     << " tablet uid: " << rowset_meta->tablet_uid()
+                     << " schema hash: " << rowset_meta->tablet_schema_hash()
+                     << " txn: " << rowset_meta->txn_id()
+                     << " current valid tablet uid: " << tablet->tablet_uid();
     }
-    return OLAP_SUCCESS;
 }
 
 void DataDir::add_pending_ids(const std::string& id) {
@@ -33,9 +33,11 @@
 
 namespace doris {
 
+class RowsetMeta;
 class Tablet;
 class TabletManager;
 class TabletMeta;
+class ThreadPool;
 class TxnManager;
 
 // A DataDir used to manage data in same path.
@@ -93,8 +95,10 @@ public:
     static std::string get_root_path_from_schema_hash_path_in_trash(
             const std::string& schema_hash_dir_in_trash);
 
-    // load data from meta and data files
-    OLAPStatus load();
+    // load data from meta and data files.
+    // The metas are parsed and loaded by `load_pool` in batches, or by the calling thread
+    // if it is nullptr.
+    OLAPStatus load(ThreadPool* load_pool = nullptr);
 
     void add_pending_ids(const std::string& id);
 
@@ -147,6 +151,9 @@ private:
     // process will log fatal.
     OLAPStatus _check_incompatible_old_format_tablet();
 
+    // add a committed rowset to txn manager, or a visible rowset to its tablet
+    void _load_rowset_from_meta(const std::shared_ptr<RowsetMeta>& rowset_meta);
+
     void _process_garbage_path(const std::string& path);
 
     void _remove_check_paths(const std::set<std::string>& paths);
@@ -204,6 +211,10 @@ private:
     IntGauge* disks_state;
     IntGauge* disks_compaction_score;
     IntGauge* disks_compaction_num;
+    // time taken by the phases of load()
+    IntGauge* disks_load_rowset_metas_ms;
+    IntGauge* disks_load_tablets_ms;
+    IntGauge* disks_load_rowsets_ms;
 };
 
 } // namespace doris
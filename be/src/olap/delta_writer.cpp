@@ -338,6 +338,19 @@ int64_t DeltaWriter::mem_consumption() const {
     return _mem_tracker->consumption();
 }
 
+int64_t DeltaWriter::memtable_consumption() {
+    // the lock is held while this writer is being closed or waiting for its flushes
+    std::unique_lock<SpinLock> l(_lock, std::try_to_lock);
+    if (!l.owns_lock() || !_is_init || _is_cancelled || _mem_table == nullptr) {
+        return 0;
+    }
+    if (mem_consumption() != _mem_table->memory_usage()) {
+        // there is a memtable in flush queue, flush_memtable_and_wait() will not flush this one
+        return 0;
+    }
+    return _mem_table->memory_usage();
+}
+
 int64_t DeltaWriter::partition_id() const {
     return _req.partition_id;
 }
@@ -82,6 +82,11 @@ public:
 
     int64_t mem_consumption() const;
 
+    // the memory of the memtable being written, which flush_memtable_and_wait() would flush.
+    // return 0 without waiting if this writer is busy, is not initialized, has been closed or
+    // cancelled, or has a memtable in flush queue.
+    int64_t memtable_consumption();
+
     // Wait all memtable in flush queue to be flushed
     OLAPStatus wait_flush();
 
@@ -32,6 +32,8 @@ class RowBlockV2;
 class Schema;
 class Conditions;
 class ColumnPredicate;
+class TopNFilter;
+struct SubstringFilter;
 
 class StorageReadOptions {
 public:
@@ -68,6 +70,14 @@ public:
     // TODO use vector<ColumnPredicate*> instead
     const Conditions* conditions = nullptr;
 
+    // bound of the TopN above the scan, nullptr if not existed.
+    // read when the segment is opened and used by zone map to filter pages
+    const TopNFilter* topn_filter = nullptr;
+
+    // substrings of the values of string columns, nullptr if not existed.
+    // used by ngram bloom filter index to filter pages
+    const std::vector<SubstringFilter>* substring_filters = nullptr;
+
     // delete conditions used by column index to filter pages
     std::vector<const Conditions*> delete_conditions;
 
@@ -262,6 +262,8 @@ struct OlapReaderStatistics {
 
     int64_t rows_key_range_filtered = 0;
     int64_t rows_stats_filtered = 0;
+    int64_t rows_topn_filtered = 0;
+    int64_t rows_ngram_bf_filtered = 0;
     int64_t rows_bf_filtered = 0;
     // Including the number of rows filtered out according to the Delete information in the Tablet,
     // and the number of rows filtered for marked deleted rows under the unique key model.
@@ -47,6 +47,8 @@ class RowCursor;
 class RowBlock;
 class CollectIterator;
 class RuntimeState;
+class TopNFilter;
+struct SubstringFilter;
 
 // Params for Reader,
 // mainly include tablet, data version and fetch range.
@@ -71,6 +73,10 @@ struct ReaderParams {
 
     std::vector<TCondition> conditions;
     std::vector<std::pair<string, std::shared_ptr<IBloomFilterFuncBase>>> bloom_filters;
+    // bound published by the TopN above the scan, nullptr if not existed
+    const TopNFilter* topn_filter = nullptr;
+    // substrings from the LIKE conjuncts of the scan, nullptr if not existed
+    const std::vector<SubstringFilter>* substring_filters = nullptr;
 
     // The ColumnData will be set when using Merger, eg Cumulative, BE.
     std::vector<RowsetReaderSharedPtr> rs_readers;
@@ -25,6 +25,7 @@
 
 #include "gutil/strings/substitute.h"
 #include "olap/rowset/beta_rowset_reader.h"
+#include "olap/segment_loader.h"
 #include "olap/utils.h"
 
 namespace doris {
@@ -38,7 +39,9 @@ BetaRowset::BetaRowset(const TabletSchema* schema, string rowset_path,
                        RowsetMetaSharedPtr rowset_meta)
         : Rowset(schema, std::move(rowset_path), std::move(rowset_meta)) {}
 
-BetaRowset::~BetaRowset() {}
+BetaRowset::~BetaRowset() {
+    _erase_cached_segments();
+}
 
 OLAPStatus BetaRowset::init() {
     return OLAP_SUCCESS; // no op
@@ -46,17 +49,17 @@ OLAPStatus BetaRowset::init() {
 
 // `use_cache` is ignored because beta rowset doesn't support fd cache now
 OLAPStatus BetaRowset::do_load(bool /*use_cache*/, std::shared_ptr<MemTracker> parent) {
-    // Open all segments under the current rowset
-    for (int seg_id = 0; seg_id < num_segments(); ++seg_id) {
-        std::string seg_path = segment_file_path(_rowset_path, rowset_id(), seg_id);
-        std::shared_ptr<segment_v2::Segment> segment;
-        auto s = segment_v2::Segment::open(seg_path, seg_id, _schema, &segment);
-        if (!s.ok()) {
-            LOG(WARNING) << "failed to open segment " << seg_path << " under rowset " << unique_id()
-                         << " : " << s.to_string();
-            return OLAP_ERR_ROWSET_LOAD_FAILED;
-        }
-        _segments.push_back(std::move(segment));
+    // the segments are opened by readers through SegmentLoader
+    return OLAP_SUCCESS;
+}
+
+OLAPStatus BetaRowset::load_segment(int seg_id, segment_v2::SegmentSharedPtr* segment) {
+    std::string seg_path = segment_file_path(_rowset_path, rowset_id(), seg_id);
+    auto s = segment_v2::Segment::open(seg_path, seg_id, _schema, segment);
+    if (!s.ok()) {
+        LOG(WARNING) << "failed to open segment " << seg_path << " under rowset " << unique_id()
+                     << " : " << s.to_string();
+        return OLAP_ERR_ROWSET_LOAD_FAILED;
     }
     return OLAP_SUCCESS;
 }
@@ -108,7 +111,15 @@ OLAPStatus BetaRowset::remove() {
 }
 
 void BetaRowset::do_close() {
-    _segments.clear();
+    _erase_cached_segments();
+}
+
+void BetaRowset::_erase_cached_segments() {
+    // the rowsets loaded with the tablets when the storage engine is opened may be dropped
+    // before the segment loader is created, no segment of them can be in the cache
+    if (SegmentLoader::instance() != nullptr) {
+        SegmentLoader::instance()->erase_segments(rowset_id(), num_segments());
+    }
 }
 
 OLAPStatus BetaRowset::link_files_to(const std::string& dir, RowsetId new_rowset_id) {
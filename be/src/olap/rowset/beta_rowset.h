@@ -64,6 +64,10 @@ public:
 
     bool check_file_exist() override;
 
+    // Open a segment of this rowset. Readers get the segments from SegmentLoader,
+    // which calls it for the segments not in the cache.
+    OLAPStatus load_segment(int seg_id, segment_v2::SegmentSharedPtr* segment);
+
 protected:
     BetaRowset(const TabletSchema* schema, std::string rowset_path,
                RowsetMetaSharedPtr rowset_meta);
@@ -76,9 +80,10 @@ protected:
     void do_close() override;
 
 private:
+    void _erase_cached_segments();
+
     friend class RowsetFactory;
     friend class BetaRowsetReader;
-    std::vector<segment_v2::SegmentSharedPtr> _segments;
 };
 
 } // namespace doris
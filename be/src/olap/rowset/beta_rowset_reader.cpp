@@ -17,20 +17,128 @@
 
 #include "beta_rowset_reader.h"
 
+#include <map>
+#include <unordered_map>
 #include <utility>
 
 #include "olap/delete_handler.h"
 #include "olap/generic_iterators.h"
+#include "olap/olap_cond.h"
 #include "olap/row_block.h"
 #include "olap/row_block2.h"
 #include "olap/row_cursor.h"
 #include "olap/rowset/segment_v2/segment_iterator.h"
 #include "olap/schema.h"
+#include "olap/wrapper_field.h"
 
 #include "vec/core/block.h"
 
 namespace doris {
 
+// The min/max values of the columns of a rowset or a segment in the rowset meta, parsed like the
+// segment-level zone maps, so that the conditions can be evaluated on them.
+class StatisticsZoneMaps {
+public:
+    StatisticsZoneMaps(const TabletSchema& schema,
+                       const google::protobuf::RepeatedPtrField<ColumnStatisticsPB>& statistics)
+            : _schema(schema) {
+        for (auto& column_statistics : statistics) {
+            _statistics[column_statistics.unique_id()] = &column_statistics;
+        }
+    }
+
+    // Return nullptr if the column has no statistics.
+    const std::pair<WrapperField*, WrapperField*>* get(int32_t cid) {
+        auto it = _zone_maps.find(cid);
+        if (it != _zone_maps.end()) {
+            return it->second.first != nullptr ? &it->second : nullptr;
+        }
+        auto& zone_map = _zone_maps[cid];
+        const TabletColumn& column = _schema.column(cid);
+        auto statistics_it = _statistics.find(column.unique_id());
+        if (statistics_it == _statistics.end()) {
+            return nullptr;
+        }
+        const ColumnStatisticsPB& statistics = *statistics_it->second;
+        std::unique_ptr<WrapperField> min_value(
+                WrapperField::create_by_type(column.type(), column.length()));
+        std::unique_ptr<WrapperField> max_value(
+                WrapperField::create_by_type(column.type(), column.length()));
+        if (min_value == nullptr || max_value == nullptr) {
+            return nullptr;
+        }
+        // same as ColumnReader::_parse_zone_map
+        if (statistics.has_not_null()) {
+            if (min_value->from_string(statistics.min()) != OLAP_SUCCESS ||
+                max_value->from_string(statistics.max()) != OLAP_SUCCESS) {
+                return nullptr;
+            }
+        }
+        if (statistics.has_null()) {
+            min_value->set_null();
+            if (!statistics.has_not_null()) {
+                max_value->set_null();
+            }
+        }
+        zone_map.first = min_value.get();
+        zone_map.second = max_value.get();
+        _fields.push_back(std::move(min_value));
+        _fields.push_back(std::move(max_value));
+        return &zone_map;
+    }
+
+private:
+    const TabletSchema& _schema;
+    // unique id -> statistics
+    std::unordered_map<uint32_t, const ColumnStatisticsPB*> _statistics;
+    // column id -> min and max values, both nullptr if the column has no statistics
+    std::map<int32_t, std::pair<WrapperField*, WrapperField*>> _zone_maps;
+    std::vector<std::unique_ptr<WrapperField>> _fields;
+};
+
+// Return false if no row can satisfy the conditions, or all rows are deleted by a delete
+// condition. Like Conditions::rowset_pruning_filter, only the conditions on the key columns, or
+// any column of a duplicate table, are used.
+static bool statistics_may_match(
+        const TabletSchema& schema,
+        const google::protobuf::RepeatedPtrField<ColumnStatisticsPB>& statistics,
+        const StorageReadOptions& read_options) {
+    if (statistics.empty()) {
+        return true;
+    }
+    StatisticsZoneMaps zone_maps(schema, statistics);
+    if (read_options.conditions != nullptr) {
+        for (auto& column_condition : read_options.conditions->columns()) {
+            if (!column_condition.second->is_key() && schema.keys_type() != DUP_KEYS) {
+                continue;
+            }
+            auto zone_map = zone_maps.get(column_condition.first);
+            if (zone_map != nullptr && !column_condition.second->eval(*zone_map)) {
+                return false;
+            }
+        }
+    }
+    for (const Conditions* delete_condition : read_options.delete_conditions) {
+        // the conditions of a delete are in 'AND' relationship
+        bool all_deleted = !delete_condition->columns().empty();
+        for (auto& column_condition : delete_condition->columns()) {
+            if (!column_condition.second->is_key() && schema.keys_type() != DUP_KEYS) {
+                all_deleted = false;
+                break;
+            }
+            auto zone_map = zone_maps.get(column_condition.first);
+            if (zone_map == nullptr || column_condition.second->del_eval(*zone_map) != DEL_SATISFIED) {
+                all_deleted = false;
+                break;
+            }
+        }
+        if (all_deleted) {
+            return false;
+        }
+    }
+    return true;
+}
+
 BetaRowsetReader::BetaRowsetReader(BetaRowsetSharedPtr rowset,
                                    std::shared_ptr<MemTracker> parent_tracker)
         : _context(nullptr),
@@ -61,6 +169,8 @@ OLAPStatus BetaRowsetReader::init(RowsetReaderContext* read_context) {
     StorageReadOptions read_options;
     read_options.stats = _stats;
     read_options.conditions = read_context->conditions;
+    read_options.topn_filter = read_context->topn_filter;
+    read_options.substring_filters = read_context->substring_filters;
     if (read_context->lower_bound_keys != nullptr) {
         for (int i = 0; i < read_context->lower_bound_keys->size(); ++i) {
             read_options.key_ranges.emplace_back(read_context->lower_bound_keys->at(i),
@@ -91,7 +201,11 @@ OLAPStatus BetaRowsetReader::init(RowsetReaderContext* read_context) {
 
     // create iterator for each segment
     std::vector<std::unique_ptr<RowwiseIterator>> seg_iterators;
-    for (auto& seg_ptr : _rowset->_segments) {
+    std::vector<uint32_t> segment_ids;
+    _get_segments_to_read(read_options, &segment_ids);
+    RETURN_NOT_OK(SegmentLoader::instance()->load_segments(_rowset, segment_ids,
+                                                           &_segment_cache_handle));
+    for (auto& seg_ptr : _segment_cache_handle.segments()) {
         std::unique_ptr<RowwiseIterator> iter;
         auto s = seg_ptr->new_iterator(schema, read_options, _parent_tracker, &iter);
         if (!s.ok()) {
@@ -140,6 +254,29 @@ OLAPStatus BetaRowsetReader::init(RowsetReaderContext* read_context) {
     return OLAP_SUCCESS;
 }
 
+void BetaRowsetReader::_get_segments_to_read(const StorageReadOptions& read_options,
+                                             std::vector<uint32_t>* segment_ids) {
+    const RowsetMetaSharedPtr& rowset_meta = _rowset->rowset_meta();
+    const TabletSchema& schema = *_context->tablet_schema;
+    int64_t num_segments = _rowset->num_segments();
+    if (!statistics_may_match(schema, rowset_meta->column_statistics(), read_options)) {
+        _stats->total_segment_number += num_segments;
+        _stats->filtered_segment_number += num_segments;
+        return;
+    }
+    auto& segment_statistics = rowset_meta->segment_statistics();
+    for (uint32_t seg_id = 0; seg_id < num_segments; ++seg_id) {
+        if (segment_statistics.size() == num_segments &&
+            !statistics_may_match(schema, segment_statistics.Get(seg_id).columns(),
+                                  read_options)) {
+            _stats->total_segment_number++;
+            _stats->filtered_segment_number++;
+            continue;
+        }
+        segment_ids->push_back(seg_id);
+    }
+}
+
 OLAPStatus BetaRowsetReader::next_block(RowBlock** block) {
     SCOPED_RAW_TIMER(&_stats->block_fetch_ns);
     // read next input block
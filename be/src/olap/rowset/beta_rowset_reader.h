@@ -24,6 +24,7 @@
 #include "olap/row_cursor.h"
 #include "olap/rowset/beta_rowset.h"
 #include "olap/rowset/rowset_reader.h"
+#include "olap/segment_loader.h"
 
 namespace doris {
 
@@ -55,6 +56,12 @@ public:
     }
 
 private:
+    // Get the ids of the segments to read. A segment is skipped without being opened if its
+    // statistics in the rowset meta show that none of its rows can satisfy the conditions, or
+    // all of them are deleted.
+    void _get_segments_to_read(const StorageReadOptions& read_options,
+                               std::vector<uint32_t>* segment_ids);
+
     RowsetReaderContext* _context;
     BetaRowsetSharedPtr _rowset;
 
@@ -63,6 +70,9 @@ private:
 
     std::shared_ptr<MemTracker> _parent_tracker;
 
+    // holds the segments of _rowset in the segment cache while reading
+    SegmentCacheHandle _segment_cache_handle;
+
     std::unique_ptr<RowwiseIterator> _iterator;
 
     std::unique_ptr<RowBlockV2> _input_block;
@@ -18,6 +18,7 @@
 #include "olap/rowset/beta_rowset_writer.h"
 
 #include <ctime> // time
+#include <unordered_map>
 
 #include "common/config.h"
 #include "common/logging.h"
@@ -32,6 +33,7 @@
 #include "olap/rowset/rowset_factory.h"
 #include "olap/rowset/segment_v2/segment_writer.h"
 #include "olap/storage_engine.h"
+#include "olap/wrapper_field.h"
 #include "runtime/exec_env.h"
 
 namespace doris {
@@ -40,6 +42,44 @@ namespace doris {
 const uint32_t MAX_SEGMENT_SIZE = static_cast<uint32_t>(OLAP_MAX_COLUMN_SEGMENT_FILE_SIZE *
                                                         OLAP_COLUMN_FILE_SEGMENT_SIZE_SCALE);
 
+// Merge the statistics of a column in a segment into the ones of the rowset.
+// Return false if the values can not be compared.
+static bool merge_column_statistics(const TabletColumn& column, const ColumnStatisticsPB& src,
+                                    ColumnStatisticsPB* dst) {
+    dst->set_has_null(dst->has_null() || src.has_null());
+    if (!src.has_not_null()) {
+        return true;
+    }
+    if (!dst->has_not_null()) {
+        dst->set_min(src.min());
+        dst->set_max(src.max());
+        dst->set_has_not_null(true);
+        return true;
+    }
+    std::unique_ptr<WrapperField> src_value(
+            WrapperField::create_by_type(column.type(), column.length()));
+    std::unique_ptr<WrapperField> dst_value(
+            WrapperField::create_by_type(column.type(), column.length()));
+    if (src_value == nullptr || dst_value == nullptr) {
+        return false;
+    }
+    if (src_value->from_string(src.min()) != OLAP_SUCCESS ||
+        dst_value->from_string(dst->min()) != OLAP_SUCCESS) {
+        return false;
+    }
+    if (src_value->cmp(dst_value.get()) < 0) {
+        dst->set_min(src.min());
+    }
+    if (src_value->from_string(src.max()) != OLAP_SUCCESS ||
+        dst_value->from_string(dst->max()) != OLAP_SUCCESS) {
+        return false;
+    }
+    if (src_value->cmp(dst_value.get()) > 0) {
+        dst->set_max(src.max());
+    }
+    return true;
+}
+
 BetaRowsetWriter::BetaRowsetWriter()
         : _rowset_meta(nullptr),
           _num_segment(0),
@@ -116,8 +156,15 @@ OLAPStatus BetaRowsetWriter::add_rowset(RowsetSharedPtr rowset) {
     _num_rows_written += rowset->num_rows();
     _total_data_size += rowset->rowset_meta()->data_disk_size();
     _total_index_size += rowset->rowset_meta()->index_disk_size();
+    int32_t first_segment_id = _num_segment;
     _num_segment += rowset->num_segments();
-    // TODO update zonemap
+    auto& segment_statistics = rowset->rowset_meta()->segment_statistics();
+    if (segment_statistics.size() == rowset->num_segments()) {
+        std::lock_guard<SpinLock> l(_lock);
+        for (int i = 0; i < segment_statistics.size(); ++i) {
+            _segment_statistics[first_segment_id + i] = segment_statistics.Get(i);
+        }
+    }
     if (rowset->rowset_meta()->has_delete_predicate()) {
         _rowset_meta->set_delete_predicate(rowset->rowset_meta()->delete_predicate());
     }
@@ -126,7 +173,7 @@ OLAPStatus BetaRowsetWriter::add_rowset(RowsetSharedPtr rowset) {
 
 OLAPStatus BetaRowsetWriter::add_rowset_for_linked_schema_change(
         RowsetSharedPtr rowset, const SchemaMapping& schema_mapping) {
-    // TODO use schema_mapping to transfer zonemap
+    // the statistics are kept, they are keyed by the unique ids of the columns
     return add_rowset(rowset);
 }
 
@@ -182,7 +229,7 @@ RowsetSharedPtr BetaRowsetWriter::build() {
     _rowset_meta->set_total_disk_size(_total_data_size);
     _rowset_meta->set_data_disk_size(_total_data_size);
     _rowset_meta->set_index_disk_size(_total_index_size);
-    // TODO write zonemap to meta
+    _build_statistics();
     _rowset_meta->set_empty(_num_rows_written == 0);
     _rowset_meta->set_creation_time(time(nullptr));
     _rowset_meta->set_num_segments(_num_segment);
@@ -207,8 +254,9 @@ RowsetSharedPtr BetaRowsetWriter::build() {
 }
 
 OLAPStatus BetaRowsetWriter::_create_segment_writer(std::unique_ptr<segment_v2::SegmentWriter>* writer) {
+    int32_t segment_id = _num_segment++;
     auto path = BetaRowset::segment_file_path(_context.rowset_path_prefix, _context.rowset_id,
-                                              _num_segment++);
+                                              segment_id);
     // TODO(lingbin): should use a more general way to get BlockManager object
     // and tablets with the same type should share one BlockManager object;
     fs::BlockManager* block_mgr = fs::fs_util::block_manager();
@@ -223,7 +271,7 @@ OLAPStatus BetaRowsetWriter::_create_segment_writer(std::unique_ptr<segment_v2::
 
     DCHECK(wblock != nullptr);
     segment_v2::SegmentWriterOptions writer_options;
-    writer->reset(new segment_v2::SegmentWriter(wblock.get(), _num_segment,
+    writer->reset(new segment_v2::SegmentWriter(wblock.get(), segment_id,
                                                 _context.tablet_schema, writer_options, _context.parent_mem_tracker));
     {
         std::lock_guard<SpinLock> l(_lock);
@@ -249,8 +297,55 @@ OLAPStatus BetaRowsetWriter::_flush_segment_writer(std::unique_ptr<segment_v2::S
     }
     _total_data_size += segment_size;
     _total_index_size += index_size;
+    SegmentStatisticsPB statistics;
+    (*writer)->get_statistics(&statistics);
+    {
+        std::lock_guard<SpinLock> l(_lock);
+        _segment_statistics[(*writer)->segment_id()] = std::move(statistics);
+    }
     writer->reset();
     return OLAP_SUCCESS;
 }
 
+void BetaRowsetWriter::_build_statistics() {
+    std::lock_guard<SpinLock> l(_lock);
+    if (_segment_statistics.empty()) {
+        return;
+    }
+    std::unordered_map<uint32_t, const TabletColumn*> columns;
+    for (auto& column : _context.tablet_schema->columns()) {
+        columns[column.unique_id()] = &column;
+    }
+    // unique id -> statistics of the column merged from the segments, a column is only in the
+    // statistics of the rowset if it is in the ones of all segments
+    std::map<uint32_t, ColumnStatisticsPB> merged_statistics;
+    std::map<uint32_t, int32_t> num_merged_segments;
+    for (int32_t seg_id = 0; seg_id < _num_segment; ++seg_id) {
+        SegmentStatisticsPB* segment_statistics = _rowset_meta->mutable_segment_statistics()->Add();
+        auto it = _segment_statistics.find(seg_id);
+        if (it == _segment_statistics.end()) {
+            // unknown, e.g. the segment is linked from a rowset written by an old version
+            continue;
+        }
+        *segment_statistics = it->second;
+        for (auto& column_statistics : segment_statistics->columns()) {
+            uint32_t unique_id = column_statistics.unique_id();
+            auto column_it = columns.find(unique_id);
+            if (column_it == columns.end()) {
+                continue;
+            }
+            auto res = merged_statistics.emplace(unique_id, column_statistics);
+            if (res.second || merge_column_statistics(*column_it->second, column_statistics,
+                                                      &res.first->second)) {
+                ++num_merged_segments[unique_id];
+            }
+        }
+    }
+    for (auto& it : merged_statistics) {
+        if (num_merged_segments[it.first] == _num_segment) {
+            *_rowset_meta->mutable_column_statistics()->Add() = it.second;
+        }
+    }
+}
+
 } // namespace doris
@@ -18,6 +18,9 @@
 #ifndef DORIS_BE_SRC_OLAP_ROWSET_BETA_ROWSET_WRITER_H
 #define DORIS_BE_SRC_OLAP_ROWSET_BETA_ROWSET_WRITER_H
 
+#include <map>
+
+#include "gen_cpp/olap_file.pb.h"
 #include "olap/rowset/rowset_writer.h"
 #include "vector"
 
@@ -70,6 +73,9 @@ private:
 
     OLAPStatus _flush_segment_writer(std::unique_ptr<segment_v2::SegmentWriter>* writer);
 
+    // Write the statistics of the segments and the rowset to the rowset meta.
+    void _build_statistics();
+
 private:
     RowsetWriterContext _context;
     std::shared_ptr<RowsetMeta> _rowset_meta;
@@ -79,7 +85,7 @@ private:
     /// Because we want to flush memtables in parallel.
     /// In other processes, such as merger or schema change, we will use this unified writer for data writing.
     std::unique_ptr<segment_v2::SegmentWriter> _segment_writer;
-    mutable SpinLock _lock; // lock to protect _wblocks.
+    mutable SpinLock _lock; // lock to protect _wblocks and _segment_statistics.
     // TODO(lingbin): it is better to wrapper in a Batch?
     std::vector<std::unique_ptr<fs::WritableBlock>> _wblocks;
 
@@ -87,7 +93,8 @@ private:
     AtomicInt<int64_t> _num_rows_written;
     AtomicInt<int64_t> _total_data_size;
     AtomicInt<int64_t> _total_index_size;
-    // TODO rowset Zonemap
+    // segment id -> segment-level zone maps of the segment
+    std::map<int32_t, SegmentStatisticsPB> _segment_statistics;
 
     bool _is_pending = false;
     bool _already_built = false;
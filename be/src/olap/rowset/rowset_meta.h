@@ -179,6 +179,23 @@ public:
         *new_zone_map = zone_map;
     }
 
+    const google::protobuf::RepeatedPtrField<ColumnStatisticsPB>& column_statistics() const {
+        return _rowset_meta_pb.column_statistics();
+    }
+
+    google::protobuf::RepeatedPtrField<ColumnStatisticsPB>* mutable_column_statistics() {
+        return _rowset_meta_pb.mutable_column_statistics();
+    }
+
+    // empty if the statistics of the segments are unknown, e.g. written by an old version
+    const google::protobuf::RepeatedPtrField<SegmentStatisticsPB>& segment_statistics() const {
+        return _rowset_meta_pb.segment_statistics();
+    }
+
+    google::protobuf::RepeatedPtrField<SegmentStatisticsPB>* mutable_segment_statistics() {
+        return _rowset_meta_pb.mutable_segment_statistics();
+    }
+
     bool has_delete_predicate() const { return _rowset_meta_pb.has_delete_predicate(); }
 
     const DeletePredicatePB& delete_predicate() const { return _rowset_meta_pb.delete_predicate(); }
@@ -28,6 +28,8 @@ class RowCursor;
 class Conditions;
 class DeleteHandler;
 class TabletSchema;
+class TopNFilter;
+struct SubstringFilter;
 
 struct RowsetReaderContext {
     ReaderType reader_type = READER_QUERY;
@@ -44,6 +46,10 @@ struct RowsetReaderContext {
     const std::set<uint32_t>* load_bf_columns = nullptr;
     // column filter conditions by delete sql
     const Conditions* conditions = nullptr;
+    // bound of the TopN above the scan, used by zone map to filter pages
+    const TopNFilter* topn_filter = nullptr;
+    // substrings of the values of string columns, used by ngram bloom filter index
+    const std::vector<SubstringFilter>* substring_filters = nullptr;
     // column name -> column predicate
     // adding column_name for predicate to make use of column selectivity
     const std::vector<ColumnPredicate*>* predicates = nullptr;
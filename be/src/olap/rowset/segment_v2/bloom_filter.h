@@ -34,6 +34,8 @@ struct BloomFilterOptions {
     // false positive probability
     double fpp = 0.05;
     HashStrategyPB strategy = HASH_MURMUR3_X64_64;
+    // only for n-gram bloom filter index, the length in bytes of the n-grams
+    uint32_t gram_size = 3;
 };
 
 // Base class for bloom filter
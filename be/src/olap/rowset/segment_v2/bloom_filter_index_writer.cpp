@@ -19,6 +19,7 @@
 
 #include <map>
 #include <roaring/roaring.hh>
+#include <unordered_set>
 
 #include "env/env.h"
 #include "olap/fs/block_manager.h"
@@ -30,6 +31,7 @@
 #include "runtime/mem_pool.h"
 #include "runtime/mem_tracker.h"
 #include "util/faststring.h"
+#include "util/murmur_hash3.h"
 #include "util/slice.h"
 
 namespace doris {
@@ -47,6 +49,24 @@ struct BloomFilterTraits<Slice> {
     using ValueDict = std::set<Slice, Slice::Comparator>;
 };
 
+// Write the bloom filters of all pages as an IndexedColumn with ordinal index.
+Status write_bloom_filters(fs::WritableBlock* wblock,
+                           const std::vector<std::unique_ptr<BloomFilter>>& bfs,
+                           BloomFilterIndexPB* meta) {
+    const TypeInfo* bf_typeinfo = get_scalar_type_info(OLAP_FIELD_TYPE_VARCHAR);
+    IndexedColumnWriterOptions options;
+    options.write_ordinal_index = true;
+    options.write_value_index = false;
+    options.encoding = PLAIN_ENCODING;
+    IndexedColumnWriter bf_writer(options, bf_typeinfo, wblock);
+    RETURN_IF_ERROR(bf_writer.init());
+    for (auto& bf : bfs) {
+        Slice data(bf->data(), bf->size());
+        bf_writer.add(&data);
+    }
+    return bf_writer.finish(meta->mutable_bloom_filter());
+}
+
 struct Int128Comparator {
     bool operator()(const int128_t& a, const int128_t& b) const { return a < b; }
 };
@@ -129,21 +149,7 @@ public:
         BloomFilterIndexPB* meta = index_meta->mutable_bloom_filter_index();
         meta->set_hash_strategy(_bf_options.strategy);
         meta->set_algorithm(BLOCK_BLOOM_FILTER);
-
-        // write bloom filters
-        const TypeInfo* bf_typeinfo = get_scalar_type_info(OLAP_FIELD_TYPE_VARCHAR);
-        IndexedColumnWriterOptions options;
-        options.write_ordinal_index = true;
-        options.write_value_index = false;
-        options.encoding = PLAIN_ENCODING;
-        IndexedColumnWriter bf_writer(options, bf_typeinfo, wblock);
-        RETURN_IF_ERROR(bf_writer.init());
-        for (auto& bf : _bfs) {
-            Slice data(bf->data(), bf->size());
-            bf_writer.add(&data);
-        }
-        RETURN_IF_ERROR(bf_writer.finish(meta->mutable_bloom_filter()));
-        return Status::OK();
+        return write_bloom_filters(wblock, _bfs, meta);
     }
 
     uint64_t size() override {
@@ -172,6 +178,71 @@ private:
     std::vector<std::unique_ptr<BloomFilter>> _bfs;
 };
 
+// Builder for n-gram bloom filter index of a string column. For every data page, all the
+// n-grams of the values in the page are added to a bloom filter, so that a reader searching
+// the values containing a substring can skip the pages missing any n-gram of the substring.
+class NGramBloomFilterIndexWriterImpl : public BloomFilterIndexWriter {
+public:
+    explicit NGramBloomFilterIndexWriterImpl(const BloomFilterOptions& bf_options)
+            : _bf_options(bf_options), _has_null(false), _bf_buffer_size(0) {}
+
+    ~NGramBloomFilterIndexWriterImpl() = default;
+
+    void add_values(const void* values, size_t count) override {
+        const Slice* v = (const Slice*)values;
+        for (int i = 0; i < count; ++i) {
+            // the n-grams are hashed as BloomFilter::add_bytes() does, only the distinct
+            // hashes of a page are kept before the bloom filter is sized
+            for (size_t pos = 0; pos + _bf_options.gram_size <= v->size; ++pos) {
+                uint64_t hash_code;
+                murmur_hash3_x64_64(v->data + pos, _bf_options.gram_size,
+                                    BloomFilter::DEFAULT_SEED, &hash_code);
+                _hashes.insert(hash_code);
+            }
+            ++v;
+        }
+    }
+
+    void add_nulls(uint32_t count) override { _has_null = true; }
+
+    Status flush() override {
+        std::unique_ptr<BloomFilter> bf;
+        RETURN_IF_ERROR(BloomFilter::create(BLOCK_BLOOM_FILTER, &bf));
+        RETURN_IF_ERROR(bf->init(_hashes.size(), _bf_options.fpp, _bf_options.strategy));
+        bf->set_has_null(_has_null);
+        for (uint64_t hash_code : _hashes) {
+            bf->add_hash(hash_code);
+        }
+        _bf_buffer_size += bf->size();
+        _bfs.push_back(std::move(bf));
+        _hashes.clear();
+        _has_null = false;
+        return Status::OK();
+    }
+
+    Status finish(fs::WritableBlock* wblock, ColumnIndexMetaPB* index_meta) override {
+        if (_hashes.size() > 0) {
+            RETURN_IF_ERROR(flush());
+        }
+        index_meta->set_type(NGRAM_BLOOM_FILTER_INDEX);
+        BloomFilterIndexPB* meta = index_meta->mutable_ngram_bloom_filter_index();
+        meta->set_hash_strategy(_bf_options.strategy);
+        meta->set_algorithm(BLOCK_BLOOM_FILTER);
+        meta->set_gram_size(_bf_options.gram_size);
+        return write_bloom_filters(wblock, _bfs, meta);
+    }
+
+    uint64_t size() override { return _bf_buffer_size + _hashes.size() * sizeof(uint64_t); }
+
+private:
+    BloomFilterOptions _bf_options;
+    bool _has_null;
+    uint64_t _bf_buffer_size;
+    // distinct hashes of the n-grams in current page
+    std::unordered_set<uint64_t> _hashes;
+    std::vector<std::unique_ptr<BloomFilter>> _bfs;
+};
+
 } // namespace
 
 // TODO currently we don't support bloom filter index for tinyint/hll/float/double
@@ -217,5 +288,21 @@ Status BloomFilterIndexWriter::create(const BloomFilterOptions& bf_options,
     return Status::OK();
 }
 
+Status BloomFilterIndexWriter::create_ngram(const BloomFilterOptions& bf_options,
+                                            const TypeInfo* typeinfo,
+                                            std::unique_ptr<BloomFilterIndexWriter>* res) {
+    FieldType type = typeinfo->type();
+    if (type != OLAP_FIELD_TYPE_CHAR && type != OLAP_FIELD_TYPE_VARCHAR) {
+        return Status::NotSupported("unsupported type for ngram bloom filter index: " +
+                                    std::to_string(type));
+    }
+    if (bf_options.strategy != HASH_MURMUR3_X64_64) {
+        return Status::NotSupported("unsupported hash strategy for ngram bloom filter index: " +
+                                    std::to_string(bf_options.strategy));
+    }
+    res->reset(new NGramBloomFilterIndexWriterImpl(bf_options));
+    return Status::OK();
+}
+
 } // namespace segment_v2
 } // namespace doris
@@ -41,6 +41,10 @@ public:
     static Status create(const BloomFilterOptions& bf_options, const TypeInfo* typeinfo,
                          std::unique_ptr<BloomFilterIndexWriter>* res);
 
+    // Create a writer of n-gram bloom filter index for a string column.
+    static Status create_ngram(const BloomFilterOptions& bf_options, const TypeInfo* typeinfo,
+                               std::unique_ptr<BloomFilterIndexWriter>* res);
+
     BloomFilterIndexWriter() = default;
     virtual ~BloomFilterIndexWriter() = default;
 
@@ -120,6 +120,9 @@ Status ColumnReader::init() {
         case BLOOM_FILTER_INDEX:
             _bf_index_meta = &index_meta.bloom_filter_index();
             break;
+        case NGRAM_BLOOM_FILTER_INDEX:
+            _ngram_bf_index_meta = &index_meta.ngram_bloom_filter_index();
+            break;
         default:
             return Status::Corruption(strings::Substitute(
                     "Bad file $0: invalid column index type $1", _file_name, index_meta.type()));
@@ -265,24 +268,46 @@ Status ColumnReader::get_row_ranges_by_bloom_filter(CondColumn* cond_column,
     RowRanges bf_row_ranges;
     std::unique_ptr<BloomFilterIndexIterator> bf_iter;
     RETURN_IF_ERROR(_bloom_filter_index->new_iterator(&bf_iter));
-    size_t range_size = row_ranges->range_size();
-    // get covered page ids
     std::set<uint32_t> page_ids;
-    for (int i = 0; i < range_size; ++i) {
-        int64_t from = row_ranges->get_range_from(i);
-        int64_t idx = from;
-        int64_t to = row_ranges->get_range_to(i);
-        auto iter = _ordinal_index->seek_at_or_before(from);
-        while (idx < to && iter.valid()) {
-            page_ids.insert(iter.page_index());
-            idx = iter.last_ordinal() + 1;
-            iter.next();
+    _get_page_ids(row_ranges, &page_ids);
+    for (auto& pid : page_ids) {
+        std::unique_ptr<BloomFilter> bf;
+        RETURN_IF_ERROR(bf_iter->read_bloom_filter(pid, &bf));
+        if (cond_column->eval(bf.get())) {
+            bf_row_ranges.add(RowRange(_ordinal_index->get_first_ordinal(pid),
+                                       _ordinal_index->get_last_ordinal(pid) + 1));
         }
     }
+    RowRanges::ranges_intersection(*row_ranges, bf_row_ranges, row_ranges);
+    return Status::OK();
+}
+
+Status ColumnReader::get_row_ranges_by_ngram_bloom_filter(
+        const std::vector<std::string>& substrings, RowRanges* row_ranges) {
+    RETURN_IF_ERROR(_ensure_index_loaded());
+    size_t gram_size = _ngram_bf_index_meta->gram_size();
+    if (gram_size == 0) {
+        return Status::OK();
+    }
+    RowRanges bf_row_ranges;
+    std::unique_ptr<BloomFilterIndexIterator> bf_iter;
+    RETURN_IF_ERROR(_ngram_bloom_filter_index->new_iterator(&bf_iter));
+    std::set<uint32_t> page_ids;
+    _get_page_ids(row_ranges, &page_ids);
     for (auto& pid : page_ids) {
         std::unique_ptr<BloomFilter> bf;
         RETURN_IF_ERROR(bf_iter->read_bloom_filter(pid, &bf));
-        if (cond_column->eval(bf.get())) {
+        bool may_match = true;
+        // substrings shorter than gram_size have no n-gram to test
+        for (auto it = substrings.begin(); may_match && it != substrings.end(); ++it) {
+            for (size_t pos = 0; pos + gram_size <= it->size(); ++pos) {
+                if (!bf->test_hash(bf->hash(it->data() + pos, gram_size))) {
+                    may_match = false;
+                    break;
+                }
+            }
+        }
+        if (may_match) {
             bf_row_ranges.add(RowRange(_ordinal_index->get_first_ordinal(pid),
                                        _ordinal_index->get_last_ordinal(pid) + 1));
         }
@@ -291,6 +316,21 @@ Status ColumnReader::get_row_ranges_by_bloom_filter(CondColumn* cond_column,
     return Status::OK();
 }
 
+void ColumnReader::_get_page_ids(RowRanges* row_ranges, std::set<uint32_t>* page_ids) {
+    size_t range_size = row_ranges->range_size();
+    for (int i = 0; i < range_size; ++i) {
+        int64_t from = row_ranges->get_range_from(i);
+        int64_t idx = from;
+        int64_t to = row_ranges->get_range_to(i);
+        auto iter = _ordinal_index->seek_at_or_before(from);
+        while (idx < to && iter.valid()) {
+            page_ids->insert(iter.page_index());
+            idx = iter.last_ordinal() + 1;
+            iter.next();
+        }
+    }
+}
+
 Status ColumnReader::_load_ordinal_index(bool use_page_cache, bool kept_in_memory) {
     DCHECK(_ordinal_index_meta != nullptr);
     _ordinal_index.reset(new OrdinalIndexReader(_file_name, _ordinal_index_meta, _num_rows));
@@ -321,6 +361,15 @@ Status ColumnReader::_load_bloom_filter_index(bool use_page_cache, bool kept_in_
     return Status::OK();
 }
 
+Status ColumnReader::_load_ngram_bloom_filter_index(bool use_page_cache, bool kept_in_memory) {
+    if (_ngram_bf_index_meta != nullptr) {
+        _ngram_bloom_filter_index.reset(
+                new BloomFilterIndexReader(_file_name, _ngram_bf_index_meta));
+        return _ngram_bloom_filter_index->load(use_page_cache, kept_in_memory);
+    }
+    return Status::OK();
+}
+
 Status ColumnReader::seek_to_first(OrdinalPageIndexIterator* iter) {
     RETURN_IF_ERROR(_ensure_index_loaded());
     *iter = _ordinal_index->begin();
@@ -704,6 +753,14 @@ Status FileColumnIterator::get_row_ranges_by_bloom_filter(CondColumn* cond_colum
     return Status::OK();
 }
 
+Status FileColumnIterator::get_row_ranges_by_ngram_bloom_filter(
+        const std::vector<std::string>& substrings, RowRanges* row_ranges) {
+    if (_reader->has_ngram_bloom_filter_index()) {
+        RETURN_IF_ERROR(_reader->get_row_ranges_by_ngram_bloom_filter(substrings, row_ranges));
+    }
+    return Status::OK();
+}
+
 Status DefaultValueColumnIterator::init(const ColumnIteratorOptions& opts) {
     _opts = opts;
     // be consistent with segment v1
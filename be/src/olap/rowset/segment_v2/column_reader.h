@@ -20,6 +20,9 @@
 #include <cstddef> // for size_t
 #include <cstdint> // for uint32_t
 #include <memory>  // for unique_ptr
+#include <set>
+#include <string>
+#include <vector>
 
 #include "common/logging.h"
 #include "common/status.h"                              // for Status
@@ -114,6 +117,7 @@ public:
     bool has_zone_map() const { return _zone_map_index_meta != nullptr; }
     bool has_bitmap_index() const { return _bitmap_index_meta != nullptr; }
     bool has_bloom_filter_index() const { return _bf_index_meta != nullptr; }
+    bool has_ngram_bloom_filter_index() const { return _ngram_bf_index_meta != nullptr; }
 
     // Check if this column could match `cond' using segment zone map.
     // Since segment zone map is stored in metadata, this function is fast without I/O.
@@ -130,6 +134,11 @@ public:
     // get row ranges with bloom filter index
     Status get_row_ranges_by_bloom_filter(CondColumn* cond_column, RowRanges* row_ranges);
 
+    // get row ranges with ngram bloom filter index, keep the pages which may have values
+    // containing all of `substrings'
+    Status get_row_ranges_by_ngram_bloom_filter(const std::vector<std::string>& substrings,
+                                                RowRanges* row_ranges);
+
     PagePointer get_dict_page_pointer() const { return _meta.dict_page(); }
 
 private:
@@ -146,6 +155,8 @@ private:
             RETURN_IF_ERROR(_load_ordinal_index(use_page_cache, _opts.kept_in_memory));
             RETURN_IF_ERROR(_load_bitmap_index(use_page_cache, _opts.kept_in_memory));
             RETURN_IF_ERROR(_load_bloom_filter_index(use_page_cache, _opts.kept_in_memory));
+            RETURN_IF_ERROR(
+                    _load_ngram_bloom_filter_index(use_page_cache, _opts.kept_in_memory));
             return Status::OK();
         });
     }
@@ -154,6 +165,7 @@ private:
     Status _load_ordinal_index(bool use_page_cache, bool kept_in_memory);
     Status _load_bitmap_index(bool use_page_cache, bool kept_in_memory);
     Status _load_bloom_filter_index(bool use_page_cache, bool kept_in_memory);
+    Status _load_ngram_bloom_filter_index(bool use_page_cache, bool kept_in_memory);
 
     bool _zone_map_match_condition(const ZoneMapPB& zone_map, WrapperField* min_value_container,
                                    WrapperField* max_value_container, CondColumn* cond) const;
@@ -165,6 +177,9 @@ private:
                                std::unordered_set<uint32_t>* delete_partial_filtered_pages,
                                std::vector<uint32_t>* page_indexes);
 
+    // get the ids of the pages covered by `row_ranges'
+    void _get_page_ids(RowRanges* row_ranges, std::set<uint32_t>* page_ids);
+
     Status _calculate_row_ranges(const std::vector<uint32_t>& page_indexes, RowRanges* row_ranges);
 
 private:
@@ -183,12 +198,14 @@ private:
     const OrdinalIndexPB* _ordinal_index_meta = nullptr;
     const BitmapIndexPB* _bitmap_index_meta = nullptr;
     const BloomFilterIndexPB* _bf_index_meta = nullptr;
+    const BloomFilterIndexPB* _ngram_bf_index_meta = nullptr;
 
     DorisCallOnce<Status> _load_index_once;
     std::unique_ptr<ZoneMapIndexReader> _zone_map_index;
     std::unique_ptr<OrdinalIndexReader> _ordinal_index;
     std::unique_ptr<BitmapIndexReader> _bitmap_index;
     std::unique_ptr<BloomFilterIndexReader> _bloom_filter_index;
+    std::unique_ptr<BloomFilterIndexReader> _ngram_bloom_filter_index;
 
     std::vector<std::unique_ptr<ColumnReader>> _sub_readers;
 };
@@ -244,6 +261,11 @@ public:
         return Status::OK();
     }
 
+    virtual Status get_row_ranges_by_ngram_bloom_filter(
+            const std::vector<std::string>& substrings, RowRanges* row_ranges) {
+        return Status::OK();
+    }
+
 #if 0
     // Call this function every time before next_batch.
     // This function will preload pages from disk into memory if necessary.
@@ -293,6 +315,9 @@ public:
 
     Status get_row_ranges_by_bloom_filter(CondColumn* cond_column, RowRanges* row_ranges) override;
 
+    Status get_row_ranges_by_ngram_bloom_filter(const std::vector<std::string>& substrings,
+                                                RowRanges* row_ranges) override;
+
     ParsedPage* get_current_page() { return _page.get(); }
 
     bool is_nullable() { return _reader->is_nullable(); }
@@ -258,6 +258,11 @@ Status ScalarColumnWriter::init() {
         RETURN_IF_ERROR(BloomFilterIndexWriter::create(
                 BloomFilterOptions(), get_field()->type_info(), &_bloom_filter_index_builder));
     }
+    if (_opts.need_ngram_bloom_filter) {
+        RETURN_IF_ERROR(BloomFilterIndexWriter::create_ngram(BloomFilterOptions(),
+                                                             get_field()->type_info(),
+                                                             &_ngram_bloom_filter_index_builder));
+    }
     return Status::OK();
 }
 
@@ -273,6 +278,9 @@ Status ScalarColumnWriter::append_nulls(size_t num_rows) {
     if (_opts.need_bloom_filter) {
         _bloom_filter_index_builder->add_nulls(num_rows);
     }
+    if (_opts.need_ngram_bloom_filter) {
+        _ngram_bloom_filter_index_builder->add_nulls(num_rows);
+    }
     return Status::OK();
 }
 
@@ -306,6 +314,9 @@ Status ScalarColumnWriter::append_data_in_current_page(const uint8_t** ptr, size
     if (_opts.need_bloom_filter) {
         _bloom_filter_index_builder->add_values(*ptr, *num_written);
     }
+    if (_opts.need_ngram_bloom_filter) {
+        _ngram_bloom_filter_index_builder->add_values(*ptr, *num_written);
+    }
 
     _next_rowid += *num_written;
     *ptr += get_field()->size() * (*num_written);
@@ -328,6 +339,9 @@ Status ScalarColumnWriter::append_data_in_current_page(const uint8_t* ptr, size_
     if (_opts.need_bloom_filter) {
         _bloom_filter_index_builder->add_values(ptr, *num_written);
     }
+    if (_opts.need_ngram_bloom_filter) {
+        _ngram_bloom_filter_index_builder->add_values(ptr, *num_written);
+    }
 
     _next_rowid += *num_written;
     if (is_nullable()) {
@@ -352,6 +366,9 @@ uint64_t ScalarColumnWriter::estimate_buffer_size() {
     if (_opts.need_bloom_filter) {
         size += _bloom_filter_index_builder->size();
     }
+    if (_opts.need_ngram_bloom_filter) {
+        size += _ngram_bloom_filter_index_builder->size();
+    }
     return size;
 }
 
@@ -406,7 +423,12 @@ Status ScalarColumnWriter::write_bitmap_index() {
 
 Status ScalarColumnWriter::write_bloom_filter_index() {
     if (_opts.need_bloom_filter) {
-        return _bloom_filter_index_builder->finish(_wblock, _opts.meta->add_indexes());
+        RETURN_IF_ERROR(
+                _bloom_filter_index_builder->finish(_wblock, _opts.meta->add_indexes()));
+    }
+    if (_opts.need_ngram_bloom_filter) {
+        RETURN_IF_ERROR(
+                _ngram_bloom_filter_index_builder->finish(_wblock, _opts.meta->add_indexes()));
     }
     return Status::OK();
 }
@@ -437,6 +459,9 @@ Status ScalarColumnWriter::finish_current_page() {
     if (_opts.need_bloom_filter) {
         RETURN_IF_ERROR(_bloom_filter_index_builder->flush());
     }
+    if (_opts.need_ngram_bloom_filter) {
+        RETURN_IF_ERROR(_ngram_bloom_filter_index_builder->flush());
+    }
 
     // build data page body : encoded values + [nullmap]
     std::vector<Slice> body;
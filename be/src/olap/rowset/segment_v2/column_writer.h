@@ -50,13 +50,15 @@ struct ColumnWriterOptions {
     bool need_zone_map = false;
     bool need_bitmap_index = false;
     bool need_bloom_filter = false;
+    bool need_ngram_bloom_filter = false;
     std::string to_string() {
         std::stringstream ss;
         ss << std::boolalpha << "meta=" << meta->DebugString()
            << ", data_page_size=" << data_page_size
            << ", compression_min_space_saving = " << compression_min_space_saving
            << ", need_zone_map=" << need_zone_map << ", need_bitmap_index=" << need_bitmap_index
-           << ", need_bloom_filter" << need_bloom_filter;
+           << ", need_bloom_filter" << need_bloom_filter
+           << ", need_ngram_bloom_filter=" << need_ngram_bloom_filter;
         return ss.str();
     }
     std::shared_ptr<MemTracker> parent = nullptr;
@@ -250,6 +252,7 @@ private:
     std::unique_ptr<ZoneMapIndexWriter> _zone_map_index_builder;
     std::unique_ptr<BitmapIndexWriter> _bitmap_index_builder;
     std::unique_ptr<BloomFilterIndexWriter> _bloom_filter_index_builder;
+    std::unique_ptr<BloomFilterIndexWriter> _ngram_bloom_filter_index_builder;
 
     // call before flush data page.
     FlushPageCallback* _new_page_callback = nullptr;
@@ -300,6 +303,9 @@ public:
         if (_opts.need_bloom_filter) {
             return Status::NotSupported("array not support bloom filter index");
         }
+        if (_opts.need_ngram_bloom_filter) {
+            return Status::NotSupported("array not support ngram bloom filter index");
+        }
         return Status::OK();
     }
     ordinal_t get_next_rowid() const override { return _length_writer->get_next_rowid(); }
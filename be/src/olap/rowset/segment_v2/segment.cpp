@@ -93,6 +93,11 @@ Status Segment::new_iterator(const Schema& schema, const StorageReadOptions& rea
     return Status::OK();
 }
 
+size_t Segment::meta_mem_usage() const {
+    return _mem_tracker->consumption() + sizeof(Segment) +
+           _column_readers.size() * sizeof(ColumnReader);
+}
+
 Status Segment::_parse_footer() {
     // Footer := SegmentFooterPB, FooterPBSize(4), FooterPBChecksum(4), MagicNumber(4)
     std::unique_ptr<fs::ReadableBlock> rblock;
@@ -100,6 +100,9 @@ public:
         return _sk_index_decoder->num_items() - 1;
     }
 
+    // Memory used by the footer, column readers and short key index of this segment.
+    size_t meta_mem_usage() const;
+
     // only used by UT
     const SegmentFooterPB& footer() const { return _footer; }
 
@@ -29,6 +29,8 @@
 #include "olap/rowset/segment_v2/column_reader.h"
 #include "olap/rowset/segment_v2/segment.h"
 #include "olap/short_key_index.h"
+#include "olap/substring_filter.h"
+#include "olap/topn_filter.h"
 #include "util/doris_metrics.h"
 
 using strings::Substitute;
@@ -221,6 +223,14 @@ Status SegmentIterator::_get_row_ranges_by_column_conditions() {
         _opts.stats->rows_conditions_filtered += (pre_size - _row_bitmap.cardinality());
     }
 
+    if (!_row_bitmap.isEmpty() && _opts.topn_filter != nullptr) {
+        RETURN_IF_ERROR(_get_row_ranges_by_topn_filter());
+    }
+
+    if (!_row_bitmap.isEmpty() && _opts.substring_filters != nullptr) {
+        RETURN_IF_ERROR(_get_row_ranges_by_substring_filters());
+    }
+
     // TODO(hkp): calculate filter rate to decide whether to
     // use zone map/bloom filter/secondary index or not.
     return Status::OK();
@@ -292,6 +302,60 @@ Status SegmentIterator::_get_row_ranges_from_conditions(RowRanges* condition_row
     return Status::OK();
 }
 
+// skip the pages whose zone map can not reach the current bound of the TopN above the scan.
+// the bound changes while the scan runs, so it is read when the segment is opened.
+Status SegmentIterator::_get_row_ranges_by_topn_filter() {
+    TCondition condition;
+    if (!_opts.topn_filter->get_condition(&condition)) {
+        return Status::OK();
+    }
+    Conditions topn_conditions;
+    topn_conditions.set_tablet_schema(_segment->_tablet_schema);
+    if (topn_conditions.append_condition(condition) != OLAP_SUCCESS) {
+        return Status::OK();
+    }
+    for (auto& column_condition : topn_conditions.columns()) {
+        const int32_t cid = column_condition.first;
+        // values of an aggregate or unique table are only final after merging versions
+        if (_column_iterators[cid] == nullptr ||
+            (!column_condition.second->is_key() &&
+             _segment->_tablet_schema->keys_type() != KeysType::DUP_KEYS)) {
+            continue;
+        }
+        RowRanges topn_row_ranges = RowRanges::create_single(num_rows());
+        RETURN_IF_ERROR(_column_iterators[cid]->get_row_ranges_by_zone_map(
+                column_condition.second, nullptr, &topn_row_ranges));
+        size_t pre_size = _row_bitmap.cardinality();
+        _row_bitmap &= RowRanges::ranges_to_roaring(topn_row_ranges);
+        _opts.stats->rows_topn_filtered += (pre_size - _row_bitmap.cardinality());
+    }
+    return Status::OK();
+}
+
+// skip the pages in which no value contains all the substrings required by the LIKE
+// conjuncts of the scan, using the ngram bloom filter index of the column.
+Status SegmentIterator::_get_row_ranges_by_substring_filters() {
+    for (auto& substring_filter : *_opts.substring_filters) {
+        int32_t cid = _segment->_tablet_schema->field_index(substring_filter.column_name);
+        // values of an aggregate or unique table are only final after merging versions
+        if (cid < 0 || _column_iterators[cid] == nullptr ||
+            (!_segment->_tablet_schema->column(cid).is_key() &&
+             _segment->_tablet_schema->keys_type() != KeysType::DUP_KEYS)) {
+            continue;
+        }
+        RowRanges ngram_row_ranges = RowRanges::create_single(num_rows());
+        RETURN_IF_ERROR(_column_iterators[cid]->get_row_ranges_by_ngram_bloom_filter(
+                substring_filter.substrings, &ngram_row_ranges));
+        size_t pre_size = _row_bitmap.cardinality();
+        _row_bitmap &= RowRanges::ranges_to_roaring(ngram_row_ranges);
+        _opts.stats->rows_ngram_bf_filtered += (pre_size - _row_bitmap.cardinality());
+        if (_row_bitmap.isEmpty()) {
+            break;
+        }
+    }
+    return Status::OK();
+}
+
 // filter rows by evaluating column predicates using bitmap indexes.
 // upon return, predicates that've been evaluated by bitmap indexes are removed from _col_predicates.
 Status SegmentIterator::_apply_bitmap_index() {
@@ -74,6 +74,8 @@ private:
     // calculate row ranges that satisfy requested column conditions using various column index
     Status _get_row_ranges_by_column_conditions();
     Status _get_row_ranges_from_conditions(RowRanges* condition_row_ranges);
+    Status _get_row_ranges_by_topn_filter();
+    Status _get_row_ranges_by_substring_filters();
     Status _apply_bitmap_index();
 
     void _init_lazy_materialization();
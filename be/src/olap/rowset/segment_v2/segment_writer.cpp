@@ -19,6 +19,7 @@
 
 #include "common/logging.h" // LOG
 #include "env/env.h"        // Env
+#include "gen_cpp/olap_file.pb.h"
 #include "olap/fs/block_manager.h"
 #include "olap/row.h"                             // ContiguousRow
 #include "olap/row_cursor.h"                      // RowCursor
@@ -78,6 +79,7 @@ Status SegmentWriter::init(uint32_t write_mbytes_per_sec __attribute__((unused))
         opts.need_zone_map = column.is_key() || _tablet_schema->keys_type() != KeysType::AGG_KEYS;
         opts.need_bloom_filter = column.is_bf_column();
         opts.need_bitmap_index = column.has_bitmap_index();
+        opts.need_ngram_bloom_filter = column.has_ngram_bf_index();
         if (column.type() == FieldType::OLAP_FIELD_TYPE_ARRAY) {
             opts.need_zone_map = false;
             if (opts.need_bloom_filter) {
@@ -86,6 +88,9 @@ Status SegmentWriter::init(uint32_t write_mbytes_per_sec __attribute__((unused))
             if (opts.need_bitmap_index) {
                 return Status::NotSupported("Do not support bitmap index for array type");
             }
+            if (opts.need_ngram_bloom_filter) {
+                return Status::NotSupported("Do not support ngram bloom filter for array type");
+            }
         }
         opts.parent = _mem_tracker;
 
@@ -153,6 +158,28 @@ Status SegmentWriter::finalize(uint64_t* segment_file_size, uint64_t* index_size
     return Status::OK();
 }
 
+void SegmentWriter::get_statistics(SegmentStatisticsPB* statistics) const {
+    for (auto& column_meta : _footer.columns()) {
+        for (auto& index_meta : column_meta.indexes()) {
+            if (index_meta.type() != ZONE_MAP_INDEX) {
+                continue;
+            }
+            const ZoneMapPB& zone_map = index_meta.zone_map_index().segment_zone_map();
+            // min and max are not kept for some long strings
+            if (zone_map.pass_all()) {
+                break;
+            }
+            ColumnStatisticsPB* column_stats = statistics->add_columns();
+            column_stats->set_unique_id(column_meta.unique_id());
+            column_stats->set_min(zone_map.min());
+            column_stats->set_max(zone_map.max());
+            column_stats->set_has_null(zone_map.has_null());
+            column_stats->set_has_not_null(zone_map.has_not_null());
+            break;
+        }
+    }
+}
+
 // write column data to file one by one
 Status SegmentWriter::_write_data() {
     for (auto& column_writer : _column_writers) {
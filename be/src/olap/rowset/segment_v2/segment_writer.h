@@ -30,6 +30,7 @@ namespace doris {
 
 class MemTracker;
 class RowBlock;
+class SegmentStatisticsPB;
 class RowCursor;
 class TabletSchema;
 class TabletColumn;
@@ -67,6 +68,11 @@ public:
 
     Status finalize(uint64_t* segment_file_size, uint64_t* index_size);
 
+    uint32_t segment_id() const { return _segment_id; }
+
+    // Get the segment-level zone maps of the columns, must be called after finalize.
+    void get_statistics(SegmentStatisticsPB* statistics) const;
+
     static void init_column_meta(ColumnMetaPB* meta, uint32_t* column_id, const TabletColumn& column);
 
 private:
@@ -21,6 +21,8 @@
 #include <signal.h>
 
 #include <algorithm>
+#include <mutex>
+#include <numeric>
 #include <vector>
 
 #include "agent/cgroups_mgr.h"
@@ -38,6 +40,7 @@
 #include "runtime/mem_pool.h"
 #include "runtime/mem_tracker.h"
 #include "util/defer_op.h"
+#include "util/threadpool.h"
 
 using std::deque;
 using std::list;
@@ -52,23 +55,6 @@ namespace doris {
 DEFINE_GAUGE_METRIC_PROTOTYPE_5ARG(schema_change_mem_consumption, MetricUnit::BYTES, "",
                                    mem_consumption, Labels({{"type", "schema_change"}}));
 
-class RowBlockSorter {
-public:
-    explicit RowBlockSorter(RowBlockAllocator* allocator);
-    virtual ~RowBlockSorter();
-
-    bool sort(RowBlock** row_block);
-
-private:
-    static bool _row_cursor_comparator(const std::unique_ptr<RowCursor>& a,
-                                       const std::unique_ptr<RowCursor>& b) {
-        return compare_row(*a, *b) < 0;
-    }
-
-    RowBlockAllocator* _row_block_allocator;
-    RowBlock* _swap_row_block;
-};
-
 class RowBlockMerger {
 public:
     explicit RowBlockMerger(TabletSharedPtr tablet);
@@ -678,34 +664,34 @@ bool RowBlockSorter::sort(RowBlock** row_block) {
         return false;
     }
 
-    std::vector<std::unique_ptr<RowCursor>> row_cursor_list;
-    row_cursor_list.reserve((*row_block)->row_block_info().row_num);
-    // create an list of row cursor as long as the number of rows in data block.
-    for (size_t i = 0; i < (*row_block)->row_block_info().row_num; ++i) {
-        row_cursor_list.emplace_back(new (nothrow) RowCursor());
-        if (row_cursor_list[i] == nullptr) {
-            LOG(WARNING) << "failed to malloc RowCursor. size=" << sizeof(RowCursor);
-            return false;
-        }
-
-        if (row_cursor_list[i]->init((*row_block)->tablet_schema()) != OLAP_SUCCESS) {
-            return false;
-        }
-
-        (*row_block)->get_row(i, row_cursor_list[i].get());
+    // sort the indexes of the rows instead of a cursor for each row, two cursors are attached
+    // to the rows being compared.
+    RowCursor lhs_row;
+    RowCursor rhs_row;
+    if (lhs_row.init((*row_block)->tablet_schema()) != OLAP_SUCCESS ||
+        rhs_row.init((*row_block)->tablet_schema()) != OLAP_SUCCESS) {
+        LOG(WARNING) << "row cursor init failed.";
+        return false;
     }
-
+    const RowBlock* ref_block = *row_block;
+    std::vector<uint32_t> row_indexes(row_num);
+    std::iota(row_indexes.begin(), row_indexes.end(), 0);
     // Must use 'std::' because this class has a function whose name is sort too
-    std::stable_sort(row_cursor_list.begin(), row_cursor_list.end(), _row_cursor_comparator);
+    std::stable_sort(row_indexes.begin(), row_indexes.end(), [&](uint32_t a, uint32_t b) {
+        ref_block->get_row(a, &lhs_row);
+        ref_block->get_row(b, &rhs_row);
+        return compare_row(lhs_row, rhs_row) < 0;
+    });
 
     // copy the results sorted to temp row block.
     _swap_row_block->clear();
-    for (size_t i = 0; i < row_cursor_list.size(); ++i) {
+    for (size_t i = 0; i < row_indexes.size(); ++i) {
         _swap_row_block->get_row(i, &helper_row);
-        copy_row(&helper_row, *row_cursor_list[i], _swap_row_block->mem_pool());
+        ref_block->get_row(row_indexes[i], &lhs_row);
+        copy_row(&helper_row, lhs_row, _swap_row_block->mem_pool());
     }
 
-    _swap_row_block->finalize(row_cursor_list.size());
+    _swap_row_block->finalize(row_indexes.size());
 
     // swap the row block for reducing memory allocating.
     std::swap(*row_block, _swap_row_block);
@@ -729,7 +715,8 @@ RowBlockAllocator::~RowBlockAllocator() {
     }
 }
 
-OLAPStatus RowBlockAllocator::allocate(RowBlock** row_block, size_t num_rows, bool null_supported) {
+OLAPStatus RowBlockAllocator::allocate(RowBlock** row_block, size_t num_rows, bool null_supported,
+                                       bool check_parent_limit) {
     size_t row_block_size = _row_len * num_rows;
 
     if (_memory_limitation > 0 &&
@@ -740,11 +727,21 @@ OLAPStatus RowBlockAllocator::allocate(RowBlock** row_block, size_t num_rows, bo
         return OLAP_SUCCESS;
     }
 
+    if (!check_parent_limit) {
+        _mem_tracker->Consume(row_block_size);
+    } else if (!_mem_tracker->TryConsume(row_block_size)) {
+        LOG(WARNING) << "RowBlockAllocator::alocate() parent memory limit exceeded. "
+                     << "m_memory_allocated=" << _mem_tracker->consumption();
+        *row_block = nullptr;
+        return OLAP_SUCCESS;
+    }
+
     // TODO(lijiao) : 为什么舍弃原有的m_row_block_buffer
     *row_block = new (nothrow) RowBlock(&_tablet_schema);
 
     if (*row_block == nullptr) {
         LOG(WARNING) << "failed to malloc RowBlock. size=" << sizeof(RowBlock);
+        _mem_tracker->Release(row_block_size);
         return OLAP_ERR_MALLOC_ERROR;
     }
 
@@ -752,7 +749,6 @@ OLAPStatus RowBlockAllocator::allocate(RowBlock** row_block, size_t num_rows, bo
     row_block_info.null_supported = null_supported;
     (*row_block)->init(row_block_info);
 
-    _mem_tracker->Consume(row_block_size);
     VLOG_NOTICE << "RowBlockAllocator::allocate() this=" << this << ", num_rows=" << num_rows
                 << ", m_memory_allocated=" << _mem_tracker->consumption()
                 << ", row_block_addr=" << *row_block;
@@ -1065,10 +1061,14 @@ OLAPStatus SchemaChangeDirectly::process(RowsetReaderSharedPtr rowset_reader,
 
 SchemaChangeWithSorting::SchemaChangeWithSorting(const RowBlockChanger& row_block_changer,
                                                  std::shared_ptr<MemTracker> mem_tracker,
-                                                 size_t memory_limitation)
+                                                 std::shared_ptr<MemTracker> sort_mem_tracker,
+                                                 size_t memory_limitation,
+                                                 ThreadPool* sort_thread_pool)
         : SchemaChange(mem_tracker),
           _row_block_changer(row_block_changer),
+          _sort_mem_tracker(std::move(sort_mem_tracker)),
           _memory_limitation(memory_limitation),
+          _sort_thread_pool(sort_thread_pool),
           _row_block_allocator(nullptr) {
     // 每次SchemaChange做外排的时候，会写一些临时版本（比如999,1000,1001），为避免Cache冲突，临时
     // 版本进行2个处理：
@@ -1089,8 +1089,9 @@ OLAPStatus SchemaChangeWithSorting::process(RowsetReaderSharedPtr rowset_reader,
                                             TabletSharedPtr new_tablet,
                                             TabletSharedPtr base_tablet) {
     if (_row_block_allocator == nullptr) {
-        _row_block_allocator = new (nothrow)
-                RowBlockAllocator(new_tablet->tablet_schema(), _mem_tracker, _memory_limitation);
+        _row_block_allocator = new (nothrow) RowBlockAllocator(new_tablet->tablet_schema(),
+                                                               _sort_mem_tracker,
+                                                               _memory_limitation);
         if (_row_block_allocator == nullptr) {
             LOG(FATAL) << "failed to malloc RowBlockAllocator. size=" << sizeof(RowBlockAllocator);
             return OLAP_ERR_INPUT_PARAMETER_ERROR;
@@ -1120,12 +1121,33 @@ OLAPStatus SchemaChangeWithSorting::process(RowsetReaderSharedPtr rowset_reader,
     // for internal sorting
     RowBlock* new_row_block = nullptr;
     std::vector<RowBlock*> row_block_arr;
+    size_t row_block_arr_bytes = 0;
 
     // for external sorting
     // src_rowsets to store the rowset generated by internal sorting
     std::vector<RowsetSharedPtr> src_rowsets;
 
+    // the sorted runs are merged into their rowsets in _sort_thread_pool while the next run is
+    // read, each run then takes at most half of the memory
+    std::unique_ptr<ThreadPoolToken> sort_token;
+    size_t run_limitation = _memory_limitation;
+    if (_sort_thread_pool != nullptr) {
+        sort_token = _sort_thread_pool->new_token(ThreadPool::ExecutionMode::CONCURRENT);
+        run_limitation /= 2;
+    }
+    // guards src_rowsets, sort_failed, sort_merged_rows and sorting_runs, which the runs being
+    // merged update
+    std::mutex sort_lock;
+    bool sort_failed = false;
+    uint64_t sort_merged_rows = 0;
+    int sorting_runs = 0;
+
     Defer defer{[&]() {
+        // the runs being merged use the blocks and the rowsets
+        if (sort_token != nullptr) {
+            sort_token->wait();
+        }
+
         // remove the intermediate rowsets generated by internal sorting
         for (auto& row_set : src_rowsets) {
             StorageEngine::instance()->add_unused_rowset(row_set);
@@ -1148,50 +1170,97 @@ OLAPStatus SchemaChangeWithSorting::process(RowsetReaderSharedPtr rowset_reader,
     if (new_tablet->tablet_meta()->preferred_rowset_type() == BETA_ROWSET) {
         use_beta_rowset = true;
     }
+    RowsetTypePB new_rowset_type = rowset_reader->rowset()->rowset_meta()->rowset_type();
+    if (use_beta_rowset) {
+        new_rowset_type = BETA_ROWSET;
+    }
 
     SegmentsOverlapPB segments_overlap = rowset->rowset_meta()->segments_overlap();
+
+    // merges the blocks of row_block_arr into a rowset, in _sort_thread_pool if there is one.
+    // The version of a run follows the order of the rows in the rowset being converted.
+    auto sort_run = [&]() -> bool {
+        auto run = std::make_shared<std::vector<RowBlock*>>(std::move(row_block_arr));
+        row_block_arr.clear();
+        row_block_arr_bytes = 0;
+        Version version(_temp_delta_versions.second, _temp_delta_versions.second);
+        // increase temp version
+        ++_temp_delta_versions.second;
+
+        {
+            std::lock_guard<std::mutex> l(sort_lock);
+            ++sorting_runs;
+        }
+        auto internal_sorting = [this, run, version, new_tablet, new_rowset_type,
+                                 segments_overlap, &rowset_reader, &sort_lock, &sort_failed,
+                                 &sort_merged_rows, &sorting_runs, &src_rowsets]() {
+            RowsetSharedPtr rowset;
+            uint64_t merged_rows = 0;
+            bool ok = _internal_sorting(*run, version, rowset_reader->version_hash(), new_tablet,
+                                        new_rowset_type, segments_overlap, &rowset,
+                                        &merged_rows);
+            for (auto block : *run) {
+                _row_block_allocator->release(block);
+            }
+            std::lock_guard<std::mutex> l(sort_lock);
+            --sorting_runs;
+            if (!ok) {
+                LOG(WARNING) << "failed to sorting internally.";
+                sort_failed = true;
+                return;
+            }
+            src_rowsets.push_back(rowset);
+            sort_merged_rows += merged_rows;
+        };
+        if (sort_token == nullptr || !sort_token->submit_func(internal_sorting).ok()) {
+            internal_sorting();
+        }
+        std::lock_guard<std::mutex> l(sort_lock);
+        return !sort_failed;
+    };
+
     RowBlock* ref_row_block = nullptr;
     rowset_reader->next_block(&ref_row_block);
     while (ref_row_block != nullptr && ref_row_block->has_remaining()) {
-        if (OLAP_SUCCESS != _row_block_allocator->allocate(&new_row_block,
-                                                           ref_row_block->row_block_info().row_num,
-                                                           true)) {
+        size_t row_num = ref_row_block->row_block_info().row_num;
+        size_t row_block_bytes = new_tablet->tablet_schema().row_size() * row_num;
+        if (run_limitation > 0 && !row_block_arr.empty() &&
+            row_block_arr_bytes + row_block_bytes > run_limitation) {
+            if (!sort_run()) {
+                return OLAP_ERR_ALTER_STATUS_ERR;
+            }
+            continue;
+        }
+
+        // the budget shared with the other rowsets being converted is not checked for the first
+        // block, this rowset would not make progress when the others hold all of the budget
+        if (OLAP_SUCCESS != _row_block_allocator->allocate(&new_row_block, row_num, true,
+                                                           !row_block_arr.empty())) {
             LOG(WARNING) << "failed to allocate RowBlock.";
             return OLAP_ERR_INPUT_PARAMETER_ERROR;
         }
 
         if (new_row_block == nullptr) {
             if (row_block_arr.size() < 1) {
+                bool has_sorting_runs = false;
+                {
+                    std::lock_guard<std::mutex> l(sort_lock);
+                    has_sorting_runs = sorting_runs > 0;
+                }
+                if (has_sorting_runs) {
+                    // the memory is held by the runs being merged
+                    sort_token->wait();
+                    continue;
+                }
                 LOG(WARNING) << "Memory limitation is too small for Schema Change."
                              << "memory_limitation=" << _memory_limitation;
                 return OLAP_ERR_INPUT_PARAMETER_ERROR;
             }
 
             // enter here while memory limitation is reached.
-            RowsetSharedPtr rowset;
-            RowsetTypePB new_rowset_type = rowset_reader->rowset()->rowset_meta()->rowset_type();
-            if (use_beta_rowset) {
-                new_rowset_type = BETA_ROWSET;
-            }
-            if (!_internal_sorting(
-                        row_block_arr,
-                        Version(_temp_delta_versions.second, _temp_delta_versions.second),
-                        rowset_reader->version_hash(), new_tablet, new_rowset_type,
-                        segments_overlap, &rowset)) {
-                LOG(WARNING) << "failed to sorting internally.";
+            if (!sort_run()) {
                 return OLAP_ERR_ALTER_STATUS_ERR;
             }
-
-            src_rowsets.push_back(rowset);
-
-            for (auto block : row_block_arr) {
-                _row_block_allocator->release(block);
-            }
-
-            row_block_arr.clear();
-
-            // increase temp version
-            ++_temp_delta_versions.second;
             continue;
         }
 
@@ -1212,6 +1281,7 @@ OLAPStatus SchemaChangeWithSorting::process(RowsetReaderSharedPtr rowset_reader,
                 return OLAP_ERR_ALTER_STATUS_ERR;
             }
             row_block_arr.push_back(new_row_block);
+            row_block_arr_bytes += row_block_bytes;
         } else {
             LOG(INFO) << "new block num rows is: " << new_row_block->row_block_info().row_num;
             _row_block_allocator->release(new_row_block);
@@ -1222,33 +1292,16 @@ OLAPStatus SchemaChangeWithSorting::process(RowsetReaderSharedPtr rowset_reader,
         rowset_reader->next_block(&ref_row_block);
     }
 
-    if (!row_block_arr.empty()) {
-        // enter here while memory limitation is reached.
-        RowsetSharedPtr rowset = nullptr;
-
-        RowsetTypePB new_rowset_type = rowset_reader->rowset()->rowset_meta()->rowset_type();
-        if (use_beta_rowset) {
-            new_rowset_type = BETA_ROWSET;
-        }
-        if (!_internal_sorting(row_block_arr,
-                               Version(_temp_delta_versions.second, _temp_delta_versions.second),
-                               rowset_reader->version_hash(), new_tablet, new_rowset_type,
-                               segments_overlap, &rowset)) {
-            LOG(WARNING) << "failed to sorting internally.";
-            return OLAP_ERR_ALTER_STATUS_ERR;
-        }
-
-        src_rowsets.push_back(rowset);
-
-        for (auto block : row_block_arr) {
-            _row_block_allocator->release(block);
-        }
-
-        row_block_arr.clear();
-
-        // increase temp version
-        ++_temp_delta_versions.second;
+    if (!row_block_arr.empty() && !sort_run()) {
+        return OLAP_ERR_ALTER_STATUS_ERR;
+    }
+    if (sort_token != nullptr) {
+        sort_token->wait();
     }
+    if (sort_failed) {
+        return OLAP_ERR_ALTER_STATUS_ERR;
+    }
+    add_merged_rows(sort_merged_rows);
 
     if (src_rowsets.empty()) {
         res = new_rowset_writer->flush();
@@ -1292,8 +1345,8 @@ bool SchemaChangeWithSorting::_internal_sorting(const std::vector<RowBlock*>& ro
                                                 TabletSharedPtr new_tablet,
                                                 RowsetTypePB new_rowset_type,
                                                 SegmentsOverlapPB segments_overlap,
-                                                RowsetSharedPtr* rowset) {
-    uint64_t merged_rows = 0;
+                                                RowsetSharedPtr* rowset,
+                                                uint64_t* merged_rows) {
     RowBlockMerger merger(new_tablet);
 
     RowsetWriterContext context;
@@ -1319,7 +1372,7 @@ bool SchemaChangeWithSorting::_internal_sorting(const std::vector<RowBlock*>& ro
         return false;
     }
 
-    if (!merger.merge(row_block_arr, rowset_writer.get(), _mem_tracker, &merged_rows)) {
+    if (!merger.merge(row_block_arr, rowset_writer.get(), _mem_tracker, merged_rows)) {
         LOG(WARNING) << "failed to merge row blocks.";
         new_tablet->data_dir()->remove_pending_ids(ROWSET_ID_PREFIX +
                                                    rowset_writer->rowset_id().to_string());
@@ -1327,7 +1380,6 @@ bool SchemaChangeWithSorting::_internal_sorting(const std::vector<RowBlock*>& ro
     }
     new_tablet->data_dir()->remove_pending_ids(ROWSET_ID_PREFIX +
                                                rowset_writer->rowset_id().to_string());
-    add_merged_rows(merged_rows);
     *rowset = rowset_writer->build();
     return true;
 }
@@ -1364,6 +1416,28 @@ SchemaChangeHandler::SchemaChangeHandler()
         : _mem_tracker(MemTracker::CreateTracker(-1, "SchemaChange", StorageEngine::instance()->schema_change_mem_tracker())) {
     REGISTER_HOOK_METRIC(schema_change_mem_consumption,
                          [this]() { return _mem_tracker->consumption(); });
+    // the alter threads sorted with memory_limitation_per_thread_for_schema_change each before
+    // the rowsets were converted concurrently, all the sorting shares that memory now
+    int64_t sort_mem_limit = int64_t(config::memory_limitation_per_thread_for_schema_change) *
+                             std::max(1, config::alter_tablet_worker_count) * 1024 * 1024 * 1024;
+    _sort_mem_tracker = MemTracker::CreateTracker(sort_mem_limit, "SchemaChangeSorting",
+                                                  _mem_tracker);
+    Status st = ThreadPoolBuilder("SchemaChangeConvertThreadPool")
+                        .set_min_threads(1)
+                        .set_max_threads(std::max(1, config::schema_change_convert_thread_num))
+                        .build(&_convert_thread_pool);
+    if (!st.ok()) {
+        LOG(WARNING) << "failed to create schema change convert thread pool: " << st.to_string();
+        _convert_thread_pool.reset();
+    }
+    st = ThreadPoolBuilder("SchemaChangeSortThreadPool")
+                 .set_min_threads(1)
+                 .set_max_threads(std::max(1, config::schema_change_convert_thread_num))
+                 .build(&_sort_thread_pool);
+    if (!st.ok()) {
+        LOG(WARNING) << "failed to create schema change sort thread pool: " << st.to_string();
+        _sort_thread_pool.reset();
+    }
 }
 
 SchemaChangeHandler::~SchemaChangeHandler() {
@@ -1658,7 +1732,8 @@ OLAPStatus SchemaChangeHandler::schema_version_convert(TabletSharedPtr base_tabl
         LOG(INFO) << "doing schema change with sorting for base_tablet "
                   << base_tablet->full_name();
         sc_procedure = new (nothrow) SchemaChangeWithSorting(
-                rb_changer, _mem_tracker, memory_limitation * 1024 * 1024 * 1024);
+                rb_changer, _mem_tracker, _sort_mem_tracker,
+                memory_limitation * 1024 * 1024 * 1024, _sort_thread_pool.get());
     } else if (sc_directly) {
         LOG(INFO) << "doing schema change directly for base_tablet " << base_tablet->full_name();
         sc_procedure = new (nothrow) SchemaChangeDirectly(rb_changer, _mem_tracker);
@@ -1793,135 +1868,94 @@ OLAPStatus SchemaChangeHandler::_convert_historical_rowsets(const SchemaChangePa
 
     bool sc_sorting = false;
     bool sc_directly = false;
-    SchemaChange* sc_procedure = nullptr;
 
     // a. 解析Alter请求，转换成内部的表示形式
     OLAPStatus res = _parse_request(sc_params.base_tablet, sc_params.new_tablet, &rb_changer,
                                     &sc_sorting, &sc_directly, sc_params.materialized_params_map);
     if (res != OLAP_SUCCESS) {
         LOG(WARNING) << "failed to parse the request. res=" << res;
-        goto PROCESS_ALTER_EXIT;
-    }
-
-    // b. 生成历史数据转换器
-    if (sc_sorting) {
-        size_t memory_limitation = config::memory_limitation_per_thread_for_schema_change;
+    } else if (sc_sorting) {
         LOG(INFO) << "doing schema change with sorting for base_tablet "
                   << sc_params.base_tablet->full_name();
-        sc_procedure = new (nothrow) SchemaChangeWithSorting(
-                rb_changer, _mem_tracker, memory_limitation * 1024 * 1024 * 1024);
     } else if (sc_directly) {
         LOG(INFO) << "doing schema change directly for base_tablet "
                   << sc_params.base_tablet->full_name();
-        sc_procedure = new (nothrow) SchemaChangeDirectly(rb_changer, _mem_tracker);
     } else {
         LOG(INFO) << "doing linked schema change for base_tablet "
                   << sc_params.base_tablet->full_name();
-        sc_procedure = new (nothrow) LinkedSchemaChange(rb_changer, _mem_tracker);
     }
 
-    if (sc_procedure == nullptr) {
-        LOG(WARNING) << "failed to malloc SchemaChange. "
-                     << "malloc_size=" << sizeof(SchemaChangeWithSorting);
-        res = OLAP_ERR_MALLOC_ERROR;
-        goto PROCESS_ALTER_EXIT;
-    }
-
-    // c. 转换历史数据
-    for (auto& rs_reader : sc_params.ref_rowset_readers) {
-        VLOG_TRACE << "begin to convert a history rowset. version=" << rs_reader->version().first
-                   << "-" << rs_reader->version().second;
-
-        // set status for monitor
-        // 只要有一个new_table为running，ref table就设置为running
-        // NOTE 如果第一个sub_table先fail，这里会继续按正常走
-        TabletSharedPtr new_tablet = sc_params.new_tablet;
-
-        RowsetWriterContext writer_context;
-        writer_context.rowset_id = StorageEngine::instance()->next_rowset_id();
-        writer_context.tablet_uid = new_tablet->tablet_uid();
-        writer_context.tablet_id = new_tablet->tablet_id();
-        writer_context.partition_id = new_tablet->partition_id();
-        writer_context.tablet_schema_hash = new_tablet->schema_hash();
-        // linked schema change can't change rowset type, therefore we preserve rowset type in schema change now
-        writer_context.rowset_type = rs_reader->rowset()->rowset_meta()->rowset_type();
-        if (sc_params.new_tablet->tablet_meta()->preferred_rowset_type() == BETA_ROWSET) {
-            // Use beta rowset to do schema change
-            // And in this case, linked schema change will not be used.
-            writer_context.rowset_type = BETA_ROWSET;
-        }
-        writer_context.rowset_path_prefix = new_tablet->tablet_path();
-        writer_context.tablet_schema = &(new_tablet->tablet_schema());
-        writer_context.rowset_state = VISIBLE;
-        writer_context.version = rs_reader->version();
-        writer_context.version_hash = rs_reader->version_hash();
-        writer_context.segments_overlap = rs_reader->rowset()->rowset_meta()->segments_overlap();
-        writer_context.parent_mem_tracker = _mem_tracker;
-
-        std::unique_ptr<RowsetWriter> rowset_writer;
-        OLAPStatus status = RowsetFactory::create_rowset_writer(writer_context, &rowset_writer);
-        if (status != OLAP_SUCCESS) {
-            res = OLAP_ERR_ROWSET_BUILDER_INIT;
-            goto PROCESS_ALTER_EXIT;
+    // b. 生成历史数据转换器, one for each rowset because it keeps the state of the rowset
+    // being converted
+    auto new_sc_procedure = [&]() -> SchemaChange* {
+        if (sc_sorting) {
+            size_t memory_limitation = config::memory_limitation_per_thread_for_schema_change;
+            return new (nothrow) SchemaChangeWithSorting(rb_changer, _mem_tracker,
+                                                         _sort_mem_tracker,
+                                                         memory_limitation * 1024 * 1024 * 1024,
+                                                         _sort_thread_pool.get());
+        } else if (sc_directly) {
+            return new (nothrow) SchemaChangeDirectly(rb_changer, _mem_tracker);
+        } else {
+            return new (nothrow) LinkedSchemaChange(rb_changer, _mem_tracker);
         }
+    };
 
-        if ((res = sc_procedure->process(rs_reader, rowset_writer.get(), sc_params.new_tablet,
-                                         sc_params.base_tablet)) != OLAP_SUCCESS) {
-            LOG(WARNING) << "failed to process the version."
-                         << " version=" << rs_reader->version().first << "-"
-                         << rs_reader->version().second;
-            new_tablet->data_dir()->remove_pending_ids(ROWSET_ID_PREFIX +
-                                                       rowset_writer->rowset_id().to_string());
-            goto PROCESS_ALTER_EXIT;
+    // c. 转换历史数据, the rowsets are converted concurrently in the convert thread pool,
+    // the first failure stops the rowsets not started yet
+    std::mutex res_lock;
+    auto convert_rowset = [&](const RowsetReaderSharedPtr& rs_reader) {
+        {
+            std::lock_guard<std::mutex> l(res_lock);
+            if (res != OLAP_SUCCESS) {
+                return;
+            }
         }
-        new_tablet->data_dir()->remove_pending_ids(ROWSET_ID_PREFIX +
-                                                   rowset_writer->rowset_id().to_string());
-        // 将新版本的数据加入header
-        // 为了防止死锁的出现，一定要先锁住旧表，再锁住新表
-        sc_params.new_tablet->obtain_push_lock();
-        RowsetSharedPtr new_rowset = rowset_writer->build();
-        if (new_rowset == nullptr) {
-            LOG(WARNING) << "failed to build rowset, exit alter process";
-            sc_params.new_tablet->release_push_lock();
-            goto PROCESS_ALTER_EXIT;
-        }
-        res = sc_params.new_tablet->add_rowset(new_rowset, false);
-        if (res == OLAP_ERR_PUSH_VERSION_ALREADY_EXIST) {
-            LOG(WARNING) << "version already exist, version revert occurred. "
-                         << "tablet=" << sc_params.new_tablet->full_name() << ", version='"
-                         << rs_reader->version().first << "-" << rs_reader->version().second;
-            StorageEngine::instance()->add_unused_rowset(new_rowset);
-            res = OLAP_SUCCESS;
-        } else if (res != OLAP_SUCCESS) {
-            LOG(WARNING) << "failed to register new version. "
-                         << " tablet=" << sc_params.new_tablet->full_name()
-                         << ", version=" << rs_reader->version().first << "-"
-                         << rs_reader->version().second;
-            StorageEngine::instance()->add_unused_rowset(new_rowset);
-            sc_params.new_tablet->release_push_lock();
-            goto PROCESS_ALTER_EXIT;
+        OLAPStatus status = OLAP_SUCCESS;
+        std::unique_ptr<SchemaChange> sc_procedure(new_sc_procedure());
+        if (sc_procedure == nullptr) {
+            LOG(WARNING) << "failed to malloc SchemaChange. "
+                         << "malloc_size=" << sizeof(SchemaChangeWithSorting);
+            status = OLAP_ERR_MALLOC_ERROR;
         } else {
-            VLOG_NOTICE << "register new version. tablet=" << sc_params.new_tablet->full_name()
-                        << ", version=" << rs_reader->version().first << "-"
-                        << rs_reader->version().second;
+            status = _convert_historical_rowset(sc_params, rs_reader, sc_procedure.get());
+        }
+        if (status != OLAP_SUCCESS) {
+            std::lock_guard<std::mutex> l(res_lock);
+            if (res == OLAP_SUCCESS) {
+                res = status;
+            }
+        }
+    };
+    if (res == OLAP_SUCCESS) {
+        std::unique_ptr<ThreadPoolToken> convert_token;
+        if (_convert_thread_pool != nullptr && sc_params.ref_rowset_readers.size() > 1) {
+            convert_token =
+                    _convert_thread_pool->new_token(ThreadPool::ExecutionMode::CONCURRENT);
+        }
+        for (auto& rs_reader : sc_params.ref_rowset_readers) {
+            if (convert_token == nullptr ||
+                !convert_token->submit_func([&convert_rowset, rs_reader]() {
+                                   convert_rowset(rs_reader);
+                               }).ok()) {
+                convert_rowset(rs_reader);
+            }
+        }
+        if (convert_token != nullptr) {
+            convert_token->wait();
         }
-        sc_params.new_tablet->release_push_lock();
-
-        VLOG_TRACE << "succeed to convert a history version."
-                   << " version=" << rs_reader->version().first << "-"
-                   << rs_reader->version().second;
     }
     // XXX: 此时应该不取消SchemaChange状态，因为新Delta还要转换成新旧Schema的版本
-PROCESS_ALTER_EXIT : {
-    // save tablet meta here because rowset meta is not saved during add rowset
-    WriteLock new_wlock(sc_params.new_tablet->get_header_lock_ptr());
-    sc_params.new_tablet->save_meta();
-}
+
+    {
+        // save tablet meta here because rowset meta is not saved during add rowset
+        WriteLock new_wlock(sc_params.new_tablet->get_header_lock_ptr());
+        sc_params.new_tablet->save_meta();
+    }
     if (res == OLAP_SUCCESS) {
         Version test_version(0, end_version);
         res = sc_params.new_tablet->check_version_integrity(test_version);
     }
-    SAFE_DELETE(sc_procedure);
 
     LOG(INFO) << "finish converting rowsets for new_tablet from base_tablet. "
               << "base_tablet=" << sc_params.base_tablet->full_name()
@@ -1929,6 +1963,89 @@ PROCESS_ALTER_EXIT : {
     return res;
 }
 
+OLAPStatus SchemaChangeHandler::_convert_historical_rowset(const SchemaChangeParams& sc_params,
+                                                          RowsetReaderSharedPtr rs_reader,
+                                                          SchemaChange* sc_procedure) {
+    VLOG_TRACE << "begin to convert a history rowset. version=" << rs_reader->version().first
+               << "-" << rs_reader->version().second;
+
+    TabletSharedPtr new_tablet = sc_params.new_tablet;
+
+    RowsetWriterContext writer_context;
+    writer_context.rowset_id = StorageEngine::instance()->next_rowset_id();
+    writer_context.tablet_uid = new_tablet->tablet_uid();
+    writer_context.tablet_id = new_tablet->tablet_id();
+    writer_context.partition_id = new_tablet->partition_id();
+    writer_context.tablet_schema_hash = new_tablet->schema_hash();
+    // linked schema change can't change rowset type, therefore we preserve rowset type in schema change now
+    writer_context.rowset_type = rs_reader->rowset()->rowset_meta()->rowset_type();
+    if (sc_params.new_tablet->tablet_meta()->preferred_rowset_type() == BETA_ROWSET) {
+        // Use beta rowset to do schema change
+        // And in this case, linked schema change will not be used.
+        writer_context.rowset_type = BETA_ROWSET;
+    }
+    writer_context.rowset_path_prefix = new_tablet->tablet_path();
+    writer_context.tablet_schema = &(new_tablet->tablet_schema());
+    writer_context.rowset_state = VISIBLE;
+    writer_context.version = rs_reader->version();
+    writer_context.version_hash = rs_reader->version_hash();
+    writer_context.segments_overlap = rs_reader->rowset()->rowset_meta()->segments_overlap();
+    writer_context.parent_mem_tracker = _mem_tracker;
+
+    std::unique_ptr<RowsetWriter> rowset_writer;
+    OLAPStatus res = RowsetFactory::create_rowset_writer(writer_context, &rowset_writer);
+    if (res != OLAP_SUCCESS) {
+        return OLAP_ERR_ROWSET_BUILDER_INIT;
+    }
+
+    if ((res = sc_procedure->process(rs_reader, rowset_writer.get(), sc_params.new_tablet,
+                                     sc_params.base_tablet)) != OLAP_SUCCESS) {
+        LOG(WARNING) << "failed to process the version."
+                     << " version=" << rs_reader->version().first << "-"
+                     << rs_reader->version().second;
+        new_tablet->data_dir()->remove_pending_ids(ROWSET_ID_PREFIX +
+                                                   rowset_writer->rowset_id().to_string());
+        return res;
+    }
+    new_tablet->data_dir()->remove_pending_ids(ROWSET_ID_PREFIX +
+                                               rowset_writer->rowset_id().to_string());
+    // 将新版本的数据加入header
+    // 为了防止死锁的出现，一定要先锁住旧表，再锁住新表
+    sc_params.new_tablet->obtain_push_lock();
+    RowsetSharedPtr new_rowset = rowset_writer->build();
+    if (new_rowset == nullptr) {
+        LOG(WARNING) << "failed to build rowset, exit alter process";
+        sc_params.new_tablet->release_push_lock();
+        return OLAP_ERR_MALLOC_ERROR;
+    }
+    res = sc_params.new_tablet->add_rowset(new_rowset, false);
+    if (res == OLAP_ERR_PUSH_VERSION_ALREADY_EXIST) {
+        LOG(WARNING) << "version already exist, version revert occurred. "
+                     << "tablet=" << sc_params.new_tablet->full_name() << ", version='"
+                     << rs_reader->version().first << "-" << rs_reader->version().second;
+        StorageEngine::instance()->add_unused_rowset(new_rowset);
+        res = OLAP_SUCCESS;
+    } else if (res != OLAP_SUCCESS) {
+        LOG(WARNING) << "failed to register new version. "
+                     << " tablet=" << sc_params.new_tablet->full_name()
+                     << ", version=" << rs_reader->version().first << "-"
+                     << rs_reader->version().second;
+        StorageEngine::instance()->add_unused_rowset(new_rowset);
+        sc_params.new_tablet->release_push_lock();
+        return res;
+    } else {
+        VLOG_NOTICE << "register new version. tablet=" << sc_params.new_tablet->full_name()
+                    << ", version=" << rs_reader->version().first << "-"
+                    << rs_reader->version().second;
+    }
+    sc_params.new_tablet->release_push_lock();
+
+    VLOG_TRACE << "succeed to convert a history version."
+               << " version=" << rs_reader->version().first << "-"
+               << rs_reader->version().second;
+    return OLAP_SUCCESS;
+}
+
 // @static
 // 分析column的mapping以及filter key的mapping
 OLAPStatus SchemaChangeHandler::_parse_request(
@@ -2090,6 +2207,10 @@ OLAPStatus SchemaChangeHandler::_parse_request(
                        ref_tablet_schema.column(column_mapping->ref_column).has_bitmap_index()) {
                 *sc_directly = true;
                 return OLAP_SUCCESS;
+            } else if (new_tablet_schema.column(i).has_ngram_bf_index() !=
+                       ref_tablet_schema.column(column_mapping->ref_column).has_ngram_bf_index()) {
+                *sc_directly = true;
+                return OLAP_SUCCESS;
             }
         }
     }
@@ -41,6 +41,8 @@ class Tablet;
 class RowBlock;
 // defined in 'row_cursor.h'
 class RowCursor;
+// defined in 'util/threadpool.h'
+class ThreadPool;
 
 bool to_bitmap(RowCursor* read_helper, RowCursor* write_helper, const TabletColumn& ref_column,
                int field_idx, int ref_field_idx, MemPool* mem_pool);
@@ -79,7 +81,11 @@ public:
     RowBlockAllocator(const TabletSchema& tablet_schema, std::shared_ptr<MemTracker> parent, size_t memory_limitation);
     virtual ~RowBlockAllocator();
 
-    OLAPStatus allocate(RowBlock** row_block, size_t num_rows, bool null_supported);
+    // *row_block is set to nullptr if the block would exceed memory_limitation, or the limit of
+    // the parent tracker when check_parent_limit is true. The parent limit may be shared by
+    // several allocators, the blocks a user can not do without should not check it.
+    OLAPStatus allocate(RowBlock** row_block, size_t num_rows, bool null_supported,
+                        bool check_parent_limit = false);
     void release(RowBlock* row_block);
 
 private:
@@ -90,6 +96,19 @@ private:
     size_t _memory_limitation;
 };
 
+// Sorts the rows of a block by their keys, the rows with equal keys keep their order.
+class RowBlockSorter {
+public:
+    explicit RowBlockSorter(RowBlockAllocator* allocator);
+    virtual ~RowBlockSorter();
+
+    bool sort(RowBlock** row_block);
+
+private:
+    RowBlockAllocator* _row_block_allocator;
+    RowBlock* _swap_row_block;
+};
+
 class SchemaChange {
 public:
     SchemaChange(std::shared_ptr<MemTracker> tracker) : _mem_tracker(std::move(tracker)), _filtered_rows(0), _merged_rows(0) {}
@@ -155,8 +174,15 @@ private:
 // @breif schema change with sorting
 class SchemaChangeWithSorting : public SchemaChange {
 public:
-    explicit SchemaChangeWithSorting(const RowBlockChanger& row_block_changer, std::shared_ptr<MemTracker> mem_tracker,
-                                     size_t memory_limitation);
+    // the row blocks being sorted are charged to sort_mem_tracker, whose limit is shared by
+    // all the rowsets being converted, and at most memory_limitation bytes of them are used.
+    // The sorted runs are merged into their temporary rowsets in sort_thread_pool while the
+    // next run is read, or in the calling thread if it is nullptr.
+    explicit SchemaChangeWithSorting(const RowBlockChanger& row_block_changer,
+                                     std::shared_ptr<MemTracker> mem_tracker,
+                                     std::shared_ptr<MemTracker> sort_mem_tracker,
+                                     size_t memory_limitation,
+                                     ThreadPool* sort_thread_pool = nullptr);
     virtual ~SchemaChangeWithSorting();
 
     virtual OLAPStatus process(RowsetReaderSharedPtr rowset_reader,
@@ -167,13 +193,16 @@ private:
     bool _internal_sorting(const std::vector<RowBlock*>& row_block_arr,
                            const Version& temp_delta_versions, const VersionHash version_hash,
                            TabletSharedPtr new_tablet, RowsetTypePB new_rowset_type,
-                           SegmentsOverlapPB segments_overlap, RowsetSharedPtr* rowset);
+                           SegmentsOverlapPB segments_overlap, RowsetSharedPtr* rowset,
+                           uint64_t* merged_rows);
 
     bool _external_sorting(std::vector<RowsetSharedPtr>& src_rowsets, RowsetWriter* rowset_writer,
                            TabletSharedPtr new_tablet);
 
     const RowBlockChanger& _row_block_changer;
+    std::shared_ptr<MemTracker> _sort_mem_tracker;
     size_t _memory_limitation;
+    ThreadPool* _sort_thread_pool;
     Version _temp_delta_versions;
     RowBlockAllocator* _row_block_allocator;
 
@@ -226,6 +255,11 @@ private:
 
     OLAPStatus _convert_historical_rowsets(const SchemaChangeParams& sc_params);
 
+    // convert one historical rowset with sc_procedure and add it to the new tablet
+    OLAPStatus _convert_historical_rowset(const SchemaChangeParams& sc_params,
+                                          RowsetReaderSharedPtr rs_reader,
+                                          SchemaChange* sc_procedure);
+
     static OLAPStatus _parse_request(
             TabletSharedPtr base_tablet, TabletSharedPtr new_tablet, RowBlockChanger* rb_changer,
             bool* sc_sorting, bool* sc_directly,
@@ -243,6 +277,15 @@ private:
     SchemaChangeHandler& operator=(const SchemaChangeHandler&) = delete;
 
     std::shared_ptr<MemTracker> _mem_tracker;
+    // the row blocks sorted by all the schema changes, its limit is the memory budget of sorting
+    std::shared_ptr<MemTracker> _sort_mem_tracker;
+
+    // converts the historical rowsets of all the tablets being altered, nullptr if it failed
+    // to be created, then the rowsets are converted by the alter threads one by one.
+    std::unique_ptr<ThreadPool> _convert_thread_pool;
+    // merges the sorted runs of the rowsets being converted into temporary rowsets, separate
+    // from _convert_thread_pool whose threads wait for them
+    std::unique_ptr<ThreadPool> _sort_thread_pool;
 };
 
 using RowBlockDeleter = std::function<void(RowBlock*)>;
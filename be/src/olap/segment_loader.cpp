@@ -0,0 +1,81 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+#include "olap/segment_loader.h"
+
+#include "olap/rowset/beta_rowset.h"
+
+namespace doris {
+
+SegmentLoader* SegmentLoader::_s_instance = nullptr;
+
+void SegmentLoader::create_global_instance(size_t capacity) {
+    DCHECK(_s_instance == nullptr);
+    static SegmentLoader instance(capacity);
+    _s_instance = &instance;
+}
+
+SegmentLoader::SegmentLoader(size_t capacity)
+        : _mem_tracker(MemTracker::CreateTracker(capacity, "SegmentCache", nullptr, true, true,
+                                                 MemTrackerLevel::OVERVIEW)) {
+    _cache = std::unique_ptr<Cache>(new_lru_cache("SegmentCache", capacity, _mem_tracker));
+}
+
+OLAPStatus SegmentLoader::load_segments(const BetaRowsetSharedPtr& rowset,
+                                        SegmentCacheHandle* cache_handle) {
+    std::vector<uint32_t> segment_ids(rowset->num_segments());
+    for (uint32_t seg_id = 0; seg_id < segment_ids.size(); ++seg_id) {
+        segment_ids[seg_id] = seg_id;
+    }
+    return load_segments(rowset, segment_ids, cache_handle);
+}
+
+OLAPStatus SegmentLoader::load_segments(const BetaRowsetSharedPtr& rowset,
+                                        const std::vector<uint32_t>& segment_ids,
+                                        SegmentCacheHandle* cache_handle) {
+    cache_handle->reset();
+    cache_handle->_cache = _cache.get();
+
+    auto deleter = [](const doris::CacheKey& key, void* value) {
+        delete (segment_v2::SegmentSharedPtr*)value;
+    };
+    for (uint32_t seg_id : segment_ids) {
+        CacheKey key(rowset->rowset_id(), seg_id);
+        std::string encoded_key = key.encode();
+        auto lru_handle = _cache->lookup(encoded_key);
+        if (lru_handle == nullptr) {
+            segment_v2::SegmentSharedPtr segment;
+            RETURN_NOT_OK(rowset->load_segment(seg_id, &segment));
+            // the indexes loaded on demand by the column readers later are not charged,
+            // most of their pages are held by the page cache
+            size_t charge = segment->meta_mem_usage();
+            lru_handle = _cache->insert(encoded_key, new segment_v2::SegmentSharedPtr(segment),
+                                        charge, deleter);
+        }
+        cache_handle->_handles.push_back(lru_handle);
+        cache_handle->_segments.push_back(
+                *reinterpret_cast<segment_v2::SegmentSharedPtr*>(_cache->value(lru_handle)));
+    }
+    return OLAP_SUCCESS;
+}
+
+void SegmentLoader::erase_segments(const RowsetId& rowset_id, int64_t num_segments) {
+    for (int seg_id = 0; seg_id < num_segments; ++seg_id) {
+        _cache->erase(CacheKey(rowset_id, seg_id).encode());
+    }
+}
+
+} // namespace doris
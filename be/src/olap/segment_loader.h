@@ -0,0 +1,115 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gutil/macros.h" // for DISALLOW_COPY_AND_ASSIGN
+#include "olap/lru_cache.h"
+#include "olap/olap_common.h"
+#include "olap/rowset/segment_v2/segment.h"
+#include "runtime/mem_tracker.h"
+
+namespace doris {
+
+class BetaRowset;
+class SegmentCacheHandle;
+using BetaRowsetSharedPtr = std::shared_ptr<BetaRowset>;
+
+// A LRU cache of the opened segments of beta rowsets, i.e. their footers, column readers and
+// the index pages loaded by them, keyed by rowset id and segment id.
+// Instead of keeping the segments of a rowset in memory as long as the rowset lives, the
+// segments are opened on demand by readers, and the ones not used by any reader are evicted
+// when the metadata of all the cached segments exceeds `segment_cache_capacity`.
+class SegmentLoader {
+public:
+    struct CacheKey {
+        CacheKey(RowsetId rowset_id_, uint32_t segment_id_)
+                : rowset_id(rowset_id_), segment_id(segment_id_) {}
+        RowsetId rowset_id;
+        uint32_t segment_id;
+
+        // Encode to a flat binary which can be used as LRUCache's key
+        std::string encode() const {
+            std::string key_buf(rowset_id.to_string());
+            key_buf.append((char*)&segment_id, sizeof(segment_id));
+            return key_buf;
+        }
+    };
+
+    // Create global instance of this class
+    static void create_global_instance(size_t capacity);
+
+    // Return global instance.
+    // Client should call create_global_instance before.
+    static SegmentLoader* instance() { return _s_instance; }
+
+    SegmentLoader(size_t capacity);
+
+    // Load the segments of the rowset, from the cache if they are in it, otherwise open them
+    // and put them into the cache.
+    // The segments are pinned in the cache until `cache_handle` is destroyed.
+    OLAPStatus load_segments(const BetaRowsetSharedPtr& rowset, SegmentCacheHandle* cache_handle);
+
+    // Same as above, but only load the segments in `segment_ids`.
+    OLAPStatus load_segments(const BetaRowsetSharedPtr& rowset,
+                             const std::vector<uint32_t>& segment_ids,
+                             SegmentCacheHandle* cache_handle);
+
+    // Remove the segments of a rowset from the cache, called when the rowset is closed.
+    // The segments used by readers are freed after the readers release them.
+    void erase_segments(const RowsetId& rowset_id, int64_t num_segments);
+
+private:
+    static SegmentLoader* _s_instance;
+
+    std::shared_ptr<MemTracker> _mem_tracker = nullptr;
+    std::unique_ptr<Cache> _cache = nullptr;
+};
+
+// A handle for the segments of a rowset loaded by SegmentLoader. The segments stay in the
+// cache until this handle is destroyed.
+class SegmentCacheHandle {
+public:
+    SegmentCacheHandle() {}
+    ~SegmentCacheHandle() { reset(); }
+
+    const std::vector<segment_v2::SegmentSharedPtr>& segments() const { return _segments; }
+
+    // Release the segments to the cache.
+    void reset() {
+        for (Cache::Handle* handle : _handles) {
+            _cache->release(handle);
+        }
+        _handles.clear();
+        _segments.clear();
+    }
+
+private:
+    friend class SegmentLoader;
+
+    Cache* _cache = nullptr;
+    std::vector<Cache::Handle*> _handles;
+    std::vector<segment_v2::SegmentSharedPtr> _segments;
+
+    // Don't allow copy and assign
+    DISALLOW_COPY_AND_ASSIGN(SegmentCacheHandle);
+};
+
+} // namespace doris
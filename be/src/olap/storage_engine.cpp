@@ -152,10 +152,22 @@ StorageEngine::~StorageEngine() {
 }
 
 void StorageEngine::load_data_dirs(const std::vector<DataDir*>& data_dirs) {
+    MonotonicStopWatch watch;
+    watch.start();
+    std::unique_ptr<ThreadPool> load_pool;
+    Status st = ThreadPoolBuilder("TabletMetaLoadThreadPool")
+                        .set_min_threads(1)
+                        .set_max_threads(std::max(1, config::load_tablet_meta_thread_num))
+                        .build(&load_pool);
+    if (!st.ok()) {
+        // load the metas in the threads of data dirs
+        LOG(WARNING) << "failed to create tablet meta load thread pool: " << st.to_string();
+    }
+
     std::vector<std::thread> threads;
     for (auto data_dir : data_dirs) {
-        threads.emplace_back([data_dir] {
-            auto res = data_dir->load();
+        threads.emplace_back([data_dir, &load_pool] {
+            auto res = data_dir->load(load_pool.get());
             if (res != OLAP_SUCCESS) {
                 LOG(WARNING) << "io error when init load tables. res=" << res
                              << ", data dir=" << data_dir->path();
@@ -166,6 +178,11 @@ void StorageEngine::load_data_dirs(const std::vector<DataDir*>& data_dirs) {
     for (auto& thread : threads) {
         thread.join();
     }
+    if (load_pool != nullptr) {
+        load_pool->shutdown();
+    }
+    LOG(INFO) << "load data dirs finished, data dirs: " << data_dirs.size()
+              << ", cost(ms): " << watch.elapsed_time() / 1000000;
 }
 
 Status StorageEngine::_open() {
@@ -0,0 +1,44 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/substring_filter.h"
+
+namespace doris {
+
+void SubstringFilter::parse_like_pattern(const std::string& pattern,
+                                         std::vector<std::string>* literals) {
+    std::string literal;
+    bool is_escaped = false;
+    for (char c : pattern) {
+        if (!is_escaped && (c == '%' || c == '_')) {
+            if (!literal.empty()) {
+                literals->push_back(std::move(literal));
+                literal.clear();
+            }
+        } else if (!is_escaped && c == '\\') {
+            is_escaped = true;
+        } else {
+            literal.push_back(c);
+            is_escaped = false;
+        }
+    }
+    if (!literal.empty()) {
+        literals->push_back(std::move(literal));
+    }
+}
+
+} // namespace doris
@@ -0,0 +1,38 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace doris {
+
+// Substrings that every value of a string column must contain to satisfy the conjuncts of a
+// scan, extracted from its LIKE '%substr%', instr() and locate() conjuncts. A segment tests
+// them against the ngram bloom filter index of the column to skip the pages in which no value
+// can contain all of them. The conjuncts are still evaluated on the rows read.
+struct SubstringFilter {
+    std::string column_name;
+    std::vector<std::string> substrings;
+
+    // Append the literal pieces between the wildcards '%' and '_' of a LIKE pattern to
+    // `literals', with '\' escaping the next character.
+    static void parse_like_pattern(const std::string& pattern, std::vector<std::string>* literals);
+};
+
+} // namespace doris
@@ -111,7 +111,11 @@ TabletMeta::TabletMeta(int64_t table_id, int64_t partition_id, int64_t tablet_id
                     DCHECK_EQ(index.columns.size(), 1);
                     if (boost::iequals(tcolumn.column_name, index.columns[0])) {
                         column->set_has_bitmap_index(true);
-                        break;
+                    }
+                } else if (index.index_type == TIndexType::type::NGRAM_BF) {
+                    DCHECK_EQ(index.columns.size(), 1);
+                    if (boost::iequals(tcolumn.column_name, index.columns[0])) {
+                        column->set_has_ngram_bf_index(true);
                     }
                 }
             }
@@ -312,6 +312,11 @@ void TabletColumn::init_from_pb(const ColumnPB& column) {
     } else {
         _has_bitmap_index = false;
     }
+    if (column.has_has_ngram_bf_index()) {
+        _has_ngram_bf_index = column.has_ngram_bf_index();
+    } else {
+        _has_ngram_bf_index = false;
+    }
     _has_referenced_column = column.has_referenced_column_id();
     if (_has_referenced_column) {
         _referenced_column_id = column.referenced_column_id();
@@ -355,6 +360,9 @@ void TabletColumn::to_schema_pb(ColumnPB* column) {
     if (_has_bitmap_index) {
         column->set_has_bitmap_index(_has_bitmap_index);
     }
+    if (_has_ngram_bf_index) {
+        column->set_has_ngram_bf_index(_has_ngram_bf_index);
+    }
     column->set_visible(_visible);
 
     if (_type == FieldType::OLAP_FIELD_TYPE_ARRAY) {
@@ -504,6 +512,7 @@ bool operator==(const TabletColumn& a, const TabletColumn& b) {
         if (a._referenced_column != b._referenced_column) return false;
     }
     if (a._has_bitmap_index != b._has_bitmap_index) return false;
+    if (a._has_ngram_bf_index != b._has_ngram_bf_index) return false;
     return true;
 }
 
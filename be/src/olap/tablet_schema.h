@@ -46,6 +46,7 @@ public:
     inline bool is_nullable() const { return _is_nullable; }
     inline bool is_bf_column() const { return _is_bf_column; }
     inline bool has_bitmap_index() const { return _has_bitmap_index; }
+    inline bool has_ngram_bf_index() const { return _has_ngram_bf_index; }
     bool has_default_value() const { return _has_default_value; }
     std::string default_value() const { return _default_value; }
     bool has_reference_column() const { return _has_referenced_column; }
@@ -100,6 +101,7 @@ private:
     std::string _referenced_column;
 
     bool _has_bitmap_index = false;
+    bool _has_ngram_bf_index = false;
     bool _visible = true;
 
     TabletColumn* _parent = nullptr;
@@ -0,0 +1,89 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <mutex>
+#include <string>
+
+#include "gen_cpp/PaloInternalService_types.h"
+#include "runtime/primitive_type.h"
+
+namespace doris {
+
+// A bound on the first ordering column of a TopN, published by the TopN operator once it
+// holds limit rows. Only rows at or before the bound in sort order can still enter the
+// result, so the scan below it uses the bound as a zone map condition when it opens a
+// segment, skipping the segments and pages that can not reach it.
+// The bound only gets tighter, a scan that reads a stale one reads more rows than needed.
+class TopNFilter {
+public:
+    TopNFilter(std::string column_name, bool is_asc_order)
+            : _column_name(std::move(column_name)), _op(is_asc_order ? "<=" : ">=") {}
+
+    // The bound is passed as text, which has to be exact for the column type. FLOAT and
+    // DOUBLE values are printed with only 6 decimal places, and a rounded bound could skip
+    // pages holding rows that beat the real one.
+    static bool is_supported_type(PrimitiveType type) {
+        switch (type) {
+        case TYPE_TINYINT:
+        case TYPE_SMALLINT:
+        case TYPE_INT:
+        case TYPE_BIGINT:
+        case TYPE_LARGEINT:
+        case TYPE_DATE:
+        case TYPE_DATETIME:
+        case TYPE_DECIMALV2:
+        case TYPE_CHAR:
+        case TYPE_VARCHAR:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    const std::string& column_name() const { return _column_name; }
+
+    void update(std::string value) {
+        std::lock_guard<std::mutex> l(_lock);
+        _value = std::move(value);
+        _has_value = true;
+    }
+
+    // Returns false if no bound has been published yet.
+    bool get_condition(TCondition* condition) const {
+        std::lock_guard<std::mutex> l(_lock);
+        if (!_has_value) {
+            return false;
+        }
+        condition->column_name = _column_name;
+        condition->condition_op = _op;
+        condition->condition_values.clear();
+        condition->condition_values.push_back(_value);
+        return true;
+    }
+
+private:
+    const std::string _column_name;
+    const std::string _op;
+
+    mutable std::mutex _lock;
+    std::string _value;
+    bool _has_value = false;
+};
+
+} // namespace doris
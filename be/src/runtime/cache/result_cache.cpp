@@ -71,6 +71,22 @@ void ResultNodeList::clear() {
     }
     _node_count = 0;
 }
+ResultCache::ResultCache(int32 max_size, int32 elasticity_size)
+        : _mem_tracker(MemTracker::CreateTracker(-1, "ResultCache", nullptr, true, false,
+                                                 MemTrackerLevel::OVERVIEW)),
+          _max_size(static_cast<int64_t>(max_size) * 1024 * 1024),
+          _elasticity_size(static_cast<int64_t>(elasticity_size) * 1024 * 1024),
+          _node_count(0),
+          _partition_count(0) {}
+
+ResultCache::~ResultCache() {
+    for (auto& shard : _shards) {
+        shard.node_list.clear();
+        shard.node_map.clear();
+    }
+    _mem_tracker->Release(_mem_tracker->consumption());
+}
+
 /**
  * Find the node and update partition data
  * New node, the node updated in the first partition will move to the tail of the list
@@ -82,28 +98,34 @@ void ResultCache::update(const PUpdateCacheRequest* request, PCacheResponse* res
     UniqueId sql_key = request->sql_key();
     LOG(INFO) << "update cache, sql key:" << sql_key;
 
-    CacheWriteLock write_lock(_cache_mtx);
-    auto it = _node_map.find(sql_key);
-    if (it != _node_map.end()) {
-        node = it->second;
-        _cache_size -= node->get_data_size();
-        _partition_count -= node->get_partition_count();
-        status = node->update_partition(request, update_first);
-    } else {
-        node = _node_list.new_node(sql_key);
-        status = node->update_partition(request, update_first);
-        _node_list.push_back(node);
-        _node_map[sql_key] = node;
-        _node_count += 1;
-    }
-    if (update_first) {
-        _node_list.move_tail(node);
+    int shard_idx = shard_index(sql_key);
+    CacheShard& shard = _shards[shard_idx];
+    {
+        CacheWriteLock write_lock(shard.cache_mtx);
+        int64_t old_data_size = 0;
+        int64_t old_partition_count = 0;
+        auto it = shard.node_map.find(sql_key);
+        if (it != shard.node_map.end()) {
+            node = it->second;
+            old_data_size = node->get_data_size();
+            old_partition_count = node->get_partition_count();
+            status = node->update_partition(request, update_first);
+        } else {
+            node = shard.node_list.new_node(sql_key);
+            status = node->update_partition(request, update_first);
+            shard.node_list.push_back(node);
+            shard.node_map[sql_key] = node;
+            _node_count += 1;
+        }
+        if (update_first) {
+            shard.node_list.move_tail(node);
+        }
+        _mem_tracker->Consume(static_cast<int64_t>(node->get_data_size()) - old_data_size);
+        _partition_count += static_cast<int64_t>(node->get_partition_count()) - old_partition_count;
     }
-    _cache_size += node->get_data_size();
-    _partition_count += node->get_partition_count();
     response->set_status(status);
 
-    prune();
+    prune(shard_idx);
     update_monitor();
 }
 
@@ -112,13 +134,13 @@ void ResultCache::update(const PUpdateCacheRequest* request, PCacheResponse* res
  */
 void ResultCache::fetch(const PFetchCacheRequest* request, PFetchCacheResult* result) {
     bool hit_first = false;
-    ResultNodeMap::iterator node_it;
     const UniqueId sql_key = request->sql_key();
     LOG(INFO) << "fetch cache, sql key:" << sql_key;
+    CacheShard& shard = _shards[shard_index(sql_key)];
     {
-        CacheReadLock read_lock(_cache_mtx);
-        node_it = _node_map.find(sql_key);
-        if (node_it == _node_map.end()) {
+        CacheReadLock read_lock(shard.cache_mtx);
+        auto node_it = shard.node_map.find(sql_key);
+        if (node_it == shard.node_map.end()) {
             result->set_status(PCacheStatus::NO_SQL_KEY);
             LOG(INFO) << "no such sql key:" << sql_key;
             return;
@@ -147,14 +169,19 @@ void ResultCache::fetch(const PFetchCacheRequest* request, PFetchCacheResult* re
     }
 
     if (hit_first) {
-        CacheWriteLock write_lock(_cache_mtx);
-        _node_list.move_tail(node_it->second);
+        // the node may have been pruned after the read lock was released
+        CacheWriteLock write_lock(shard.cache_mtx);
+        auto node_it = shard.node_map.find(sql_key);
+        if (node_it != shard.node_map.end()) {
+            shard.node_list.move_tail(node_it->second);
+        }
     }
 }
 
 bool ResultCache::contains(const UniqueId& sql_key) {
-    CacheReadLock read_lock(_cache_mtx);
-    return _node_map.find(sql_key) != _node_map.end();
+    CacheShard& shard = _shards[shard_index(sql_key)];
+    CacheReadLock read_lock(shard.cache_mtx);
+    return shard.node_map.find(sql_key) != shard.node_map.end();
 }
 
 /**
@@ -166,20 +193,26 @@ bool ResultCache::contains(const UniqueId& sql_key) {
  * };
  */
 void ResultCache::clear(const PClearCacheRequest* request, PCacheResponse* response) {
-    LOG(INFO) << "clear cache type" << request->clear_type()
-              << ", node size:" << _node_list.get_node_count() << ", map size:" << _node_map.size();
-    CacheWriteLock write_lock(_cache_mtx);
+    LOG(INFO) << "clear cache type" << request->clear_type() << ", node size:" << _node_count
+              << ", partition size:" << _partition_count;
     //0 clear, 1 prune, 2 before_time,3 sql_key
     switch (request->clear_type()) {
     case PClearType::CLEAR_ALL:
-        _node_list.clear();
-        _node_map.clear();
-        _cache_size = 0;
-        _node_count = 0;
-        _partition_count = 0;
+        for (auto& shard : _shards) {
+            CacheWriteLock write_lock(shard.cache_mtx);
+            int64_t shard_size = 0;
+            for (auto& node : shard.node_map) {
+                shard_size += node.second->get_data_size();
+                _partition_count -= node.second->get_partition_count();
+            }
+            _node_count -= shard.node_map.size();
+            shard.node_list.clear();
+            shard.node_map.clear();
+            _mem_tracker->Release(shard_size);
+        }
         break;
     case PClearType::PRUNE_CACHE:
-        prune();
+        prune(0);
         break;
     default:
         break;
@@ -206,6 +239,20 @@ ResultNode* find_min_time_node(ResultNode* result_node) {
     return result_node;
 }
 
+void ResultCache::prune(int start_shard) {
+    if (_mem_tracker->consumption() <= _max_size + _elasticity_size) {
+        return;
+    }
+    LOG(INFO) << "begin prune cache, cache_size : " << _mem_tracker->consumption()
+              << ", max_size : " << _max_size << ", elasticity_size : " << _elasticity_size;
+    for (int i = 0; i < NUM_SHARDS && _mem_tracker->consumption() > _max_size; ++i) {
+        CacheShard& shard = _shards[(start_shard + i) % NUM_SHARDS];
+        CacheWriteLock write_lock(shard.cache_mtx);
+        prune_shard(&shard);
+    }
+    LOG(INFO) << "finish prune, cache_size : " << _mem_tracker->consumption();
+}
+
 /*
 * Two-dimensional array, prune the min last_read_time PartitionRowBatch.
 * The following example is the last read time array.
@@ -220,19 +267,16 @@ ResultNode* find_min_time_node(ResultNode* result_node) {
 *   4,3,6,8
 *   5,7,9,11,13 //_tail
 */
-void ResultCache::prune() {
-    if (_cache_size <= (_max_size + _elasticity_size)) {
-        return;
-    }
-    LOG(INFO) << "begin prune cache, cache_size : " << _cache_size << ", max_size : " << _max_size
-              << ", elasticity_size : " << _elasticity_size;
-    ResultNode* result_node = _node_list.get_head();
-    while (_cache_size > _max_size) {
+void ResultCache::prune_shard(CacheShard* shard) {
+    ResultNode* result_node = shard->node_list.get_head();
+    while (_mem_tracker->consumption() > _max_size) {
         if (result_node == NULL) {
             break;
         }
         result_node = find_min_time_node(result_node);
-        _cache_size -= result_node->prune_first();
+        size_t partition_count = result_node->get_partition_count();
+        _mem_tracker->Release(result_node->prune_first());
+        _partition_count -= partition_count - result_node->get_partition_count();
         if (result_node->get_data_size() == 0) {
             ResultNode* next_node;
             if (result_node->get_next()) {
@@ -240,33 +284,28 @@ void ResultCache::prune() {
             } else if (result_node->get_prev()) {
                 next_node = result_node->get_prev();
             } else {
-                next_node = _node_list.get_head();
+                next_node = NULL;
             }
-            remove(result_node);
+            remove(shard, result_node);
             result_node = next_node;
         }
     }
-    LOG(INFO) << "finish prune, cache_size : " << _cache_size;
-    _node_count = _node_map.size();
-    _cache_size = 0;
-    _partition_count = 0;
-    for (auto node_it = _node_map.begin(); node_it != _node_map.end(); node_it++) {
-        _partition_count += node_it->second->get_partition_count();
-        _cache_size += node_it->second->get_data_size();
-    }
 }
 
-void ResultCache::remove(ResultNode* result_node) {
-    auto node_it = _node_map.find(result_node->get_sql_key());
-    if (node_it != _node_map.end()) {
-        _node_map.erase(node_it);
-        _node_list.remove(result_node);
-        _node_list.delete_node(&result_node);
+void ResultCache::remove(CacheShard* shard, ResultNode* result_node) {
+    auto node_it = shard->node_map.find(result_node->get_sql_key());
+    if (node_it != shard->node_map.end()) {
+        _partition_count -= result_node->get_partition_count();
+        _node_count -= 1;
+        shard->node_map.erase(node_it);
+        shard->node_list.remove(result_node);
+        shard->node_list.delete_node(&result_node);
     }
 }
 
 void ResultCache::update_monitor() {
-    DorisMetrics::instance()->query_cache_memory_total_byte->set_value(_cache_size);
+    DorisMetrics::instance()->query_cache_memory_total_byte->set_value(
+            _mem_tracker->consumption());
     DorisMetrics::instance()->query_cache_sql_total_count->set_value(_node_count);
     DorisMetrics::instance()->query_cache_partition_total_count->set_value(_partition_count);
 }
@@ -18,6 +18,7 @@
 #ifndef DORIS_BE_SRC_RUNTIME_RESULT_CACHE_H
 #define DORIS_BE_SRC_RUNTIME_RESULT_CACHE_H
 
+#include <atomic>
 #include <boost/thread.hpp>
 #include <cassert>
 #include <cstdio>
@@ -73,44 +74,54 @@ private:
 
 /**
  * Cache results of query, including the entire result set or the result set of divided partitions.
- * Two data structures, one is unordered_map and the other is a doubly linked list, corresponding to a result node.
- * If the cache is hit, the node will be moved to the end of the linked list.
+ * The sql keys are spread over NUM_SHARDS shards, each with its own lock, unordered_map and
+ * doubly linked list, so requests of different sqls don't contend on a single lock.
+ * If the cache is hit, the node will be moved to the end of the linked list of its shard.
  * If the cache is cleared, nodes that are expired or have not been accessed for a long time will be cleared.
+ * The size of all cached partitions is accounted in a MemTracker.
  */
 class ResultCache {
 public:
-    ResultCache(int32 max_size, int32 elasticity_size) {
-        _max_size = max_size * 1024 * 1024;
-        _elasticity_size = elasticity_size * 1024 * 1024;
-        _cache_size = 0;
-        _node_count = 0;
-        _partition_count = 0;
-    }
+    ResultCache(int32 max_size, int32 elasticity_size);
 
-    virtual ~ResultCache() {}
+    virtual ~ResultCache();
     void update(const PUpdateCacheRequest* request, PCacheResponse* response);
     void fetch(const PFetchCacheRequest* request, PFetchCacheResult* result);
     bool contains(const UniqueId& sql_key);
     void clear(const PClearCacheRequest* request, PCacheResponse* response);
 
-    size_t get_cache_size() { return _cache_size; }
+    size_t get_cache_size() { return _mem_tracker->consumption(); }
 
 private:
-    void prune();
-    void remove(ResultNode* result_node);
+    static constexpr int NUM_SHARDS = 16;
+
+    struct CacheShard {
+        //At the same time, multithreaded reading
+        //Single thread updating and cleaning(only single be, Fe is not affected)
+        mutable std::shared_mutex cache_mtx;
+        ResultNodeMap node_map;
+        //List of result nodes corresponding to SqlKey,last recently used at the tail
+        ResultNodeList node_list;
+    };
+
+    int shard_index(const UniqueId& sql_key) const {
+        return std::hash<UniqueId>()(sql_key) % NUM_SHARDS;
+    }
+
+    // prune shards one by one, beginning with 'start_shard', until the cache fits in
+    // max size again
+    void prune(int start_shard);
+    // the write lock of 'shard' must be held
+    void prune_shard(CacheShard* shard);
+    void remove(CacheShard* shard, ResultNode* result_node);
     void update_monitor();
 
-    //At the same time, multithreaded reading
-    //Single thread updating and cleaning(only single be, Fe is not affected)
-    mutable std::shared_mutex _cache_mtx;
-    ResultNodeMap _node_map;
-    //List of result nodes corresponding to SqlKey,last recently used at the tail
-    ResultNodeList _node_list;
-    size_t _cache_size;
-    size_t _max_size;
-    double _elasticity_size;
-    size_t _node_count;
-    size_t _partition_count;
+    CacheShard _shards[NUM_SHARDS];
+    std::shared_ptr<MemTracker> _mem_tracker;
+    int64_t _max_size;
+    int64_t _elasticity_size;
+    std::atomic<int64_t> _node_count;
+    std::atomic<int64_t> _partition_count;
 
 private:
     ResultCache();
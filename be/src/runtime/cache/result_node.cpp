@@ -36,7 +36,7 @@ void PartitionRowBatch::set_row_batch(const PCacheValue& value) {
     }
     SAFE_DELETE(_cache_value);
     _cache_value = new PCacheValue(value);
-    _data_size += _cache_value->data_size();
+    _data_size = _cache_value->data_size();
     _cache_stat.update();
     LOG(INFO) << "finish set row batch, row num:" << _cache_value->rows_size()
               << ", data size:" << _data_size;
@@ -174,6 +174,8 @@ PCacheStatus ResultNode::update_partition_cache(const PUpdateCacheRequest *reque
 * Partition cache : 20191211-20191215
 * Hit cache parameter : [20191211 - 20191215], [20191212 - 20191214], [20191212 - 20191216],[20191210 - 20191215]
 * Miss cache parameter: [20191210 - 20191216]
+* A partition with a newer version than the cached one ends the hit range, so a query whose
+* newest partition keeps loading is answered from the older partitions plus a scan of the newest.
 */
 PCacheStatus ResultNode::fetch_partition(const PFetchCacheRequest* request,
                                          PartitionRowBatchList& row_batch_list,
@@ -251,9 +253,17 @@ PCacheStatus ResultNode::fetch_partition(const PFetchCacheRequest* request,
                 param_idx++;
                 part_it++;
                 find = false;
+            } else if (begin_idx >= 0) {
+                // A newer version of this partition was loaded, e.g. today's partition of a
+                // time series. The range cached before it still answers the query and only the
+                // rest of the partitions are scanned again.
+                break;
             } else {
+                // stale partitions ahead of the cached range are scanned again as well
                 status = PCacheStatus::DATA_OVERDUE;
-                break;
+                param_idx++;
+                part_it++;
+                find = false;
             }
         }
     }
@@ -261,6 +271,7 @@ PCacheStatus ResultNode::fetch_partition(const PFetchCacheRequest* request,
     if (begin_it == _partition_list.end() && end_it == _partition_list.end()) {
         return status;
     }
+    status = PCacheStatus::CACHE_OK;
 
     //[20191210 - 20191216] hit partition range [20191212-20191214],the sql will be splited to 3 part!
     if (begin_idx != 0 && end_idx != request->params_size() - 1) {
@@ -307,6 +318,7 @@ void ResultNode::clear() {
         SAFE_DELETE(*it);
         it = _partition_list.erase(it);
     }
+    _partition_map.clear();
     _data_size = 0;
 }
 
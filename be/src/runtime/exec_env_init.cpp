@@ -26,6 +26,7 @@
 #include "gen_cpp/TExtDataSourceService.h"
 #include "gen_cpp/TPaloBrokerService.h"
 #include "olap/page_cache.h"
+#include "olap/segment_loader.h"
 #include "olap/storage_engine.h"
 #include "plugin/plugin_mgr.h"
 #include "runtime/broker_mgr.h"
@@ -204,6 +205,7 @@ Status ExecEnv::_init_mem_tracker() {
     }
     int32_t index_page_cache_percentage = config::index_page_cache_percentage;
     StoragePageCache::create_global_cache(storage_cache_limit, index_page_cache_percentage);
+    SegmentLoader::create_global_instance(config::segment_cache_capacity);
 
     REGISTER_HOOK_METRIC(query_mem_consumption, [this]() {
       return _mem_tracker->consumption();
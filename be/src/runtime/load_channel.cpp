@@ -128,6 +128,24 @@ void LoadChannel::handle_mem_exceed_limit(bool force) {
     }
 }
 
+void LoadChannel::get_memtable_consumptions(std::vector<MemTableConsumption>* consumptions) {
+    std::vector<std::shared_ptr<TabletsChannel>> channels;
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        for (auto& it : _tablets_channels) {
+            channels.push_back(it.second);
+        }
+    }
+    std::vector<std::pair<int64_t, int64_t>> tablet_consumptions;
+    for (auto& channel : channels) {
+        tablet_consumptions.clear();
+        channel->get_memtable_consumptions(&tablet_consumptions);
+        for (auto& it : tablet_consumptions) {
+            consumptions->push_back({channel, it.first, it.second});
+        }
+    }
+}
+
 // lock should be held when calling this method
 bool LoadChannel::_find_largest_consumption_channel(std::shared_ptr<TabletsChannel>* channel) {
     int64_t max_consume = 0;
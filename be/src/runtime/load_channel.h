@@ -21,6 +21,7 @@
 #include <ostream>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include "common/status.h"
 #include "gen_cpp/PaloInternalService_types.h"
@@ -34,6 +35,13 @@ namespace doris {
 class Cache;
 class TabletsChannel;
 
+// memory of the memtable being written to a tablet of a tablets channel
+struct MemTableConsumption {
+    std::shared_ptr<TabletsChannel> channel;
+    int64_t tablet_id;
+    int64_t mem_consumption;
+};
+
 // A LoadChannel manages tablets channels for all indexes
 // corresponding to a certain load job
 class LoadChannel {
@@ -64,6 +72,10 @@ public:
     // try to reduce memory.
     void handle_mem_exceed_limit(bool force);
 
+    // append the memory of the memtables being written by all tablets channels of this
+    // load channel to 'consumptions'.
+    void get_memtable_consumptions(std::vector<MemTableConsumption>* consumptions);
+
     int64_t mem_consumption() const { return _mem_tracker->consumption(); }
 
     int64_t timeout() const { return _timeout_s; }
@@ -17,6 +17,10 @@
 
 #include "runtime/load_channel_mgr.h"
 
+#include <algorithm>
+#include <map>
+#include <vector>
+
 #include "gutil/strings/substitute.h"
 #include "olap/lru_cache.h"
 #include "runtime/load_channel.h"
@@ -169,31 +173,114 @@ Status LoadChannelMgr::add_batch(const PTabletWriterAddBatchRequest& request,
 }
 
 void LoadChannelMgr::_handle_mem_exceed_limit() {
-    // lock so that only one thread can check mem limit
-    std::lock_guard<std::mutex> l(_lock);
-    if (!_mem_tracker->limit_exceeded()) {
+    int64_t limit = _mem_tracker->limit();
+    if (limit < 0) {
+        return;
+    }
+    int64_t soft_limit = limit * config::load_process_soft_mem_limit_percent / 100;
+    if (_mem_tracker->consumption() <= soft_limit) {
         return;
     }
 
-    int64_t max_consume = 0;
-    std::shared_ptr<LoadChannel> channel;
-    for (auto& kv : _load_channels) {
-        if (kv.second->mem_consumption() > max_consume) {
-            max_consume = kv.second->mem_consumption();
-            channel = kv.second;
+    // Below the hard limit, other threads go on writing while one thread is picking
+    // memtables to flush. Beyond it, they all wait for memtables to be flushed.
+    std::unique_lock<std::mutex> l(_reduce_mem_lock, std::defer_lock);
+    if (!_mem_tracker->limit_exceeded()) {
+        if (l.try_lock()) {
+            _reduce_mem_usage(soft_limit, false);
         }
+        return;
     }
-    if (max_consume == 0) {
-        // should not happen, add log to observe
-        LOG(WARNING) << "failed to find suitable load channel when total load mem limit exceed";
+    MonotonicStopWatch timer;
+    timer.start();
+    l.lock();
+    _reduce_mem_usage(soft_limit, _mem_tracker->limit_exceeded());
+    DorisMetrics::instance()->load_mem_limit_stall_duration_us->increment(
+            timer.elapsed_time() / 1000);
+}
+
+void LoadChannelMgr::_reduce_mem_usage(int64_t soft_limit, bool need_wait) {
+    int64_t consumption = _mem_tracker->consumption();
+    if (consumption <= soft_limit) {
         return;
     }
-    DCHECK(channel.get() != nullptr);
 
-    // force reduce mem limit of the selected channel
-    LOG(INFO) << "reducing memory of " << *channel << " because total load mem consumption "
-              << _mem_tracker->consumption() << " has exceeded limit " << _mem_tracker->limit();
-    channel->handle_mem_exceed_limit(true);
+    std::vector<std::shared_ptr<LoadChannel>> channels;
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        for (auto& kv : _load_channels) {
+            channels.push_back(kv.second);
+        }
+    }
+    std::vector<MemTableConsumption> memtables;
+    for (auto& channel : channels) {
+        channel->get_memtable_consumptions(&memtables);
+    }
+
+    HistogramStat hist;
+    int64_t memtables_consumption = 0;
+    for (auto& memtable : memtables) {
+        if (memtable.mem_consumption > 0) {
+            hist.add(memtable.mem_consumption);
+            memtables_consumption += memtable.mem_consumption;
+        }
+    }
+    DorisMetrics::instance()->load_memtable_size_distribution->set_histogram(hist);
+
+    // The memory of the memtables in flush queue will be released without flushing more,
+    // so only the memtables being written count towards the bytes to flush.
+    int64_t bytes_to_flush = memtables_consumption - soft_limit;
+    if (bytes_to_flush <= 0 && !need_wait) {
+        return;
+    }
+    std::sort(memtables.begin(), memtables.end(),
+              [](const MemTableConsumption& lhs, const MemTableConsumption& rhs) {
+                  return lhs.mem_consumption > rhs.mem_consumption;
+              });
+    // tablets channel -> ids of the tablets to flush
+    std::map<std::shared_ptr<TabletsChannel>, std::vector<int64_t>> tablets_to_flush;
+    int64_t flushed_bytes = 0;
+    size_t num_flushed = 0;
+    for (auto& memtable : memtables) {
+        // flush at least one memtable when the hard limit is exceeded
+        if (memtable.mem_consumption == 0 ||
+            (flushed_bytes >= bytes_to_flush && (num_flushed > 0 || !need_wait))) {
+            break;
+        }
+        tablets_to_flush[memtable.channel].push_back(memtable.tablet_id);
+        flushed_bytes += memtable.mem_consumption;
+        ++num_flushed;
+    }
+    if (num_flushed > 0) {
+        LOG(INFO) << "flushing " << num_flushed << " memtables of " << flushed_bytes
+                  << " bytes because total load mem consumption " << consumption
+                  << " has exceeded soft limit " << soft_limit << ", hard limit "
+                  << _mem_tracker->limit() << ", memtables being written " << memtables.size()
+                  << " of " << memtables_consumption << " bytes";
+        DorisMetrics::instance()->load_mem_limit_memtable_flush_total->increment(num_flushed);
+        for (auto& it : tablets_to_flush) {
+            Status st = it.first->flush_memtables(it.second);
+            if (!st.ok()) {
+                LOG(WARNING) << "failed to flush memtables to reduce load mem consumption: "
+                             << st.get_error_msg();
+            }
+        }
+    } else if (need_wait) {
+        // the memory is in flush queue, or held by busy writers, wait for all of them instead
+        for (auto& memtable : memtables) {
+            tablets_to_flush[memtable.channel].push_back(memtable.tablet_id);
+        }
+    }
+    if (!need_wait) {
+        return;
+    }
+    for (auto& it : tablets_to_flush) {
+        Status st = it.first->wait_flush(it.second);
+        if (!st.ok()) {
+            LOG(WARNING) << "failed to wait memtable flush to reduce load mem consumption: "
+                         << st.get_error_msg();
+        }
+    }
 }
 
 Status LoadChannelMgr::cancel(const PTabletWriterCancelRequest& params) {
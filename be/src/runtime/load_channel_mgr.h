@@ -57,10 +57,15 @@ public:
     Status cancel(const PTabletWriterCancelRequest& request);
 
 private:
-    // check if the total load mem consumption exceeds limit.
-    // If yes, it will pick a load channel to try to reduce memory consumption.
+    // check if the total load mem consumption exceeds the soft limit.
+    // If yes, it will submit the largest memtables of all load channels to flush queue.
+    // The caller only waits for the flushes when the hard limit is exceeded.
     void _handle_mem_exceed_limit();
 
+    // flush the largest memtables until the mem consumption is expected to drop below
+    // 'soft_limit' once the flushes are done. _reduce_mem_lock should be held.
+    void _reduce_mem_usage(int64_t soft_limit, bool need_wait);
+
     Status _start_bg_worker();
 
 private:
@@ -69,6 +74,8 @@ private:
     // load id -> load channel
     std::unordered_map<UniqueId, std::shared_ptr<LoadChannel>> _load_channels;
     Cache* _last_success_channel = nullptr;
+    // lock so that only one thread picks memtables to flush at a time
+    std::mutex _reduce_mem_lock;
 
     // check the total load mem consumption of this Backend
     std::shared_ptr<MemTracker> _mem_tracker;
@@ -128,11 +128,14 @@ ChunkAllocator::ChunkAllocator(size_t reserve_limit)
     INT_COUNTER_METRIC_REGISTER(_chunk_allocator_metric_entity, chunk_pool_system_free_cost_ns);
 }
 
-bool ChunkAllocator::allocate(size_t size, Chunk* chunk) {
+bool ChunkAllocator::allocate(size_t size, Chunk* chunk, bool* from_cache) {
     // fast path: allocate from current core arena
     int core_id = CpuInfo::get_current_core();
     chunk->size = size;
     chunk->core_id = core_id;
+    if (from_cache != nullptr) {
+        *from_cache = true;
+    }
 
     if (_arenas[core_id]->pop_free_chunk(size, &chunk->data)) {
         _reserved_bytes.fetch_sub(size);
@@ -153,6 +156,9 @@ bool ChunkAllocator::allocate(size_t size, Chunk* chunk) {
         }
     }
 
+    if (from_cache != nullptr) {
+        *from_cache = false;
+    }
     int64_t cost_ns = 0;
     {
         SCOPED_RAW_TIMER(&cost_ns);
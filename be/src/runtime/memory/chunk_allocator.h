@@ -63,7 +63,9 @@ public:
     // Allocate a Chunk with a power-of-two length "size".
     // Return true if success and allocated chunk is saved in "chunk".
     // Otherwise return false.
-    bool allocate(size_t size, Chunk* chunk);
+    // If "from_cache" is not null, it's set to whether the chunk was a free one
+    // of some core arena rather than allocated from system.
+    bool allocate(size_t size, Chunk* chunk, bool* from_cache = nullptr);
 
     // Free chunk allocated from this allocator
     void free(const Chunk& chunk);
@@ -42,6 +42,8 @@
 #include "util/pretty_printer.h"
 #include "util/uid_util.h"
 
+#include "vec/common/exception.h"
+#include "vec/common/thread_mem_tracker.h"
 #include "vec/core/block.h"
 #include "vec/exec/vexchange_node.h"
 #include "vec/runtime/vdata_stream_mgr.h"
@@ -271,7 +273,18 @@ Status PlanFragmentExecutor::open() {
     }
     Status status = Status::OK();
     if (_runtime_state->enable_vectorized_exec()) {
-        status = open_vectorized_internal();
+        // The memory allocated by the vectorized engine is tracked by the allocator, which
+        // throws once the fragment would exceed its limit.
+        vectorized::ScopedThreadMemTracker scoped_tracker(_mem_tracker);
+        try {
+            status = open_vectorized_internal();
+        } catch (const vectorized::Exception& e) {
+            if (e.code() == TStatusCode::MEM_LIMIT_EXCEEDED) {
+                status = Status::MemoryLimitExceeded(e.message());
+            } else {
+                status = Status::InternalError(e.message());
+            }
+        }
     } else {
         status = open_internal();
     }
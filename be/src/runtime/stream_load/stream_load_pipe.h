@@ -154,6 +154,9 @@ public:
 
     int64_t size() override { return 0; }
 
+    // -1 if the data is read as separate messages, see read_one_message().
+    int64_t total_length() const { return _total_length; }
+
     Status seek(int64_t position) override { return Status::InternalError("Not implemented"); }
 
     Status tell(int64_t* position) override { return Status::InternalError("Not implemented"); }
@@ -72,6 +72,7 @@ Status TabletsChannel::open(const PTabletWriterOpenRequest& params) {
     RETURN_IF_ERROR(_open_all_writers(params));
 
     _state = kOpened;
+    _writers_opened = true;
     return Status::OK();
 }
 
@@ -208,6 +209,58 @@ Status TabletsChannel::reduce_mem_usage() {
     return Status::OK();
 }
 
+void TabletsChannel::get_memtable_consumptions(
+        std::vector<std::pair<int64_t, int64_t>>* consumptions) {
+    // _lock is held while this channel waits for flushes, not to wait for it. _tablet_writers
+    // is not changed once the writers are opened, like in add_batch().
+    if (!_writers_opened) {
+        return;
+    }
+    for (auto& it : _tablet_writers) {
+        consumptions->emplace_back(it.first, it.second->memtable_consumption());
+    }
+}
+
+Status TabletsChannel::flush_memtables(const std::vector<int64_t>& tablet_ids) {
+    std::lock_guard<std::mutex> l(_lock);
+    if (_state == kFinished) {
+        return _close_status;
+    }
+    for (int64_t tablet_id : tablet_ids) {
+        auto it = _tablet_writers.find(tablet_id);
+        if (it == _tablet_writers.end()) {
+            continue;
+        }
+        OLAPStatus st = it->second->flush_memtable_and_wait(false);
+        if (st != OLAP_SUCCESS) {
+            std::stringstream ss;
+            ss << "failed to flush memtable of tablet " << tablet_id << ". err: " << st;
+            return Status::InternalError(ss.str());
+        }
+    }
+    return Status::OK();
+}
+
+Status TabletsChannel::wait_flush(const std::vector<int64_t>& tablet_ids) {
+    std::lock_guard<std::mutex> l(_lock);
+    if (_state == kFinished) {
+        return _close_status;
+    }
+    for (int64_t tablet_id : tablet_ids) {
+        auto it = _tablet_writers.find(tablet_id);
+        if (it == _tablet_writers.end()) {
+            continue;
+        }
+        OLAPStatus st = it->second->wait_flush();
+        if (st != OLAP_SUCCESS) {
+            std::stringstream ss;
+            ss << "failed to wait memtable flush of tablet " << tablet_id << ". err: " << st;
+            return Status::InternalError(ss.str());
+        }
+    }
+    return Status::OK();
+}
+
 Status TabletsChannel::_open_all_writers(const PTabletWriterOpenRequest& params) {
     std::vector<SlotDescriptor*>* index_slots = nullptr;
     int32_t schema_hash = 0;
@@ -80,6 +80,19 @@ public:
     // no-op when this channel has been closed or cancelled
     Status reduce_mem_usage();
 
+    // append the memory of the memtable being written to each tablet of this channel
+    // to 'consumptions' as pairs of tablet id and bytes, without waiting for other operations.
+    // no-op when this channel is not opened
+    void get_memtable_consumptions(std::vector<std::pair<int64_t, int64_t>>* consumptions);
+
+    // submit the memtables of the given tablets to flush queue without waiting.
+    // no-op when this channel has been closed or cancelled
+    Status flush_memtables(const std::vector<int64_t>& tablet_ids);
+
+    // wait for all memtables of the given tablets in flush queue to be flushed.
+    // no-op when this channel has been closed or cancelled
+    Status wait_flush(const std::vector<int64_t>& tablet_ids);
+
     int64_t mem_consumption() const { return _mem_tracker->consumption(); }
 
 private:
@@ -118,6 +131,8 @@ private:
 
     // tablet_id -> TabletChannel
     std::unordered_map<int64_t, DeltaWriter*> _tablet_writers;
+    // set once all the writers are opened, _tablet_writers can be read without _lock then
+    std::atomic<bool> _writers_opened{false};
 
     std::unordered_set<int64_t> _partition_ids;
 
@@ -0,0 +1,267 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "util/arrow/block_convertor.h"
+
+#include <arrow/array.h>
+#include <arrow/buffer.h>
+#include <arrow/memory_pool.h>
+#include <arrow/record_batch.h>
+#include <arrow/status.h>
+#include <arrow/type.h>
+#include <arrow/util/bit_util.h>
+
+#include <limits>
+#include <memory>
+
+#include "common/logging.h"
+#include "gutil/strings/substitute.h"
+#include "util/arrow/utils.h"
+#include "vec/columns/column_decimal.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/column_string.h"
+#include "vec/columns/column_vector.h"
+#include "vec/common/assert_cast.h"
+#include "vec/common/string_buffer.hpp"
+#include "vec/common/typeid_cast.h"
+#include "vec/core/block.h"
+#include "vec/data_types/data_type_nullable.h"
+
+namespace doris {
+
+using strings::Substitute;
+
+// An Arrow buffer over the memory of a vectorized column. It holds a reference
+// to the column, so the memory is alive as long as the buffer is referenced.
+// Column is COW, the block owning the column can not modify it in place.
+class ColumnBuffer : public arrow::Buffer {
+public:
+    ColumnBuffer(vectorized::ColumnPtr column, const uint8_t* data, int64_t size)
+            : arrow::Buffer(data, size), _column(std::move(column)) {}
+
+private:
+    vectorized::ColumnPtr _column;
+};
+
+class FromBlockConverter {
+public:
+    FromBlockConverter(const vectorized::Block& block, const std::shared_ptr<arrow::Schema>& schema,
+                       arrow::MemoryPool* pool)
+            : _block(block), _schema(schema), _pool(pool) {}
+
+    Status convert(std::shared_ptr<arrow::RecordBatch>* out);
+
+private:
+    // Convert the null map of a nullable column to an Arrow validity bitmap.
+    // The bitmap is left empty when there is no null value.
+    Status _convert_null_map(const vectorized::ColumnNullable& column,
+                             std::shared_ptr<arrow::Buffer>* bitmap, int64_t* null_count);
+
+    template <typename ColumnType>
+    Status _convert_fixed_width(const vectorized::ColumnPtr& column,
+                                const std::shared_ptr<arrow::DataType>& type,
+                                const std::shared_ptr<arrow::Buffer>& bitmap, int64_t null_count,
+                                std::shared_ptr<arrow::Array>* out);
+
+    Status _convert_string(const vectorized::ColumnString& column,
+                           const std::shared_ptr<arrow::Buffer>& bitmap, int64_t null_count,
+                           std::shared_ptr<arrow::Array>* out);
+
+    Status _convert_column(const vectorized::ColumnPtr& column,
+                           const vectorized::DataTypePtr& data_type,
+                           const std::shared_ptr<arrow::DataType>& type,
+                           std::shared_ptr<arrow::Array>* out);
+
+private:
+    const vectorized::Block& _block;
+    const std::shared_ptr<arrow::Schema>& _schema;
+    arrow::MemoryPool* _pool;
+};
+
+Status FromBlockConverter::_convert_null_map(const vectorized::ColumnNullable& column,
+                                             std::shared_ptr<arrow::Buffer>* bitmap,
+                                             int64_t* null_count) {
+    const auto& null_map = column.get_null_map_data();
+    size_t num_rows = null_map.size();
+    *null_count = 0;
+    for (size_t i = 0; i < num_rows; ++i) {
+        *null_count += null_map[i];
+    }
+    if (*null_count == 0) {
+        return Status::OK();
+    }
+
+    RETURN_IF_ERROR(to_status(
+            arrow::AllocateBuffer(_pool, arrow::BitUtil::BytesForBits(num_rows), bitmap)));
+    uint8_t* bits = (*bitmap)->mutable_data();
+    memset(bits, 0, (*bitmap)->size());
+    for (size_t i = 0; i < num_rows; ++i) {
+        if (!null_map[i]) {
+            arrow::BitUtil::SetBit(bits, i);
+        }
+    }
+    return Status::OK();
+}
+
+template <typename ColumnType>
+Status FromBlockConverter::_convert_fixed_width(const vectorized::ColumnPtr& column,
+                                                const std::shared_ptr<arrow::DataType>& type,
+                                                const std::shared_ptr<arrow::Buffer>& bitmap,
+                                                int64_t null_count,
+                                                std::shared_ptr<arrow::Array>* out) {
+    const auto* data_column = typeid_cast<const ColumnType*>(column.get());
+    if (data_column == nullptr) {
+        return Status::InvalidArgument(
+                Substitute("column $0 does not match arrow type $1", column->get_name(),
+                           type->ToString()));
+    }
+    const auto& data = data_column->get_data();
+    // share the memory of column, there is no copy of values
+    auto values = std::make_shared<ColumnBuffer>(
+            column, reinterpret_cast<const uint8_t*>(data.data()),
+            data.size() * sizeof(data[0]));
+    *out = arrow::MakeArray(
+            arrow::ArrayData::Make(type, data.size(), {bitmap, values}, null_count));
+    return Status::OK();
+}
+
+Status FromBlockConverter::_convert_string(const vectorized::ColumnString& column,
+                                           const std::shared_ptr<arrow::Buffer>& bitmap,
+                                           int64_t null_count,
+                                           std::shared_ptr<arrow::Array>* out) {
+    const auto& chars = column.get_chars();
+    const auto& offsets = column.get_offsets();
+    size_t num_rows = offsets.size();
+    // Every string of ColumnString is followed by a terminating zero, which
+    // Arrow does not have, so payloads are compacted with one copy per row.
+    size_t data_size = chars.size() - num_rows;
+    if (data_size > std::numeric_limits<int32_t>::max()) {
+        return Status::InvalidArgument(
+                Substitute("string column is too large for arrow, size=$0", data_size));
+    }
+
+    std::shared_ptr<arrow::Buffer> arrow_offsets;
+    std::shared_ptr<arrow::Buffer> arrow_data;
+    RETURN_IF_ERROR(to_status(
+            arrow::AllocateBuffer(_pool, (num_rows + 1) * sizeof(int32_t), &arrow_offsets)));
+    RETURN_IF_ERROR(to_status(arrow::AllocateBuffer(_pool, data_size, &arrow_data)));
+
+    auto* dst_offsets = reinterpret_cast<int32_t*>(arrow_offsets->mutable_data());
+    uint8_t* dst_data = arrow_data->mutable_data();
+    int32_t pos = 0;
+    for (size_t i = 0; i < num_rows; ++i) {
+        // offsets[-1] is 0 in PaddedPODArray
+        size_t begin = offsets[i - 1];
+        size_t size = offsets[i] - begin - 1;
+        dst_offsets[i] = pos;
+        memcpy(dst_data + pos, chars.data() + begin, size);
+        pos += size;
+    }
+    dst_offsets[num_rows] = pos;
+
+    *out = arrow::MakeArray(arrow::ArrayData::Make(arrow::utf8(), num_rows,
+                                                   {bitmap, arrow_offsets, arrow_data},
+                                                   null_count));
+    return Status::OK();
+}
+
+Status FromBlockConverter::_convert_column(const vectorized::ColumnPtr& column,
+                                           const vectorized::DataTypePtr& data_type,
+                                           const std::shared_ptr<arrow::DataType>& type,
+                                           std::shared_ptr<arrow::Array>* out) {
+    vectorized::ColumnPtr nested_column = column;
+    vectorized::DataTypePtr nested_type = data_type;
+    std::shared_ptr<arrow::Buffer> bitmap;
+    int64_t null_count = 0;
+    if (column->is_nullable()) {
+        const auto& nullable_column = assert_cast<const vectorized::ColumnNullable&>(*column);
+        nested_column = nullable_column.get_nested_column_ptr();
+        nested_type = vectorized::remove_nullable(data_type);
+        RETURN_IF_ERROR(_convert_null_map(nullable_column, &bitmap, &null_count));
+    }
+
+    switch (type->id()) {
+    case arrow::Type::INT8:
+        return _convert_fixed_width<vectorized::ColumnInt8>(nested_column, type, bitmap,
+                                                            null_count, out);
+    case arrow::Type::INT16:
+        return _convert_fixed_width<vectorized::ColumnInt16>(nested_column, type, bitmap,
+                                                             null_count, out);
+    case arrow::Type::INT32:
+        return _convert_fixed_width<vectorized::ColumnInt32>(nested_column, type, bitmap,
+                                                             null_count, out);
+    case arrow::Type::INT64:
+        return _convert_fixed_width<vectorized::ColumnInt64>(nested_column, type, bitmap,
+                                                             null_count, out);
+    case arrow::Type::FLOAT:
+        return _convert_fixed_width<vectorized::ColumnFloat32>(nested_column, type, bitmap,
+                                                               null_count, out);
+    case arrow::Type::DOUBLE:
+        return _convert_fixed_width<vectorized::ColumnFloat64>(nested_column, type, bitmap,
+                                                               null_count, out);
+    case arrow::Type::DECIMAL:
+        // DecimalV2 and arrow Decimal128(27, 9) share the same little-endian
+        // 128-bit layout, so the values can be used directly.
+        return _convert_fixed_width<vectorized::ColumnDecimal<vectorized::Decimal128>>(
+                nested_column, type, bitmap, null_count, out);
+    case arrow::Type::STRING: {
+        if (const auto* string_column =
+                    typeid_cast<const vectorized::ColumnString*>(nested_column.get())) {
+            return _convert_string(*string_column, bitmap, null_count, out);
+        }
+        // LARGEINT, DATE and DATETIME are sent as their text form
+        auto text_column = vectorized::ColumnString::create();
+        vectorized::VectorBufferWriter writer(*text_column);
+        for (size_t i = 0; i < nested_column->size(); ++i) {
+            nested_type->to_string(*nested_column, i, writer);
+            writer.commit();
+        }
+        return _convert_string(*text_column, bitmap, null_count, out);
+    }
+    default:
+        return Status::InvalidArgument(
+                Substitute("Unsupported arrow type $0 for vectorized block", type->ToString()));
+    }
+}
+
+Status FromBlockConverter::convert(std::shared_ptr<arrow::RecordBatch>* out) {
+    size_t num_fields = _schema->num_fields();
+    if (_block.columns() != num_fields) {
+        return Status::InvalidArgument("number fields not match");
+    }
+
+    std::vector<std::shared_ptr<arrow::Array>> arrays(num_fields);
+    for (size_t idx = 0; idx < num_fields; ++idx) {
+        const auto& column_with_type = _block.get_by_position(idx);
+        auto column = column_with_type.column->convert_to_full_column_if_const();
+        RETURN_IF_ERROR(_convert_column(column, column_with_type.type,
+                                        _schema->field(idx)->type(), &arrays[idx]));
+    }
+    *out = arrow::RecordBatch::Make(_schema, _block.rows(), std::move(arrays));
+    return Status::OK();
+}
+
+Status convert_to_arrow_batch(const vectorized::Block& block,
+                              const std::shared_ptr<arrow::Schema>& schema,
+                              arrow::MemoryPool* pool,
+                              std::shared_ptr<arrow::RecordBatch>* result) {
+    FromBlockConverter converter(block, schema, pool);
+    return converter.convert(result);
+}
+
+} // namespace doris
@@ -83,6 +83,10 @@ public:
         return cycles_per_ms_;
     }
 
+    /// Returns the size in bytes of the given cache level, or a value <= 0 if it is
+    /// unknown on this machine.
+    static long get_cache_size(CacheLevel level);
+
     /// Returns the number of cores (including hyper-threaded) on this machine that are
     /// available for use by Impala (either the number of online cores or the value of
     /// the --num_cores command-line flag).
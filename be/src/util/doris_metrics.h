@@ -123,6 +123,10 @@ public:
 
     IntCounter* memtable_flush_total;
     IntCounter* memtable_flush_duration_us;
+    // memtables flushed because the total load mem consumption exceeds the soft limit
+    IntCounter* load_mem_limit_memtable_flush_total;
+    // time load requests wait for memtable flushes when the load mem limit is exceeded
+    IntCounter* load_mem_limit_stall_duration_us;
 
     IntGauge* memory_pool_bytes_total;
     IntGauge* process_thread_num;
@@ -142,6 +146,8 @@ public:
     IntGauge* compaction_waitting_permits;
 
     HistogramMetric* tablet_version_num_distribution;
+    // bytes of the memtables being written when the load mem soft limit is exceeded
+    HistogramMetric* load_memtable_size_distribution;
 
     // The following metrics will be calculated
     // by metric calculator
@@ -23,6 +23,7 @@
 
 #include "common/logging.h"
 #include "gutil/strings/numbers.h"
+#include "runtime/datetime_value.h"
 #include "util/mysql_global.h"
 
 namespace doris {
@@ -210,6 +211,13 @@ int MysqlRowBuffer::push_unsigned_bigint(uint64_t data) {
     return 0;
 }
 
+int MysqlRowBuffer::push_largeint(__int128 data) {
+    // format into a stack buffer, avoid the std::string of LargeIntValue::to_string
+    fmt::memory_buffer buffer;
+    fmt::format_to(buffer, "{}", data);
+    return push_string(buffer.data(), buffer.size());
+}
+
 int MysqlRowBuffer::push_float(float data) {
     // 1 for string trail, 1 for length, 1 for sign, other for digits
     int ret = reserve(3 + MAX_FLOAT_STR_LENGTH);
@@ -236,6 +244,25 @@ int MysqlRowBuffer::push_double(double data) {
     return 0;
 }
 
+int MysqlRowBuffer::push_datetime(const DateTimeValue& data) {
+    // 1 for length, other for "YYYY-MM-DD HH:MM:SS.ffffff" and the string trail
+    int ret = reserve(1 + 64);
+
+    if (0 != ret) {
+        LOG(ERROR) << "mysql row buffer reserve failed.";
+        return ret;
+    }
+
+    char* start = _pos + !_dynamic_mode;
+    // to_string returns the position after the string trail
+    int length = data.to_string(start) - start - 1;
+    if (!_dynamic_mode) {
+        int1store(_pos++, length);
+    }
+    _pos += length;
+    return 0;
+}
+
 int MysqlRowBuffer::push_string(const char* str, int length) {
     // 9 for length pack max, 1 for sign, other for digits
     if (NULL == str) {
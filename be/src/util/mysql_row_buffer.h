@@ -22,6 +22,8 @@
 
 namespace doris {
 
+class DateTimeValue;
+
 /**
 // Now only support text protocol
  * helper for construct MySQL send row
@@ -61,8 +63,10 @@ public:
     int push_int(int32_t data);
     int push_bigint(int64_t data);
     int push_unsigned_bigint(uint64_t data);
+    int push_largeint(__int128 data);
     int push_float(float data);
     int push_double(double data);
+    int push_datetime(const DateTimeValue& data);
     int push_string(const char* str, int length);
     int push_null();
 
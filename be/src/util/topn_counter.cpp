@@ -88,6 +88,16 @@ void TopNCounter::sort_retain(uint32_t capacity, std::vector<Counter>* sort_vec)
     }
 }
 
+void TopNCounter::sorted_counters(uint32_t capacity, std::vector<Counter>* sort_vec) const {
+    for (const auto& entry : *_counter_map) {
+        sort_vec->emplace_back(entry.second.get_item(), entry.second.get_count());
+    }
+    std::sort(sort_vec->begin(), sort_vec->end(), TopNComparator());
+    if (sort_vec->size() > capacity) {
+        sort_vec->resize(capacity);
+    }
+}
+
 // Based on the  parallel version of the Space Saving algorithm as described in:
 // A parallel space saving algorithm for frequent items and the Hurwitz zeta distribution by Massimo Cafaro, et al.
 void TopNCounter::merge(doris::TopNCounter &&other) {
@@ -122,6 +132,52 @@ void TopNCounter::merge(doris::TopNCounter &&other) {
     sort_retain(_capacity);
 }
 
+// The same merge as above, for a counter which is still used afterwards, as the states of
+// the vectorized topn are.
+void TopNCounter::merge(const doris::TopNCounter &other) {
+    if (other._counter_map->size() == 0) {
+        return;
+    }
+    // the minimum counts below are taken from the sorted counters, a counter
+    // which was only updated by add_item is not sorted yet, the counters of
+    // other are sorted into a copy then
+    if (!_ordered) {
+        sort_retain(_capacity);
+    }
+    std::vector<Counter> other_sorted;
+    const std::vector<Counter>* other_vec = other._counter_vec;
+    if (!other._ordered) {
+        other.sorted_counters(other._capacity, &other_sorted);
+        other_vec = &other_sorted;
+    }
+
+    _space_expand_rate = other._space_expand_rate;
+    set_top_num(other._top_num);
+    bool this_full = _counter_map->size() >= _capacity;
+    bool another_full = other_vec->size() >= other._capacity;
+
+    uint64_t m1 = this_full && !_counter_vec->empty() ? _counter_vec->back().get_count() : 0;
+    uint64_t m2 = another_full && !other_vec->empty() ? other_vec->back().get_count() : 0;
+
+    if (another_full == true) {
+        for (auto &entry : *(this->_counter_map)) {
+            entry.second.add_count(m2);
+        }
+    }
+
+    for (auto &other_entry : *other_vec) {
+        auto itr = this->_counter_map->find(other_entry.get_item());
+        if (itr != _counter_map->end()) {
+            itr->second.add_count(other_entry.get_count() - m2);
+        } else {
+            this->_counter_map->insert(std::make_pair(other_entry.get_item(),
+                    Counter(other_entry.get_item(), other_entry.get_count() + m1)));
+        }
+    }
+    _ordered = false;
+    sort_retain(_capacity);
+}
+
 void TopNCounter::finalize(std::string& finalize_str) {
     if (!_ordered) {
         sort_retain(_top_num);
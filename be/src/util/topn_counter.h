@@ -143,11 +143,19 @@ public:
 
     void merge(doris::TopNCounter&& other);
 
+    // Like merge(TopNCounter&&), but other is left unchanged and its counters do not need to
+    // be sorted
+    void merge(const doris::TopNCounter& other);
+
     // Sort counter by count value and record it in _counter_vec
     void sort_retain(uint32_t capacity);
 
     void sort_retain(uint32_t capacity, std::vector<Counter>* sort_vec);
 
+    // Copy the first capacity counters sorted by count value into sort_vec,
+    // without retaining them
+    void sorted_counters(uint32_t capacity, std::vector<Counter>* sort_vec) const;
+
     void finalize(std::string&);
 
     void set_top_num(uint32_t top_num) {
@@ -155,6 +163,11 @@ public:
         _capacity = top_num * _space_expand_rate;
     }
 
+    void set_space_expand_rate(uint32_t space_expand_rate) {
+        _space_expand_rate = space_expand_rate;
+        _capacity = _top_num * _space_expand_rate;
+    }
+
 private:
     uint32_t _top_num;
     uint32_t _space_expand_rate;
@@ -0,0 +1,106 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#pragma once
+
+#include "olap/hll.h"
+#include "util/hash_util.hpp"
+#include "util/slice.h"
+#include "vec/aggregate_functions/aggregate_function.h"
+#include "vec/columns/column_vector.h"
+#include "vec/data_types/data_type_number.h"
+#include "vec/io/io_helper.h"
+
+namespace doris::vectorized {
+
+struct AggregateFunctionApproxCountDistinctData {
+    HyperLogLog hll_data;
+
+    // hash the bytes of the value with the murmur hash of the row engine's ndv. The hashes are
+    // the same as the row engine's for numbers and strings only, datetime and decimal values
+    // are laid out differently in the two engines
+    void add(const StringRef& value) {
+        uint64_t hash_value = HashUtil::murmur_hash64A(value.data, value.size, HashUtil::MURMUR_SEED);
+        if (hash_value != 0) {
+            hll_data.update(hash_value);
+        }
+    }
+
+    void merge(const AggregateFunctionApproxCountDistinctData& rhs) { hll_data.merge(rhs.hll_data); }
+
+    void write(BufferWritable& buf) const {
+        std::string result(hll_data.max_serialized_size(), '0');
+        int size = hll_data.serialize((uint8_t*)result.c_str());
+        result.resize(size);
+        write_binary(result, buf);
+    }
+
+    void read(BufferReadable& buf) {
+        StringRef ref;
+        read_binary(ref, buf);
+        hll_data.deserialize(Slice(ref.data, ref.size));
+    }
+
+    Int64 get() const { return hll_data.estimate_cardinality(); }
+};
+
+class AggregateFunctionApproxCountDistinct final
+        : public IAggregateFunctionDataHelper<AggregateFunctionApproxCountDistinctData,
+                                              AggregateFunctionApproxCountDistinct> {
+public:
+    String get_name() const override { return "approx_count_distinct"; }
+
+    AggregateFunctionApproxCountDistinct(const DataTypes& argument_types_)
+            : IAggregateFunctionDataHelper(argument_types_, {}) {}
+
+    DataTypePtr get_return_type() const override { return std::make_shared<DataTypeInt64>(); }
+
+    void add(AggregateDataPtr place, const IColumn** columns, size_t row_num,
+             Arena*) const override {
+        this->data(place).add(columns[0]->get_data_at(row_num));
+    }
+
+    void add_batch_single_place(size_t batch_size, AggregateDataPtr place, const IColumn** columns,
+                                Arena*) const override {
+        auto& data = this->data(place);
+        for (size_t i = 0; i < batch_size; ++i) {
+            data.add(columns[0]->get_data_at(i));
+        }
+    }
+
+    void merge(AggregateDataPtr place, ConstAggregateDataPtr rhs, Arena*) const override {
+        this->data(place).merge(this->data(rhs));
+    }
+
+    void serialize(ConstAggregateDataPtr place, BufferWritable& buf) const override {
+        this->data(place).write(buf);
+    }
+
+    void deserialize(AggregateDataPtr place, BufferReadable& buf, Arena*) const override {
+        this->data(place).read(buf);
+    }
+
+    void insert_result_into(ConstAggregateDataPtr place, IColumn& to) const override {
+        auto& column = static_cast<ColumnInt64&>(to);
+        column.get_data().push_back(this->data(place).get());
+    }
+
+    const char* get_header_file_path() const override { return __FILE__; }
+};
+
+} // namespace doris::vectorized
@@ -0,0 +1,141 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#pragma once
+
+#include "vec/aggregate_functions/aggregate_function.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/column_string.h"
+#include "vec/common/assert_cast.h"
+#include "vec/common/string_ref.h"
+#include "vec/data_types/data_type_nullable.h"
+#include "vec/data_types/data_type_string.h"
+#include "vec/io/io_helper.h"
+
+namespace doris::vectorized {
+
+/// Like the intermediate state of the row engine, every value is appended
+/// together with the separator before it, and the length of the first
+/// separator is kept to strip it from the result.
+struct AggregateFunctionGroupConcatData {
+    static constexpr Int64 EMPTY = -1;
+
+    std::string data;
+    Int64 separator_size = EMPTY;
+
+    void add(const StringRef& value, const StringRef& separator) {
+        if (separator_size == EMPTY) {
+            separator_size = separator.size;
+        }
+        data.append(separator.data, separator.size);
+        data.append(value.data, value.size);
+    }
+
+    void merge(const AggregateFunctionGroupConcatData& rhs) {
+        if (rhs.separator_size == EMPTY) {
+            return;
+        }
+        if (separator_size == EMPTY) {
+            separator_size = rhs.separator_size;
+        }
+        data.append(rhs.data);
+    }
+
+    void write(BufferWritable& buf) const {
+        write_binary(separator_size, buf);
+        write_binary(data, buf);
+    }
+
+    void read(BufferReadable& buf) {
+        read_binary(separator_size, buf);
+        read_binary(data, buf);
+    }
+
+    StringRef get() const {
+        if (separator_size == EMPTY) {
+            return StringRef();
+        }
+        return StringRef(data.data() + separator_size, data.size() - separator_size);
+    }
+};
+
+/// group_concat(value[, separator]), the default separator is ", ".
+/// Like the row engine, the result of a group without any value is NULL.
+class AggregateFunctionGroupConcat final
+        : public IAggregateFunctionDataHelper<AggregateFunctionGroupConcatData,
+                                              AggregateFunctionGroupConcat> {
+public:
+    AggregateFunctionGroupConcat(const DataTypes& argument_types_, bool result_is_nullable)
+            : IAggregateFunctionDataHelper(argument_types_, {}),
+              _result_is_nullable(result_is_nullable) {}
+
+    String get_name() const override { return "group_concat"; }
+
+    DataTypePtr get_return_type() const override {
+        DataTypePtr type = std::make_shared<DataTypeString>();
+        return _result_is_nullable ? make_nullable(type) : type;
+    }
+
+    void add(AggregateDataPtr place, const IColumn** columns, size_t row_num,
+             Arena*) const override {
+        static const StringRef default_separator(", ", 2);
+        const auto& values = static_cast<const ColumnString&>(*columns[0]);
+        StringRef separator = this->argument_types.size() == 2
+                                      ? static_cast<const ColumnString&>(*columns[1])
+                                                .get_data_at(row_num)
+                                      : default_separator;
+        this->data(place).add(values.get_data_at(row_num), separator);
+    }
+
+    void merge(AggregateDataPtr place, ConstAggregateDataPtr rhs, Arena*) const override {
+        this->data(place).merge(this->data(rhs));
+    }
+
+    void serialize(ConstAggregateDataPtr place, BufferWritable& buf) const override {
+        this->data(place).write(buf);
+    }
+
+    void deserialize(AggregateDataPtr place, BufferReadable& buf, Arena*) const override {
+        this->data(place).read(buf);
+    }
+
+    void insert_result_into(ConstAggregateDataPtr place, IColumn& to) const override {
+        const auto& data = this->data(place);
+        if (_result_is_nullable) {
+            auto& nullable_column = assert_cast<ColumnNullable&>(to);
+            if (data.separator_size == AggregateFunctionGroupConcatData::EMPTY) {
+                nullable_column.insert_default();
+                return;
+            }
+            auto result = data.get();
+            static_cast<ColumnString&>(nullable_column.get_nested_column())
+                    .insert_data(result.data, result.size);
+            nullable_column.get_null_map_data().push_back(0);
+        } else {
+            auto result = data.get();
+            static_cast<ColumnString&>(to).insert_data(result.data, result.size);
+        }
+    }
+
+    const char* get_header_file_path() const override { return __FILE__; }
+
+private:
+    bool _result_is_nullable;
+};
+
+} // namespace doris::vectorized
@@ -0,0 +1,163 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#pragma once
+
+#include <memory>
+
+#include "util/tdigest.h"
+#include "vec/aggregate_functions/aggregate_function.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/column_vector.h"
+#include "vec/columns/columns_number.h"
+#include "vec/common/assert_cast.h"
+#include "vec/data_types/data_type_nullable.h"
+#include "vec/data_types/data_type_number.h"
+#include "vec/io/io_helper.h"
+
+namespace doris::vectorized {
+
+struct PercentileApproxState {
+    static constexpr double INIT_QUANTILE = -1.0;
+
+    PercentileApproxState() : digest(new TDigest()) {}
+
+    // the compression is a constant argument, take it from the first row only
+    void init(double compression) {
+        if (!init_flag) {
+            if (compression >= 2048 && compression <= 10000) {
+                digest.reset(new TDigest(compression));
+            }
+            init_flag = true;
+        }
+    }
+
+    void add(double value, double quantile) {
+        digest->add(value);
+        target_quantile = quantile;
+    }
+
+    void merge(const PercentileApproxState& rhs) {
+        if (!rhs.init_flag) {
+            return;
+        }
+        init_flag = true;
+        digest->merge(rhs.digest.get());
+        // target_quantile only need set once from child result
+        if (target_quantile == INIT_QUANTILE) {
+            target_quantile = rhs.target_quantile;
+        }
+    }
+
+    void write(BufferWritable& buf) const {
+        write_binary(init_flag, buf);
+        if (!init_flag) {
+            return;
+        }
+        write_binary(target_quantile, buf);
+        std::string result(digest->serialized_size(), '0');
+        digest->serialize((uint8_t*)result.data());
+        write_binary(result, buf);
+    }
+
+    void read(BufferReadable& buf) {
+        read_binary(init_flag, buf);
+        if (!init_flag) {
+            return;
+        }
+        read_binary(target_quantile, buf);
+        StringRef ref;
+        read_binary(ref, buf);
+        digest->unserialize((uint8_t*)ref.data);
+    }
+
+    double get() const { return digest->quantile(target_quantile); }
+
+    bool init_flag = false;
+    double target_quantile = INIT_QUANTILE;
+    // quantile() of TDigest compresses the unprocessed values, so keep it
+    // behind a pointer to be usable from the const result path
+    std::unique_ptr<TDigest> digest;
+};
+
+/// percentile_approx(value, quantile[, compression]), backed by t-digest.
+/// Like the row engine, the result of a group without any value is NULL.
+class AggregateFunctionPercentileApprox final
+        : public IAggregateFunctionDataHelper<PercentileApproxState,
+                                              AggregateFunctionPercentileApprox> {
+public:
+    AggregateFunctionPercentileApprox(const DataTypes& argument_types_, bool result_is_nullable)
+            : IAggregateFunctionDataHelper(argument_types_, {}),
+              _result_is_nullable(result_is_nullable) {}
+
+    String get_name() const override { return "percentile_approx"; }
+
+    DataTypePtr get_return_type() const override {
+        DataTypePtr type = std::make_shared<DataTypeFloat64>();
+        return _result_is_nullable ? make_nullable(type) : type;
+    }
+
+    void add(AggregateDataPtr place, const IColumn** columns, size_t row_num,
+             Arena*) const override {
+        const auto& values = static_cast<const ColumnFloat64&>(*columns[0]).get_data();
+        const auto& quantiles = static_cast<const ColumnFloat64&>(*columns[1]).get_data();
+        auto& data = this->data(place);
+        if (this->argument_types.size() == 3) {
+            data.init(static_cast<const ColumnFloat64&>(*columns[2]).get_data()[row_num]);
+        } else {
+            data.init(0);
+        }
+        data.add(values[row_num], quantiles[row_num]);
+    }
+
+    void merge(AggregateDataPtr place, ConstAggregateDataPtr rhs, Arena*) const override {
+        this->data(place).merge(this->data(rhs));
+    }
+
+    void serialize(ConstAggregateDataPtr place, BufferWritable& buf) const override {
+        this->data(place).write(buf);
+    }
+
+    void deserialize(AggregateDataPtr place, BufferReadable& buf, Arena*) const override {
+        this->data(place).read(buf);
+    }
+
+    void insert_result_into(ConstAggregateDataPtr place, IColumn& to) const override {
+        const auto& data = this->data(place);
+        if (_result_is_nullable) {
+            auto& nullable_column = assert_cast<ColumnNullable&>(to);
+            if (!data.init_flag) {
+                nullable_column.insert_default();
+                return;
+            }
+            static_cast<ColumnFloat64&>(nullable_column.get_nested_column())
+                    .get_data()
+                    .push_back(data.get());
+            nullable_column.get_null_map_data().push_back(0);
+        } else {
+            static_cast<ColumnFloat64&>(to).get_data().push_back(data.get());
+        }
+    }
+
+    const char* get_header_file_path() const override { return __FILE__; }
+
+private:
+    bool _result_is_nullable;
+};
+
+} // namespace doris::vectorized
@@ -28,6 +28,11 @@ void register_aggregate_function_HLL_union_agg(AggregateFunctionSimpleFactory& f
 void register_aggregate_function_uniq(AggregateFunctionSimpleFactory& factory);
 void register_aggregate_function_combinator_distinct(AggregateFunctionSimpleFactory& factory);
 void register_aggregate_function_bitmap(AggregateFunctionSimpleFactory& factory);
+void register_aggregate_function_approx_count_distinct(AggregateFunctionSimpleFactory& factory);
+void register_aggregate_function_stddev_variance(AggregateFunctionSimpleFactory& factory);
+void register_aggregate_function_percentile_approx(AggregateFunctionSimpleFactory& factory);
+void register_aggregate_function_group_concat(AggregateFunctionSimpleFactory& factory);
+void register_aggregate_function_topn(AggregateFunctionSimpleFactory& factory);
 
 AggregateFunctionSimpleFactory& AggregateFunctionSimpleFactory::instance() {
     static std::once_flag oc;
@@ -39,6 +44,11 @@ AggregateFunctionSimpleFactory& AggregateFunctionSimpleFactory::instance() {
         register_aggregate_function_count(instance);
         register_aggregate_function_uniq(instance);
         register_aggregate_function_bitmap(instance);
+        register_aggregate_function_approx_count_distinct(instance);
+        register_aggregate_function_stddev_variance(instance);
+        register_aggregate_function_percentile_approx(instance);
+        register_aggregate_function_group_concat(instance);
+        register_aggregate_function_topn(instance);
         register_aggregate_function_combinator_distinct(instance);
         register_aggregate_function_HLL_union_agg(instance);
         register_aggregate_function_combinator_null(instance);
@@ -0,0 +1,85 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "vec/aggregate_functions/aggregate_function_stddev.h"
+
+#include "common/logging.h"
+#include "vec/aggregate_functions/aggregate_function_nothing.h"
+#include "vec/aggregate_functions/aggregate_function_simple_factory.h"
+#include "vec/aggregate_functions/factory_helpers.h"
+#include "vec/aggregate_functions/helpers.h"
+#include "vec/data_types/data_type_nullable.h"
+
+namespace doris::vectorized {
+
+namespace {
+
+template <bool is_pop, bool is_stddev>
+struct Variance {
+    template <typename T>
+    using Function = AggregateFunctionVariance<T, VarianceResult<is_pop, is_stddev>>;
+};
+
+template <bool is_pop, bool is_stddev>
+AggregateFunctionPtr create_aggregate_function_variance(const std::string& name,
+                                                        const DataTypes& argument_types,
+                                                        const Array& parameters,
+                                                        const bool result_is_nullable) {
+    assert_no_parameters(name, parameters);
+    assert_unary(name, argument_types);
+
+    if (argument_types[0]->only_null()) {
+        return std::make_shared<AggregateFunctionNothing>(argument_types, parameters);
+    }
+
+    AggregateFunctionPtr res(
+            create_with_numeric_type<Variance<is_pop, is_stddev>::template Function>(
+                    *remove_nullable(argument_types[0]), name, argument_types,
+                    result_is_nullable));
+    if (!res) {
+        LOG(WARNING) << fmt::format("Illegal type {} of argument for aggregate function {}",
+                                    argument_types[0]->get_name(), name);
+    }
+    return res;
+}
+
+} // namespace
+
+void register_aggregate_function_stddev_variance(AggregateFunctionSimpleFactory& factory) {
+    // keep the same semantics as the row engine: stddev and variance are of the population
+    for (bool nullable : {false, true}) {
+        factory.register_function("stddev", create_aggregate_function_variance<true, true>,
+                                  nullable);
+        factory.register_function("stddev_pop", create_aggregate_function_variance<true, true>,
+                                  nullable);
+        factory.register_function("stddev_samp", create_aggregate_function_variance<false, true>,
+                                  nullable);
+        factory.register_function("variance", create_aggregate_function_variance<true, false>,
+                                  nullable);
+        factory.register_function("variance_pop", create_aggregate_function_variance<true, false>,
+                                  nullable);
+        factory.register_function("var_pop", create_aggregate_function_variance<true, false>,
+                                  nullable);
+        factory.register_function("variance_samp",
+                                  create_aggregate_function_variance<false, false>, nullable);
+        factory.register_function("var_samp", create_aggregate_function_variance<false, false>,
+                                  nullable);
+    }
+}
+
+} // namespace doris::vectorized
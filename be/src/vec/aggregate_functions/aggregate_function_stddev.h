@@ -0,0 +1,184 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#pragma once
+
+#include <cmath>
+
+#include "vec/aggregate_functions/aggregate_function.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/columns_number.h"
+#include "vec/common/assert_cast.h"
+#include "vec/data_types/data_type_nullable.h"
+#include "vec/data_types/data_type_number.h"
+#include "vec/io/io_helper.h"
+
+namespace doris::vectorized {
+
+/// Count, mean and sum of squared differences from the mean, updated with
+/// Welford's algorithm and merged with Chan's parallel formula.
+struct AggregateFunctionVarianceData {
+    UInt64 count = 0;
+    Float64 mean = 0;
+    Float64 m2 = 0;
+
+    void add(Float64 value) {
+        ++count;
+        Float64 delta = value - mean;
+        mean += delta / count;
+        m2 += delta * (value - mean);
+    }
+
+    void merge(const AggregateFunctionVarianceData& rhs) {
+        if (rhs.count == 0) {
+            return;
+        }
+        UInt64 total_count = count + rhs.count;
+        Float64 delta = rhs.mean - mean;
+        mean += delta * rhs.count / total_count;
+        m2 += rhs.m2 + delta * delta * count * rhs.count / total_count;
+        count = total_count;
+    }
+
+    void write(BufferWritable& buf) const {
+        write_binary(count, buf);
+        write_binary(mean, buf);
+        write_binary(m2, buf);
+    }
+
+    void read(BufferReadable& buf) {
+        read_binary(count, buf);
+        read_binary(mean, buf);
+        read_binary(m2, buf);
+    }
+};
+
+template <bool is_pop, bool is_stddev>
+struct VarianceResult {
+    /// The sample variance of less than two values is NULL
+    static bool is_valid(const AggregateFunctionVarianceData& data) {
+        return is_pop ? data.count > 0 : data.count > 1;
+    }
+
+    static Float64 get(const AggregateFunctionVarianceData& data) {
+        Float64 variance = data.m2 / (is_pop ? data.count : data.count - 1);
+        return is_stddev ? std::sqrt(variance) : variance;
+    }
+};
+
+/// Calculates variance and standard deviation, of the population or of the sample.
+/// Like the row engine, the result is NULL if there are not enough values, so this
+/// function skips NULL arguments by itself instead of being wrapped by the null
+/// combinator, which can only return NULL for groups without any value.
+template <typename T, typename Result>
+class AggregateFunctionVariance final
+        : public IAggregateFunctionDataHelper<AggregateFunctionVarianceData,
+                                              AggregateFunctionVariance<T, Result>> {
+public:
+    using ColVecType = ColumnVector<T>;
+
+    AggregateFunctionVariance(const std::string& name, const DataTypes& argument_types_,
+                              bool result_is_nullable)
+            : IAggregateFunctionDataHelper<AggregateFunctionVarianceData,
+                                           AggregateFunctionVariance<T, Result>>(argument_types_,
+                                                                                 {}),
+              _name(name),
+              _argument_is_nullable(argument_types_[0]->is_nullable()),
+              _result_is_nullable(result_is_nullable) {}
+
+    String get_name() const override { return _name; }
+
+    DataTypePtr get_return_type() const override {
+        DataTypePtr type = std::make_shared<DataTypeFloat64>();
+        return _result_is_nullable ? make_nullable(type) : type;
+    }
+
+    void add(AggregateDataPtr place, const IColumn** columns, size_t row_num,
+             Arena*) const override {
+        const IColumn* column = columns[0];
+        if (_argument_is_nullable) {
+            const auto& nullable_column = assert_cast<const ColumnNullable&>(*column);
+            if (nullable_column.is_null_at(row_num)) {
+                return;
+            }
+            column = &nullable_column.get_nested_column();
+        }
+        this->data(place).add(
+                static_cast<Float64>(static_cast<const ColVecType&>(*column).get_data()[row_num]));
+    }
+
+    void add_batch_single_place(size_t batch_size, AggregateDataPtr place, const IColumn** columns,
+                                Arena*) const override {
+        auto& data = this->data(place);
+        if (_argument_is_nullable) {
+            const auto& nullable_column = assert_cast<const ColumnNullable&>(*columns[0]);
+            const auto& null_map = nullable_column.get_null_map_data();
+            const auto& column_data =
+                    static_cast<const ColVecType&>(nullable_column.get_nested_column()).get_data();
+            for (size_t i = 0; i < batch_size; ++i) {
+                if (!null_map[i]) {
+                    data.add(static_cast<Float64>(column_data[i]));
+                }
+            }
+            return;
+        }
+        const auto& column_data = static_cast<const ColVecType&>(*columns[0]).get_data();
+        for (size_t i = 0; i < batch_size; ++i) {
+            data.add(static_cast<Float64>(column_data[i]));
+        }
+    }
+
+    void merge(AggregateDataPtr place, ConstAggregateDataPtr rhs, Arena*) const override {
+        this->data(place).merge(this->data(rhs));
+    }
+
+    void serialize(ConstAggregateDataPtr place, BufferWritable& buf) const override {
+        this->data(place).write(buf);
+    }
+
+    void deserialize(AggregateDataPtr place, BufferReadable& buf, Arena*) const override {
+        this->data(place).read(buf);
+    }
+
+    void insert_result_into(ConstAggregateDataPtr place, IColumn& to) const override {
+        const auto& data = this->data(place);
+        if (_result_is_nullable) {
+            auto& nullable_column = assert_cast<ColumnNullable&>(to);
+            if (!Result::is_valid(data)) {
+                nullable_column.insert_default();
+                return;
+            }
+            static_cast<ColumnFloat64&>(nullable_column.get_nested_column())
+                    .get_data()
+                    .push_back(Result::get(data));
+            nullable_column.get_null_map_data().push_back(0);
+        } else {
+            static_cast<ColumnFloat64&>(to).get_data().push_back(
+                    Result::is_valid(data) ? Result::get(data) : 0);
+        }
+    }
+
+    const char* get_header_file_path() const override { return __FILE__; }
+
+private:
+    std::string _name;
+    bool _argument_is_nullable;
+    bool _result_is_nullable;
+};
+
+} // namespace doris::vectorized
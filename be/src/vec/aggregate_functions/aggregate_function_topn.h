@@ -0,0 +1,127 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#pragma once
+
+#include "util/topn_counter.h"
+#include "vec/aggregate_functions/aggregate_function.h"
+#include "vec/columns/column_string.h"
+#include "vec/columns/columns_number.h"
+#include "vec/data_types/data_type_string.h"
+#include "vec/io/io_helper.h"
+
+namespace doris::vectorized {
+
+struct AggregateFunctionTopNData {
+    // top_num and space_expand_rate are constant arguments, take them from the first row only
+    void init(uint32_t top_num, uint32_t space_expand_rate) {
+        if (!init_flag) {
+            if (space_expand_rate > 0) {
+                counter.set_space_expand_rate(space_expand_rate);
+            }
+            counter.set_top_num(top_num);
+            init_flag = true;
+        }
+    }
+
+    void add(const std::string& value) { counter.add_item(value, 1); }
+
+    // TopNCounter sorts and retains its counters when merged, serialized and finalized
+    void merge(const AggregateFunctionTopNData& rhs) {
+        init_flag = true;
+        counter.merge(rhs.counter);
+    }
+
+    void write(BufferWritable& buf) const {
+        std::string result;
+        counter.serialize(&result);
+        write_binary(result, buf);
+    }
+
+    void read(BufferReadable& buf) {
+        StringRef ref;
+        read_binary(ref, buf);
+        counter.deserialize(Slice(ref.data, ref.size));
+        init_flag = true;
+    }
+
+    std::string get() const {
+        std::string result;
+        counter.finalize(result);
+        return result;
+    }
+
+    bool init_flag = false;
+    mutable TopNCounter counter;
+};
+
+/// topn(value, top_num[, space_expand_rate]), returns the most frequent values
+/// and their counts as json, based on the Space-Saving algorithm.
+class AggregateFunctionTopN final
+        : public IAggregateFunctionDataHelper<AggregateFunctionTopNData, AggregateFunctionTopN> {
+public:
+    AggregateFunctionTopN(const DataTypes& argument_types_)
+            : IAggregateFunctionDataHelper(argument_types_, {}),
+              _is_string(WhichDataType(argument_types_[0]).is_string()) {}
+
+    String get_name() const override { return "topn"; }
+
+    DataTypePtr get_return_type() const override { return std::make_shared<DataTypeString>(); }
+
+    void add(AggregateDataPtr place, const IColumn** columns, size_t row_num,
+             Arena*) const override {
+        auto& data = this->data(place);
+        if (!data.init_flag) {
+            auto top_num = static_cast<const ColumnInt32&>(*columns[1]).get_data()[row_num];
+            auto space_expand_rate =
+                    this->argument_types.size() == 3
+                            ? static_cast<const ColumnInt32&>(*columns[2]).get_data()[row_num]
+                            : 0;
+            data.init(top_num, space_expand_rate);
+        }
+        if (_is_string) {
+            data.add(columns[0]->get_data_at(row_num).to_string());
+        } else {
+            data.add(this->argument_types[0]->to_string(*columns[0], row_num));
+        }
+    }
+
+    void merge(AggregateDataPtr place, ConstAggregateDataPtr rhs, Arena*) const override {
+        this->data(place).merge(this->data(rhs));
+    }
+
+    void serialize(ConstAggregateDataPtr place, BufferWritable& buf) const override {
+        this->data(place).write(buf);
+    }
+
+    void deserialize(AggregateDataPtr place, BufferReadable& buf, Arena*) const override {
+        this->data(place).read(buf);
+    }
+
+    void insert_result_into(ConstAggregateDataPtr place, IColumn& to) const override {
+        auto result = this->data(place).get();
+        static_cast<ColumnString&>(to).insert_data(result.data(), result.size());
+    }
+
+    const char* get_header_file_path() const override { return __FILE__; }
+
+private:
+    bool _is_string;
+};
+
+} // namespace doris::vectorized
@@ -21,6 +21,7 @@
 
 #include "vec/columns/column_const.h"
 #include "vec/columns/column_nullable.h"
+#include "util/hash_util.hpp"
 #include "vec/core/field.h"
 
 namespace doris::vectorized {
@@ -43,6 +44,17 @@ void IColumn::insert_from(const IColumn& src, size_t n) {
     insert(src[n]);
 }
 
+void IColumn::update_hashes_with_value(uint32_t* __restrict hashes,
+                                       const uint8_t* __restrict null_data) const {
+    size_t s = size();
+    for (size_t i = 0; i < s; ++i) {
+        if (null_data == nullptr || null_data[i] == 0) {
+            StringRef value = get_data_at(i);
+            hashes[i] = HashUtil::hash(value.data, value.size, hashes[i]);
+        }
+    }
+}
+
 bool is_column_nullable(const IColumn& column) {
     return check_column<ColumnNullable>(column);
 }
@@ -158,6 +158,13 @@ public:
         for (size_t i = 0; i < length; ++i) insert_from(src, position);
     }
 
+    /// Appends the elements of other column with the same type at the positions in
+    /// [indices_begin, indices_end). Is used to scatter rows to the channels of a shuffle.
+    virtual void insert_indices_from(const IColumn& src, const int* indices_begin,
+                                     const int* indices_end) {
+        for (auto x = indices_begin; x != indices_end; ++x) insert_from(src, *x);
+    }
+
     /// Appends data located in specified memory chunk if it is possible (throws an exception if it cannot be implemented).
     /// Is used to optimize some computations (in aggregation, for example).
     /// Parameter length could be ignored if column values have fixed size.
@@ -199,6 +206,13 @@ public:
     ///  passed bytes to hash must identify sequence of values unambiguously.
     virtual void update_hash_with_value(size_t n, SipHash& hash) const = 0;
 
+    /// Update hashes[i] with the value of i-th element for all the elements, a column at a
+    /// time. The elements whose null_data is set are skipped, so the same value hashes the
+    /// same in a nullable column and in a not nullable one.
+    /// The hash depends only on the bytes of the value, it is used to shuffle rows.
+    virtual void update_hashes_with_value(uint32_t* __restrict hashes,
+                                          const uint8_t* __restrict null_data = nullptr) const;
+
     /** Removes elements that don't match the filter.
       * Is used in WHERE and HAVING operations.
       * If result_size_hint > 0, then makes advance reserve(result_size_hint) for the result column;
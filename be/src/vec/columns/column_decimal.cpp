@@ -17,6 +17,7 @@
 
 #include "vec/columns/column_decimal.h"
 
+#include "util/hash_util.hpp"
 #include "vec/columns/columns_common.h"
 #include "vec/common/arena.h"
 #include "vec/common/assert_cast.h"
@@ -68,6 +69,17 @@ void ColumnDecimal<T>::update_hash_with_value(size_t n, SipHash& hash) const {
     hash.update(data[n]);
 }
 
+template <typename T>
+void ColumnDecimal<T>::update_hashes_with_value(uint32_t* __restrict hashes,
+                                                const uint8_t* __restrict null_data) const {
+    size_t s = data.size();
+    for (size_t i = 0; i < s; ++i) {
+        if (null_data == nullptr || null_data[i] == 0) {
+            hashes[i] = HashUtil::hash(&data[i], sizeof(T), hashes[i]);
+        }
+    }
+}
+
 template <typename T>
 void ColumnDecimal<T>::get_permutation(bool reverse, size_t limit, int,
                                        IColumn::Permutation& res) const {
@@ -143,6 +155,18 @@ void ColumnDecimal<T>::insert_range_from(const IColumn& src, size_t start, size_
     memcpy(data.data() + old_size, &src_vec.data[start], length * sizeof(data[0]));
 }
 
+template <typename T>
+void ColumnDecimal<T>::insert_indices_from(const IColumn& src, const int* indices_begin,
+                                           const int* indices_end) {
+    const T* src_data = assert_cast<const ColumnDecimal&>(src).data.data();
+    size_t old_size = data.size();
+    data.resize(old_size + (indices_end - indices_begin));
+    T* dst = data.data() + old_size;
+    for (auto x = indices_begin; x != indices_end; ++x) {
+        *dst++ = src_data[*x];
+    }
+}
+
 template <typename T>
 ColumnPtr ColumnDecimal<T>::filter(const IColumn::Filter& filt, ssize_t result_size_hint) const {
     size_t size = data.size();
@@ -46,6 +46,12 @@ void ColumnNullable::update_hash_with_value(size_t n, SipHash& hash) const {
     if (arr[n] == 0) get_nested_column().update_hash_with_value(n, hash);
 }
 
+void ColumnNullable::update_hashes_with_value(uint32_t* __restrict hashes,
+                                              const uint8_t* __restrict null_data) const {
+    DCHECK(null_data == nullptr);
+    get_nested_column().update_hashes_with_value(hashes, get_null_map_data().data());
+}
+
 MutableColumnPtr ColumnNullable::clone_resized(size_t new_size) const {
     MutableColumnPtr new_nested_col = get_nested_column().clone_resized(new_size);
     auto new_null_map = ColumnUInt8::create();
@@ -144,6 +150,15 @@ void ColumnNullable::insert_from(const IColumn& src, size_t n) {
     get_null_map_data().push_back(src_concrete.get_null_map_data()[n]);
 }
 
+void ColumnNullable::insert_indices_from(const IColumn& src, const int* indices_begin,
+                                         const int* indices_end) {
+    const ColumnNullable& src_concrete = assert_cast<const ColumnNullable&>(src);
+    get_nested_column().insert_indices_from(src_concrete.get_nested_column(), indices_begin,
+                                            indices_end);
+    get_null_map_column().insert_indices_from(src_concrete.get_null_map_column(), indices_begin,
+                                              indices_end);
+}
+
 void ColumnNullable::insert_from_not_nullable(const IColumn& src, size_t n) {
     get_nested_column().insert_from(src, n);
     get_null_map_data().push_back(0);
@@ -79,6 +79,8 @@ public:
     void insert_range_from(const IColumn& src, size_t start, size_t length) override;
     void insert(const Field& x) override;
     void insert_from(const IColumn& src, size_t n) override;
+    void insert_indices_from(const IColumn& src, const int* indices_begin,
+                             const int* indices_end) override;
 
     void insert_from_not_nullable(const IColumn& src, size_t n);
     void insert_range_from_not_nullable(const IColumn& src, size_t start, size_t length);
@@ -102,6 +104,8 @@ public:
     void protect() override;
     ColumnPtr replicate(const Offsets& replicate_offsets) const override;
     void update_hash_with_value(size_t n, SipHash& hash) const override;
+    void update_hashes_with_value(uint32_t* __restrict hashes,
+                                  const uint8_t* __restrict null_data) const override;
     void get_extremes(Field& min, Field& max) const override;
 
     MutableColumns scatter(ColumnIndex num_columns, const Selector& selector) const override {
@@ -17,6 +17,7 @@
 
 #include "vec/columns/column_string.h"
 
+#include "util/hash_util.hpp"
 #include "vec/columns/collator.h"
 #include "vec/columns/columns_common.h"
 #include "vec/common/arena.h"
@@ -90,6 +91,42 @@ void ColumnString::insert_range_from(const IColumn& src, size_t start, size_t le
     }
 }
 
+void ColumnString::insert_indices_from(const IColumn& src, const int* indices_begin,
+                                       const int* indices_end) {
+    const ColumnString& src_concrete = assert_cast<const ColumnString&>(src);
+
+    size_t old_chars_size = chars.size();
+    size_t new_chars_size = old_chars_size;
+    for (auto x = indices_begin; x != indices_end; ++x) {
+        new_chars_size += src_concrete.size_at(*x);
+    }
+    chars.resize(new_chars_size);
+
+    size_t old_size = offsets.size();
+    offsets.resize(old_size + (indices_end - indices_begin));
+    size_t dst_offset = old_chars_size;
+    Offset* dst_offsets = offsets.data() + old_size;
+    for (auto x = indices_begin; x != indices_end; ++x) {
+        size_t size_to_append = src_concrete.size_at(*x);
+        memcpy_small_allow_read_write_overflow15(&chars[dst_offset],
+                                                 &src_concrete.chars[src_concrete.offset_at(*x)],
+                                                 size_to_append);
+        dst_offset += size_to_append;
+        *dst_offsets++ = dst_offset;
+    }
+}
+
+void ColumnString::update_hashes_with_value(uint32_t* __restrict hashes,
+                                            const uint8_t* __restrict null_data) const {
+    size_t s = offsets.size();
+    for (size_t i = 0; i < s; ++i) {
+        if (null_data == nullptr || null_data[i] == 0) {
+            // Without the terminating zero, the same as get_data_at().
+            hashes[i] = HashUtil::hash(&chars[offset_at(i)], size_at(i) - 1, hashes[i]);
+        }
+    }
+}
+
 ColumnPtr ColumnString::filter(const Filter& filt, ssize_t result_size_hint) const {
     if (offsets.size() == 0) return ColumnString::create();
 
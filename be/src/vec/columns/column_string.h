@@ -182,8 +182,14 @@ public:
         hash.update(reinterpret_cast<const char*>(&chars[offset]), string_size);
     }
 
+    void update_hashes_with_value(uint32_t* __restrict hashes,
+                                  const uint8_t* __restrict null_data) const override;
+
     void insert_range_from(const IColumn& src, size_t start, size_t length) override;
 
+    void insert_indices_from(const IColumn& src, const int* indices_begin,
+                             const int* indices_end) override;
+
     ColumnPtr filter(const Filter& filt, ssize_t result_size_hint) const override;
 
     ColumnPtr permute(const Permutation& perm, size_t limit) const override;
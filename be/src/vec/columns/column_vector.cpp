@@ -28,6 +28,7 @@
 #include "vec/common/exception.h"
 #include "vec/common/nan_utils.h"
 #include "vec/common/sip_hash.h"
+#include "util/hash_util.hpp"
 #include "vec/common/unaligned.h"
 
 #ifdef __SSE2__
@@ -55,6 +56,21 @@ void ColumnVector<T>::update_hash_with_value(size_t n, SipHash& hash) const {
     hash.update(data[n]);
 }
 
+template <typename T>
+void ColumnVector<T>::update_hashes_with_value(uint32_t* __restrict hashes,
+                                               const uint8_t* __restrict null_data) const {
+    size_t s = data.size();
+    if (null_data == nullptr) {
+        for (size_t i = 0; i < s; ++i) {
+            hashes[i] = HashUtil::hash(&data[i], sizeof(T), hashes[i]);
+        }
+    } else {
+        for (size_t i = 0; i < s; ++i) {
+            if (null_data[i] == 0) hashes[i] = HashUtil::hash(&data[i], sizeof(T), hashes[i]);
+        }
+    }
+}
+
 template <typename T>
 struct ColumnVector<T>::less {
     const Self& parent;
@@ -216,6 +232,18 @@ void ColumnVector<T>::insert_range_from(const IColumn& src, size_t start, size_t
     memcpy(data.data() + old_size, &src_vec.data[start], length * sizeof(data[0]));
 }
 
+template <typename T>
+void ColumnVector<T>::insert_indices_from(const IColumn& src, const int* indices_begin,
+                                          const int* indices_end) {
+    const T* src_data = static_cast<const Self&>(src).get_data().data();
+    size_t old_size = data.size();
+    data.resize(old_size + (indices_end - indices_begin));
+    T* dst = data.data() + old_size;
+    for (auto x = indices_begin; x != indices_end; ++x) {
+        *dst++ = src_data[*x];
+    }
+}
+
 template <typename T>
 ColumnPtr ColumnVector<T>::filter(const IColumn::Filter& filt, ssize_t result_size_hint) const {
     size_t size = data.size();
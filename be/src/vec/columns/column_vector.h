@@ -129,6 +129,9 @@ public:
         data.push_back(static_cast<const Self&>(src).get_data()[n]);
     }
 
+    void insert_indices_from(const IColumn& src, const int* indices_begin,
+                             const int* indices_end) override;
+
     void insert_data(const char* pos, size_t /*length*/) override {
         data.push_back(unaligned_load<T>(pos));
     }
@@ -143,6 +146,9 @@ public:
 
     void update_hash_with_value(size_t n, SipHash& hash) const override;
 
+    void update_hashes_with_value(uint32_t* __restrict hashes,
+                                  const uint8_t* __restrict null_data) const override;
+
     size_t byte_size() const override { return data.size() * sizeof(data[0]); }
 
     size_t allocated_bytes() const override { return data.allocated_bytes(); }
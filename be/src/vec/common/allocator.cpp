@@ -0,0 +1,80 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+#include "vec/common/allocator.h"
+
+#include "common/config.h"
+#include "runtime/memory/chunk.h"
+#include "runtime/memory/chunk_allocator.h"
+#include "util/cpu_info.h"
+#include "util/doris_metrics.h"
+
+namespace doris::vectorized {
+
+DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(vec_allocator_chunk_alloc_count, MetricUnit::NOUNIT);
+DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(vec_allocator_chunk_hit_count, MetricUnit::NOUNIT);
+DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(vec_allocator_chunk_free_count, MetricUnit::NOUNIT);
+
+static IntCounter* vec_allocator_chunk_alloc_count;
+static IntCounter* vec_allocator_chunk_hit_count;
+static IntCounter* vec_allocator_chunk_free_count;
+
+bool use_chunk_cache() {
+    static const bool enabled = [] {
+        if (!config::enable_vec_chunk_cache || ChunkAllocator::instance() == nullptr) {
+            return false;
+        }
+        static std::shared_ptr<MetricEntity> entity =
+                DorisMetrics::instance()->metric_registry()->register_entity("vec_allocator");
+        INT_COUNTER_METRIC_REGISTER(entity, vec_allocator_chunk_alloc_count);
+        INT_COUNTER_METRIC_REGISTER(entity, vec_allocator_chunk_hit_count);
+        INT_COUNTER_METRIC_REGISTER(entity, vec_allocator_chunk_free_count);
+        return true;
+    }();
+    return enabled;
+}
+
+void* chunk_cache_alloc(size_t size) {
+    Chunk chunk;
+    bool from_cache = false;
+    if (!ChunkAllocator::instance()->allocate(size, &chunk, &from_cache)) {
+        return nullptr;
+    }
+    vec_allocator_chunk_alloc_count->increment(1);
+    if (from_cache) {
+        vec_allocator_chunk_hit_count->increment(1);
+    }
+    return chunk.data;
+}
+
+void chunk_cache_free(void* buf, size_t size) {
+    Chunk chunk;
+    chunk.data = reinterpret_cast<uint8_t*>(buf);
+    chunk.size = size;
+    chunk.core_id = CpuInfo::get_current_core();
+    ChunkAllocator::instance()->free(chunk);
+    vec_allocator_chunk_free_count->increment(1);
+}
+
+void advise_huge_pages(void* buf, size_t size) {
+#ifdef MADV_HUGEPAGE
+    if (config::enable_vec_hash_table_huge_pages) {
+        madvise(buf, size, MADV_HUGEPAGE);
+    }
+#endif
+}
+
+} // namespace doris::vectorized
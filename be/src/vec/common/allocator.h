@@ -17,7 +17,6 @@
 
 #pragma once
 
-// TODO: Tracker
 // TODO: Readable
 
 #include <fmt/format.h>
@@ -50,6 +49,7 @@
 #include "vec/common/allocator_fwd.h"
 #include "vec/common/exception.h"
 #include "vec/common/mremap.h"
+#include "vec/common/thread_mem_tracker.h"
 
 /// Required for older Darwin builds, that lack definition of MAP_ANONYMOUS
 #ifndef MAP_ANONYMOUS
@@ -83,6 +83,44 @@ static constexpr size_t MMAP_THRESHOLD = 4096;
 static constexpr size_t MMAP_MIN_ALIGNMENT = 4096;
 static constexpr size_t MALLOC_MIN_ALIGNMENT = 8;
 
+/** Buffers of [CHUNK_CACHE_MIN_SIZE, CHUNK_CACHE_MAX_SIZE) bytes, the column buffers of a
+  * batch for the most part, are served from the per-core free lists of ChunkAllocator when
+  * enable_vec_chunk_cache is set. A buffer freed by one batch is then reused by the next
+  * one instead of going back to the system. The size is rounded up to a power of two.
+  * Smaller buffers are left to malloc, which has its own thread caches for them. Larger ones,
+  * the hash tables for the most part, keep being malloc'd or mmap'd, so that zeroed buffers
+  * get the zero pages of mmap instead of a memset of a dirty chunk. The bounds do not depend
+  * on MMAP_THRESHOLD, so that debug builds use the cache like release builds do.
+  */
+static constexpr size_t CHUNK_CACHE_MIN_SIZE = 32 * 1024;
+static constexpr size_t CHUNK_CACHE_MAX_SIZE = 1ULL << 20;
+
+namespace doris::vectorized {
+
+/// Whether the chunk cache is used: enable_vec_chunk_cache is set and ChunkAllocator has been
+/// initialized, which the daemon does before any vectorized allocation. Decided once at the
+/// first call, so that a buffer is always freed the same way it was allocated.
+bool use_chunk_cache();
+void* chunk_cache_alloc(size_t size);
+void chunk_cache_free(void* buf, size_t size);
+/// Advises transparent huge pages for a hash table buffer if enable_vec_hash_table_huge_pages.
+void advise_huge_pages(void* buf, size_t size);
+
+inline bool in_chunk_cache(size_t size) {
+    return size >= CHUNK_CACHE_MIN_SIZE && size < CHUNK_CACHE_MAX_SIZE && use_chunk_cache();
+}
+
+inline size_t chunk_cache_size(size_t size) {
+    return size_t(1) << (64 - __builtin_clzll(size - 1));
+}
+
+/// The memory a buffer of size bytes takes, which is tracked instead of the size.
+inline size_t allocated_size(size_t size) {
+    return in_chunk_cache(size) ? chunk_cache_size(size) : size;
+}
+
+} // namespace doris::vectorized
+
 /** Responsible for allocating / freeing memory. Used, for example, in PODArray, Arena.
   * Also used in hash tables.
   * The interface is different from std::allocator
@@ -98,14 +136,14 @@ class Allocator {
 public:
     /// Allocate memory range.
     void* alloc(size_t size, size_t alignment = 0) {
-        // CurrentMemoryTracker::alloc(size);
+        doris::vectorized::thread_mem_tracker().alloc(doris::vectorized::allocated_size(size));
         return alloc_no_track(size, alignment);
     }
 
     /// Free memory range.
     void free(void* buf, size_t size) {
         free_no_track(buf, size);
-        // CurrentMemoryTracker::free(size);
+        doris::vectorized::thread_mem_tracker().free(doris::vectorized::allocated_size(size));
     }
 
     /** Enlarge memory range.
@@ -116,10 +154,27 @@ public:
         if (old_size == new_size) {
             /// nothing to do.
             /// BTW, it's not possible to change alignment while doing realloc.
+        } else if (doris::vectorized::in_chunk_cache(old_size) ||
+                   doris::vectorized::in_chunk_cache(new_size)) {
+            /// Chunks can not be resized in place, unless the new size is in the same chunk,
+            /// which is already tracked.
+            if (doris::vectorized::in_chunk_cache(old_size) &&
+                doris::vectorized::in_chunk_cache(new_size) &&
+                doris::vectorized::chunk_cache_size(old_size) ==
+                        doris::vectorized::chunk_cache_size(new_size)) {
+                if constexpr (clear_memory)
+                    if (new_size > old_size)
+                        memset(reinterpret_cast<char*>(buf) + old_size, 0, new_size - old_size);
+            } else {
+                void* new_buf = alloc(new_size, alignment);
+                memcpy(new_buf, buf, std::min(old_size, new_size));
+                free(buf, old_size);
+                buf = new_buf;
+            }
         } else if (old_size < MMAP_THRESHOLD && new_size < MMAP_THRESHOLD &&
                    alignment <= MALLOC_MIN_ALIGNMENT) {
             /// Resize malloc'd memory region with no special alignment requirement.
-            // CurrentMemoryTracker::realloc(old_size, new_size);
+            doris::vectorized::thread_mem_tracker().realloc(old_size, new_size);
 
             void* new_buf = ::realloc(buf, new_size);
             if (nullptr == new_buf)
@@ -134,7 +189,7 @@ public:
                     memset(reinterpret_cast<char*>(buf) + old_size, 0, new_size - old_size);
         } else if (old_size >= MMAP_THRESHOLD && new_size >= MMAP_THRESHOLD) {
             /// Resize mmap'd memory region.
-            // CurrentMemoryTracker::realloc(old_size, new_size);
+            doris::vectorized::thread_mem_tracker().realloc(old_size, new_size);
 
             // On apple and freebsd self-implemented mremap used (common/mremap.h)
             buf = clickhouse_mremap(buf, old_size, new_size, MREMAP_MAYMOVE, PROT_READ | PROT_WRITE,
@@ -145,17 +200,18 @@ public:
                                                           std::to_string(new_size) + ".",
                                                   doris::TStatusCode::VEC_CANNOT_MREMAP);
 
+            if constexpr (clear_memory) doris::vectorized::advise_huge_pages(buf, new_size);
             /// No need for zero-fill, because mmap guarantees it.
         } else if (new_size < MMAP_THRESHOLD) {
-            /// Small allocs that requires a copy. Assume there's enough memory in system. Call CurrentMemoryTracker once.
-            // CurrentMemoryTracker::realloc(old_size, new_size);
+            /// Small allocs that requires a copy. Assume there's enough memory in system. Call the tracker once.
+            doris::vectorized::thread_mem_tracker().realloc(old_size, new_size);
 
             void* new_buf = alloc_no_track(new_size, alignment);
             memcpy(new_buf, buf, std::min(old_size, new_size));
             free_no_track(buf, old_size);
             buf = new_buf;
         } else {
-            /// Big allocs that requires a copy. MemoryTracker is called inside 'alloc', 'free' methods.
+            /// Big allocs that requires a copy. The tracker is called inside 'alloc', 'free' methods.
             void* new_buf = alloc(new_size, alignment);
             memcpy(new_buf, buf, std::min(old_size, new_size));
             free(buf, old_size);
@@ -187,7 +243,23 @@ private:
     void* alloc_no_track(size_t size, size_t alignment) {
         void* buf;
 
-        if (size >= MMAP_THRESHOLD) {
+        if (doris::vectorized::in_chunk_cache(size)) {
+            if (alignment > MMAP_MIN_ALIGNMENT)
+                throw doris::vectorized::Exception(
+                        fmt::format(
+                                "Too large alignment {}: more than page size when allocating {}.",
+                                alignment, size),
+                        doris::TStatusCode::VEC_BAD_ARGUMENTS);
+
+            buf = doris::vectorized::chunk_cache_alloc(doris::vectorized::chunk_cache_size(size));
+            if (nullptr == buf)
+                doris::vectorized::throwFromErrno(
+                        fmt::format("Allocator: Cannot allocate chunk {}.", size),
+                        doris::TStatusCode::VEC_CANNOT_ALLOCATE_MEMORY);
+
+            /// A cached chunk is not zeroed.
+            if constexpr (clear_memory) memset(buf, 0, size);
+        } else if (size >= MMAP_THRESHOLD) {
             if (alignment > MMAP_MIN_ALIGNMENT)
                 throw doris::vectorized::Exception(
                         fmt::format(
@@ -200,6 +272,7 @@ private:
                 doris::vectorized::throwFromErrno(fmt::format("Allocator: Cannot mmap {}.", size),
                                                   doris::TStatusCode::VEC_CANNOT_ALLOCATE_MEMORY);
 
+            if constexpr (clear_memory) doris::vectorized::advise_huge_pages(buf, size);
             /// No need for zero-fill, because mmap guarantees it.
         } else {
             if (alignment <= MALLOC_MIN_ALIGNMENT) {
@@ -228,7 +301,9 @@ private:
     }
 
     void free_no_track(void* buf, size_t size) {
-        if (size >= MMAP_THRESHOLD) {
+        if (doris::vectorized::in_chunk_cache(size)) {
+            doris::vectorized::chunk_cache_free(buf, doris::vectorized::chunk_cache_size(size));
+        } else if (size >= MMAP_THRESHOLD) {
             if (0 != munmap(buf, size))
                 doris::vectorized::throwFromErrno(fmt::format("Allocator: Cannot munmap {}.", size),
                                                   doris::TStatusCode::VEC_CANNOT_MUNMAP);
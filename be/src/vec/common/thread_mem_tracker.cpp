@@ -0,0 +1,61 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+#include "vec/common/thread_mem_tracker.h"
+
+#include <fmt/format.h>
+
+#include "runtime/mem_tracker.h"
+#include "vec/common/exception.h"
+
+namespace doris::vectorized {
+
+void ThreadMemTracker::flush() {
+    if (_tracker != nullptr && _untracked != 0) {
+        _tracker->Consume(_untracked);
+    }
+    _untracked = 0;
+}
+
+void ThreadMemTracker::try_consume(int64_t size) {
+    flush();
+    if (!_tracker->TryConsume(size)) {
+        throw Exception(fmt::format("Memory exceed limit. Failed to allocate {} bytes, "
+                                    "tracker={}, consumption={}, limit={}.",
+                                    size, _tracker->label(), _tracker->consumption(),
+                                    _tracker->limit()),
+                        TStatusCode::MEM_LIMIT_EXCEEDED);
+    }
+}
+
+ScopedThreadMemTracker::ScopedThreadMemTracker(const std::shared_ptr<MemTracker>& tracker,
+                                               bool check_limit) {
+    auto& thread_tracker = thread_mem_tracker();
+    thread_tracker.flush();
+    _prev_tracker = std::move(thread_tracker._tracker);
+    _prev_check_limit = thread_tracker._check_limit;
+    thread_tracker._tracker = tracker;
+    thread_tracker._check_limit = check_limit;
+}
+
+ScopedThreadMemTracker::~ScopedThreadMemTracker() {
+    auto& thread_tracker = thread_mem_tracker();
+    thread_tracker.flush();
+    thread_tracker._tracker = std::move(_prev_tracker);
+    thread_tracker._check_limit = _prev_check_limit;
+}
+
+} // namespace doris::vectorized
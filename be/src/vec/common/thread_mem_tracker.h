@@ -0,0 +1,116 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+namespace doris {
+
+class MemTracker;
+
+namespace vectorized {
+
+/** Accounts the memory allocated through Allocator (PODArray, Arena, hash tables) on the
+  * current thread to the MemTracker of the fragment instance the thread works for.
+  * Small allocations and frees are summed up in a thread local delta, which is flushed to
+  * the tracker hierarchy once it reaches BATCH_BYTES in either direction. Allocations of at
+  * least BATCH_BYTES are checked against the limits of the hierarchy before they are made,
+  * and throw an Exception with MEM_LIMIT_EXCEEDED if one would be exceeded.
+  * Nothing is tracked while no tracker is attached to the thread.
+  * Memory is often freed by another thread than the one allocating it, e.g. the blocks of the
+  * scanner threads are freed by the fragment thread, so every thread allocating for a fragment
+  * instance attaches the same tracker of the instance. Only the fragment thread, which can
+  * return the failure as the status of the query, checks the limits.
+  */
+class ThreadMemTracker {
+public:
+    static constexpr int64_t BATCH_BYTES = 1L << 20;
+
+    ~ThreadMemTracker() { flush(); }
+
+    void alloc(int64_t size) {
+        if (_tracker == nullptr) {
+            return;
+        }
+        if (size >= BATCH_BYTES && _check_limit) {
+            try_consume(size);
+            return;
+        }
+        _untracked += size;
+        if (_untracked >= BATCH_BYTES) {
+            flush();
+        }
+    }
+
+    void free(int64_t size) {
+        if (_tracker == nullptr) {
+            return;
+        }
+        _untracked -= size;
+        if (_untracked <= -BATCH_BYTES) {
+            flush();
+        }
+    }
+
+    void realloc(int64_t old_size, int64_t new_size) {
+        if (new_size > old_size) {
+            alloc(new_size - old_size);
+        } else {
+            free(old_size - new_size);
+        }
+    }
+
+    /// Pushes the local delta to the attached tracker.
+    void flush();
+
+    const std::shared_ptr<MemTracker>& tracker() const { return _tracker; }
+
+private:
+    friend class ScopedThreadMemTracker;
+
+    /// Flushes the local delta, then consumes size if no limit would be exceeded.
+    /// Throws an Exception with MEM_LIMIT_EXCEEDED otherwise.
+    void try_consume(int64_t size);
+
+    std::shared_ptr<MemTracker> _tracker;
+    bool _check_limit = true;
+    int64_t _untracked = 0;
+};
+
+inline ThreadMemTracker& thread_mem_tracker() {
+    static thread_local ThreadMemTracker tracker;
+    return tracker;
+}
+
+/// Attaches a tracker to the current thread for the lifetime of the object. The previously
+/// attached tracker, if any, is restored when it goes out of scope.
+/// Threads which can not report a failed allocation to the query, like the scanner and the
+/// RPC threads, pass check_limit = false and only account their memory.
+class ScopedThreadMemTracker {
+public:
+    explicit ScopedThreadMemTracker(const std::shared_ptr<MemTracker>& tracker,
+                                    bool check_limit = true);
+    ~ScopedThreadMemTracker();
+
+private:
+    std::shared_ptr<MemTracker> _prev_tracker;
+    bool _prev_check_limit;
+};
+
+} // namespace vectorized
+} // namespace doris
@@ -617,7 +617,13 @@ void Block::clear() {
 
 void Block::clear_column_data() noexcept {
     for (auto& d : data) {
-        (*std::move(d.column)).mutate()->clear();
+        if (d.column->use_count() > 1) {
+            // The column is shared with a block handed over by reference, e.g. to a local
+            // exchange receiver. Mutating it would copy all the data only to clear it.
+            d.column = d.column->clone_empty();
+        } else {
+            (*std::move(d.column)).mutate()->clear();
+        }
     }
 }
 
@@ -738,6 +744,14 @@ void MutableBlock::add_row(const Block* block, int row) {
     }
 }
 
+void MutableBlock::add_rows(const Block* block, const int* row_begin, const int* row_end) {
+    auto& src_columns_with_schema = block->get_columns_with_type_and_name();
+    for (size_t i = 0; i < _columns.size(); ++i) {
+        auto src_column = src_columns_with_schema[i].column->convert_to_full_column_if_const();
+        _columns[i]->insert_indices_from(*src_column, row_begin, row_end);
+    }
+}
+
 Block MutableBlock::to_block() {
     ColumnsWithTypeAndName columns_with_schema;
     for (size_t i = 0; i < _columns.size(); ++i) {
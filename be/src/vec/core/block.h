@@ -300,15 +300,14 @@ public:
     Block to_block();
 
     void add_row(const Block* block, int row);
+    // Appends the rows of block at the positions in [row_begin, row_end).
+    void add_rows(const Block* block, const int* row_begin, const int* row_end);
     std::string dump_data(size_t row_limit = 100) const;
 
     void clear() {
         _columns.clear();
         _data_types.clear();
     }
-
-    // TODO: use add_rows instead of this
-    // add_rows(Block* block,PODArray<Int32>& group,int group_num);
 };
 
 } // namespace vectorized
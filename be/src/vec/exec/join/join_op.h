@@ -33,83 +33,34 @@ struct RowRef {
     RowRef(const Block* block_, size_t row_num_) : block(block_), row_num(row_num_) {}
 };
 
-/// Single linked list of references to rows. Used for ALL JOINs (non-unique JOINs)
-struct RowRefList : RowRef {
-    /// Portion of RowRefs, 16 * (MAX_SIZE + 1) bytes sized.
-    struct Batch {
-        static constexpr size_t MAX_SIZE = 7; /// Adequate values are 3, 7, 15, 31.
+/// Reference to the first row of a key, with a flag marking whether the key was found by
+/// a probe. Used for INTERSECT and EXCEPT, which only keep one row per key.
+struct RowRefWithFlag : RowRef {
+    bool visited = false;
 
-        SizeT size = 0; /// It's smaller than size_t but keeps align in Arena.
-        Batch* next;
-        RowRef row_refs[MAX_SIZE];
-
-        Batch(Batch* parent) : next(parent) {}
-
-        bool full() const { return size == MAX_SIZE; }
-
-        Batch* insert(RowRef&& row_ref, Arena& pool) {
-            if (full()) {
-                auto batch = pool.alloc<Batch>();
-                *batch = Batch(this);
-                batch->insert(std::move(row_ref), pool);
-                return batch;
-            }
-
-            row_refs[size++] = std::move(row_ref);
-            return this;
-        }
-    };
-
-    class ForwardIterator {
-    public:
-        ForwardIterator(const RowRefList* begin)
-                : root(begin), first(true), batch(root->next), position(0) {}
-
-        const RowRef* operator->() const {
-            if (first) return root;
-            return &batch->row_refs[position];
-        }
-
-        void operator++() {
-            if (first) {
-                first = false;
-                return;
-            }
-
-            if (batch) {
-                ++position;
-                if (position >= batch->size) {
-                    batch = batch->next;
-                    position = 0;
-                }
-            }
-        }
-
-        bool ok() const { return first || (batch && position < batch->size); }
-
-    private:
-        const RowRefList* root;
-        bool first;
-        Batch* batch;
-        size_t position;
-    };
+    RowRefWithFlag() {}
+    RowRefWithFlag(const Block* block_, size_t row_num_) : RowRef(block_, row_num_) {}
+};
 
-    RowRefList() {}
-    RowRefList(const Block* block_, size_t row_num_) : RowRef(block_, row_num_) {}
+/// Position of a build row of a hash join: the index of its block in the build side and the
+/// row in that block. Half the size of a RowRef, which carries a full block pointer.
+struct RowId {
+    uint32_t block_idx = 0;
+    uint32_t row_num = 0;
 
-    ForwardIterator begin() const { return ForwardIterator(this); }
+    RowId() {}
+    RowId(uint32_t block_idx_, uint32_t row_num_) : block_idx(block_idx_), row_num(row_num_) {}
+};
 
-    /// insert element after current one
-    void insert(RowRef&& row_ref, Arena& pool) {
-        if (!next) {
-            next = pool.alloc<Batch>();
-            *next = Batch(nullptr);
-        }
-        next = next->insert(std::move(row_ref), pool);
-    }
+/// The rows of one build key. Used for ALL JOINs (non-unique JOINs).
+/// While the build side is consumed only the group of every row is recorded. Once it is
+/// complete, the rows are laid out group by group in one flat RowId array and the group
+/// addresses its range [offsets[group], offsets[group + 1]) of it.
+struct RowIdGroup {
+    uint32_t group = 0;
 
-private:
-    Batch* next = nullptr;
+    RowIdGroup() {}
+    RowIdGroup(uint32_t group_) : group(group_) {}
 };
 
 // using MapI32 = doris::vectorized::HashMap<UInt32, MappedAll, HashCRC32<UInt32>>;
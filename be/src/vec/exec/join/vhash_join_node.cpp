@@ -17,6 +17,8 @@
 
 #include "vec/exec/join/vhash_join_node.h"
 
+#include <limits>
+
 #include "gen_cpp/PlanNodes_types.h"
 #include "util/defer_op.h"
 #include "vec/core/materialize_block.h"
@@ -28,12 +30,15 @@
 namespace doris::vectorized {
 
 using ProfileCounter = RuntimeProfile::Counter;
+
+static constexpr uint32_t INVALID_GROUP = std::numeric_limits<uint32_t>::max();
+// How many rows ahead the gather of the build columns prefetches
+static constexpr size_t GATHER_PREFETCH_STEP = 16;
+
 template <class HashTableContext, bool has_null_map>
 struct ProcessHashTableBuild {
-    ProcessHashTableBuild(int rows, Block& acquired_block, ColumnRawPtrs& build_raw_ptrs,
-                          HashJoinNode* join_node)
+    ProcessHashTableBuild(int rows, ColumnRawPtrs& build_raw_ptrs, HashJoinNode* join_node)
             : _rows(rows),
-              _acquired_block(acquired_block),
               _build_raw_ptrs(build_raw_ptrs),
               _join_node(join_node) {}
 
@@ -48,11 +53,17 @@ struct ProcessHashTableBuild {
 
         KeyGetter key_getter(_build_raw_ptrs, _join_node->_build_key_sz, nullptr);
 
+        auto& group_sizes = _join_node->_build_group_offsets;
+        auto& row_groups = _join_node->_build_row_groups;
+        size_t first_row = row_groups.size();
+        row_groups.resize(first_row + _rows);
+
         SCOPED_TIMER(_join_node->_build_table_insert_timer);
         for (size_t k = 0; k < _rows; ++k) {
             // TODO: make this as constexpr
             if constexpr (has_null_map) {
                 if ((*null_map)[k]) {
+                    row_groups[first_row + k] = INVALID_GROUP;
                     continue;
                 }
             }
@@ -64,11 +75,13 @@ struct ProcessHashTableBuild {
             }
 
             if (emplace_result.is_inserted()) {
-                new (&emplace_result.get_mapped()) Mapped({&_acquired_block, k});
-            } else {
-                /// The first element of the list is stored in the value of the hash table, the rest in the pool.
-                emplace_result.get_mapped().insert({&_acquired_block, k}, _join_node->_arena);
+                new (&emplace_result.get_mapped()) Mapped(group_sizes.size());
+                group_sizes.push_back(0);
             }
+            /// Only count the rows of the group here, they are laid out by _build_flat_rows()
+            auto group = emplace_result.get_mapped().group;
+            ++group_sizes[group];
+            row_groups[first_row + k] = group;
         }
 
         return Status::OK();
@@ -76,7 +89,6 @@ struct ProcessHashTableBuild {
 
 private:
     const int _rows;
-    Block& _acquired_block;
     ColumnRawPtrs& _build_raw_ptrs;
     HashJoinNode* _join_node;
 };
@@ -107,6 +119,10 @@ struct ProcessHashTableProbe {
         auto& mcol = mutable_block.mutable_columns();
         offset_data.assign(_probe_rows, (uint32_t)0);
 
+        const auto& build_row_ids = _join_node->_build_row_ids;
+        const auto& group_offsets = _join_node->_build_group_offsets;
+        _matched_rows.clear();
+
         int right_col_idx = _left_table_data_types.size();
         int current_offset = 0;
 
@@ -125,15 +141,11 @@ struct ProcessHashTableProbe {
             }
 
             if (find_result.is_found()) {
-                auto& mapped = find_result.get_mapped();
-                for (auto it = mapped.begin(); it.ok(); ++it) {
-                    int size = _right_table_data_types.size();
-                    for (size_t j = 0; j < size; ++j) {
-                        auto& column = *it->block->get_by_position(j).column;
-                        mcol[j + right_col_idx]->insert_from(column, it->row_num);
-                    }
-                    ++current_offset;
-                }
+                auto group = find_result.get_mapped().group;
+                auto begin = build_row_ids.begin() + group_offsets[group];
+                auto end = build_row_ids.begin() + group_offsets[group + 1];
+                _matched_rows.insert(_matched_rows.end(), begin, end);
+                current_offset += end - begin;
             }
 
             offset_data[_probe_index++] = current_offset;
@@ -147,6 +159,13 @@ struct ProcessHashTableProbe {
             offset_data[i] = current_offset;
         }
 
+        {
+            SCOPED_TIMER(_join_node->_probe_gather_timer);
+            for (size_t j = 0; j < _right_table_data_types.size(); ++j) {
+                _gather_build_column(_join_node->_build_columns[j], *mcol[j + right_col_idx]);
+            }
+        }
+
         output_block->swap(mutable_block.to_block());
         for (int i = 0; i < right_col_idx; ++i) {
             auto& column = _probe_block.get_by_position(i).column;
@@ -168,6 +187,32 @@ struct ProcessHashTableProbe {
     }
 
 private:
+    // Copies the matched rows of one build column, a column at a time so that the destination
+    // stays in cache. The source rows of fixed size columns are prefetched a few rows ahead.
+    void _gather_build_column(const ColumnRawPtrs& build_columns, IColumn& dst) {
+        const size_t num_rows = _matched_rows.size();
+        dst.reserve(dst.size() + num_rows);
+
+        const bool is_fixed = !build_columns.empty() && build_columns[0]->is_fixed_and_contiguous();
+        size_t value_size = 0;
+        _raw_data.clear();
+        if (is_fixed) {
+            value_size = build_columns[0]->size_of_value_if_fixed();
+            for (const auto* column : build_columns) {
+                _raw_data.push_back(column->get_raw_data().data);
+            }
+        }
+
+        for (size_t k = 0; k < num_rows; ++k) {
+            if (is_fixed && k + GATHER_PREFETCH_STEP < num_rows) {
+                const auto& next = _matched_rows[k + GATHER_PREFETCH_STEP];
+                __builtin_prefetch(_raw_data[next.block_idx] + next.row_num * value_size);
+            }
+            const auto& row_id = _matched_rows[k];
+            dst.insert_from(*build_columns[row_id.block_idx], row_id.row_num);
+        }
+    }
+
     HashJoinNode* _join_node;
     const DataTypes& _left_table_data_types;
     const DataTypes& _right_table_data_types;
@@ -179,6 +224,10 @@ private:
     ColumnRawPtrs& _probe_raw_ptrs;
     Arena& _arena;
 
+    // Build rows matched by the probe rows of this batch, in output order
+    std::vector<RowId> _matched_rows;
+    std::vector<const char*> _raw_data;
+
     ProfileCounter* _rows_returned_counter;
 };
 
@@ -395,9 +444,46 @@ Status HashJoinNode::_hash_table_build(RuntimeState* state) {
         RETURN_IF_ERROR(child(1)->get_next(state, &block, &eos));
         RETURN_IF_ERROR(_process_build_block(block));
     }
+    _build_flat_rows();
     return Status::OK();
 }
 
+void HashJoinNode::_build_flat_rows() {
+    SCOPED_TIMER(_build_table_spread_timer);
+    // Turn the row counts of the groups into the end offsets of the groups, then place every
+    // row at the end of its group going backwards, which leaves the offsets at the beginning
+    // of the groups and keeps the rows of a group in build order.
+    auto& group_offsets = _build_group_offsets;
+    uint32_t total_rows = 0;
+    for (auto& offset : group_offsets) {
+        total_rows += offset;
+        offset = total_rows;
+    }
+    group_offsets.push_back(total_rows);
+
+    _build_row_ids.resize(total_rows);
+    size_t row_pos = _build_row_groups.size();
+    for (size_t block_idx = _build_blocks.size(); block_idx > 0; --block_idx) {
+        size_t rows = _build_blocks[block_idx - 1].rows();
+        for (size_t row = rows; row > 0; --row) {
+            auto group = _build_row_groups[--row_pos];
+            if (group != INVALID_GROUP) {
+                _build_row_ids[--group_offsets[group]] = RowId(block_idx - 1, row - 1);
+            }
+        }
+    }
+    DCHECK_EQ(row_pos, 0);
+    std::vector<uint32_t>().swap(_build_row_groups);
+
+    _build_columns.resize(_right_table_data_types.size());
+    for (size_t i = 0; i < _build_columns.size(); ++i) {
+        _build_columns[i].reserve(_build_blocks.size());
+        for (const auto& block : _build_blocks) {
+            _build_columns[i].push_back(block.get_by_position(i).column.get());
+        }
+    }
+}
+
 template <bool asymmetric_null>
 Status HashJoinNode::extract_eq_join_column(VExprContexts& exprs, Block& block, NullMap& null_map,
                                             ColumnRawPtrs& raw_ptrs, bool& has_null) {
@@ -435,7 +521,11 @@ Status HashJoinNode::_process_build_block(Block& block) {
     if (rows == 0) {
         return Status::OK();
     }
-    auto& acquired_block = _acquire_list.acquire(std::move(block));
+    if (_build_row_groups.size() + rows > std::numeric_limits<uint32_t>::max()) {
+        return Status::InternalError("Too many rows in the build side of hash join");
+    }
+    _build_blocks.emplace_back(std::move(block));
+    auto& acquired_block = _build_blocks.back();
 
     materialize_block_inplace(acquired_block);
 
@@ -465,11 +555,11 @@ Status HashJoinNode::_process_build_block(Block& block) {
                 if constexpr (!std::is_same_v<HashTableCtxType, std::monostate>) {
                     if (has_null) {
                         ProcessHashTableBuild<HashTableCtxType, true> hash_table_build_process(
-                                rows, acquired_block, raw_ptrs, this);
+                                rows, raw_ptrs, this);
                         st = hash_table_build_process(arg, &null_map_val);
                     } else {
                         ProcessHashTableBuild<HashTableCtxType, false> hash_table_build_process(
-                                rows, acquired_block, raw_ptrs, this);
+                                rows, raw_ptrs, this);
                         st = hash_table_build_process(arg, &null_map_val);
                     }
                 } else {
@@ -498,7 +588,7 @@ void HashJoinNode::_hash_table_init() {
             _hash_table_variants.emplace<I64HashTableContext>();
             break;
         default:
-            _hash_table_variants.emplace<SerializedHashTableContext>();
+            _hash_table_variants.emplace<SerializedHashTableContext<RowIdGroup>>();
         }
         return;
     }
@@ -547,7 +637,7 @@ void HashJoinNode::_hash_table_init() {
             }
         }
     } else {
-        _hash_table_variants.emplace<SerializedHashTableContext>();
+        _hash_table_variants.emplace<SerializedHashTableContext<RowIdGroup>>();
     }
 }
 
@@ -30,8 +30,9 @@
 namespace doris {
 namespace vectorized {
 
+template <typename RowRefListType>
 struct SerializedHashTableContext {
-    using Mapped = RowRefList;
+    using Mapped = RowRefListType;
     using HashTable = HashMap<StringRef, Mapped>;
     using State = ColumnsHashing::HashMethodSerialized<typename HashTable::value_type, Mapped>;
 
@@ -40,9 +41,9 @@ struct SerializedHashTableContext {
 };
 
 // T should be UInt32 UInt64 UInt128
-template <class T>
+template <class T, typename RowRefListType>
 struct PrimaryTypeHashTableContext {
-    using Mapped = RowRefList;
+    using Mapped = RowRefListType;
     using HashTable = HashMap<T, Mapped, HashCRC32<T>>;
     using State =
             ColumnsHashing::HashMethodOneNumber<typename HashTable::value_type, Mapped, T, false>;
@@ -52,11 +53,11 @@ struct PrimaryTypeHashTableContext {
 };
 
 // TODO: use FixedHashTable instead of HashTable
-using I8HashTableContext = PrimaryTypeHashTableContext<UInt8>;
-using I16HashTableContext = PrimaryTypeHashTableContext<UInt16>;
+using I8HashTableContext = PrimaryTypeHashTableContext<UInt8, RowIdGroup>;
+using I16HashTableContext = PrimaryTypeHashTableContext<UInt16, RowIdGroup>;
 
-using I32HashTableContext = PrimaryTypeHashTableContext<UInt32>;
-using I64HashTableContext = PrimaryTypeHashTableContext<UInt64>;
+using I32HashTableContext = PrimaryTypeHashTableContext<UInt32, RowIdGroup>;
+using I64HashTableContext = PrimaryTypeHashTableContext<UInt64, RowIdGroup>;
 
 template <class T>
 struct HashTableFunc;
@@ -71,9 +72,9 @@ struct HashTableFunc<UInt128> {
     using Func = UInt128HashCRC32;
 };
 
-template <class T, bool has_null>
+template <class T, bool has_null, typename RowRefListType>
 struct FixedKeyHashTableContext {
-    using Mapped = RowRefList;
+    using Mapped = RowRefListType;
     using HashTable = HashMap<T, Mapped, typename HashTableFunc<T>::Func>;
     using State = ColumnsHashing::HashMethodKeysFixed<typename HashTable::value_type, T, Mapped,
                                                       has_null, false>;
@@ -82,13 +83,13 @@ struct FixedKeyHashTableContext {
 };
 
 template <bool has_null>
-using I64FixedKeyHashTableContext = FixedKeyHashTableContext<UInt64, has_null>;
+using I64FixedKeyHashTableContext = FixedKeyHashTableContext<UInt64, has_null, RowIdGroup>;
 
 template <bool has_null>
-using I128FixedKeyHashTableContext = FixedKeyHashTableContext<UInt128, has_null>;
+using I128FixedKeyHashTableContext = FixedKeyHashTableContext<UInt128, has_null, RowIdGroup>;
 
 using HashTableVariants =
-        std::variant<std::monostate, SerializedHashTableContext, I8HashTableContext,
+        std::variant<std::monostate, SerializedHashTableContext<RowIdGroup>, I8HashTableContext,
                      I16HashTableContext, I32HashTableContext, I64HashTableContext,
                      I64FixedKeyHashTableContext<true>, I64FixedKeyHashTableContext<false>,
                      I128FixedKeyHashTableContext<true>, I128FixedKeyHashTableContext<false>>;
@@ -153,7 +154,17 @@ private:
 
     Arena _arena;
     HashTableVariants _hash_table_variants;
-    AcquireList<Block> _acquire_list;
+    Blocks _build_blocks;
+
+    // Group of every build row in build order, INVALID_GROUP for the rows with a null key.
+    // Only needed until the flat layout is built.
+    std::vector<uint32_t> _build_row_groups;
+    // Number of rows of every group while building, then the offsets of the groups in
+    // _build_row_ids, with one more element for the end of the last group.
+    std::vector<uint32_t> _build_group_offsets;
+    std::vector<RowId> _build_row_ids;
+    // _build_columns[i][block_idx] is the i-th column of a build block
+    std::vector<ColumnRawPtrs> _build_columns;
 
     Block _probe_block;
     ColumnRawPtrs _probe_columns;
@@ -167,6 +178,8 @@ private:
 private:
     Status _hash_table_build(RuntimeState* state);
     Status _process_build_block(Block& block);
+    // Lays out the build rows contiguously by group once the build side is consumed.
+    void _build_flat_rows();
 
     template <bool asymmetric_null>
     Status extract_eq_join_column(VExprContexts& exprs, Block& block, NullMap& null_map,
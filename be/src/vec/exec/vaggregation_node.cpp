@@ -22,6 +22,7 @@
 #include "exec/exec_node.h"
 #include "runtime/mem_pool.h"
 #include "runtime/row_batch.h"
+#include "util/cpu_info.h"
 #include "util/defer_op.h"
 #include "vec/core/block.h"
 #include "vec/data_types/data_type_nullable.h"
@@ -60,8 +61,8 @@ struct StreamingHtMinReductionEntry {
     double streaming_ht_min_reduction;
 };
 
-// TODO: experimentally tune these values and also programmatically get the cache size
-// of the machine that we're running on.
+// TODO: experimentally tune these values. The 'min_ht_mem' values are only defaults,
+// prepare() replaces them with the L2 and L3 cache sizes of the machine when known.
 static constexpr StreamingHtMinReductionEntry STREAMING_HT_MIN_REDUCTION[] = {
         // Expand up to L2 cache always.
         {0, 0.0},
@@ -74,6 +75,14 @@ static constexpr StreamingHtMinReductionEntry STREAMING_HT_MIN_REDUCTION[] = {
 static constexpr int STREAMING_HT_MIN_REDUCTION_SIZE =
         sizeof(STREAMING_HT_MIN_REDUCTION) / sizeof(STREAMING_HT_MIN_REDUCTION[0]);
 
+/// Once the hash table stopped growing, a batch that collapses less than this factor
+/// is not worth hashing into the bounded table, its rows are passed through instead.
+static constexpr double STREAMING_HT_MIN_BATCH_REDUCTION = 1.1;
+
+/// While passing rows through, one out of this many batches is hashed again to sample
+/// the reduction of the current input.
+static constexpr int64_t STREAMING_PREAGG_SAMPLE_INTERVAL = 16;
+
 AggregationNode::AggregationNode(ObjectPool* pool, const TPlanNode& tnode,
                                  const DescriptorTbl& descs)
         : ExecNode(pool, tnode, descs),
@@ -84,6 +93,7 @@ AggregationNode::AggregationNode(ObjectPool* pool, const TPlanNode& tnode,
           _needs_finalize(tnode.agg_node.need_finalize),
           _is_merge(false),
           _agg_data(),
+          _agg_arena_pool(new Arena),
           _build_timer(nullptr),
           _exec_timer(nullptr),
           _merge_timer(nullptr) {
@@ -283,8 +293,6 @@ Status AggregationNode::prepare(RuntimeState* state) {
                                                      std::placeholders::_3);
         }
 
-        _executor.update_memusage =
-                std::bind<void>(&AggregationNode::_update_memusage_without_key, this);
         _executor.close = std::bind<void>(&AggregationNode::_close_without_key, this);
     } else {
         _init_hash_method(_probe_expr_ctxs);
@@ -300,7 +308,28 @@ Status AggregationNode::prepare(RuntimeState* state) {
             _executor.pre_agg =
                     std::bind<Status>(&AggregationNode::_pre_agg_with_serialized_key, this,
                                       std::placeholders::_1, std::placeholders::_2);
-            _max_size_of_stream_pre_agg_buffer = state->batch_size();
+
+            _preagg_streaming_ht_min_reduction = ADD_COUNTER(
+                    runtime_profile(), "StreamingHtMinReduction", TUnit::DOUBLE_VALUE);
+            _preagg_hash_reduction =
+                    ADD_COUNTER(runtime_profile(), "HashReduction", TUnit::DOUBLE_VALUE);
+            _preagg_bounded_hash_reduction =
+                    ADD_COUNTER(runtime_profile(), "BoundedHashReduction", TUnit::DOUBLE_VALUE);
+            _preagg_reduction =
+                    ADD_COUNTER(runtime_profile(), "PreAggReduction", TUnit::DOUBLE_VALUE);
+            _preagg_passthrough_rows =
+                    ADD_COUNTER(runtime_profile(), "RowsPassedThrough", TUnit::UNIT);
+            _preagg_flush_counter =
+                    ADD_COUNTER(runtime_profile(), "HashTableFlushCount", TUnit::UNIT);
+
+            long l2_cache_size = CpuInfo::get_cache_size(CpuInfo::L2_CACHE);
+            long l3_cache_size = CpuInfo::get_cache_size(CpuInfo::L3_CACHE);
+            _streaming_ht_min_mem.resize(STREAMING_HT_MIN_REDUCTION_SIZE);
+            for (int i = 0; i < STREAMING_HT_MIN_REDUCTION_SIZE; ++i) {
+                _streaming_ht_min_mem[i] = STREAMING_HT_MIN_REDUCTION[i].min_ht_mem;
+            }
+            if (l2_cache_size > 0) _streaming_ht_min_mem[1] = l2_cache_size;
+            if (l3_cache_size > l2_cache_size) _streaming_ht_min_mem[2] = l3_cache_size;
         }
 
         if (_needs_finalize) {
@@ -312,8 +341,6 @@ Status AggregationNode::prepare(RuntimeState* state) {
                     &AggregationNode::_serialize_with_serialized_key_result, this,
                     std::placeholders::_1, std::placeholders::_2, std::placeholders::_3);
         }
-        _executor.update_memusage =
-                std::bind<void>(&AggregationNode::_update_memusage_with_serialized_key, this);
         _executor.close = std::bind<void>(&AggregationNode::_close_with_serialized_key, this);
     }
 
@@ -345,7 +372,6 @@ Status AggregationNode::open(RuntimeState* state) {
             continue;
         }
         RETURN_IF_ERROR(_executor.execute(&block));
-        _executor.update_memusage();
         RETURN_IF_LIMIT_EXCEEDED(state, "aggregator, while execute open.");
     }
 
@@ -360,13 +386,12 @@ Status AggregationNode::get_next(RuntimeState* state, Block* block, bool* eos) {
     SCOPED_TIMER(_runtime_profile->total_time_counter());
 
     if (_is_streaming_preagg) {
-        bool child_eos = false;
-
         RETURN_IF_CANCELLED(state);
-        do {
+        _preagg_block.clear_column_data();
+        while (_preagg_block.rows() == 0 && !_child_eos) {
             _preagg_block.clear_column_data();
-            RETURN_IF_ERROR(_children[0]->get_next(state, &_preagg_block, &child_eos));
-        } while (_preagg_block.rows() == 0 && !child_eos);
+            RETURN_IF_ERROR(_children[0]->get_next(state, &_preagg_block, &_child_eos));
+        }
 
         if (_preagg_block.rows() != 0) {
             RETURN_IF_ERROR(_executor.pre_agg(&_preagg_block, block));
@@ -384,7 +409,6 @@ Status AggregationNode::get_next(RuntimeState* state, Block* block, bool* eos) {
         }
     }
 
-    _executor.update_memusage();
     RETURN_IF_LIMIT_EXCEEDED(state, "aggregator, while execute get_next.");
     _num_rows_returned += block->rows();
     COUNTER_SET(_rows_returned_counter, _num_rows_returned);
@@ -527,11 +551,11 @@ Status AggregationNode::_merge_without_key(Block* block) {
 
                 _aggregate_evaluators[i]->function()->deserialize(
                         deserialize_buffer.get() + _offsets_of_aggregate_states[i], buffer_reader,
-                        &_agg_arena_pool);
+                        _agg_arena_pool.get());
 
                 _aggregate_evaluators[i]->function()->merge(
                         _agg_data.without_key + _offsets_of_aggregate_states[i],
-                        deserialize_buffer.get() + _offsets_of_aggregate_states[i], &_agg_arena_pool);
+                        deserialize_buffer.get() + _offsets_of_aggregate_states[i], _agg_arena_pool.get());
 
                 _destory_agg_status(deserialize_buffer.get());
             }
@@ -543,20 +567,14 @@ Status AggregationNode::_merge_without_key(Block* block) {
     return Status::OK();
 }
 
-void AggregationNode::_update_memusage_without_key() {
-    mem_tracker()->Consume(_agg_arena_pool.size() - _mem_usage_record.used_in_arena);
-    _mem_usage_record.used_in_arena = _agg_arena_pool.size();
-}
-
 void AggregationNode::_close_without_key() {
     _destory_agg_status(_agg_data.without_key);
-    release_tracker();
 }
 
 bool AggregationNode::_should_expand_preagg_hash_tables() {
     if (!_should_expand_hash_table) return false;
 
-    return std::visit([&](auto&& agg_method)-> bool { 
+    return std::visit([&](auto&& agg_method)-> bool {
         auto& hash_tbl = agg_method.data;
         auto [ht_mem, ht_rows] = std::pair{hash_tbl.get_buffer_size_in_bytes(), hash_tbl.size()};
 
@@ -566,37 +584,22 @@ bool AggregationNode::_should_expand_preagg_hash_tables() {
         // Find the appropriate reduction factor in our table for the current hash table sizes.
         int cache_level = 0;
         while (cache_level + 1 < STREAMING_HT_MIN_REDUCTION_SIZE &&
-            ht_mem >= STREAMING_HT_MIN_REDUCTION[cache_level + 1].min_ht_mem) {
+            ht_mem >= _streaming_ht_min_mem[cache_level + 1]) {
             ++cache_level;
         }
 
         // Compare the number of rows in the hash table with the number of input rows that
-        // were aggregated into it. Exclude passed through rows from this calculation since
-        // they were not in hash tables.
-        const int64_t input_rows = _children[0]->rows_returned();
-        const int64_t aggregated_input_rows = input_rows - _num_rows_returned;
-        // TODO chenhao
-        //  const int64_t expected_input_rows = estimated_input_cardinality_ - num_rows_returned_;
-        double current_reduction = static_cast<double>(aggregated_input_rows) / ht_rows;
-
-        // TODO: workaround for IMPALA-2490: subplan node rows_returned counter may be
-        // inaccurate, which could lead to a divide by zero below.
+        // were aggregated into it. Passed through rows are not part of this calculation
+        // since they were not in hash tables, and the table is only expanded in HASH mode.
+        const int64_t aggregated_input_rows = _preagg_input_rows[HASH];
         if (aggregated_input_rows <= 0) return true;
+        double current_reduction = static_cast<double>(aggregated_input_rows) / ht_rows;
 
-        // Extrapolate the current reduction factor (r) using the formula
-        // R = 1 + (N / n) * (r - 1), where R is the reduction factor over the full input data
-        // set, N is the number of input rows, excluding passed-through rows, and n is the
-        // number of rows inserted or merged into the hash tables. This is a very rough
-        // approximation but is good enough to be useful.
-        // TODO: consider collecting more statistics to better estimate reduction.
-        //  double estimated_reduction = aggregated_input_rows >= expected_input_rows
-        //      ? current_reduction
-        //      : 1 + (expected_input_rows / aggregated_input_rows) * (current_reduction - 1);
+        // TODO: extrapolate the current reduction factor (r) using the formula
+        // R = 1 + (N / n) * (r - 1) once the planner sends the estimated input cardinality.
         double min_reduction = STREAMING_HT_MIN_REDUCTION[cache_level].streaming_ht_min_reduction;
+        COUNTER_SET(_preagg_streaming_ht_min_reduction, min_reduction);
 
-        //  COUNTER_SET(preagg_estimated_reduction_, estimated_reduction);
-        //    COUNTER_SET(preagg_streaming_ht_min_reduction_, min_reduction);
-        //  return estimated_reduction > min_reduction;
         _should_expand_hash_table = current_reduction > min_reduction;
         return _should_expand_hash_table;
     }, _agg_data._aggregated_method_variant);
@@ -619,82 +622,38 @@ Status AggregationNode::_pre_agg_with_serialized_key(doris::vectorized::Block* i
     }
 
     int rows = in_block->rows();
-    PODArray<AggregateDataPtr> places(rows);
+    bool is_sample_batch = ++_num_preagg_batches % STREAMING_PREAGG_SAMPLE_INTERVAL == 0;
+    if (_preagg_mode == PASS_THROUGH && !is_sample_batch) {
+        return _pass_through_pre_agg_block(in_block, key_columns, out_block);
+    }
 
     // Stop expanding hash tables if we're not reducing the input sufficiently. As our
     // hash tables expand out of each level of cache hierarchy, every hash table lookup
     // will take longer. We also may not be able to expand hash tables because of memory
-    // pressure. In either case we should always use the remaining space in the hash table
-    // to avoid wasting memory.
+    // pressure. In either case the table keeps its current, cache sized, buffer and the
+    // reduction of the last hashed batch decides whether to go on hashing into it or to
+    // pass the rows through.
     // But for fixed hash map, it never need to expand
-    bool ret_flag = false;
-    std::visit([&](auto&& agg_method)-> void { 
-        if (auto& hash_tbl = agg_method.data; hash_tbl.add_elem_size_overflow(rows)) {
-            // do not try to do agg, just init and serialize directly return the out_block
-            if (!_should_expand_preagg_hash_tables()) {
-                if (_streaming_pre_agg_buffer == nullptr) {
-                    _streaming_pre_agg_buffer = _agg_arena_pool.aligned_alloc(
-                            _total_size_of_aggregate_states * _max_size_of_stream_pre_agg_buffer,
-                            _align_aggregate_states);
-                }
-
-                auto aggregate_data = _streaming_pre_agg_buffer;
-                for (size_t i = 0; i < rows; ++i) {
-                    _create_agg_status(aggregate_data);
-                    places[i] = aggregate_data;
-                    aggregate_data += _total_size_of_aggregate_states;
-                }
-                for (int i = 0; i < _aggregate_evaluators.size(); ++i) {
-                    _aggregate_evaluators[i]->execute_batch_add(
-                            in_block, _offsets_of_aggregate_states[i], places.data(), &_agg_arena_pool);
-                }
-
-                // will serialize value data to string column
-                std::vector<VectorBufferWriter> value_buffer_writers;
-                bool mem_reuse = out_block->mem_reuse();
-                auto serialize_string_type = std::make_shared<DataTypeString>();
-                MutableColumns value_columns;
-                for (int i = 0; i <  _aggregate_evaluators.size(); ++i) {
-                    if (mem_reuse) {
-                        value_columns.emplace_back(
-                                std::move(*out_block->get_by_position(i + key_size).column).mutate());
-                    } else {
-                        // slot type of value it should always be string type
-                        value_columns.emplace_back(serialize_string_type->create_column());
-                    }
-                    value_buffer_writers.emplace_back(*reinterpret_cast<ColumnString*>(value_columns[i].get()));
-                }
-
-                aggregate_data = _streaming_pre_agg_buffer;
-                for (size_t j = 0; j < rows; ++j) {
-                    for (size_t i = 0; i < _aggregate_evaluators.size(); ++i) {
-                        _aggregate_evaluators[i]->function()->serialize(
-                        aggregate_data + _offsets_of_aggregate_states[i], value_buffer_writers[i]);
-                        value_buffer_writers[i].commit();
-                    }
-                    aggregate_data += _total_size_of_aggregate_states;
-                }
+    bool ht_is_full = std::visit([&](auto&& agg_method) -> bool {
+        return agg_method.data.add_elem_size_overflow(rows);
+    }, _agg_data._aggregated_method_variant);
 
-                if (!mem_reuse) {
-                    ColumnsWithTypeAndName columns_with_schema;
-                    for (int i = 0; i < key_size; ++i) {
-                        columns_with_schema.emplace_back(key_columns[i]->clone_resized(rows),
-                                                _probe_expr_ctxs[i]->root()->data_type(), "");
-                    }
-                    for (int i = 0; i < value_columns.size(); ++i) {
-                        columns_with_schema.emplace_back(std::move(value_columns[i]), serialize_string_type, "");
-                    }
-                    out_block->swap(Block(columns_with_schema));
-                } else {
-                    for (int i = 0; i < key_size; ++i) {
-                        std::move(*out_block->get_by_position(i).column).mutate()
-                            ->insert_range_from(*key_columns[i], 0, rows);
-                    }
-                }
-                ret_flag = true;
-            }
+    if (ht_is_full && !_should_expand_preagg_hash_tables()) {
+        if (_preagg_mode == HASH) {
+            _preagg_mode = _last_batch_reduction >= STREAMING_HT_MIN_BATCH_REDUCTION
+                                   ? BOUNDED_HASH
+                                   : PASS_THROUGH;
+        }
+        // the groups stay in the table while rows are passed through, they are only
+        // evicted when a sample batch needs the room
+        if (_preagg_mode == PASS_THROUGH && !is_sample_batch) {
+            return _pass_through_pre_agg_block(in_block, key_columns, out_block);
         }
-    },  _agg_data._aggregated_method_variant);
+        RETURN_IF_ERROR(_flush_pre_agg_hash_table(out_block));
+    }
+
+    PODArray<AggregateDataPtr> places(rows);
+    size_t new_groups = 0;
 
     std::visit([&](auto&& agg_method)-> void {
         using HashMethodType = std::decay_t<decltype(agg_method)>;
@@ -704,18 +663,19 @@ Status AggregationNode::_pre_agg_with_serialized_key(doris::vectorized::Block* i
         for (size_t i = 0; i < rows; ++i) {
             AggregateDataPtr aggregate_data = nullptr;
 
-            auto emplace_result = state.emplace_key(agg_method.data, i, _agg_arena_pool);
+            auto emplace_result = state.emplace_key(agg_method.data, i, *_agg_arena_pool);
 
             /// If a new key is inserted, initialize the states of the aggregate functions, and possibly something related to the key.
             if (emplace_result.is_inserted()) {
                 /// exception-safety - if you can not allocate memory or create states, then destructors will not be called.
                 emplace_result.set_mapped(nullptr);
 
-                aggregate_data = _agg_arena_pool.aligned_alloc(_total_size_of_aggregate_states,
+                aggregate_data = _agg_arena_pool->aligned_alloc(_total_size_of_aggregate_states,
                                                             _align_aggregate_states);
                 _create_agg_status(aggregate_data);
 
                 emplace_result.set_mapped(aggregate_data);
+                ++new_groups;
             } else
                 aggregate_data = emplace_result.get_mapped();
 
@@ -726,12 +686,197 @@ Status AggregationNode::_pre_agg_with_serialized_key(doris::vectorized::Block* i
 
     for (int i = 0; i < _aggregate_evaluators.size(); ++i) {
         _aggregate_evaluators[i]->execute_batch_add(in_block, _offsets_of_aggregate_states[i],
-                                                    places.data(), &_agg_arena_pool);
+                                                    places.data(), _agg_arena_pool.get());
+    }
+
+    // a sample batch taken while passing through is accounted to the bounded table
+    auto hashed_mode = _preagg_mode == HASH ? HASH : BOUNDED_HASH;
+    _preagg_input_rows[hashed_mode] += rows;
+    _preagg_output_rows[hashed_mode] += new_groups;
+    _last_batch_reduction = static_cast<double>(rows) / std::max<size_t>(new_groups, 1);
+    if (_preagg_mode != HASH) {
+        _preagg_mode = _last_batch_reduction >= STREAMING_HT_MIN_BATCH_REDUCTION ? BOUNDED_HASH
+                                                                                 : PASS_THROUGH;
+    }
+    _update_pre_agg_counters();
+
+    return Status::OK();
+}
+
+Status AggregationNode::_pass_through_pre_agg_block(Block* in_block,
+                                                    const ColumnRawPtrs& key_columns,
+                                                    Block* out_block) {
+    size_t key_size = key_columns.size();
+    size_t rows = in_block->rows();
+
+    // one state per row, they are destroyed as soon as they are serialized, so they
+    // must not live in the arena of the hash table
+    Arena arena;
+    PODArray<AggregateDataPtr> places(rows);
+    auto aggregate_data =
+            arena.aligned_alloc(_total_size_of_aggregate_states * rows, _align_aggregate_states);
+    for (size_t i = 0; i < rows; ++i) {
+        _create_agg_status(aggregate_data);
+        places[i] = aggregate_data;
+        aggregate_data += _total_size_of_aggregate_states;
+    }
+    Defer defer {[&]() {
+        for (size_t i = 0; i < rows; ++i) {
+            _destory_agg_status(places[i]);
+        }
+    }};
+
+    for (int i = 0; i < _aggregate_evaluators.size(); ++i) {
+        _aggregate_evaluators[i]->execute_batch_add(in_block, _offsets_of_aggregate_states[i],
+                                                    places.data(), &arena);
+    }
+
+    // will serialize value data to string column
+    std::vector<VectorBufferWriter> value_buffer_writers;
+    bool mem_reuse = out_block->mem_reuse();
+    auto serialize_string_type = std::make_shared<DataTypeString>();
+    MutableColumns value_columns;
+    for (int i = 0; i < _aggregate_evaluators.size(); ++i) {
+        if (mem_reuse) {
+            value_columns.emplace_back(
+                    std::move(*out_block->get_by_position(i + key_size).column).mutate());
+        } else {
+            // slot type of value it should always be string type
+            value_columns.emplace_back(serialize_string_type->create_column());
+        }
+        value_buffer_writers.emplace_back(*reinterpret_cast<ColumnString*>(value_columns[i].get()));
+    }
+
+    for (size_t j = 0; j < rows; ++j) {
+        for (size_t i = 0; i < _aggregate_evaluators.size(); ++i) {
+            _aggregate_evaluators[i]->function()->serialize(
+                    places[j] + _offsets_of_aggregate_states[i], value_buffer_writers[i]);
+            value_buffer_writers[i].commit();
+        }
+    }
+
+    if (!mem_reuse) {
+        ColumnsWithTypeAndName columns_with_schema;
+        for (int i = 0; i < key_size; ++i) {
+            columns_with_schema.emplace_back(key_columns[i]->clone_resized(rows),
+                                             _probe_expr_ctxs[i]->root()->data_type(), "");
+        }
+        for (int i = 0; i < value_columns.size(); ++i) {
+            columns_with_schema.emplace_back(std::move(value_columns[i]), serialize_string_type,
+                                             "");
+        }
+        out_block->swap(Block(columns_with_schema));
+    } else {
+        for (int i = 0; i < key_size; ++i) {
+            std::move(*out_block->get_by_position(i).column)
+                    .mutate()
+                    ->insert_range_from(*key_columns[i], 0, rows);
+        }
     }
 
+    _preagg_input_rows[PASS_THROUGH] += rows;
+    _preagg_output_rows[PASS_THROUGH] += rows;
+    COUNTER_UPDATE(_preagg_passthrough_rows, rows);
+    _update_pre_agg_counters();
     return Status::OK();
 }
 
+Status AggregationNode::_flush_pre_agg_hash_table(Block* out_block) {
+    bool ht_is_empty = std::visit([&](auto&& agg_method) -> bool {
+        return agg_method.data.empty();
+    }, _agg_data._aggregated_method_variant);
+    if (ht_is_empty) return Status::OK();
+
+    int key_size = _probe_expr_ctxs.size();
+    int agg_size = _aggregate_evaluators.size();
+    bool mem_reuse = out_block->mem_reuse();
+    auto serialize_string_type = std::make_shared<DataTypeString>();
+
+    MutableColumns key_columns;
+    for (int i = 0; i < key_size; ++i) {
+        if (mem_reuse) {
+            key_columns.emplace_back(std::move(*out_block->get_by_position(i).column).mutate());
+        } else {
+            key_columns.emplace_back(_probe_expr_ctxs[i]->root()->data_type()->create_column());
+        }
+    }
+
+    // will serialize data to string column
+    MutableColumns value_columns(agg_size);
+    std::vector<VectorBufferWriter> value_buffer_writers;
+    for (int i = 0; i < agg_size; ++i) {
+        if (mem_reuse) {
+            value_columns[i] = std::move(*out_block->get_by_position(i + key_size).column).mutate();
+        } else {
+            value_columns[i] = serialize_string_type->create_column();
+        }
+        value_buffer_writers.emplace_back(*reinterpret_cast<ColumnString*>(value_columns[i].get()));
+    }
+
+    // Every group leaves the table, the next batches start over in the same buffer so the
+    // table keeps fitting in the cache level it stopped growing at.
+    std::visit([&](auto&& agg_method) -> void {
+        auto& data = agg_method.data;
+        auto serialize_and_destroy = [&](AggregateDataPtr mapped) {
+            for (int i = 0; i < agg_size; ++i) {
+                _aggregate_evaluators[i]->function()->serialize(
+                        mapped + _offsets_of_aggregate_states[i], value_buffer_writers[i]);
+                value_buffer_writers[i].commit();
+            }
+            _destory_agg_status(mapped);
+        };
+
+        for (auto iter = data.begin(); iter != data.end(); ++iter) {
+            agg_method.insert_key_into_columns(iter->get_first(), key_columns, _probe_key_sz);
+            serialize_and_destroy(iter->get_second());
+        }
+        if (data.has_null_key_data()) {
+            DCHECK(key_columns.size() == 1);
+            DCHECK(key_columns[0]->is_nullable());
+            key_columns[0]->insert_data(nullptr, 0);
+            serialize_and_destroy(data.get_null_key_data());
+        }
+        data.clear();
+    }, _agg_data._aggregated_method_variant);
+
+    // keys and states of the flushed groups are not referenced any more
+    _agg_arena_pool.reset(new Arena);
+
+    if (!mem_reuse) {
+        ColumnsWithTypeAndName columns_with_schema;
+        for (int i = 0; i < key_size; ++i) {
+            columns_with_schema.emplace_back(std::move(key_columns[i]),
+                                             _probe_expr_ctxs[i]->root()->data_type(), "");
+        }
+        for (int i = 0; i < agg_size; ++i) {
+            columns_with_schema.emplace_back(std::move(value_columns[i]), serialize_string_type,
+                                             "");
+        }
+        out_block->swap(Block(columns_with_schema));
+    }
+
+    COUNTER_UPDATE(_preagg_flush_counter, 1);
+    return Status::OK();
+}
+
+void AggregationNode::_update_pre_agg_counters() {
+    auto reduction = [](int64_t input_rows, int64_t output_rows) {
+        return output_rows == 0 ? 0.0 : static_cast<double>(input_rows) / output_rows;
+    };
+    COUNTER_SET(_preagg_hash_reduction,
+                reduction(_preagg_input_rows[HASH], _preagg_output_rows[HASH]));
+    COUNTER_SET(_preagg_bounded_hash_reduction,
+                reduction(_preagg_input_rows[BOUNDED_HASH], _preagg_output_rows[BOUNDED_HASH]));
+
+    int64_t input_rows = 0;
+    int64_t output_rows = 0;
+    for (int i = 0; i < NUM_PREAGG_MODES; ++i) {
+        input_rows += _preagg_input_rows[i];
+        output_rows += _preagg_output_rows[i];
+    }
+    COUNTER_SET(_preagg_reduction, reduction(input_rows, output_rows));
+}
+
 Status AggregationNode::_execute_with_serialized_key(Block* block) {
     SCOPED_TIMER(_build_timer);
     DCHECK(!_probe_expr_ctxs.empty());
@@ -758,14 +903,14 @@ Status AggregationNode::_execute_with_serialized_key(Block* block) {
         for (size_t i = 0; i < rows; ++i) {
             AggregateDataPtr aggregate_data = nullptr;
 
-            auto emplace_result = state.emplace_key(agg_method.data, i, _agg_arena_pool);
+            auto emplace_result = state.emplace_key(agg_method.data, i, *_agg_arena_pool);
 
             /// If a new key is inserted, initialize the states of the aggregate functions, and possibly something related to the key.
             if (emplace_result.is_inserted()) {
                 /// exception-safety - if you can not allocate memory or create states, then destructors will not be called.
                 emplace_result.set_mapped(nullptr);
 
-                aggregate_data = _agg_arena_pool.aligned_alloc(_total_size_of_aggregate_states,
+                aggregate_data = _agg_arena_pool->aligned_alloc(_total_size_of_aggregate_states,
                                                             _align_aggregate_states);
                 _create_agg_status(aggregate_data);
 
@@ -780,7 +925,7 @@ Status AggregationNode::_execute_with_serialized_key(Block* block) {
 
     for (int i = 0; i < _aggregate_evaluators.size(); ++i) {
         _aggregate_evaluators[i]->execute_batch_add(block, _offsets_of_aggregate_states[i],
-                                                    places.data(), &_agg_arena_pool);
+                                                    places.data(), _agg_arena_pool.get());
     }
 
     return Status::OK();
@@ -969,14 +1114,14 @@ Status AggregationNode::_merge_with_serialized_key(Block* block) {
         for (size_t i = 0; i < rows; ++i) {
             AggregateDataPtr aggregate_data = nullptr;
 
-            auto emplace_result = state.emplace_key(agg_method.data, i, _agg_arena_pool);
+            auto emplace_result = state.emplace_key(agg_method.data, i, *_agg_arena_pool);
 
             /// If a new key is inserted, initialize the states of the aggregate functions, and possibly something related to the key.
             if (emplace_result.is_inserted()) {
                 /// exception-safety - if you can not allocate memory or create states, then destructors will not be called.
                 emplace_result.set_mapped(nullptr);
 
-                aggregate_data = _agg_arena_pool.aligned_alloc(_total_size_of_aggregate_states,
+                aggregate_data = _agg_arena_pool->aligned_alloc(_total_size_of_aggregate_states,
                                                             _align_aggregate_states);
                 _create_agg_status(aggregate_data);
 
@@ -1004,32 +1149,22 @@ Status AggregationNode::_merge_with_serialized_key(Block* block) {
 
                 _aggregate_evaluators[i]->function()->deserialize(
                         deserialize_buffer.get() + _offsets_of_aggregate_states[i], buffer_reader,
-                        &_agg_arena_pool);
+                        _agg_arena_pool.get());
 
                 _aggregate_evaluators[i]->function()->merge(
                         places.data()[j] + _offsets_of_aggregate_states[i],
-                        deserialize_buffer.get() + _offsets_of_aggregate_states[i], &_agg_arena_pool);
+                        deserialize_buffer.get() + _offsets_of_aggregate_states[i], _agg_arena_pool.get());
 
                 _destory_agg_status(deserialize_buffer.get());
             }
         } else {
             _aggregate_evaluators[i]->execute_batch_add(block, _offsets_of_aggregate_states[i],
-                                                    places.data(), &_agg_arena_pool);
+                                                    places.data(), _agg_arena_pool.get());
         }
     }
     return Status::OK();
 }
 
-void AggregationNode::_update_memusage_with_serialized_key() {
-    std::visit([&](auto&& agg_method)-> void {
-        auto& data = agg_method.data;
-        mem_tracker()->Consume(_agg_arena_pool.size() - _mem_usage_record.used_in_arena);
-        mem_tracker()->Consume(data.get_buffer_size_in_bytes() - _mem_usage_record.used_in_state);
-        _mem_usage_record.used_in_state = data.get_buffer_size_in_bytes();
-        _mem_usage_record.used_in_arena = _agg_arena_pool.size();
-    }, _agg_data._aggregated_method_variant);
-}
-
 void AggregationNode::_close_with_serialized_key() {
     std::visit([&](auto&& agg_method)-> void {
         auto& data = agg_method.data;
@@ -1040,11 +1175,6 @@ void AggregationNode::_close_with_serialized_key() {
             }
         });
     }, _agg_data._aggregated_method_variant);
-    release_tracker();
-}
-
-void AggregationNode::release_tracker() {
-    mem_tracker()->Release(_mem_usage_record.used_in_state + _mem_usage_record.used_in_arena);
 }
 
 } // namespace doris::vectorized
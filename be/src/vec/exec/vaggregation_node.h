@@ -18,6 +18,7 @@
 #pragma once
 
 #include <functional>
+#include <memory>
 
 #include "common/object_pool.h"
 #include "exec/exec_node.h"
@@ -410,7 +411,9 @@ private:
 
     AggregatedDataVariants _agg_data;
 
-    Arena _agg_arena_pool;
+    // keys and aggregate states of _agg_data, the streaming preagg drops it
+    // together with the hash table whenever the table is flushed
+    std::unique_ptr<Arena> _agg_arena_pool;
 
     RuntimeProfile::Counter* _build_timer;
     RuntimeProfile::Counter* _exec_timer;
@@ -418,14 +421,35 @@ private:
     RuntimeProfile::Counter* _expr_timer;
     RuntimeProfile::Counter* _get_results_timer;
 
+    /// How a streaming preaggregation consumes its input blocks. It starts in HASH mode,
+    /// growing the hash table while the reduction justifies leaving the current cache
+    /// level. Once the table stops growing, every sampled batch decides whether to keep
+    /// hashing into the bounded table, flushing it as a whole when it is full, or to
+    /// pass the serialized rows straight to the exchange.
+    enum PreAggMode { HASH = 0, BOUNDED_HASH = 1, PASS_THROUGH = 2, NUM_PREAGG_MODES = 3 };
+
     bool _is_streaming_preagg;
+    bool _child_eos = false;
     Block _preagg_block = Block();
     bool _should_expand_hash_table = true;
-    char* _streaming_pre_agg_buffer = nullptr;
-    size_t _max_size_of_stream_pre_agg_buffer = 0;
+    PreAggMode _preagg_mode = HASH;
+    int64_t _num_preagg_batches = 0;
+    /// Input rows divided by the new groups of the last hashed batch.
+    double _last_batch_reduction = 0;
+    /// Hash table memory thresholds of STREAMING_HT_MIN_REDUCTION, taken from the cache
+    /// sizes of this machine.
+    std::vector<size_t> _streaming_ht_min_mem;
+    /// Input rows and produced rows (groups or passed through rows) of each mode.
+    int64_t _preagg_input_rows[NUM_PREAGG_MODES] = {0};
+    int64_t _preagg_output_rows[NUM_PREAGG_MODES] = {0};
 
     /// Expose the minimum reduction factor to continue growing the hash tables.
-    RuntimeProfile::Counter* preagg_streaming_ht_min_reduction_;
+    RuntimeProfile::Counter* _preagg_streaming_ht_min_reduction = nullptr;
+    RuntimeProfile::Counter* _preagg_hash_reduction = nullptr;
+    RuntimeProfile::Counter* _preagg_bounded_hash_reduction = nullptr;
+    RuntimeProfile::Counter* _preagg_reduction = nullptr;
+    RuntimeProfile::Counter* _preagg_passthrough_rows = nullptr;
+    RuntimeProfile::Counter* _preagg_flush_counter = nullptr;
 
 private:
     /// Return true if we should keep expanding hash tables in the preagg. If false,
@@ -439,44 +463,34 @@ private:
     Status _serialize_without_key(RuntimeState* state, Block* block, bool* eos);
     Status _execute_without_key(Block* block);
     Status _merge_without_key(Block* block);
-    void _update_memusage_without_key();
     void _close_without_key();
 
     Status _get_with_serialized_key_result(RuntimeState* state, Block* block, bool* eos);
     Status _serialize_with_serialized_key_result(RuntimeState* state, Block* block, bool* eos);
     Status _pre_agg_with_serialized_key(Block* in_block, Block* out_block);
+    Status _pass_through_pre_agg_block(Block* in_block, const ColumnRawPtrs& key_columns,
+                                       Block* out_block);
+    Status _flush_pre_agg_hash_table(Block* out_block);
+    void _update_pre_agg_counters();
     Status _execute_with_serialized_key(Block* block);
     Status _merge_with_serialized_key(Block* block);
-    void _update_memusage_with_serialized_key();
     void _close_with_serialized_key();
     void _init_hash_method(std::vector<VExprContext*>& probe_exprs);
 
-    void release_tracker();
-
     using vectorized_execute = std::function<Status(Block* block)>;
     using vectorized_pre_agg = std::function<Status(Block* in_block, Block* out_block)>;
     using vectorized_get_result =
             std::function<Status(RuntimeState* state, Block* block, bool* eos)>;
     using vectorized_closer = std::function<void()>;
-    using vectorized_update_memusage = std::function<void()>;
 
     struct executor {
         vectorized_execute execute;
         vectorized_pre_agg pre_agg;
         vectorized_get_result get_result;
         vectorized_closer close;
-        vectorized_update_memusage update_memusage;
     };
 
     executor _executor;
-
-    struct MemoryRecord {
-        MemoryRecord() : used_in_arena(0), used_in_state(0) {}
-        int64_t used_in_arena;
-        int64_t used_in_state;
-    };
-
-    MemoryRecord _mem_usage_record;
 };
 } // namespace vectorized
 } // namespace doris
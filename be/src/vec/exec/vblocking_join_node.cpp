@@ -24,6 +24,7 @@
 #include "gen_cpp/PlanNodes_types.h"
 #include "runtime/runtime_state.h"
 #include "util/runtime_profile.h"
+#include "vec/common/thread_mem_tracker.h"
 
 namespace doris::vectorized {
 
@@ -68,7 +69,11 @@ Status VBlockingJoinNode::close(RuntimeState* state) {
 }
 
 void VBlockingJoinNode::build_side_thread(RuntimeState* state, std::promise<Status>* status) {
-    status->set_value(construct_build_side(state));
+    {
+        // the build blocks are freed by the fragment thread
+        ScopedThreadMemTracker scoped_tracker(state->fragment_mem_tracker(), false);
+        status->set_value(construct_build_side(state));
+    }
     // Release the thread token as soon as possible (before the main thread joins
     // on it).  This way, if we had a chain of 10 joins using 1 additional thread,
     // we'd keep the additional thread busy the whole time.
@@ -25,27 +25,79 @@
 
 #include "vec/exec/vcross_join_node.h"
 
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/columns_common.h"
+#include "vec/data_types/data_type_nullable.h"
+#include "vec/exprs/vexpr.h"
+#include "vec/exprs/vexpr_context.h"
+#include "vec/utils/util.hpp"
+
 namespace doris::vectorized {
 
+static TJoinOp::type cross_join_op(const TPlanNode& tnode) {
+    if (tnode.__isset.cross_join_node && tnode.cross_join_node.__isset.join_op) {
+        return tnode.cross_join_node.join_op;
+    }
+    return TJoinOp::CROSS_JOIN;
+}
+
 VCrossJoinNode::VCrossJoinNode(ObjectPool* pool, const TPlanNode& tnode, const DescriptorTbl& descs)
-        : VBlockingJoinNode("VCrossJoinNode", TJoinOp::CROSS_JOIN, pool, tnode, descs) {
+        : VBlockingJoinNode("VCrossJoinNode", cross_join_op(tnode), pool, tnode, descs) {
+}
+
+Status VCrossJoinNode::init(const TPlanNode& tnode, RuntimeState* state) {
+    RETURN_IF_ERROR(VBlockingJoinNode::init(tnode, state));
+    switch (_join_op) {
+    case TJoinOp::CROSS_JOIN:
+    case TJoinOp::INNER_JOIN:
+    case TJoinOp::LEFT_OUTER_JOIN:
+    case TJoinOp::LEFT_SEMI_JOIN:
+    case TJoinOp::LEFT_ANTI_JOIN:
+        break;
+    default:
+        return Status::NotSupported("Not supported join op in VCrossJoinNode");
+    }
+    if (tnode.__isset.cross_join_node && tnode.cross_join_node.__isset.vjoin_conjunct) {
+        RETURN_IF_ERROR(VExpr::create_expr_tree(_pool, tnode.cross_join_node.vjoin_conjunct,
+                                                &_vjoin_conjunct_ctx));
+    }
+    return Status::OK();
 }
 
 Status VCrossJoinNode::prepare(RuntimeState* state) {
-    DCHECK(_join_op == TJoinOp::CROSS_JOIN);
     RETURN_IF_ERROR(VBlockingJoinNode::prepare(state));
 
     _num_existing_columns = child(0)->row_desc().num_materialized_slots();
     _num_columns_to_add = child(1)->row_desc().num_materialized_slots();
+
+    _tile_pairs_counter = ADD_COUNTER(runtime_profile(), "TilePairs", TUnit::UNIT);
+    _join_conjunct_timer = ADD_TIMER(runtime_profile(), "JoinConjunctTime");
+
+    // the join conjunct is evaluated on the rows of both children, before the output row of
+    // semi and anti joins drops the build columns
+    _intermediate_row_desc = RowDescriptor(child(0)->row_desc(), child(1)->row_desc());
+    if (_vjoin_conjunct_ctx != nullptr) {
+        RETURN_IF_ERROR(
+                _vjoin_conjunct_ctx->prepare(state, _intermediate_row_desc, expr_mem_tracker()));
+    }
     return Status::OK();
 }
 
+Status VCrossJoinNode::open(RuntimeState* state) {
+    if (_vjoin_conjunct_ctx != nullptr) {
+        RETURN_IF_ERROR(_vjoin_conjunct_ctx->open(state));
+    }
+    return VBlockingJoinNode::open(state);
+}
+
 Status VCrossJoinNode::close(RuntimeState* state) {
     // avoid double close
     if (is_closed()) {
         return Status::OK();
     }
-    _mem_tracker->Release(_total_mem_usage);
+    if (_vjoin_conjunct_ctx != nullptr) {
+        _vjoin_conjunct_ctx->close(state);
+    }
     VBlockingJoinNode::close(state);
     return Status::OK();
 }
@@ -54,6 +106,7 @@ Status VCrossJoinNode::construct_build_side(RuntimeState* state) {
     // Do a full scan of child(1) and store all build row batches.
     RETURN_IF_ERROR(child(1)->open(state));
 
+    const bool nullable_build = _join_op == TJoinOp::LEFT_OUTER_JOIN;
     bool eos = false;
     while (true) {
         SCOPED_TIMER(_build_timer);
@@ -62,13 +115,19 @@ Status VCrossJoinNode::construct_build_side(RuntimeState* state) {
         Block block;
         RETURN_IF_ERROR(child(1)->get_next(state, &block, &eos));
         auto rows = block.rows();
-        auto mem_usage = block.allocated_bytes();
 
         if (rows != 0) {
+            if (nullable_build) {
+                // the build columns are null-extended for the unmatched left rows
+                for (size_t i = 0; i < block.columns(); ++i) {
+                    auto& column_with_type = block.get_by_position(i);
+                    column_with_type.column = make_nullable(column_with_type.column);
+                    column_with_type.type = make_nullable(column_with_type.type);
+                }
+            }
             _build_rows += rows;
-            _total_mem_usage += mem_usage;
+            _max_build_block_rows = std::max(_max_build_block_rows, rows);
             _build_blocks.emplace_back(std::move(block));
-            _mem_tracker->Consume(mem_usage);
         }
         // to prevent use too many memory
         RETURN_IF_LIMIT_EXCEEDED(state, "Cross join, while getting next from the child 1.");
@@ -78,12 +137,25 @@ Status VCrossJoinNode::construct_build_side(RuntimeState* state) {
         }
     }
 
+    if (!_build_blocks.empty()) {
+        _build_column_types = _build_blocks[0].get_data_types();
+    } else {
+        _build_column_types = VectorizedUtils::get_data_types(child(1)->row_desc());
+        if (nullable_build) {
+            for (auto& type : _build_column_types) {
+                type = make_nullable(type);
+            }
+        }
+    }
+
     COUNTER_UPDATE(_build_row_counter, _build_rows);
     return Status::OK();
 }
 
-void VCrossJoinNode::init_get_next(int left_batch_row) {
+void VCrossJoinNode::init_get_next(int first_left_row) {
     _current_build_pos = 0;
+    _build_row_pos = 0;
+    _left_tile_rows = 0;
 }
 
 Status VCrossJoinNode::get_next(RuntimeState* state, Block* block, bool* eos) {
@@ -91,112 +163,254 @@ Status VCrossJoinNode::get_next(RuntimeState* state, Block* block, bool* eos) {
     *eos = false;
     SCOPED_TIMER(_runtime_profile->total_time_counter());
 
-    if (reached_limit() || _eos) {
+    // inner and semi joins produce nothing without build rows
+    if (_build_blocks.empty() && _join_op != TJoinOp::LEFT_OUTER_JOIN &&
+        _join_op != TJoinOp::LEFT_ANTI_JOIN) {
+        _eos = true;
+    }
+    if (reached_limit() || (_eos && _surplus_columns.empty())) {
         *eos = true;
         return Status::OK();
     }
 
-    ScopedTimer<MonotonicStopWatch> timer(_left_child_timer);
-    // Check to see if we're done processing the current left child batch
-    if (_current_build_pos == _build_blocks.size()) {
-        _current_build_pos = 0;
-        _left_block_pos++;
-        
-        if (_left_block_pos == _left_block.rows()) {
-            _left_block_pos = 0;
-
-            if (_left_side_eos) {
-                *eos = _eos = true;
-            } else {
-                do {
-                    _left_block.clear_column_data();
-                    timer.stop();
-                    RETURN_IF_ERROR(child(0)->get_next(state, &_left_block, &_left_side_eos));
-                    timer.start();
-                } while (_left_block.rows() == 0 && !_left_side_eos);
-                COUNTER_UPDATE(_left_child_row_counter, _left_block.rows());
-                *eos = _eos = _left_side_eos;
-            }
+    MutableColumns dst_columns;
+    ColumnsWithTypeAndName header;
+    for (size_t i = 0; i < _num_existing_columns; ++i) {
+        const auto& src_column = _left_block.get_by_position(i);
+        header.emplace_back(nullptr, src_column.type, src_column.name);
+        dst_columns.emplace_back(src_column.type->create_column());
+    }
+    if (_output_build_columns()) {
+        for (size_t i = 0; i < _num_columns_to_add; ++i) {
+            header.emplace_back(nullptr, _build_column_types[i], "");
+            dst_columns.emplace_back(_build_column_types[i]->create_column());
         }
     }
 
-    if (!_eos) {
-        auto block_nums = 0;
-        do {
-            // Compute max rows that should be added to block
-            const auto &now_process_build_block = _build_blocks[_current_build_pos++];
-            int64_t max_added_rows = now_process_build_block.rows();
+    if (!_surplus_columns.empty()) {
+        dst_columns = std::move(_surplus_columns);
+        _surplus_columns.clear();
+    }
 
-            if (limit() != -1) {
-                max_added_rows = std::min(max_added_rows, limit() - rows_returned());
-            }
-            block_nums = process_left_child_block(block, now_process_build_block, max_added_rows);
-        } while (block_nums == 0 && _current_build_pos < _build_blocks.size());
+    const size_t batch_size = state->batch_size();
+    while (!_eos && dst_columns[0]->size() < batch_size) {
+        if (_left_block_pos >= _left_block.rows()) {
+            RETURN_IF_ERROR(_fetch_left_block(state));
+            continue;
+        }
+        if (_left_tile_rows == 0) {
+            _start_left_tile(batch_size);
+        }
+
+        // semi and anti joins are decided for the tile once all of its rows matched
+        const bool tile_decided = (_join_op == TJoinOp::LEFT_SEMI_JOIN ||
+                                   _join_op == TJoinOp::LEFT_ANTI_JOIN) &&
+                                  _num_left_tile_matched == _left_tile_rows;
+        if (_current_build_pos < _build_blocks.size() && !tile_decided) {
+            RETURN_IF_ERROR(_process_tile_pair(dst_columns, batch_size));
+        } else {
+            _finish_left_tile(dst_columns);
+            _left_block_pos += _left_tile_rows;
+            init_get_next(_left_block_pos);
+        }
+        RETURN_IF_CANCELLED(state);
+    }
 
-        _num_rows_returned += block_nums;
-        COUNTER_SET(_rows_returned_counter, _num_rows_returned);
+    // the last tile pair may overshoot batch_size, keep its tail for the next call
+    const size_t num_rows = dst_columns[0]->size();
+    if (num_rows > batch_size) {
+        for (auto& column : dst_columns) {
+            auto surplus = column->clone_empty();
+            surplus->insert_range_from(*column, batch_size, num_rows - batch_size);
+            column->pop_back(num_rows - batch_size);
+            _surplus_columns.emplace_back(std::move(surplus));
+        }
+    }
+
+    for (size_t i = 0; i < dst_columns.size(); ++i) {
+        header[i].column = std::move(dst_columns[i]);
+    }
+    *block = Block(header);
 
-        *eos = _eos = reached_limit();
+    if (_vconjunct_ctx_ptr) {
+        int result_column_id = -1;
+        int orig_columns = block->columns();
+        RETURN_IF_ERROR((*_vconjunct_ctx_ptr)->execute(block, &result_column_id));
+        RETURN_IF_ERROR(Block::filter_block(block, result_column_id, orig_columns));
     }
 
+    _num_rows_returned += block->rows();
+    if (reached_limit()) {
+        block->set_num_rows(block->rows() - (_num_rows_returned - _limit));
+        _num_rows_returned = _limit;
+        _eos = true;
+    }
+    COUNTER_SET(_rows_returned_counter, _num_rows_returned);
+    *eos = _eos && _surplus_columns.empty() && block->rows() == 0;
     return Status::OK();
 }
 
-std::string VCrossJoinNode::build_list_debug_string() {
-    std::stringstream out;
-    out << "BuildBlock(";
-    for (const auto& block : _build_blocks) {
-        out << block.dump_structure() << "\n";
+Status VCrossJoinNode::_fetch_left_block(RuntimeState* state) {
+    if (_left_side_eos) {
+        _eos = true;
+        return Status::OK();
     }
-    out << ")";
-    return out.str();
+    ScopedTimer<MonotonicStopWatch> timer(_left_child_timer);
+    do {
+        _left_block.clear_column_data();
+        timer.stop();
+        RETURN_IF_ERROR(child(0)->get_next(state, &_left_block, &_left_side_eos));
+        timer.start();
+    } while (_left_block.rows() == 0 && !_left_side_eos);
+    COUNTER_UPDATE(_left_child_row_counter, _left_block.rows());
+
+    _left_block_pos = 0;
+    init_get_next(_left_block_pos);
+    if (_left_block.rows() == 0) {
+        _eos = true;
+    }
+    return Status::OK();
 }
 
-int VCrossJoinNode::process_left_child_block(Block* block, const Block& now_process_build_block,
-                                            int max_added_rows) {
-    MutableColumns dst_columns(_num_existing_columns + _num_columns_to_add);
+void VCrossJoinNode::_start_left_tile(size_t batch_size) {
+    // a build tile has at most batch_size rows, take as many left rows as keep the
+    // product of the pair around batch_size
+    size_t build_tile_rows = std::max<size_t>(1, std::min(_max_build_block_rows, batch_size));
+    _left_tile_rows = std::max<size_t>(1, batch_size / build_tile_rows);
+    _left_tile_rows = std::min(_left_tile_rows, _left_block.rows() - _left_block_pos);
+    _left_tile_matched.assign(_left_tile_rows, (uint8_t)0);
+    _num_left_tile_matched = 0;
+}
 
-    bool mem_reuse = block->mem_reuse();
-    for (size_t i = 0; i < _num_existing_columns; ++i) {
-        const ColumnWithTypeAndName & src_column = _left_block.get_by_position(i);
-        if (mem_reuse) {
-            dst_columns[i] = std::move(*block->get_by_position(i).column).mutate();
-        } else {
-            dst_columns[i] = src_column.type->create_column();
-            block->insert(src_column);
+Status VCrossJoinNode::_process_tile_pair(MutableColumns& dst_columns, size_t batch_size) {
+    const Block& build_block = _build_blocks[_current_build_pos];
+    const size_t build_tile_rows = std::min(batch_size, build_block.rows() - _build_row_pos);
+    const size_t tile_rows = _left_tile_rows * build_tile_rows;
+    COUNTER_UPDATE(_tile_pairs_counter, 1);
+
+    // row k of the pair joins left row k / build_tile_rows with build row k % build_tile_rows
+    auto append_pair = [&](MutableColumns& columns) {
+        for (size_t i = 0; i < _num_existing_columns; ++i) {
+            const auto& src_column = *_left_block.get_by_position(i).column;
+            for (size_t row = 0; row < _left_tile_rows; ++row) {
+                columns[i]->insert_many_from(src_column, _left_block_pos + row, build_tile_rows);
+            }
         }
-        dst_columns[i]->insert_many_from(*src_column.column, _left_block_pos, max_added_rows);
-    }
-
-    for (size_t i = 0; i < _num_columns_to_add; ++i) {
-        const ColumnWithTypeAndName &src_column = now_process_build_block.get_by_position(i);
-        if (mem_reuse) {
-            dst_columns[_num_existing_columns + i] =
-                    std::move(*block->get_by_position(_num_existing_columns + i).column).mutate();
-        } else {
-            dst_columns[_num_existing_columns + i] = src_column.column->clone_empty();
-            block->insert(src_column);
+        for (size_t i = 0; i < _num_columns_to_add; ++i) {
+            const auto& src_column = *build_block.get_by_position(i).column;
+            for (size_t row = 0; row < _left_tile_rows; ++row) {
+                columns[_num_existing_columns + i]->insert_range_from(src_column, _build_row_pos,
+                                                                      build_tile_rows);
+            }
         }
-        dst_columns[_num_existing_columns + i]->insert_range_from(*src_column.column.get(), 0, max_added_rows);
-    }
+    };
 
-    if (!mem_reuse) {
-        *block = block->clone_with_columns(std::move(dst_columns));
+    if (_vjoin_conjunct_ctx == nullptr) {
+        // a cartesian product, every left row matches every build row
+        if (_output_build_columns()) {
+            append_pair(dst_columns);
+        }
+        _left_tile_matched.assign(_left_tile_rows, (uint8_t)1);
+        _num_left_tile_matched = _left_tile_rows;
     } else {
-        dst_columns.clear();
+        ColumnsWithTypeAndName tile_columns;
+        MutableColumns columns;
+        for (size_t i = 0; i < _num_existing_columns; ++i) {
+            const auto& src_column = _left_block.get_by_position(i);
+            tile_columns.emplace_back(nullptr, src_column.type, src_column.name);
+            columns.emplace_back(src_column.column->clone_empty());
+            columns.back()->reserve(tile_rows);
+        }
+        for (size_t i = 0; i < _num_columns_to_add; ++i) {
+            const auto& src_column = build_block.get_by_position(i);
+            tile_columns.emplace_back(nullptr, src_column.type, src_column.name);
+            columns.emplace_back(src_column.column->clone_empty());
+            columns.back()->reserve(tile_rows);
+        }
+        append_pair(columns);
+        for (size_t i = 0; i < columns.size(); ++i) {
+            tile_columns[i].column = std::move(columns[i]);
+        }
+        Block tile_block(tile_columns);
+
+        IColumn::Filter filter;
+        {
+            SCOPED_TIMER(_join_conjunct_timer);
+            int result_column_id = -1;
+            RETURN_IF_ERROR(_vjoin_conjunct_ctx->execute(&tile_block, &result_column_id));
+            ColumnPtr filter_column = tile_block.get_by_position(result_column_id)
+                                              .column->convert_to_full_column_if_const();
+            if (auto* nullable_column = check_and_get_column<ColumnNullable>(*filter_column)) {
+                const auto& nested_data =
+                        assert_cast<const ColumnUInt8&>(nullable_column->get_nested_column())
+                                .get_data();
+                const auto& null_map = nullable_column->get_null_map_data();
+                filter.resize(tile_rows);
+                for (size_t k = 0; k < tile_rows; ++k) {
+                    filter[k] = nested_data[k] && !null_map[k];
+                }
+            } else {
+                filter = assert_cast<const ColumnUInt8&>(*filter_column).get_data();
+            }
+        }
+
+        for (size_t k = 0; k < tile_rows; ++k) {
+            if (filter[k]) {
+                auto& matched = _left_tile_matched[k / build_tile_rows];
+                _num_left_tile_matched += !matched;
+                matched = 1;
+            }
+        }
+
+        if (_output_build_columns()) {
+            size_t count = count_bytes_in_filter(filter);
+            if (count != 0) {
+                for (size_t i = 0; i < dst_columns.size(); ++i) {
+                    auto filtered = tile_block.get_by_position(i).column->filter(filter, count);
+                    dst_columns[i]->insert_range_from(*filtered, 0, count);
+                }
+            }
+        }
     }
 
-    if (_vconjunct_ctx_ptr) {
-        int result_column_id = -1;
-        int orig_columns = block->columns();
-        (*_vconjunct_ctx_ptr)->execute(block, &result_column_id);
-        Block::filter_block(block, result_column_id, orig_columns);
+    _build_row_pos += build_tile_rows;
+    if (_build_row_pos == build_block.rows()) {
+        _build_row_pos = 0;
+        ++_current_build_pos;
     }
+    return Status::OK();
+}
 
-    if (block->rows() > max_added_rows) {
-        block->set_num_rows(max_added_rows);
+void VCrossJoinNode::_finish_left_tile(MutableColumns& dst_columns) {
+    if (_join_op == TJoinOp::CROSS_JOIN || _join_op == TJoinOp::INNER_JOIN) {
+        return;
+    }
+    // semi joins output the matched rows, outer and anti joins the unmatched ones
+    const uint8_t output_matched = _join_op == TJoinOp::LEFT_SEMI_JOIN;
+    for (size_t row = 0; row < _left_tile_rows; ++row) {
+        if (_left_tile_matched[row] != output_matched) {
+            continue;
+        }
+        for (size_t i = 0; i < _num_existing_columns; ++i) {
+            dst_columns[i]->insert_from(*_left_block.get_by_position(i).column,
+                                        _left_block_pos + row);
+        }
+        if (_join_op == TJoinOp::LEFT_OUTER_JOIN) {
+            for (size_t i = 0; i < _num_columns_to_add; ++i) {
+                dst_columns[_num_existing_columns + i]->insert_default();
+            }
+        }
     }
+}
 
-    return block->rows();
+std::string VCrossJoinNode::build_list_debug_string() {
+    std::stringstream out;
+    out << "BuildBlock(";
+    for (const auto& block : _build_blocks) {
+        out << block.dump_structure() << "\n";
+    }
+    out << ")";
+    return out.str();
 }
-} // namespace doris
+
+} // namespace doris::vectorized
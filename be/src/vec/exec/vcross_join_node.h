@@ -32,18 +32,28 @@
 #include "vec/exec/vblocking_join_node.h"
 
 namespace doris::vectorized {
-// Node for cross joins.
-// Iterates over the left child rows and then the right child rows and, for
-// each combination, writes the output row if the conjuncts are satisfied. The
-// build batches are kept in a list that is fully constructed from the right child in
+class VExprContext;
+
+// Node for nested loop joins: cross joins, and inner, left outer, left semi and left anti
+// joins without equi-join predicates.
+// The build blocks are kept in a list that is fully constructed from the right child in
 // construct_build_side() (called by BlockingJoinNode::open()) while rows are fetched from
 // the left child as necessary in get_next().
+// The left block is processed in tiles of rows. Each left tile is joined with the build
+// blocks one tile at a time, sized so that the pair produces about batch_size rows and
+// both stay in cache. The join conjunct is evaluated on every tile pair with the vectorized
+// exprs, and the matched flags of the left tile rows drive the outer, semi and anti output
+// once the tile has seen all build rows.
 class VCrossJoinNode final : public VBlockingJoinNode {
 public:
     VCrossJoinNode(ObjectPool *pool, const TPlanNode &tnode, const DescriptorTbl &descs);
 
+    Status init(const TPlanNode &tnode, RuntimeState *state = nullptr) override;
+
     Status prepare(RuntimeState *state) override;
 
+    Status open(RuntimeState *state) override;
+
     Status get_next(RuntimeState* state, Block* block, bool* eos) override;
 
     Status close(RuntimeState *state) override;
@@ -57,20 +67,51 @@ private:
     // List of build batches, constructed in prepare()
     Blocks _build_blocks;
     size_t _current_build_pos = 0;
+    // Start row of the current tile in _build_blocks[_current_build_pos]
+    size_t _build_row_pos = 0;
+    size_t _max_build_block_rows = 0;
+    // Types of the build columns in the output, nullable for left outer join
+    DataTypes _build_column_types;
+
+    // Rows of the current left tile, starting at _left_block_pos
+    size_t _left_tile_rows = 0;
+    // Whether each row of the current left tile has matched a build row
+    IColumn::Filter _left_tile_matched;
+    size_t _num_left_tile_matched = 0;
 
     size_t _num_existing_columns = 0;
     size_t _num_columns_to_add = 0;
 
+    // Output rows past batch_size of the last get_next(), returned first by the next one.
+    // A tile pair or a finished left tile adds at most batch_size rows, so this holds
+    // fewer than batch_size rows.
+    MutableColumns _surplus_columns;
+
+    // Conjuncts of the ON clause, evaluated on the rows of both children
+    VExprContext* _vjoin_conjunct_ctx = nullptr;
+    RowDescriptor _intermediate_row_desc;
+
     uint64_t _build_rows = 0;
-    uint64_t _total_mem_usage = 0;
-    // Processes a batch from the left child.
-    //  output_batch: the batch for resulting tuple rows
-    //  batch: the batch from the left child to process.  This function can be called to
-    //    continue processing a batch in the middle
-    //  max_added_rows: maximum rows that can be added to output_batch
-    // return the number of rows added to output_batch
-    int process_left_child_block(Block* block, const Block& now_process_build_block,
-                                            int max_added_rows);
+
+    RuntimeProfile::Counter* _tile_pairs_counter = nullptr;
+    RuntimeProfile::Counter* _join_conjunct_timer = nullptr;
+
+    bool _output_build_columns() const {
+        return _join_op != TJoinOp::LEFT_SEMI_JOIN && _join_op != TJoinOp::LEFT_ANTI_JOIN;
+    }
+
+    // Fetches the next non-empty left block, sets _eos if the left child is exhausted.
+    Status _fetch_left_block(RuntimeState* state);
+
+    void _start_left_tile(size_t batch_size);
+
+    // Joins the current left tile with the current build tile, appending the matched rows of
+    // an inner or outer join to dst_columns.
+    Status _process_tile_pair(MutableColumns& dst_columns, size_t batch_size);
+
+    // Appends the left tile rows which the join type outputs on their own: the unmatched
+    // rows of outer and anti joins, the matched rows of semi joins.
+    void _finish_left_tile(MutableColumns& dst_columns);
 
     // Returns a debug string for _build_rows. This is used for debugging during the
     // build list construction and before doing the join.
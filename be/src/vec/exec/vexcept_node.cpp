@@ -31,20 +31,31 @@ VExceptNode::VExceptNode(ObjectPool* pool, const TPlanNode& tnode, const Descrip
 
 Status VExceptNode::init(const TPlanNode& tnode, RuntimeState* state) {
     RETURN_IF_ERROR(VSetOperationNode::init(tnode, state));
-    DCHECK(tnode.__isset.union_node);
+    DCHECK(tnode.__isset.except_node);
     return Status::OK();
 }
 
 Status VExceptNode::prepare(RuntimeState* state) {
-    return VSetOperationNode::prepare(state);
+    RETURN_IF_ERROR(VSetOperationNode::prepare(state));
+    return _prepare_hash_table(state);
 }
 
 Status VExceptNode::open(RuntimeState* state) {
-    return VSetOperationNode::open(state);
+    RETURN_IF_ERROR(VSetOperationNode::open(state));
+    SCOPED_TIMER(_runtime_profile->total_time_counter());
+    RETURN_IF_ERROR(_hash_table_build(state));
+    for (int i = 1; i < _children.size() && _valid_element_in_hash_tbl > 0; ++i) {
+        RETURN_IF_ERROR(_probe_child(state, i));
+        // a key found in any of the other children is not part of the result
+        _refresh_hash_table(false);
+    }
+    return Status::OK();
 }
 
 Status VExceptNode::get_next(RuntimeState* state, Block* block, bool* eos) {
-    return Status::NotSupported("Not Implemented.");
+    SCOPED_TIMER(_runtime_profile->total_time_counter());
+    RETURN_IF_CANCELLED(state);
+    return _get_data_in_hashtable(state, block, eos);
 }
 
 Status VExceptNode::close(RuntimeState* state) {
@@ -48,9 +48,15 @@ Status VExchangeNode::open(RuntimeState* state) {
 
     if (_is_merging) {
         RETURN_IF_ERROR(_vsort_exec_exprs.open(state));
-        RETURN_IF_ERROR(_stream_recvr->create_merger(_vsort_exec_exprs.lhs_ordering_expr_ctxs(),
-                                                     _is_asc_order, _nulls_first,
-                                                     state->batch_size(), _limit, _offset));
+        if (state->enable_exchange_node_parallel_merge()) {
+            RETURN_IF_ERROR(_stream_recvr->create_parallel_merger(
+                    _vsort_exec_exprs.lhs_ordering_expr_ctxs(), _is_asc_order, _nulls_first,
+                    state->batch_size(), _limit, _offset));
+        } else {
+            RETURN_IF_ERROR(_stream_recvr->create_merger(
+                    _vsort_exec_exprs.lhs_ordering_expr_ctxs(), _is_asc_order, _nulls_first,
+                    state->batch_size(), _limit, _offset));
+        }
     }
 
     return Status::OK();
@@ -31,20 +31,31 @@ VIntersectNode::VIntersectNode(ObjectPool* pool, const TPlanNode& tnode, const D
         : VSetOperationNode(pool, tnode, descs) {}
 Status VIntersectNode::init(const TPlanNode& tnode, RuntimeState* state) {
     RETURN_IF_ERROR(VSetOperationNode::init(tnode, state));
-    DCHECK(tnode.__isset.union_node);
+    DCHECK(tnode.__isset.intersect_node);
     return Status::OK();
 }
 
 Status VIntersectNode::prepare(RuntimeState* state) {
-    return VSetOperationNode::prepare(state);
+    RETURN_IF_ERROR(VSetOperationNode::prepare(state));
+    return _prepare_hash_table(state);
 }
 
 Status VIntersectNode::open(RuntimeState* state) {
-    return VSetOperationNode::open(state);
+    RETURN_IF_ERROR(VSetOperationNode::open(state));
+    SCOPED_TIMER(_runtime_profile->total_time_counter());
+    RETURN_IF_ERROR(_hash_table_build(state));
+    for (int i = 1; i < _children.size() && _valid_element_in_hash_tbl > 0; ++i) {
+        RETURN_IF_ERROR(_probe_child(state, i));
+        // a key of the result has to be found in every child
+        _refresh_hash_table(true);
+    }
+    return Status::OK();
 }
 
 Status VIntersectNode::get_next(RuntimeState* state, Block* block, bool* eos) {
-    return Status::NotSupported("Not Implemented VIntersectNode::get_next.");
+    SCOPED_TIMER(_runtime_profile->total_time_counter());
+    RETURN_IF_CANCELLED(state);
+    return _get_data_in_hashtable(state, block, eos);
 }
 
 Status VIntersectNode::close(RuntimeState* state) {
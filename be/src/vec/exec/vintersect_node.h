@@ -30,6 +30,7 @@ public:
     virtual Status open(RuntimeState* state);
     virtual Status get_next(RuntimeState* state, vectorized::Block* block, bool* eos);
     virtual Status close(RuntimeState* state);
+    virtual void debug_string(int indentation_level, std::stringstream* out) const;
 };
 } // namespace vectorized
 } // namespace doris
@@ -21,6 +21,7 @@
 #include "runtime/descriptors.h"
 #include "runtime/exec_env.h"
 #include "util/priority_thread_pool.hpp"
+#include "vec/common/thread_mem_tracker.h"
 #include "vec/core/block.h"
 #include "vec/exec/volap_scanner.h"
 #include "vec/exprs/vexpr.h"
@@ -36,6 +37,8 @@ VOlapScanNode::VOlapScanNode(ObjectPool* pool, const TPlanNode& tnode, const Des
 VOlapScanNode::~VOlapScanNode() {}
 
 void VOlapScanNode::transfer_thread(RuntimeState* state) {
+    // the free blocks are allocated here and freed by the fragment thread
+    ScopedThreadMemTracker scoped_tracker(state->fragment_mem_tracker(), false);
     // scanner open pushdown to scanThread
     state->resource_pool()->acquire_thread_token();
     Status status = Status::OK();
@@ -189,6 +192,7 @@ void VOlapScanNode::scanner_thread(VOlapScanner* scanner) {
     bool eos = false;
     RuntimeState* state = scanner->runtime_state();
     DCHECK(NULL != state);
+    ScopedThreadMemTracker scoped_tracker(state->fragment_mem_tracker(), false);
     if (!scanner->is_open()) {
         status = scanner->open();
         if (!status.ok()) {
@@ -313,7 +317,6 @@ Status VOlapScanNode::add_one_block(Block* block) {
 
         VLOG_CRITICAL << "Push block to materialized_blocks";
         _materialized_blocks.push_back(block);
-        _mem_tracker->Consume(block->allocated_bytes());
     }
     // remove one block, notify main thread
     _block_added_cv.notify_one();
@@ -411,14 +414,11 @@ Status VOlapScanNode::close(RuntimeState* state) {
     // join transfer thread
     _transfer_thread.join_all();
 
-    size_t mem_usege_in_block = 0;
     // clear some block in queue
     for (auto block : _materialized_blocks) {
-        mem_usege_in_block += block->allocated_bytes();
         delete block;
     }
     _materialized_blocks.clear();
-    _mem_tracker->Release(mem_usege_in_block);
 
     for (auto block : _scan_blocks) {
         delete block;
@@ -504,7 +504,6 @@ Status VOlapScanNode::get_next(RuntimeState* state, Block* block, bool* eos) {
         VLOG_ROW << "VOlapScanNode output rows: " << block->rows();
         _num_rows_returned += block->rows();
         COUNTER_SET(_rows_returned_counter, _num_rows_returned);
-        _mem_tracker->Release(block->allocated_bytes());
 
         // reach scan node limit
         if (reached_limit()) {
@@ -18,11 +18,80 @@
 #include "vec/exec/vset_operation_node.h"
 
 #include "vec/exprs/vexpr.h"
+#include "vec/utils/util.hpp"
 
 namespace doris {
 
 namespace vectorized {
 
+template <class HashTableContext>
+struct HashTableBuild {
+    HashTableBuild(int rows, Block& acquired_block, ColumnRawPtrs& build_raw_ptrs,
+                   VSetOperationNode* operation_node)
+            : _rows(rows),
+              _acquired_block(acquired_block),
+              _build_raw_ptrs(build_raw_ptrs),
+              _operation_node(operation_node) {}
+
+    Status operator()(HashTableContext& hash_table_ctx) {
+        using KeyGetter = typename HashTableContext::State;
+        using Mapped = typename HashTableContext::Mapped;
+
+        KeyGetter key_getter(_build_raw_ptrs, _operation_node->_build_key_sz, nullptr);
+
+        for (size_t k = 0; k < _rows; ++k) {
+            auto emplace_result =
+                    key_getter.emplace_key(hash_table_ctx.hash_table, k, _operation_node->_arena);
+            if (k + 1 < _rows) {
+                key_getter.prefetch(hash_table_ctx.hash_table, k + 1, _operation_node->_arena);
+            }
+
+            // Only the first row of a key is kept, the result of a set operation is distinct.
+            if (emplace_result.is_inserted()) {
+                new (&emplace_result.get_mapped()) Mapped(&_acquired_block, k);
+                ++_operation_node->_valid_element_in_hash_tbl;
+            }
+        }
+        return Status::OK();
+    }
+
+private:
+    const int _rows;
+    Block& _acquired_block;
+    ColumnRawPtrs& _build_raw_ptrs;
+    VSetOperationNode* _operation_node;
+};
+
+template <class HashTableContext>
+struct HashTableProbe {
+    HashTableProbe(int rows, ColumnRawPtrs& probe_raw_ptrs, VSetOperationNode* operation_node)
+            : _rows(rows), _probe_raw_ptrs(probe_raw_ptrs), _operation_node(operation_node) {}
+
+    Status operator()(HashTableContext& hash_table_ctx) {
+        using KeyGetter = typename HashTableContext::State;
+
+        KeyGetter key_getter(_probe_raw_ptrs, _operation_node->_build_key_sz, nullptr);
+
+        for (size_t k = 0; k < _rows; ++k) {
+            auto find_result =
+                    key_getter.find_key(hash_table_ctx.hash_table, k, _operation_node->_arena);
+            if (k + 1 < _rows) {
+                key_getter.prefetch(hash_table_ctx.hash_table, k + 1, _operation_node->_arena);
+            }
+
+            if (find_result.is_found()) {
+                find_result.get_mapped().visited = true;
+            }
+        }
+        return Status::OK();
+    }
+
+private:
+    const int _rows;
+    ColumnRawPtrs& _probe_raw_ptrs;
+    VSetOperationNode* _operation_node;
+};
+
 VSetOperationNode::VSetOperationNode(ObjectPool* pool, const TPlanNode& tnode,
                                      const DescriptorTbl& descs)
         : ExecNode(pool, tnode, descs),
@@ -47,16 +116,30 @@ Status VSetOperationNode::close(RuntimeState* state) {
 Status VSetOperationNode::init(const TPlanNode& tnode, RuntimeState* state) {
     RETURN_IF_ERROR(ExecNode::init(tnode, state));
     DCHECK_EQ(_conjunct_ctxs.size(), 0);
-    // Create const_expr_ctx_lists_ from thrift exprs.
-    auto& const_texpr_lists = tnode.union_node.const_expr_lists;
-    for (auto& texprs : const_texpr_lists) {
-        std::vector<VExprContext*> ctxs;
-        RETURN_IF_ERROR(VExpr::create_expr_trees(_pool, texprs, &ctxs));
-        _const_expr_lists.push_back(ctxs);
+    const std::vector<std::vector<TExpr>>* result_texpr_lists = nullptr;
+    switch (tnode.node_type) {
+    case TPlanNodeType::UNION_NODE: {
+        // Create const_expr_ctx_lists_ from thrift exprs.
+        auto& const_texpr_lists = tnode.union_node.const_expr_lists;
+        for (auto& texprs : const_texpr_lists) {
+            std::vector<VExprContext*> ctxs;
+            RETURN_IF_ERROR(VExpr::create_expr_trees(_pool, texprs, &ctxs));
+            _const_expr_lists.push_back(ctxs);
+        }
+        result_texpr_lists = &tnode.union_node.result_expr_lists;
+        break;
+    }
+    case TPlanNodeType::INTERSECT_NODE:
+        result_texpr_lists = &tnode.intersect_node.result_expr_lists;
+        break;
+    case TPlanNodeType::EXCEPT_NODE:
+        result_texpr_lists = &tnode.except_node.result_expr_lists;
+        break;
+    default:
+        return Status::InternalError("unsupported set operation node type");
     }
     // Create result_expr_ctx_lists_ from thrift exprs.
-    auto& result_texpr_lists = tnode.union_node.result_expr_lists;
-    for (auto& texprs : result_texpr_lists) {
+    for (auto& texprs : *result_texpr_lists) {
         std::vector<VExprContext*> ctxs;
         RETURN_IF_ERROR(VExpr::create_expr_trees(_pool, texprs, &ctxs));
         _child_expr_lists.push_back(ctxs);
@@ -100,5 +183,252 @@ Status VSetOperationNode::prepare(RuntimeState* state) {
     return Status::OK();
 }
 
+Status VSetOperationNode::_prepare_hash_table(RuntimeState* state) {
+    _build_timer = ADD_TIMER(runtime_profile(), "BuildTime");
+    _probe_timer = ADD_TIMER(runtime_profile(), "ProbeTime");
+    _build_rows_counter = ADD_COUNTER(runtime_profile(), "BuildRows", TUnit::UNIT);
+    _probe_rows_counter = ADD_COUNTER(runtime_profile(), "ProbeRows", TUnit::UNIT);
+
+    for (const auto& data_type : VectorizedUtils::get_data_types(row_desc())) {
+        _output_nullable.push_back(data_type->is_nullable());
+    }
+    DCHECK(!_child_expr_lists.empty());
+    const auto& build_exprs = _child_expr_lists[0];
+    if (build_exprs.size() != _output_nullable.size()) {
+        return Status::InternalError("set operation result exprs do not match the output row");
+    }
+
+    if (build_exprs.size() == 1 && !_output_nullable[0]) {
+        // Single column optimization
+        switch (build_exprs[0]->root()->result_type()) {
+        case TYPE_TINYINT:
+            _hash_table_variants.emplace<SetPrimaryTypeHashTableContext<UInt8>>();
+            break;
+        case TYPE_SMALLINT:
+            _hash_table_variants.emplace<SetPrimaryTypeHashTableContext<UInt16>>();
+            break;
+        case TYPE_INT:
+            _hash_table_variants.emplace<SetPrimaryTypeHashTableContext<UInt32>>();
+            break;
+        case TYPE_BIGINT:
+            _hash_table_variants.emplace<SetPrimaryTypeHashTableContext<UInt64>>();
+            break;
+        default:
+            _hash_table_variants.emplace<SetSerializedHashTableContext>();
+        }
+        return Status::OK();
+    }
+
+    bool use_fixed_key = true;
+    bool has_null = false;
+    int key_byte_size = 0;
+
+    _build_key_sz.resize(build_exprs.size());
+    for (int i = 0; i < build_exprs.size(); ++i) {
+        auto result_type = build_exprs[i]->root()->result_type();
+
+        has_null |= _output_nullable[i];
+        _build_key_sz[i] = get_real_byte_size(result_type);
+        key_byte_size += _build_key_sz[i];
+
+        if (has_variable_type(result_type)) {
+            use_fixed_key = false;
+            break;
+        }
+    }
+
+    if (std::tuple_size<KeysNullMap<UInt128>>::value + key_byte_size > sizeof(UInt128)) {
+        use_fixed_key = false;
+    }
+
+    if (use_fixed_key) {
+        if (has_null) {
+            if (std::tuple_size<KeysNullMap<UInt64>>::value + key_byte_size <= sizeof(UInt64)) {
+                _hash_table_variants.emplace<SetFixedKeyHashTableContext<UInt64, true>>();
+            } else {
+                _hash_table_variants.emplace<SetFixedKeyHashTableContext<UInt128, true>>();
+            }
+        } else {
+            if (key_byte_size <= sizeof(UInt64)) {
+                _hash_table_variants.emplace<SetFixedKeyHashTableContext<UInt64, false>>();
+            } else {
+                _hash_table_variants.emplace<SetFixedKeyHashTableContext<UInt128, false>>();
+            }
+        }
+    } else {
+        _hash_table_variants.emplace<SetSerializedHashTableContext>();
+    }
+    return Status::OK();
+}
+
+Status VSetOperationNode::_materialize_child_block(int child_idx, Block* src_block,
+                                                   Block* dst_block) {
+    SCOPED_TIMER(_materialize_exprs_evaluate_timer);
+    const auto& child_exprs = _child_expr_lists[child_idx];
+    ColumnsWithTypeAndName columns;
+    for (size_t i = 0; i < child_exprs.size(); ++i) {
+        int result_column_id = -1;
+        RETURN_IF_ERROR(child_exprs[i]->execute(src_block, &result_column_id));
+        const auto& result = src_block->get_by_position(result_column_id);
+        auto column = result.column->convert_to_full_column_if_const();
+        auto type = result.type;
+        if (_output_nullable[i] && !type->is_nullable()) {
+            column = make_nullable(column);
+            type = make_nullable(type);
+        }
+        columns.emplace_back(column, type, result.name);
+    }
+    *dst_block = Block(columns);
+    return Status::OK();
+}
+
+Status VSetOperationNode::_hash_table_build(RuntimeState* state) {
+    SCOPED_TIMER(_build_timer);
+    Block block;
+    bool eos = false;
+    while (!eos) {
+        block.clear();
+        RETURN_IF_CANCELLED(state);
+        RETURN_IF_ERROR(child(0)->get_next(state, &block, &eos));
+        RETURN_IF_ERROR(_process_build_block(block));
+    }
+    return Status::OK();
+}
+
+Status VSetOperationNode::_process_build_block(Block& block) {
+    size_t rows = block.rows();
+    if (rows == 0) {
+        return Status::OK();
+    }
+    COUNTER_UPDATE(_build_rows_counter, rows);
+
+    Block materialized_block;
+    RETURN_IF_ERROR(_materialize_child_block(0, &block, &materialized_block));
+    auto& acquired_block = _acquire_list.acquire(std::move(materialized_block));
+
+    ColumnRawPtrs raw_ptrs(acquired_block.columns());
+    for (size_t i = 0; i < acquired_block.columns(); ++i) {
+        raw_ptrs[i] = acquired_block.get_by_position(i).column.get();
+    }
+
+    return std::visit(
+            [&](auto&& arg) -> Status {
+                using HashTableCtxType = std::decay_t<decltype(arg)>;
+                if constexpr (!std::is_same_v<HashTableCtxType, std::monostate>) {
+                    HashTableBuild<HashTableCtxType> hash_table_build_process(
+                            rows, acquired_block, raw_ptrs, this);
+                    return hash_table_build_process(arg);
+                } else {
+                    LOG(FATAL) << "FATAL: uninited hash table";
+                }
+                __builtin_unreachable();
+            },
+            _hash_table_variants);
+}
+
+Status VSetOperationNode::_probe_child(RuntimeState* state, int child_idx) {
+    RETURN_IF_ERROR(child(child_idx)->open(state));
+    SCOPED_TIMER(_probe_timer);
+    Block block;
+    Block materialized_block;
+    bool eos = false;
+    while (!eos) {
+        block.clear();
+        RETURN_IF_CANCELLED(state);
+        RETURN_IF_ERROR(child(child_idx)->get_next(state, &block, &eos));
+        size_t rows = block.rows();
+        if (rows == 0) {
+            continue;
+        }
+        COUNTER_UPDATE(_probe_rows_counter, rows);
+
+        RETURN_IF_ERROR(_materialize_child_block(child_idx, &block, &materialized_block));
+        ColumnRawPtrs raw_ptrs(materialized_block.columns());
+        for (size_t i = 0; i < materialized_block.columns(); ++i) {
+            raw_ptrs[i] = materialized_block.get_by_position(i).column.get();
+        }
+
+        RETURN_IF_ERROR(std::visit(
+                [&](auto&& arg) -> Status {
+                    using HashTableCtxType = std::decay_t<decltype(arg)>;
+                    if constexpr (!std::is_same_v<HashTableCtxType, std::monostate>) {
+                        HashTableProbe<HashTableCtxType> hash_table_probe_process(rows, raw_ptrs,
+                                                                                  this);
+                        return hash_table_probe_process(arg);
+                    } else {
+                        LOG(FATAL) << "FATAL: uninited hash table";
+                    }
+                    __builtin_unreachable();
+                },
+                _hash_table_variants));
+    }
+    return Status::OK();
+}
+
+void VSetOperationNode::_refresh_hash_table(bool keep_visited) {
+    std::visit(
+            [&](auto&& arg) {
+                using HashTableCtxType = std::decay_t<decltype(arg)>;
+                if constexpr (!std::is_same_v<HashTableCtxType, std::monostate>) {
+                    // The hash tables can not erase, a dropped key is marked by a null block.
+                    for (auto iter = arg.hash_table.begin(); iter != arg.hash_table.end();
+                         ++iter) {
+                        auto& mapped = iter->get_second();
+                        if (mapped.block == nullptr) {
+                            continue;
+                        }
+                        if (mapped.visited != keep_visited) {
+                            mapped.block = nullptr;
+                            --_valid_element_in_hash_tbl;
+                        }
+                        mapped.visited = false;
+                    }
+                } else {
+                    LOG(FATAL) << "FATAL: uninited hash table";
+                }
+            },
+            _hash_table_variants);
+}
+
+Status VSetOperationNode::_get_data_in_hashtable(RuntimeState* state, Block* output_block,
+                                                 bool* eos) {
+    MutableBlock mutable_block(VectorizedUtils::create_empty_columnswithtypename(row_desc()));
+    auto& columns = mutable_block.mutable_columns();
+    int64_t max_rows = state->batch_size();
+    if (_limit != -1) {
+        max_rows = std::min(max_rows, _limit - _num_rows_returned);
+    }
+
+    std::visit(
+            [&](auto&& arg) {
+                using HashTableCtxType = std::decay_t<decltype(arg)>;
+                if constexpr (!std::is_same_v<HashTableCtxType, std::monostate>) {
+                    arg.init_once();
+                    auto& iter = arg.iter;
+                    int64_t rows = 0;
+                    for (; iter != arg.hash_table.end() && rows < max_rows; ++iter) {
+                        const auto& mapped = iter->get_second();
+                        if (mapped.block == nullptr) {
+                            continue;
+                        }
+                        for (size_t j = 0; j < columns.size(); ++j) {
+                            columns[j]->insert_from(*mapped.block->get_by_position(j).column,
+                                                    mapped.row_num);
+                        }
+                        ++rows;
+                    }
+                    _num_rows_returned += rows;
+                    *eos = iter == arg.hash_table.end() || reached_limit();
+                } else {
+                    LOG(FATAL) << "FATAL: uninited hash table";
+                }
+            },
+            _hash_table_variants);
+
+    output_block->swap(mutable_block.to_block());
+    COUNTER_SET(_rows_returned_counter, _num_rows_returned);
+    return Status::OK();
+}
+
 } // namespace vectorized
 } // namespace doris
@@ -21,11 +21,52 @@
 #include "exec/exec_node.h"
 #include "runtime/row_batch.h"
 #include "runtime/runtime_state.h"
+#include "vec/core/block.h"
+#include "vec/exec/join/join_op.h"
+#include "vec/exec/join/vacquire_list.hpp"
+#include "vec/exec/join/vhash_join_node.h"
 
 namespace doris {
 
 namespace vectorized {
 
+/// A hash join context with the position of the output in its table. INTERSECT and EXCEPT
+/// return the kept keys over several calls of get_next().
+template <typename HashTableContext>
+struct SetHashTableContext : public HashTableContext {
+    using Iter = typename HashTableContext::HashTable::iterator;
+
+    Iter iter;
+    bool inited = false;
+
+    void init_once() {
+        if (!inited) {
+            inited = true;
+            iter = this->hash_table.begin();
+        }
+    }
+};
+
+/// INTERSECT and EXCEPT keep one row per distinct key, so the tables map a key to the first
+/// row of the key with a flag set when a probe finds it.
+using SetSerializedHashTableContext =
+        SetHashTableContext<SerializedHashTableContext<RowRefWithFlag>>;
+template <class T>
+using SetPrimaryTypeHashTableContext =
+        SetHashTableContext<PrimaryTypeHashTableContext<T, RowRefWithFlag>>;
+template <class T, bool has_null>
+using SetFixedKeyHashTableContext =
+        SetHashTableContext<FixedKeyHashTableContext<T, has_null, RowRefWithFlag>>;
+
+using SetHashTableVariants =
+        std::variant<std::monostate, SetSerializedHashTableContext,
+                     SetPrimaryTypeHashTableContext<UInt8>, SetPrimaryTypeHashTableContext<UInt16>,
+                     SetPrimaryTypeHashTableContext<UInt32>, SetPrimaryTypeHashTableContext<UInt64>,
+                     SetFixedKeyHashTableContext<UInt64, true>,
+                     SetFixedKeyHashTableContext<UInt64, false>,
+                     SetFixedKeyHashTableContext<UInt128, true>,
+                     SetFixedKeyHashTableContext<UInt128, false>>;
+
 class VSetOperationNode : public ExecNode {
 public:
     VSetOperationNode(ObjectPool* pool, const TPlanNode& tnode, const DescriptorTbl& descs);
@@ -40,6 +81,21 @@ public:
     virtual void debug_string(int indentation_level, std::stringstream* out) const {};
 
 protected:
+    /// Evaluates the result exprs of child 'child_idx' on 'src_block' into 'dst_block'. The
+    /// result columns are full columns with the nullability of the output row.
+    Status _materialize_child_block(int child_idx, Block* src_block, Block* dst_block);
+
+    /// Used by INTERSECT and EXCEPT: chooses the hash table by the key types of the output row.
+    Status _prepare_hash_table(RuntimeState* state);
+    /// Builds the distinct rows of child 0 into the hash table.
+    Status _hash_table_build(RuntimeState* state);
+    /// Streams child 'child_idx' through the hash table and marks the keys it contains.
+    Status _probe_child(RuntimeState* state, int child_idx);
+    /// Drops the keys whose visited flag differs from 'keep_visited' and resets the flags.
+    void _refresh_hash_table(bool keep_visited);
+    /// Gathers up to batch_size live rows of the hash table into 'output_block'.
+    Status _get_data_in_hashtable(RuntimeState* state, Block* output_block, bool* eos);
+
     /// Const exprs materialized by this node. These exprs don't refer to any children.
     /// Only materialized by the first fragment instance to avoid duplication.
     std::vector<std::vector<VExprContext*>> _const_expr_lists;
@@ -65,6 +121,31 @@ protected:
 
     // Time spent to evaluates exprs and materializes the results
     RuntimeProfile::Counter* _materialize_exprs_evaluate_timer = nullptr;
+
+    /// Nullability of the output columns. Keys of every child are hashed with it so that
+    /// equal values from nullable and non-nullable children meet in the same table.
+    std::vector<bool> _output_nullable;
+
+    SetHashTableVariants _hash_table_variants;
+    Arena _arena;
+    AcquireList<Block> _acquire_list;
+    Sizes _build_key_sz;
+    /// Number of keys still part of the result.
+    int64_t _valid_element_in_hash_tbl = 0;
+
+    RuntimeProfile::Counter* _build_timer = nullptr;
+    RuntimeProfile::Counter* _probe_timer = nullptr;
+    RuntimeProfile::Counter* _build_rows_counter = nullptr;
+    RuntimeProfile::Counter* _probe_rows_counter = nullptr;
+
+private:
+    Status _process_build_block(Block& block);
+
+    template <class HashTableContext>
+    friend struct HashTableBuild;
+
+    template <class HashTableContext>
+    friend struct HashTableProbe;
 };
 
 } // namespace vectorized
@@ -103,7 +103,6 @@ Status VSortNode::close(RuntimeState* state) {
     if (is_closed()) {
         return Status::OK();
     }
-    _mem_tracker->Release(_total_mem_usage);
     _vsort_exec_exprs.close(state);
     ExecNode::close(state);
     return Status::OK();
@@ -129,7 +128,6 @@ Status VSortNode::sort_input(RuntimeState* state) {
 
         if (rows != 0) {
             RETURN_IF_ERROR(pretreat_block(block));
-            size_t mem_usage = block.allocated_bytes();
 
             // dispose TOP-N logic
             if (_limit != -1 ) {
@@ -138,7 +136,6 @@ Status VSortNode::sort_input(RuntimeState* state) {
                 // if one block totally greater the heap top of _block_priority_queue
                 // we can throw the block data directly.
                 if (_num_rows_in_block < _limit) {
-                    _total_mem_usage += mem_usage;
                     _sorted_blocks.emplace_back(std::move(block));
                     _num_rows_in_block += rows;
                     _block_priority_queue.emplace(
@@ -149,18 +146,15 @@ Status VSortNode::sort_input(RuntimeState* state) {
                     if (!block_cursor.totally_greater(_block_priority_queue.top())) {
                         _sorted_blocks.emplace_back(std::move(block));
                         _block_priority_queue.push(block_cursor);
-                        _total_mem_usage += mem_usage;
                     } else {
                         continue;
                     }
                 }
             } else {
                 // dispose normal sort logic
-                _total_mem_usage += mem_usage;
                 _sorted_blocks.emplace_back(std::move(block));
             }
 
-            _mem_tracker->Consume(mem_usage);
             RETURN_IF_CANCELLED(state);
             RETURN_IF_ERROR(state->check_query_state("vsort, while sorting input."));
         }
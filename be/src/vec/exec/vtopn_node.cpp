@@ -0,0 +1,335 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/exec/vtopn_node.h"
+
+#include <algorithm>
+
+#include "runtime/row_batch.h"
+#include "runtime/runtime_state.h"
+#include "util/debug_util.h"
+#include "vec/columns/columns_common.h"
+#include "vec/core/sort_block.h"
+#include "vec/exec/volap_scan_node.h"
+#include "vec/exprs/vslot_ref.h"
+
+namespace doris::vectorized {
+
+VTopNNode::VTopNNode(ObjectPool* pool, const TPlanNode& tnode, const DescriptorTbl& descs)
+        : ExecNode(pool, tnode, descs),
+          _offset(tnode.sort_node.__isset.offset ? tnode.sort_node.offset : 0) {}
+
+Status VTopNNode::init(const TPlanNode& tnode, RuntimeState* state) {
+    RETURN_IF_ERROR(ExecNode::init(tnode, state));
+    RETURN_IF_ERROR(_vsort_exec_exprs.init(tnode.sort_node.sort_info, _pool));
+    _is_asc_order = tnode.sort_node.sort_info.is_asc_order;
+    _nulls_first = tnode.sort_node.sort_info.nulls_first;
+    DCHECK_GE(_limit, 0);
+    _heap_size = _offset + _limit;
+    return Status::OK();
+}
+
+Status VTopNNode::prepare(RuntimeState* state) {
+    SCOPED_TIMER(_runtime_profile->total_time_counter());
+    RETURN_IF_ERROR(ExecNode::prepare(state));
+    RETURN_IF_ERROR(_vsort_exec_exprs.prepare(state, child(0)->row_desc(), _row_descriptor,
+                                              expr_mem_tracker()));
+    _sort_timer = ADD_TIMER(runtime_profile(), "SortTime");
+    _discarded_blocks_counter = ADD_COUNTER(runtime_profile(), "DiscardedBlocks", TUnit::UNIT);
+    _filtered_rows_counter = ADD_COUNTER(runtime_profile(), "HeapTopFilteredRows", TUnit::UNIT);
+    _compact_counter = ADD_COUNTER(runtime_profile(), "CompactHeapBlocks", TUnit::UNIT);
+    _init_topn_filter(state);
+    return Status::OK();
+}
+
+Status VTopNNode::open(RuntimeState* state) {
+    SCOPED_TIMER(_runtime_profile->total_time_counter());
+    RETURN_IF_ERROR(ExecNode::open(state));
+    RETURN_IF_ERROR(_vsort_exec_exprs.open(state));
+    RETURN_IF_CANCELLED(state);
+    RETURN_IF_ERROR(state->check_query_state("vtopn, while open."));
+    RETURN_IF_ERROR(child(0)->open(state));
+
+    bool eos = false;
+    while (!eos && _heap_size > 0) {
+        Block block;
+        RETURN_IF_ERROR(child(0)->get_next(state, &block, &eos));
+        if (block.rows() != 0) {
+            RETURN_IF_ERROR(_process_block(block));
+        }
+        RETURN_IF_CANCELLED(state);
+        RETURN_IF_ERROR(state->check_query_state("vtopn, while processing input."));
+    }
+
+    // the heap pops the greatest row first
+    _sorted_rows.resize(_heap.size());
+    for (auto it = _sorted_rows.rbegin(); it != _sorted_rows.rend(); ++it) {
+        *it = _heap.top();
+        _heap.pop();
+    }
+    _output_pos = std::min<size_t>(_offset, _sorted_rows.size());
+    return Status::OK();
+}
+
+Status VTopNNode::get_next(RuntimeState* state, RowBatch* row_batch, bool* eos) {
+    *eos = true;
+    return Status::NotSupported("Not Implemented VTopNNode::get_next scalar");
+}
+
+Status VTopNNode::get_next(RuntimeState* state, Block* block, bool* eos) {
+    SCOPED_TIMER(_runtime_profile->total_time_counter());
+    if (_output_pos == _sorted_rows.size()) {
+        *eos = true;
+        COUNTER_SET(_rows_returned_counter, _num_rows_returned);
+        return Status::OK();
+    }
+
+    const Block& sample_block = _heap_blocks.front()->block;
+    MutableColumns columns = sample_block.clone_empty_columns();
+    size_t end = std::min(_sorted_rows.size(), _output_pos + state->batch_size());
+    for (; _output_pos < end; ++_output_pos) {
+        const auto& heap_row = _sorted_rows[_output_pos];
+        for (size_t i = 0; i < columns.size(); ++i) {
+            columns[i]->insert_from(*heap_row.heap_block->block.get_by_position(i).column,
+                                    heap_row.row);
+        }
+    }
+    *block = sample_block.clone_with_columns(std::move(columns));
+    _num_rows_returned += block->rows();
+
+    *eos = _output_pos == _sorted_rows.size();
+    if (*eos) {
+        COUNTER_SET(_rows_returned_counter, _num_rows_returned);
+    }
+    return Status::OK();
+}
+
+Status VTopNNode::close(RuntimeState* state) {
+    if (is_closed()) {
+        return Status::OK();
+    }
+    _sorted_rows.clear();
+    _heap_blocks.clear();
+    _vsort_exec_exprs.close(state);
+    return ExecNode::close(state);
+}
+
+void VTopNNode::debug_string(int indentation_level, std::stringstream* out) const {
+    *out << std::string(indentation_level * 2, ' ');
+    *out << "VTopNNode(";
+    for (int i = 0; i < _is_asc_order.size(); ++i) {
+        *out << (i > 0 ? " " : "") << (_is_asc_order[i] ? "asc" : "desc") << " nulls "
+             << (_nulls_first[i] ? "first" : "last");
+    }
+    ExecNode::debug_string(indentation_level, out);
+    *out << ")";
+}
+
+void VTopNNode::_init_topn_filter(RuntimeState* state) {
+    // The rows cut by the scan have to be the ones this node would discard, so the scan has to
+    // be the direct child and the first ordering expr a not null column of it, of a type whose
+    // values print exactly.
+    if (dynamic_cast<VOlapScanNode*>(child(0)) == nullptr ||
+        _vsort_exec_exprs.lhs_ordering_expr_ctxs().empty()) {
+        return;
+    }
+    const VExpr* expr = _vsort_exec_exprs.lhs_ordering_expr_ctxs()[0]->root();
+    if (!expr->is_slot_ref()) {
+        return;
+    }
+    int slot_id = static_cast<const VSlotRef*>(expr)->slot_id();
+    if (_vsort_exec_exprs.need_materialize_tuple()) {
+        // the ordering exprs refer to the sort tuple, whose slots are materialized in order by
+        // the sort tuple slot exprs
+        const auto& sort_slots = _row_descriptor.tuple_descriptors()[0]->slots();
+        const auto& slot_expr_ctxs = _vsort_exec_exprs.sort_tuple_slot_expr_ctxs();
+        auto it = std::find_if(sort_slots.begin(), sort_slots.end(),
+                               [&](const SlotDescriptor* slot) { return slot->id() == slot_id; });
+        size_t slot_idx = it - sort_slots.begin();
+        if (slot_idx >= slot_expr_ctxs.size() ||
+            !slot_expr_ctxs[slot_idx]->root()->is_slot_ref()) {
+            return;
+        }
+        slot_id = static_cast<const VSlotRef*>(slot_expr_ctxs[slot_idx]->root())->slot_id();
+    }
+
+    const SlotDescriptor* slot = state->desc_tbl().get_slot_descriptor(slot_id);
+    if (slot == nullptr || slot->is_nullable() ||
+        !TopNFilter::is_supported_type(slot->type().type) ||
+        child(0)->row_desc().get_tuple_idx(slot->parent()) == RowDescriptor::INVALID_IDX) {
+        return;
+    }
+    _topn_filter = std::make_shared<TopNFilter>(slot->col_name(), _is_asc_order[0]);
+    static_cast<VOlapScanNode*>(child(0))->set_topn_filter(_topn_filter);
+    _runtime_profile->add_info_string("TopNFilter", slot->col_name());
+}
+
+Status VTopNNode::_pretreat_block(Block& block) {
+    if (_vsort_exec_exprs.need_materialize_tuple()) {
+        auto output_tuple_expr_ctxs = _vsort_exec_exprs.sort_tuple_slot_expr_ctxs();
+        std::vector<int> valid_column_ids(output_tuple_expr_ctxs.size());
+        for (int i = 0; i < output_tuple_expr_ctxs.size(); ++i) {
+            RETURN_IF_ERROR(output_tuple_expr_ctxs[i]->execute(&block, &valid_column_ids[i]));
+        }
+
+        Block new_block;
+        for (auto column_id : valid_column_ids) {
+            new_block.insert(block.get_by_position(column_id));
+        }
+        block.swap(new_block);
+    }
+
+    _sort_description.resize(_vsort_exec_exprs.lhs_ordering_expr_ctxs().size());
+    for (int i = 0; i < _sort_description.size(); i++) {
+        const auto& ordering_expr = _vsort_exec_exprs.lhs_ordering_expr_ctxs()[i];
+        RETURN_IF_ERROR(ordering_expr->execute(&block, &_sort_description[i].column_number));
+
+        _sort_description[i].direction = _is_asc_order[i] ? 1 : -1;
+        _sort_description[i].nulls_direction = _nulls_first[i] ? -1 : 1;
+    }
+    return Status::OK();
+}
+
+bool VTopNNode::_filter_by_heap_top(Block& block) {
+    const auto& top = _heap.top();
+    const auto& desc = _sort_description[0];
+    const IColumn& column = *block.get_by_position(desc.column_number).column;
+    const IColumn& top_column = *top.heap_block->cursor.sort_columns[0];
+    if (is_column_const(column)) {
+        return true;
+    }
+
+    // rows equal to the top on the first column may still sort before it on the following ones
+    const bool keep_equal = _sort_description.size() > 1;
+    const size_t rows = block.rows();
+    IColumn::Filter filter(rows);
+    for (size_t i = 0; i < rows; ++i) {
+        int res = desc.direction *
+                  column.compare_at(i, top.row, top_column, desc.nulls_direction);
+        filter[i] = res < 0 || (keep_equal && res == 0);
+    }
+
+    size_t count = count_bytes_in_filter(filter);
+    COUNTER_UPDATE(_filtered_rows_counter, rows - count);
+    if (count == 0) {
+        return false;
+    }
+    if (count != rows) {
+        for (size_t i = 0; i < block.columns(); ++i) {
+            auto& column_with_type = block.get_by_position(i);
+            column_with_type.column = column_with_type.column->filter(filter, count);
+        }
+    }
+    return true;
+}
+
+Status VTopNNode::_process_block(Block& block) {
+    RETURN_IF_ERROR(_pretreat_block(block));
+    if (_heap.size() == _heap_size && !_filter_by_heap_top(block)) {
+        COUNTER_UPDATE(_discarded_blocks_counter, 1);
+        return Status::OK();
+    }
+
+    {
+        SCOPED_TIMER(_sort_timer);
+        sort_block(block, _sort_description, _heap_size);
+    }
+
+    auto heap_block = std::make_unique<HeapBlock>(std::move(block), _sort_description);
+    SortCursor cursor(&heap_block->cursor);
+    const size_t rows = heap_block->cursor.rows;
+    for (size_t row = 0; row < rows; ++row) {
+        if (_heap.size() == _heap_size) {
+            const auto& top = _heap.top();
+            // the block is sorted, the following rows can not sort before the top either
+            if (cursor.greater_at(SortCursor(&top.heap_block->cursor), row, top.row) >= 0) {
+                break;
+            }
+            _release_heap_row(top);
+            _heap.pop();
+        }
+        _heap.push({heap_block.get(), row});
+        ++heap_block->num_heap_rows;
+    }
+
+    if (heap_block->num_heap_rows > 0) {
+        _num_rows_in_heap_blocks += rows;
+        _heap_blocks.emplace_back(std::move(heap_block));
+    }
+
+    for (auto it = _heap_blocks.begin(); it != _heap_blocks.end();) {
+        if ((*it)->num_heap_rows == 0) {
+            _num_rows_in_heap_blocks -= (*it)->cursor.rows;
+            it = _heap_blocks.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    if (_heap_blocks.size() > 1 && _num_rows_in_heap_blocks > 2 * _heap_size) {
+        _compact_heap_blocks();
+    }
+    if (_heap.size() == _heap_size) {
+        _update_topn_filter();
+    }
+    return Status::OK();
+}
+
+void VTopNNode::_release_heap_row(const HeapSortCursor& heap_row) {
+    DCHECK_GT(heap_row.heap_block->num_heap_rows, 0);
+    --heap_row.heap_block->num_heap_rows;
+}
+
+void VTopNNode::_compact_heap_blocks() {
+    std::vector<HeapSortCursor> rows(_heap.size());
+    for (auto it = rows.rbegin(); it != rows.rend(); ++it) {
+        *it = _heap.top();
+        _heap.pop();
+    }
+
+    const Block& sample_block = _heap_blocks.front()->block;
+    MutableColumns columns = sample_block.clone_empty_columns();
+    for (const auto& heap_row : rows) {
+        for (size_t i = 0; i < columns.size(); ++i) {
+            columns[i]->insert_from(*heap_row.heap_block->block.get_by_position(i).column,
+                                    heap_row.row);
+        }
+    }
+    auto heap_block = std::make_unique<HeapBlock>(
+            sample_block.clone_with_columns(std::move(columns)), _sort_description);
+    for (size_t row = 0; row < rows.size(); ++row) {
+        _heap.push({heap_block.get(), row});
+    }
+    heap_block->num_heap_rows = rows.size();
+
+    _num_rows_in_heap_blocks = rows.size();
+    _heap_blocks.clear();
+    _heap_blocks.emplace_back(std::move(heap_block));
+    COUNTER_UPDATE(_compact_counter, 1);
+}
+
+void VTopNNode::_update_topn_filter() {
+    if (_topn_filter == nullptr) {
+        return;
+    }
+    const auto& top = _heap.top();
+    const auto& column =
+            top.heap_block->block.get_by_position(_sort_description[0].column_number);
+    _topn_filter->update(column.type->to_string(*column.column, top.row));
+}
+
+} // namespace doris::vectorized
@@ -0,0 +1,127 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <list>
+#include <queue>
+
+#include "exec/exec_node.h"
+#include "olap/topn_filter.h"
+#include "vec/core/block.h"
+#include "vec/core/sort_cursor.h"
+#include "vec/exec/vsort_exec_exprs.h"
+
+namespace doris::vectorized {
+
+// Node for in-memory TopN (ORDER BY ... LIMIT).
+// In open(), VTopNNode keeps the offset + limit smallest rows of its input in a max heap of
+// row cursors: the heap top is the current Nth row. Once the heap is full, every input block
+// is first compared against the top on the first ordering column and only the rows which can
+// still enter the heap are sorted and pushed. The Nth value is also published to an olap scan
+// directly below this node, which skips the segments and pages that can not beat it.
+// In get_next(), the rows of the heap are output in order.
+class VTopNNode : public doris::ExecNode {
+public:
+    VTopNNode(ObjectPool* pool, const TPlanNode& tnode, const DescriptorTbl& descs);
+
+    ~VTopNNode() override = default;
+
+    virtual Status init(const TPlanNode& tnode, RuntimeState* state = nullptr);
+
+    virtual Status prepare(RuntimeState* state);
+
+    virtual Status open(RuntimeState* state);
+
+    virtual Status get_next(RuntimeState* state, RowBatch* row_batch, bool* eos);
+
+    virtual Status get_next(RuntimeState* state, Block* block, bool* eos);
+
+    virtual Status close(RuntimeState* state);
+
+protected:
+    virtual void debug_string(int indentation_level, std::stringstream* out) const;
+
+private:
+    // An input block with at least one row in the heap.
+    struct HeapBlock {
+        HeapBlock(Block&& block_, const SortDescription& desc)
+                : block(std::move(block_)), cursor(block, desc) {}
+
+        Block block;
+        SortCursorImpl cursor;
+        size_t num_heap_rows = 0;
+    };
+
+    // A row of a HeapBlock. The top of the heap is the greatest row in sort order.
+    struct HeapSortCursor {
+        HeapBlock* heap_block;
+        size_t row;
+
+        bool operator<(const HeapSortCursor& rhs) const {
+            return SortCursor(&heap_block->cursor)
+                           .greater_at(SortCursor(&rhs.heap_block->cursor), row, rhs.row) < 0;
+        }
+    };
+
+    // Publishes the bound of the first ordering column to the olap scan below, if any.
+    void _init_topn_filter(RuntimeState* state);
+
+    Status _pretreat_block(Block& block);
+
+    // Evaluates the first ordering column against the heap top and filters out the rows that
+    // sort after it. Returns false if no row is left.
+    bool _filter_by_heap_top(Block& block);
+
+    Status _process_block(Block& block);
+
+    void _release_heap_row(const HeapSortCursor& heap_row);
+
+    // Copies the rows of the heap into one block, so that the blocks holding only a few of
+    // them can be freed.
+    void _compact_heap_blocks();
+
+    void _update_topn_filter();
+
+    // Number of rows to skip.
+    int64_t _offset;
+    // offset + limit, the number of rows kept in the heap.
+    size_t _heap_size = 0;
+
+    // Expressions and parameters used for build _sort_description
+    VSortExecExprs _vsort_exec_exprs;
+    std::vector<bool> _is_asc_order;
+    std::vector<bool> _nulls_first;
+    SortDescription _sort_description;
+
+    std::list<std::unique_ptr<HeapBlock>> _heap_blocks;
+    size_t _num_rows_in_heap_blocks = 0;
+    std::priority_queue<HeapSortCursor> _heap;
+
+    // Rows of the heap in sort order, filled at the end of open().
+    std::vector<HeapSortCursor> _sorted_rows;
+    size_t _output_pos = 0;
+
+    std::shared_ptr<TopNFilter> _topn_filter;
+
+    RuntimeProfile::Counter* _sort_timer = nullptr;
+    RuntimeProfile::Counter* _discarded_blocks_counter = nullptr;
+    RuntimeProfile::Counter* _filtered_rows_counter = nullptr;
+    RuntimeProfile::Counter* _compact_counter = nullptr;
+};
+
+} // namespace doris::vectorized
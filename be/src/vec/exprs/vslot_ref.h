@@ -35,6 +35,7 @@ public:
     }
 
     virtual const std::string& expr_name() const override;
+    int slot_id() const { return _slot_id; }
     virtual std::string debug_string() const;
 
 private:
@@ -20,6 +20,7 @@
 #include "gen_cpp/data.pb.h"
 #include "runtime/mem_tracker.h"
 #include "util/uid_util.h"
+#include "vec/common/thread_mem_tracker.h"
 #include "vec/core/block.h"
 #include "vec/core/sort_cursor.h"
 #include "vec/runtime/vdata_stream_mgr.h"
@@ -92,17 +93,8 @@ void VDataStreamRecvr::SenderQueue::add_block(const PBlock& pblock, int be_numbe
     if (_is_cancelled) {
         return;
     }
-    auto iter = _packet_seq_map.find(be_number);
-    if (iter != _packet_seq_map.end()) {
-        if (iter->second >= packet_seq) {
-            LOG(WARNING) << fmt::format(
-                    "packet already exist [cur_packet_id= {} receive_packet_id={}]", iter->second,
-                    packet_seq);
-            return;
-        }
-        iter->second = packet_seq;
-    } else {
-        _packet_seq_map.emplace(be_number, packet_seq);
+    if (_is_duplicate_packet(be_number, packet_seq)) {
+        return;
     }
     int block_byte_size = pblock.ByteSize();
     COUNTER_UPDATE(_recvr->_bytes_received_counter, block_byte_size);
@@ -112,19 +104,45 @@ void VDataStreamRecvr::SenderQueue::add_block(const PBlock& pblock, int be_numbe
         return;
     }
 
-    if (_is_cancelled) {
-        return;
-    }
-
+    // Deserialize without holding the lock, so that the merger keeps consuming the blocks
+    // already in the queue meanwhile.
+    l.unlock();
+    // the block is freed by the fragment thread, account it to the same tracker
+    ScopedThreadMemTracker scoped_tracker(_recvr->_mem_tracker, false);
     Block* block = nullptr;
     {
         SCOPED_TIMER(_recvr->_deserialize_row_batch_timer);
         block = new Block(pblock);
     }
-    _recvr->_mem_tracker->Consume(block->bytes());
+    l.lock();
 
-    VLOG_ROW << "added #rows=" << block->rows() << " batch_size=" << block_byte_size << "\n";
-    _block_queue.emplace_back(block_byte_size, block);
+    if (_is_cancelled || _is_duplicate_packet(be_number, packet_seq)) {
+        delete block;
+        return;
+    }
+    _recvr->_num_buffered_bytes += block_byte_size;
+
+    // A sender has several requests in flight, which may arrive in any order. The blocks
+    // arriving ahead of their turn wait until the ones before them are queued, the sorted
+    // runs of a merging exchange must stay in order. They count toward the buffer limit
+    // like the queued blocks.
+    int64_t& next_packet_seq = _packet_seq_map[be_number];
+    if (packet_seq != next_packet_seq) {
+        _out_of_order_blocks[be_number].emplace(packet_seq, std::make_pair(block_byte_size, block));
+    } else {
+        VLOG_ROW << "added #rows=" << block->rows() << " batch_size=" << block_byte_size << "\n";
+        _block_queue.emplace_back(block_byte_size, block);
+        ++next_packet_seq;
+        auto out_of_order_iter = _out_of_order_blocks.find(be_number);
+        if (out_of_order_iter != _out_of_order_blocks.end()) {
+            auto& blocks = out_of_order_iter->second;
+            while (!blocks.empty() && blocks.begin()->first == next_packet_seq) {
+                _block_queue.push_back(blocks.begin()->second);
+                blocks.erase(blocks.begin());
+                ++next_packet_seq;
+            }
+        }
+    }
     // if done is nullptr, this function can't delay this response
     if (done != nullptr && _recvr->exceeds_limit(block_byte_size)) {
         MonotonicStopWatch monotonicStopWatch;
@@ -133,32 +151,44 @@ void VDataStreamRecvr::SenderQueue::add_block(const PBlock& pblock, int be_numbe
         _pending_closures.emplace_back(*done, monotonicStopWatch);
         *done = nullptr;
     }
-    _recvr->_num_buffered_bytes += block_byte_size;
     _data_arrival_cv.notify_one();
 }
 
+bool VDataStreamRecvr::SenderQueue::_is_duplicate_packet(int be_number, int64_t packet_seq) {
+    auto iter = _packet_seq_map.find(be_number);
+    if (iter == _packet_seq_map.end()) {
+        return false;
+    }
+    if (packet_seq < iter->second) {
+        LOG(WARNING) << fmt::format(
+                "packet already exist [next_packet_id= {} receive_packet_id={}]", iter->second,
+                packet_seq);
+        return true;
+    }
+    auto out_of_order_iter = _out_of_order_blocks.find(be_number);
+    if (out_of_order_iter != _out_of_order_blocks.end() &&
+        out_of_order_iter->second.count(packet_seq) > 0) {
+        LOG(WARNING) << fmt::format("packet already exist [receive_packet_id={}]", packet_seq);
+        return true;
+    }
+    return false;
+}
+
 void VDataStreamRecvr::SenderQueue::add_block(Block* block, bool use_move) {
     std::unique_lock<std::mutex> l(_lock);
     if (_is_cancelled) {
         return;
     }
+    // The columns are shared with the sender, COW makes whichever side mutates them
+    // first copy its own. If use_move is true the sender gives up its block.
     Block* nblock = new Block(block->get_columns_with_type_and_name());
     nblock->info = block->info;
-
-    // local exchange should copy the block contented if use move == false
     if (use_move) {
         block->clear();
-    } else {
-        auto rows = block->rows();
-        for (int i = 0; i < nblock->columns(); ++i) {
-            nblock->get_by_position(i).column =
-                    nblock->get_by_position(i).column->clone_resized(rows);
-        }
     }
 
     size_t block_size = nblock->bytes();
     _block_queue.emplace_back(block_size, nblock);
-    _recvr->_mem_tracker->Consume(nblock->bytes());
     _data_arrival_cv.notify_one();
 
     if (_recvr->exceeds_limit(block_size)) {
@@ -232,16 +262,25 @@ void VDataStreamRecvr::SenderQueue::close() {
         _pending_closures.clear();
     }
 
-    // Delete any batches queued in _block_queue
+    // Delete any batches queued in _block_queue or waiting for their turn
     for (auto it = _block_queue.begin(); it != _block_queue.end(); ++it) {
+        _recvr->_num_buffered_bytes -= it->first;
         delete it->second;
     }
+    _block_queue.clear();
+    for (auto& [be_number, blocks] : _out_of_order_blocks) {
+        for (auto& [packet_seq, block] : blocks) {
+            _recvr->_num_buffered_bytes -= block.first;
+            delete block.second;
+        }
+    }
+    _out_of_order_blocks.clear();
 
     _current_block.reset();
 }
 
 VDataStreamRecvr::VDataStreamRecvr(
-        VDataStreamMgr* stream_mgr, const std::shared_ptr<MemTracker>& parent_tracker,
+        VDataStreamMgr* stream_mgr, const std::shared_ptr<MemTracker>& mem_tracker,
         const RowDescriptor& row_desc, const TUniqueId& fragment_instance_id,
         PlanNodeId dest_node_id, int num_senders, bool is_merging, int total_buffer_limit,
         RuntimeProfile* profile,
@@ -254,11 +293,9 @@ VDataStreamRecvr::VDataStreamRecvr(
           _is_merging(is_merging),
           _is_closed(false),
           _num_buffered_bytes(0),
+          _mem_tracker(mem_tracker),
           _profile(profile),
           _sub_plan_query_statistics_recvr(sub_plan_query_statistics_recvr) {
-    _mem_tracker = MemTracker::CreateTracker(
-            _profile, -1, "VDataStreamRecvr:" + print_id(_fragment_instance_id), parent_tracker);
-
     // Create one queue per sender if is_merging is true.
     int num_queues = is_merging ? num_senders : 1;
     _sender_queues.reserve(num_queues);
@@ -300,6 +337,43 @@ Status VDataStreamRecvr::create_merger(const std::vector<VExprContext*>& orderin
     return Status::OK();
 }
 
+Status VDataStreamRecvr::create_parallel_merger(const std::vector<VExprContext*>& ordering_expr,
+                                                const std::vector<bool>& is_asc_order,
+                                                const std::vector<bool>& nulls_first,
+                                                size_t batch_size, int64_t limit, size_t offset) {
+    DCHECK(_is_merging);
+    std::vector<BlockSupplier> child_block_suppliers;
+    // Create the merger that will a single stream of sorted rows.
+    _merger.reset(new VSortedRunMerger(ordering_expr, is_asc_order, nulls_first, batch_size, limit,
+                                       offset, _profile));
+
+    // Same split as the row based DataStreamRecvr::create_parallel_merger(): with N sender
+    // queues and M child mergers, the final merger works on log(M) and the child mergers on
+    // log(N / M) per row, so 2 child mergers below 81 sender queues and 3 above.
+    // A child merger can not know which of its rows are skipped by the offset, so it outputs
+    // up to offset + limit rows and the final merger applies both.
+    int64_t child_limit = limit < 0 ? -1 : limit + offset;
+    auto parallel_thread = _sender_queues.size() < 81 ? 2 : 3;
+    auto step = _sender_queues.size() / parallel_thread + 1;
+    for (int i = 0; i < _sender_queues.size(); i += step) {
+        std::unique_ptr<VSortedRunMerger> child_merger(
+                new VSortedRunMerger(ordering_expr, is_asc_order, nulls_first, batch_size,
+                                     child_limit, 0, _profile));
+        std::vector<BlockSupplier> input_block_suppliers;
+        for (int j = i; j < std::min((size_t)i + step, _sender_queues.size()); ++j) {
+            input_block_suppliers.emplace_back(std::bind(std::mem_fn(&SenderQueue::get_batch),
+                                                         _sender_queues[j], std::placeholders::_1));
+        }
+        RETURN_IF_ERROR(child_merger->prepare(input_block_suppliers));
+
+        child_block_suppliers.emplace_back(std::bind(std::mem_fn(&VSortedRunMerger::get_block),
+                                                     child_merger.get(), std::placeholders::_1));
+        _child_mergers.emplace_back(std::move(child_merger));
+    }
+    RETURN_IF_ERROR(_merger->prepare(child_block_suppliers, true));
+    return Status::OK();
+}
+
 void VDataStreamRecvr::add_block(const PBlock& pblock, int sender_id, int be_number,
                                  int64_t packet_seq, ::google::protobuf::Closure** done) {
     int use_sender_id = _is_merging ? sender_id : 0;
@@ -324,12 +398,6 @@ Status VDataStreamRecvr::get_next(Block* block, bool* eos) {
     } else {
         RETURN_IF_ERROR(_merger->get_next(block, eos));
     }
-
-    if (LIKELY(_mem_tracker->consumption() >= block->bytes())) {
-        _mem_tracker->Release(block->bytes());
-    } else {
-        _mem_tracker->Release(_mem_tracker->consumption());
-    }
     return Status::OK();
 }
 
@@ -349,6 +417,13 @@ void VDataStreamRecvr::close() {
         return;
     }
     _is_closed = true;
+    if (!_child_mergers.empty()) {
+        // Wake up the merge threads waiting on a sender queue and wait for them to finish
+        // before the queues drop their blocks.
+        cancel_stream();
+        _merger.reset();
+        _child_mergers.clear();
+    }
     for (int i = 0; i < _sender_queues.size(); ++i) {
         _sender_queues[i]->close();
     }
@@ -358,7 +433,6 @@ void VDataStreamRecvr::close() {
     _mgr = nullptr;
 
     _merger.reset();
-    _mem_tracker->Release(_mem_tracker->consumption());
 }
 
 } // namespace doris::vectorized
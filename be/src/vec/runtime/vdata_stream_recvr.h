@@ -20,6 +20,7 @@
 #include <atomic>
 #include <condition_variable>
 #include <list>
+#include <map>
 #include <thread>
 
 #include "common/global_types.h"
@@ -49,7 +50,7 @@ class VExprContext;
 
 class VDataStreamRecvr {
 public:
-    VDataStreamRecvr(VDataStreamMgr* stream_mgr, const std::shared_ptr<MemTracker>& parent_tracker,
+    VDataStreamRecvr(VDataStreamMgr* stream_mgr, const std::shared_ptr<MemTracker>& mem_tracker,
                      const RowDescriptor& row_desc, const TUniqueId& fragment_instance_id,
                      PlanNodeId dest_node_id, int num_senders, bool is_merging,
                      int total_buffer_limit, RuntimeProfile* profile,
@@ -62,6 +63,13 @@ public:
                          const std::vector<bool>& nulls_first, size_t batch_size, int64_t limit,
                          size_t offset);
 
+    // Like create_merger(), but the sender queues are split among a few child mergers
+    // which merge in their own threads, and the final merger merges their output.
+    Status create_parallel_merger(const std::vector<VExprContext*>& ordering_expr,
+                                  const std::vector<bool>& is_asc_order,
+                                  const std::vector<bool>& nulls_first, size_t batch_size,
+                                  int64_t limit, size_t offset);
+
     void add_block(const PBlock& pblock, int sender_id, int be_number, int64_t packet_seq,
                    ::google::protobuf::Closure** done);
 
@@ -115,10 +123,14 @@ private:
     bool _is_closed;
 
     std::atomic<int> _num_buffered_bytes;
+    // The tracker of the fragment instance. The blocks are tracked by the allocator, the RPC
+    // threads deserializing them attach this tracker.
     std::shared_ptr<MemTracker> _mem_tracker;
     std::vector<SenderQueue*> _sender_queues;
 
     std::unique_ptr<VSortedRunMerger> _merger;
+    // Child mergers of a parallel merge, which supply the sorted runs of _merger
+    std::vector<std::unique_ptr<VSortedRunMerger>> _child_mergers;
 
     ObjectPool _sender_queue_pool;
     RuntimeProfile* _profile;
@@ -163,6 +175,9 @@ public:
     Block* current_block() const { return _current_block.get(); }
 
 private:
+    // Returns true if the packet has been received already. Must hold _lock.
+    bool _is_duplicate_packet(int be_number, int64_t packet_seq);
+
     VDataStreamRecvr* _recvr;
     std::mutex _lock;
     bool _is_cancelled;
@@ -178,8 +193,10 @@ private:
     bool _received_first_batch;
     // sender_id
     std::unordered_set<int> _sender_eos_set;
-    // be_number => packet_seq
+    // be_number => packet_seq of the next block to queue
     std::unordered_map<int, int64_t> _packet_seq_map;
+    // be_number => the blocks received ahead of _packet_seq_map, by packet_seq
+    std::unordered_map<int, std::map<int64_t, std::pair<int, Block*>>> _out_of_order_blocks;
     std::deque<std::pair<google::protobuf::Closure*, MonotonicStopWatch>> _pending_closures;
     std::unordered_map<std::thread::id, std::unique_ptr<ThreadClosure>> _local_closure;
 };
@@ -17,6 +17,10 @@
 
 #include "vec/runtime/vsorted_run_merger.h"
 
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 #include "exprs/expr.h"
@@ -27,6 +31,7 @@
 #include "util/debug_util.h"
 #include "util/defer_op.h"
 #include "util/runtime_profile.h"
+#include "vec/common/thread_mem_tracker.h"
 
 using std::vector;
 
@@ -40,9 +45,100 @@ VSortedRunMerger::VSortedRunMerger(const std::vector<VExprContext *>& ordering_e
     _get_next_block_timer = ADD_TIMER(profile, "MergeGetNextBlock");
 }
 
+// Pulls the blocks of a sorted run in its own thread and keeps up to MAX_QUEUED_BLOCKS of
+// them ready for the merger, so that the run (usually a child merger) makes progress while
+// the parent merger works on the blocks it already has.
+class VSortedRunMerger::ParallelBlockSupplier {
+public:
+    static constexpr size_t MAX_QUEUED_BLOCKS = 2;
+
+    // The blocks are freed by the thread creating the supplier, so the pull thread tracks
+    // them on the tracker of that thread.
+    ParallelBlockSupplier(const BlockSupplier& sorted_run)
+            : _sorted_run(sorted_run), _mem_tracker(thread_mem_tracker().tracker()) {
+        _pull_task_thread = std::thread(&ParallelBlockSupplier::process_sorted_run_task, this);
+    }
+
+    ~ParallelBlockSupplier() {
+        // when have the limit clause need to wait the _pull_task_thread join terminate
+        {
+            std::lock_guard<std::mutex> l(_lock);
+            _cancel = true;
+        }
+        _cv.notify_all();
+        _pull_task_thread.join();
+    }
+
+    Status get_block(Block** block) {
+        std::unique_lock<std::mutex> l(_lock);
+        _cv.wait(l, [this]() { return !_blocks.empty() || _eos; });
+        if (_blocks.empty()) {
+            _current_block.reset();
+            *block = nullptr;
+            return _status;
+        }
+        _current_block = std::move(_blocks.front());
+        _blocks.pop_front();
+        _cv.notify_all();
+        *block = _current_block.get();
+        return Status::OK();
+    }
+
+private:
+    void process_sorted_run_task() {
+        ScopedThreadMemTracker scoped_tracker(_mem_tracker, false);
+        while (true) {
+            {
+                std::unique_lock<std::mutex> l(_lock);
+                _cv.wait(l, [this]() { return _blocks.size() < MAX_QUEUED_BLOCKS || _cancel; });
+                if (_cancel) {
+                    break;
+                }
+            }
+
+            // do merge from sender queue data
+            Block* block = nullptr;
+            Status status = _sorted_run(&block);
+
+            std::lock_guard<std::mutex> l(_lock);
+            if (!status.ok() || block == nullptr) {
+                _status = status;
+                _eos = true;
+                _cv.notify_all();
+                break;
+            }
+            // the block is owned by the run until its next call
+            _blocks.emplace_back(new Block());
+            _blocks.back()->swap(*block);
+            _cv.notify_all();
+        }
+    }
+
+    BlockSupplier _sorted_run;
+    std::shared_ptr<MemTracker> _mem_tracker;
+    std::thread _pull_task_thread;
+
+    std::mutex _lock;
+    // signal of new block, of a free slot in _blocks or of the eos/cancelled condition
+    std::condition_variable _cv;
+    std::deque<std::unique_ptr<Block>> _blocks;
+    std::unique_ptr<Block> _current_block;
+    Status _status;
+    bool _eos = false;
+    bool _cancel = false;
+};
+
 Status VSortedRunMerger::prepare(const vector<BlockSupplier>& input_runs, bool parallel) {
     for (const auto &supplier : input_runs) {
-        _cursors.emplace_back(supplier, _ordering_expr, _is_asc_order, _nulls_first);
+        if (parallel) {
+            _parallel_suppliers.emplace_back(new ParallelBlockSupplier(supplier));
+            _cursors.emplace_back(std::bind(std::mem_fn(&ParallelBlockSupplier::get_block),
+                                            _parallel_suppliers.back().get(),
+                                            std::placeholders::_1),
+                                  _ordering_expr, _is_asc_order, _nulls_first);
+        } else {
+            _cursors.emplace_back(supplier, _ordering_expr, _is_asc_order, _nulls_first);
+        }
     }
 
     for (auto& _cursor : _cursors) {
@@ -139,6 +235,16 @@ Status VSortedRunMerger::get_next(Block* output_block, bool* eos) {
     return Status::OK();
 }
 
+Status VSortedRunMerger::get_block(Block** block) {
+    _output_block.clear();
+    while (!_output_eos && _output_block.rows() == 0) {
+        _output_block.clear();
+        RETURN_IF_ERROR(get_next(&_output_block, &_output_eos));
+    }
+    *block = _output_block.rows() == 0 ? nullptr : &_output_block;
+    return Status::OK();
+}
+
 void VSortedRunMerger::next_heap(SortCursor& current) {
     if (!current->isLast()) {
         current->next();
@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include <memory>
 #include <queue>
 
 #include "common/object_pool.h"
@@ -50,11 +51,18 @@ public:
     // Prepare this merger to merge and return rows from the sorted runs in 'input_runs'.
     // Retrieves the first batch from each run and sets up the binary heap implementing
     // the priority queue.
+    // If 'parallel' is true, every run is pulled by its own thread a few blocks ahead of
+    // the merge, which is used when the runs are themselves the output of mergers.
     Status prepare(const std::vector<BlockSupplier>& input_runs, bool parallel = false);
 
     // Return the next block of sorted rows from this merger.
     Status get_next(Block* output_block, bool *eos);
 
+    // Return the next block of sorted rows as a BlockSupplier, so that the output of this
+    // merger can be a sorted run of a parent merger. The block is owned by this merger
+    // until the next call, nullptr is returned at eos.
+    Status get_block(Block** block);
+
     // Do not support now
     virtual Status get_batch(RowBatch **output_batch) {
         return Status::InternalError("no support method get_batch(RowBatch** output_batch)");
@@ -75,6 +83,13 @@ protected:
 
     Block _empty_block;
 
+    // Output of get_block()
+    Block _output_block;
+    bool _output_eos = false;
+
+    class ParallelBlockSupplier;
+    std::vector<std::unique_ptr<ParallelBlockSupplier>> _parallel_suppliers;
+
     // Times calls to get_next().
     RuntimeProfile::Counter *_get_next_timer;
 
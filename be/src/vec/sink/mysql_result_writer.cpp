@@ -37,11 +37,7 @@ MysqlResultWriter::MysqlResultWriter(BufferControlBlock* sinker,
           _output_vexpr_ctxs(output_vexpr_ctxs),
           _parent_profile(parent_profile) {}
 
-MysqlResultWriter::~MysqlResultWriter() {
-    for (auto buffer : _vec_buffers) {
-        delete buffer;
-    }
-}
+MysqlResultWriter::~MysqlResultWriter() = default;
 
 Status MysqlResultWriter::init(RuntimeState* state) {
     _init_profile();
@@ -49,9 +45,11 @@ Status MysqlResultWriter::init(RuntimeState* state) {
         return Status::InternalError("sinker is NULL pointer.");
     }
 
-    _vec_buffers.resize(state->batch_size());
-    for (int i = 0; i < state->batch_size(); ++i) {
-        _vec_buffers[i] = new MysqlRowBuffer();
+    _column_buffers.resize(_output_vexpr_ctxs.size());
+    _column_offsets.resize(_output_vexpr_ctxs.size());
+    for (int i = 0; i < _output_vexpr_ctxs.size(); ++i) {
+        _column_buffers[i].reset(new MysqlRowBuffer());
+        _column_offsets[i].reserve(state->batch_size());
     }
 
     return Status::OK();
@@ -65,14 +63,14 @@ void MysqlResultWriter::_init_profile() {
 }
 
 template <PrimitiveType type, bool is_nullable>
-Status MysqlResultWriter::_add_one_column(const ColumnPtr& column_ptr) {
+Status MysqlResultWriter::_add_one_column(const ColumnPtr& column_ptr, int column_idx) {
     SCOPED_TIMER(_convert_tuple_timer);
-    DCHECK(column_ptr->size() <= _vec_buffers.size());
 
     const auto column_size = column_ptr->size();
-    for (int i = 0; i < column_size; i++) {
-        _vec_buffers[i]->reset();
-    }
+    auto& buffer = *_column_buffers[column_idx];
+    auto& offsets = _column_offsets[column_idx];
+    buffer.reset();
+    offsets.resize(column_size);
 
     doris::vectorized::ColumnPtr column;
     if constexpr (is_nullable) {
@@ -85,62 +83,62 @@ Status MysqlResultWriter::_add_one_column(const ColumnPtr& column_ptr) {
     for (int i = 0; i < column_size; ++i) {
         if constexpr (is_nullable) {
             if (column_ptr->is_null_at(i)) {
-                buf_ret = _vec_buffers[i]->push_null();
+                buf_ret = buffer.push_null();
+                if (0 != buf_ret) {
+                    return Status::InternalError("pack mysql buffer failed.");
+                }
+                offsets[i] = buffer.length();
                 continue;
             }
         }
 
         if constexpr (type == TYPE_BOOLEAN) {
             //todo here need to using uint after MysqlRowBuffer support it
-            buf_ret = _vec_buffers[i]->push_tinyint(
+            buf_ret = buffer.push_tinyint(
                 assert_cast<const ColumnVector<UInt8>&>(*column).get_data()[i]);
         }
         if constexpr (type == TYPE_TINYINT) {
-            buf_ret = _vec_buffers[i]->push_tinyint(
+            buf_ret = buffer.push_tinyint(
                 assert_cast<const ColumnVector<Int8>&>(*column).get_data()[i]);
         }
         if constexpr (type == TYPE_SMALLINT) {
-            buf_ret = _vec_buffers[i]->push_smallint(
+            buf_ret = buffer.push_smallint(
                     assert_cast<const ColumnVector<Int16>&>(*column).get_data()[i]);
         }
         if constexpr (type == TYPE_INT) {
-            buf_ret = _vec_buffers[i]->push_int(
+            buf_ret = buffer.push_int(
                     assert_cast<const ColumnVector<Int32>&>(*column).get_data()[i]);
         }
         if constexpr (type == TYPE_BIGINT) {
-            buf_ret = _vec_buffers[i]->push_bigint(
+            buf_ret = buffer.push_bigint(
                     assert_cast<const ColumnVector<Int64>&>(*column).get_data()[i]);
         }
         if constexpr (type == TYPE_LARGEINT) {
-            auto v = LargeIntValue::to_string(
+            buf_ret = buffer.push_largeint(
                     assert_cast<const ColumnVector<Int128>&>(*column).get_data()[i]);
-            buf_ret = _vec_buffers[i]->push_string(v.c_str(), v.size());
         }
         if constexpr (type == TYPE_FLOAT) {
-            buf_ret = _vec_buffers[i]->push_float(
+            buf_ret = buffer.push_float(
                     assert_cast<const ColumnVector<Float32>&>(*column).get_data()[i]);
         }
         if constexpr (type == TYPE_DOUBLE) {
-            buf_ret = _vec_buffers[i]->push_double(
+            buf_ret = buffer.push_double(
                     assert_cast<const ColumnVector<Float64>&>(*column).get_data()[i]);
         }
         if constexpr (type == TYPE_TIME) {
             auto time = assert_cast<const ColumnVector<Float64>&>(*column).get_data()[i];
             std::string time_str = time_str_from_double(time);
-            buf_ret = _vec_buffers[i]->push_string(time_str.c_str(), time_str.size());
+            buf_ret = buffer.push_string(time_str.c_str(), time_str.size());
         }
         if constexpr (type == TYPE_DATETIME) {
-            char buf[64];
             auto time_num = assert_cast<const ColumnVector<Int128>&>(*column).get_data()[i];
             DateTimeValue time_val;
             memcpy(&time_val, &time_num, sizeof(Int128));
-            // TODO(zhaochun), this function has core risk
-            char* pos = time_val.to_string(buf);
-            buf_ret = _vec_buffers[i]->push_string(buf, pos - buf - 1);
+            buf_ret = buffer.push_datetime(time_val);
         }
 
         if constexpr (type == TYPE_OBJECT) {
-            buf_ret = _vec_buffers[i]->push_null();
+            buf_ret = buffer.push_null();
         }
         if constexpr (type == TYPE_VARCHAR) {
             const auto string_val = column->get_data_at(i);
@@ -149,12 +147,12 @@ Status MysqlResultWriter::_add_one_column(const ColumnPtr& column_ptr) {
                 if (string_val.size == 0) {
                     // 0x01 is a magic num, not useful actually, just for present ""
                     char* tmp_val = reinterpret_cast<char*>(0x01);
-                    buf_ret = _vec_buffers[i]->push_string(tmp_val, string_val.size);
+                    buf_ret = buffer.push_string(tmp_val, string_val.size);
                 } else {
-                    buf_ret = _vec_buffers[i]->push_null();
+                    buf_ret = buffer.push_null();
                 }
             } else {
-                buf_ret = _vec_buffers[i]->push_string(string_val.data, string_val.size);
+                buf_ret = buffer.push_string(string_val.data, string_val.size);
             }
         }
         if constexpr (type == TYPE_DECIMALV2) {
@@ -168,17 +166,38 @@ Status MysqlResultWriter::_add_one_column(const ColumnPtr& column_ptr) {
             //            } else {
             decimal_str = decimal_val.to_string();
             //            }
-            buf_ret = _vec_buffers[i]->push_string(decimal_str.c_str(), decimal_str.length());
+            buf_ret = buffer.push_string(decimal_str.c_str(), decimal_str.length());
         }
 
         if (0 != buf_ret) {
             return Status::InternalError("pack mysql buffer failed.");
         }
+        offsets[i] = buffer.length();
     }
 
     return Status::OK();
 }
 
+void MysqlResultWriter::_assemble_rows(int num_rows, std::vector<std::string>* rows) {
+    SCOPED_TIMER(_convert_tuple_timer);
+    const int num_columns = _column_buffers.size();
+    rows->resize(num_rows);
+    for (int j = 0; j < num_rows; ++j) {
+        size_t row_size = 0;
+        for (int i = 0; i < num_columns; ++i) {
+            row_size += _column_offsets[i][j] - (j == 0 ? 0 : _column_offsets[i][j - 1]);
+        }
+
+        // size the row exactly once, then copy every cell of it
+        auto& row = (*rows)[j];
+        row.reserve(row_size);
+        for (int i = 0; i < num_columns; ++i) {
+            const int begin = j == 0 ? 0 : _column_offsets[i][j - 1];
+            row.append(_column_buffers[i]->buf() + begin, _column_offsets[i][j] - begin);
+        }
+    }
+}
+
 Status MysqlResultWriter::append_row_batch(const RowBatch* batch) {
     return Status::RuntimeError("Not Implemented MysqlResultWriter::append_row_batch scalar");
 }
@@ -199,20 +218,10 @@ Status MysqlResultWriter::append_block(Block& block) {
         return Status::OK();
     }
 
-    // TODO: Recheck the vec buffer size of block buffer size
-    if (UNLIKELY(block.rows() > _vec_buffers.size())) {
-        auto gap_size = block.rows() - _vec_buffers.size();
-        _vec_buffers.reserve(block.rows());
-        for (int i = 0; i < gap_size; ++i) {
-            _vec_buffers.emplace_back(new MysqlRowBuffer);
-        }
-    }
-
     Status status;
     // convert one batch
     auto result = std::make_unique<TFetchDataResult>();
     int num_rows = block.rows();
-    result->result_batch.rows.resize(num_rows);
 
     for (int i = 0; status.ok() && i < _output_vexpr_ctxs.size(); ++i) {
         auto column_ptr =
@@ -222,107 +231,107 @@ Status MysqlResultWriter::append_block(Block& block) {
         switch (_output_vexpr_ctxs[i]->root()->result_type()) {
         case TYPE_BOOLEAN:
             if (type_ptr->is_nullable()) {
-                status = _add_one_column<PrimitiveType::TYPE_BOOLEAN, true>(column_ptr);
+                status = _add_one_column<PrimitiveType::TYPE_BOOLEAN, true>(column_ptr, i);
             } else {
-                status = _add_one_column<PrimitiveType::TYPE_BOOLEAN, false>(column_ptr);
+                status = _add_one_column<PrimitiveType::TYPE_BOOLEAN, false>(column_ptr, i);
             }
             break;
         case TYPE_TINYINT: {
             if (type_ptr->is_nullable()) {
-                status = _add_one_column<PrimitiveType::TYPE_TINYINT, true>(column_ptr);
+                status = _add_one_column<PrimitiveType::TYPE_TINYINT, true>(column_ptr, i);
             } else {
-                status = _add_one_column<PrimitiveType::TYPE_TINYINT, false>(column_ptr);
+                status = _add_one_column<PrimitiveType::TYPE_TINYINT, false>(column_ptr, i);
             }
             break;
         }
         case TYPE_SMALLINT: {
             if (type_ptr->is_nullable()) {
-                status = _add_one_column<PrimitiveType::TYPE_SMALLINT, true>(column_ptr);
+                status = _add_one_column<PrimitiveType::TYPE_SMALLINT, true>(column_ptr, i);
             } else {
-                status = _add_one_column<PrimitiveType::TYPE_SMALLINT, false>(column_ptr);
+                status = _add_one_column<PrimitiveType::TYPE_SMALLINT, false>(column_ptr, i);
             }
             break;
         }
         case TYPE_INT: {
             if (type_ptr->is_nullable()) {
-                status = _add_one_column<PrimitiveType::TYPE_INT, true>(column_ptr);
+                status = _add_one_column<PrimitiveType::TYPE_INT, true>(column_ptr, i);
             } else {
-                status = _add_one_column<PrimitiveType::TYPE_INT, false>(column_ptr);
+                status = _add_one_column<PrimitiveType::TYPE_INT, false>(column_ptr, i);
             }
             break;
         }
         case TYPE_BIGINT: {
             if (type_ptr->is_nullable()) {
-                status = _add_one_column<PrimitiveType::TYPE_BIGINT, true>(column_ptr);
+                status = _add_one_column<PrimitiveType::TYPE_BIGINT, true>(column_ptr, i);
             } else {
-                status = _add_one_column<PrimitiveType::TYPE_BIGINT, false>(column_ptr);
+                status = _add_one_column<PrimitiveType::TYPE_BIGINT, false>(column_ptr, i);
             }
             break;
         }
         case TYPE_LARGEINT: {
             if (type_ptr->is_nullable()) {
-                status = _add_one_column<PrimitiveType::TYPE_LARGEINT, true>(column_ptr);
+                status = _add_one_column<PrimitiveType::TYPE_LARGEINT, true>(column_ptr, i);
             } else {
-                status = _add_one_column<PrimitiveType::TYPE_LARGEINT, false>(column_ptr);
+                status = _add_one_column<PrimitiveType::TYPE_LARGEINT, false>(column_ptr, i);
             }
             break;
         }
         case TYPE_FLOAT: {
             if (type_ptr->is_nullable()) {
-                status = _add_one_column<PrimitiveType::TYPE_FLOAT, true>(column_ptr);
+                status = _add_one_column<PrimitiveType::TYPE_FLOAT, true>(column_ptr, i);
             } else {
-                status = _add_one_column<PrimitiveType::TYPE_FLOAT, false>(column_ptr);
+                status = _add_one_column<PrimitiveType::TYPE_FLOAT, false>(column_ptr, i);
             }
             break;
         }
         case TYPE_DOUBLE: {
             if (type_ptr->is_nullable()) {
-                status = _add_one_column<PrimitiveType::TYPE_DOUBLE, true>(column_ptr);
+                status = _add_one_column<PrimitiveType::TYPE_DOUBLE, true>(column_ptr, i);
             } else {
-                status = _add_one_column<PrimitiveType::TYPE_DOUBLE, false>(column_ptr);
+                status = _add_one_column<PrimitiveType::TYPE_DOUBLE, false>(column_ptr, i);
             }
             break;
         }
         case TYPE_TIME: {
             if (type_ptr->is_nullable()) {
-                status = _add_one_column<PrimitiveType::TYPE_TIME, true>(column_ptr);
+                status = _add_one_column<PrimitiveType::TYPE_TIME, true>(column_ptr, i);
             } else {
-                status = _add_one_column<PrimitiveType::TYPE_TIME, false>(column_ptr);
+                status = _add_one_column<PrimitiveType::TYPE_TIME, false>(column_ptr, i);
             }
             break;
         }
         case TYPE_CHAR:
         case TYPE_VARCHAR: {
             if (type_ptr->is_nullable()) {
-                status = _add_one_column<PrimitiveType::TYPE_VARCHAR, true>(column_ptr);
+                status = _add_one_column<PrimitiveType::TYPE_VARCHAR, true>(column_ptr, i);
             } else {
-                status = _add_one_column<PrimitiveType::TYPE_VARCHAR, false>(column_ptr);
+                status = _add_one_column<PrimitiveType::TYPE_VARCHAR, false>(column_ptr, i);
             }
             break;
         }
         case TYPE_DECIMALV2: {
             if (type_ptr->is_nullable()) {
-                status = _add_one_column<PrimitiveType::TYPE_DECIMALV2, true>(column_ptr);
+                status = _add_one_column<PrimitiveType::TYPE_DECIMALV2, true>(column_ptr, i);
             } else {
-                status = _add_one_column<PrimitiveType::TYPE_DECIMALV2, false>(column_ptr);
+                status = _add_one_column<PrimitiveType::TYPE_DECIMALV2, false>(column_ptr, i);
             }
             break;
         }
         case TYPE_DATE:
         case TYPE_DATETIME: {
             if (type_ptr->is_nullable()) {
-                status = _add_one_column<PrimitiveType::TYPE_DATETIME, true>(column_ptr);
+                status = _add_one_column<PrimitiveType::TYPE_DATETIME, true>(column_ptr, i);
             } else {
-                status = _add_one_column<PrimitiveType::TYPE_DATETIME, false>(column_ptr);
+                status = _add_one_column<PrimitiveType::TYPE_DATETIME, false>(column_ptr, i);
             }
             break;
         }
         case TYPE_HLL:
         case TYPE_OBJECT: {
             if (type_ptr->is_nullable()) {
-                status = _add_one_column<PrimitiveType::TYPE_OBJECT, true>(column_ptr);
+                status = _add_one_column<PrimitiveType::TYPE_OBJECT, true>(column_ptr, i);
             } else {
-                status = _add_one_column<PrimitiveType::TYPE_OBJECT, false>(column_ptr);
+                status = _add_one_column<PrimitiveType::TYPE_OBJECT, false>(column_ptr, i);
             }
             break;
         }
@@ -333,17 +342,14 @@ Status MysqlResultWriter::append_block(Block& block) {
         }
         }
 
-        if (status) {
-            for (int j = 0; j < num_rows; ++j) {
-                result->result_batch.rows[j].append(_vec_buffers[j]->buf(),
-                                                    _vec_buffers[j]->length());
-            }
-        } else {
+        if (!status) {
             LOG(WARNING) << "convert row to mysql result failed.";
             break;
         }
     }
     if (status) {
+        _assemble_rows(num_rows, &result->result_batch.rows);
+
         SCOPED_TIMER(_result_send_timer);
         // push this batch to back
         status = _sinker->add_batch(result.get());
@@ -16,6 +16,8 @@
 // under the License.
 
 #pragma once
+#include <memory>
+
 #include "runtime/primitive_type.h"
 #include "util/runtime_profile.h"
 #include "vec/core/block.h"
@@ -49,7 +51,10 @@ private:
     void _init_profile();
 
     template <PrimitiveType type, bool is_nullable>
-    Status _add_one_column(const ColumnPtr& column_ptr);
+    Status _add_one_column(const ColumnPtr& column_ptr, int column_idx);
+
+    // assemble the mysql packet of every row from the column buffers
+    void _assemble_rows(int num_rows, std::vector<std::string>* rows);
 
 private:
     BufferControlBlock* _sinker;
@@ -57,7 +62,10 @@ private:
     const std::vector<vectorized::VExprContext*>& _output_vexpr_ctxs;
     // std::vector<int> _result_column_ids;
 
-    std::vector<MysqlRowBuffer*> _vec_buffers;
+    // one contiguous buffer per output column, reused across blocks. the end of
+    // row j of column i in _column_buffers[i] is _column_offsets[i][j].
+    std::vector<std::unique_ptr<MysqlRowBuffer>> _column_buffers;
+    std::vector<std::vector<int>> _column_offsets;
 
     RuntimeProfile* _parent_profile; // parent profile from result sink. not owned
     // total time cost on append batch operation
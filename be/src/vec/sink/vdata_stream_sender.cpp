@@ -7,8 +7,9 @@
 #include "runtime/dpp_sink_internal.h"
 #include "runtime/exec_env.h"
 #include "runtime/mem_tracker.h"
+#include "runtime/raw_value.h"
 #include "runtime/runtime_state.h"
-#include "vec/common/sip_hash.h"
+#include "vec/columns/column_nullable.h"
 #include "vec/runtime/vdata_stream_mgr.h"
 #include "vec/runtime/vdata_stream_recvr.h"
 #include "vec/runtime/vpartition_info.h"
@@ -76,9 +77,15 @@ Status VDataStreamSender::Channel::send_local_block(bool eos) {
             _parent->state()->exec_env()->vstream_mgr()->find_recvr(_fragment_instance_id,
                                                                     _dest_node_id);
     if (recvr != nullptr) {
-        Block block = _mutable_block->to_block();
-        COUNTER_UPDATE(_parent->_local_bytes_send_counter, block.bytes());
-        recvr->add_block(&block, _parent->_sender_id, true);
+        SCOPED_TIMER(_parent->_local_send_timer);
+        // The rows were partitioned straight into _mutable_block, its columns are moved to
+        // the receiver without being serialized.
+        if (_mutable_block->rows() > 0) {
+            Block block = _mutable_block->to_block();
+            COUNTER_UPDATE(_parent->_local_bytes_send_counter, block.bytes());
+            COUNTER_UPDATE(_parent->_local_blocks_send_counter, 1);
+            recvr->add_block(&block, _parent->_sender_id, true);
+        }
         if (eos) {
             recvr->remove_sender(_parent->_sender_id, _be_number);
         }
@@ -92,19 +99,31 @@ Status VDataStreamSender::Channel::send_local_block(Block* block) {
             _parent->state()->exec_env()->vstream_mgr()->find_recvr(_fragment_instance_id,
                                                                     _dest_node_id);
     if (recvr != nullptr) {
+        SCOPED_TIMER(_parent->_local_send_timer);
         COUNTER_UPDATE(_parent->_local_bytes_send_counter, block->bytes());
+        COUNTER_UPDATE(_parent->_local_blocks_send_counter, 1);
+        // The receiver shares the columns of the block by reference.
         recvr->add_block(block, _parent->_sender_id, false);
     }
     return Status::OK();
 }
 
 Status VDataStreamSender::Channel::send_block(PBlock* block, bool eos) {
-    if (_closure == nullptr) {
-        _closure = new RefCountClosure<PTransmitDataResult>();
-        _closure->ref();
+    // The receiver puts the blocks of a channel back in packet_seq order, but it handles eos
+    // as soon as it arrives, so eos is only sent once all the blocks have been received.
+    size_t max_in_flight = std::max(config::exchange_max_in_flight_requests, 1);
+    {
+        SCOPED_TIMER(_parent->_wait_brpc_timer);
+        RETURN_IF_ERROR(_wait_in_flight_brpc(eos ? 0 : max_in_flight - 1));
+    }
+    RefCountClosure<PTransmitDataResult>* closure = nullptr;
+    if (_idle_closures.empty()) {
+        closure = new RefCountClosure<PTransmitDataResult>();
+        closure->ref();
     } else {
-        RETURN_IF_ERROR(_wait_last_brpc());
-        _closure->cntl.Reset();
+        closure = _idle_closures.back();
+        _idle_closures.pop_back();
+        closure->cntl.Reset();
     }
     VLOG_ROW << "Channel::send_batch() instance_id=" << _fragment_instance_id
              << " dest_node=" << _dest_node_id;
@@ -119,21 +138,41 @@ Status VDataStreamSender::Channel::send_block(PBlock* block, bool eos) {
     }
     _brpc_request.set_packet_seq(_packet_seq++);
 
-    _closure->ref();
-    _closure->cntl.set_timeout_ms(_brpc_timeout_ms);
-    _brpc_stub->transmit_block(&_closure->cntl, &_brpc_request, &_closure->result, _closure);
+    closure->ref();
+    closure->cntl.set_timeout_ms(_brpc_timeout_ms);
+    // The request is serialized before transmit_block() returns, so _brpc_request and the
+    // block can be reused while the request is in flight.
+    _brpc_stub->transmit_block(&closure->cntl, &_brpc_request, &closure->result, closure);
+    _in_flight_closures.push_back(closure);
     if (block != nullptr) {
         _brpc_request.release_block();
     }
     return Status::OK();
 }
 
+Status VDataStreamSender::Channel::add_rows(Block* block, const int* row_begin,
+                                           const int* row_end) {
+    if (_fragment_instance_id.lo == -1) {
+        return Status::OK();
+    }
+    if (_mutable_block->rows() == 0) {
+        auto empty_block = block->clone_empty();
+        _mutable_block.reset(
+                new MutableBlock(empty_block.mutate_columns(), empty_block.get_data_types()));
+    }
+    _mutable_block->add_rows(block, row_begin, row_end);
+    if (_mutable_block->rows() >= _parent->state()->batch_size()) {
+        RETURN_IF_ERROR(send_current_block());
+    }
+    return Status::OK();
+}
+
 Status VDataStreamSender::Channel::add_row(Block* block, int row) {
     if (_fragment_instance_id.lo == -1) {
         return Status::OK();
     }
     int batch_size = _parent->state()->batch_size();
-    if (block->rows() == batch_size) {
+    if (_mutable_block->rows() >= batch_size) {
         RETURN_IF_ERROR(send_current_block());
     }
     if (_mutable_block->rows() == 0) {
@@ -147,7 +186,7 @@ Status VDataStreamSender::Channel::add_row(Block* block, int row) {
 
 Status VDataStreamSender::Channel::close_wait(RuntimeState* state) {
     if (_need_close) {
-        Status st = _wait_last_brpc();
+        Status st = _wait_in_flight_brpc(0);
         if (!st.ok()) {
             state->log_error(st.get_error_msg());
         }
@@ -165,7 +204,8 @@ Status VDataStreamSender::Channel::close_internal() {
     VLOG_RPC << "Channel::close() instance_id=" << _fragment_instance_id
              << " dest_node=" << _dest_node_id
              << " #rows= " << ((_mutable_block == nullptr) ? 0 : _mutable_block->rows());
-    if (_mutable_block != nullptr && _mutable_block->rows() > 0) {
+    // A local channel hands eos to the receiver directly instead of through brpc.
+    if (_mutable_block != nullptr && (_mutable_block->rows() > 0 || is_local())) {
         RETURN_IF_ERROR(send_current_block(true));
     } else {
         RETURN_IF_ERROR(send_block(nullptr, true));
@@ -298,6 +338,8 @@ Status VDataStreamSender::prepare(RuntimeState* state) {
     }
 
     _bytes_sent_counter = ADD_COUNTER(profile(), "BytesSent", TUnit::BYTES);
+    _partition_timer = ADD_TIMER(profile(), "PartitionTime");
+    _wait_brpc_timer = ADD_TIMER(profile(), "WaitBrpcTime");
     _uncompressed_bytes_counter = ADD_COUNTER(profile(), "UncompressedRowBatchSize", TUnit::BYTES);
     _ignore_rows = ADD_COUNTER(profile(), "IgnoreRows", TUnit::UNIT);
     _serialize_batch_timer = ADD_TIMER(profile(), "SerializeBatchTime");
@@ -307,6 +349,8 @@ Status VDataStreamSender::prepare(RuntimeState* state) {
                                  profile()->total_time_counter()),
             "");
     _local_bytes_send_counter = ADD_COUNTER(profile(), "LocalBytesSent", TUnit::BYTES);
+    _local_blocks_send_counter = ADD_COUNTER(profile(), "LocalBlocksSent", TUnit::UNIT);
+    _local_send_timer = ADD_TIMER(profile(), "LocalSendTime");
     for (int i = 0; i < _channels.size(); ++i) {
         RETURN_IF_ERROR(_channels[i]->init(state));
     }
@@ -367,54 +411,41 @@ Status VDataStreamSender::send(RuntimeState* state, Block* block) {
         // 4. switch proto
         _current_channel_idx = (_current_channel_idx + 1) % _channels.size();
     } else if (_part_type == TPartitionType::HASH_PARTITIONED) {
-        // TODO: use vectorized hash caculate
-        int num_channels = _channels.size();
+        SCOPED_TIMER(_partition_timer);
         // will only copy schema
         // we don't want send temp columns
         auto send_block = *block;
 
         std::vector<int> result(_partition_expr_ctxs.size());
         int counter = 0;
-
         for (auto ctx : _partition_expr_ctxs) {
             RETURN_IF_ERROR(ctx->execute(block, &result[counter++]));
         }
 
-        // caculate hash
-        int rows = block->rows();
-        for (int i = 0; i < rows; ++i) {
-            SipHash siphash;
-            for (int j = 0; j < result.size(); ++j) {
-                auto column = block->get_by_position(result[j]).column;
-                column->update_hash_with_value(i, siphash);
-            }
-            auto target_channel_id = siphash.get64() % num_channels;
-            RETURN_IF_ERROR(_channels[target_channel_id]->add_row(&send_block, i));
+        // caculate hash a column at a time
+        _hash_vals.assign(block->rows(), 0);
+        for (int j = 0; j < result.size(); ++j) {
+            block->get_by_position(result[j]).column->update_hashes_with_value(_hash_vals.data());
         }
-        return Status::OK();
+        RETURN_IF_ERROR(channel_add_rows(_channels, &send_block));
 
     } else if (_part_type == TPartitionType::BUCKET_SHFFULE_HASH_PARTITIONED) {
+        SCOPED_TIMER(_partition_timer);
         // 1. caculate hash
         // 2. dispatch rows to channel
-        int num_channels = _channel_shared_ptrs.size();
         auto send_block = *block;
         std::vector<int> result(_partition_expr_ctxs.size());
         int counter = 0;
         for (auto ctx : _partition_expr_ctxs) {
             RETURN_IF_ERROR(ctx->execute(block, &result[counter++]));
         }
-        int rows = block->rows();
-        for (int i = 0; i < rows; ++i) {
-            size_t hash_val = 0;
-            for (int j = 0; j < result.size(); ++j) {
-                auto column = block->get_by_position(result[j]).column;
-                void* val = reinterpret_cast<void*>(const_cast<char*>(column->get_data_at(i).data));
-                hash_val = RawValue::zlib_crc32(val, _partition_expr_ctxs[j]->root()->type(),
-                                                hash_val);
-            }
-            auto target_channel_id = hash_val % num_channels;
-            RETURN_IF_ERROR(_channel_shared_ptrs[target_channel_id]->add_row(&send_block, i));
+        // The hash must be the one the tablets are bucketed with.
+        _hash_vals.assign(block->rows(), 0);
+        for (int j = 0; j < result.size(); ++j) {
+            update_crcs_with_column(*block->get_by_position(result[j]).column,
+                                    _partition_expr_ctxs[j]->root()->type(), _hash_vals.data());
         }
+        RETURN_IF_ERROR(channel_add_rows(_channel_shared_ptrs, &send_block));
     } else {
         // Range partition
         // 1. caculate range
@@ -423,6 +454,46 @@ Status VDataStreamSender::send(RuntimeState* state, Block* block) {
     return Status::OK();
 }
 
+void VDataStreamSender::update_crcs_with_column(const IColumn& column,
+                                                const TypeDescriptor& type, uint32_t* hashes) {
+    auto full_column = column.convert_to_full_column_if_const();
+    const IColumn* values = full_column.get();
+    const uint8_t* null_data = nullptr;
+    if (auto* nullable = check_and_get_column<ColumnNullable>(*full_column)) {
+        values = &nullable->get_nested_column();
+        null_data = nullable->get_null_map_data().data();
+    }
+
+    size_t rows = values->size();
+    if (type.is_string_type()) {
+        for (size_t i = 0; i < rows; ++i) {
+            if (null_data != nullptr && null_data[i]) {
+                hashes[i] = RawValue::zlib_crc32(nullptr, type, hashes[i]);
+            } else {
+                StringRef ref = values->get_data_at(i);
+                StringValue value(const_cast<char*>(ref.data), ref.size);
+                hashes[i] = RawValue::zlib_crc32(&value, type, hashes[i]);
+            }
+        }
+    } else if (values->is_fixed_and_contiguous()) {
+        // Numbers, decimals and dates are stored the way RawValue reads them.
+        const char* data = values->get_raw_data().data;
+        size_t value_size = values->size_of_value_if_fixed();
+        for (size_t i = 0; i < rows; ++i) {
+            const void* value =
+                    (null_data != nullptr && null_data[i]) ? nullptr : data + i * value_size;
+            hashes[i] = RawValue::zlib_crc32(value, type, hashes[i]);
+        }
+    } else {
+        for (size_t i = 0; i < rows; ++i) {
+            const void* value = (null_data != nullptr && null_data[i])
+                                        ? nullptr
+                                        : values->get_data_at(i).data;
+            hashes[i] = RawValue::zlib_crc32(value, type, hashes[i]);
+        }
+    }
+}
+
 Status VDataStreamSender::close(RuntimeState* state, Status exec_status) {
     if (_closed) return Status::OK();
     _closed = true;
@@ -64,6 +64,15 @@ private:
 
     Status handle_unpartitioned(Block* block);
 
+    // Updates hashes[i] with the zlib crc32 of the i-th value of column, the way the storage
+    // layer hashes the distribution columns of a tablet.
+    static void update_crcs_with_column(const IColumn& column, const TypeDescriptor& type,
+                                        uint32_t* hashes);
+
+    // Appends every row of block to the channel _hash_vals maps it to.
+    template <typename Channels>
+    Status channel_add_rows(Channels& channels, Block* block);
+
     // Sender instance id, unique within a fragment.
     int _sender_id;
 
@@ -88,12 +97,21 @@ private:
     std::vector<Channel*> _channels;
     std::vector<std::shared_ptr<Channel>> _channel_shared_ptrs;
 
+    // Per-row hash of the partition columns of the current block, then its channel index.
+    std::vector<uint32_t> _hash_vals;
+    // Rows of the current block grouped by channel, and the offsets of the groups.
+    std::vector<int> _channel_rows;
+    std::vector<int> _channel_row_offsets;
+
     // map from range value to partition_id
     // sorted in ascending orderi by range for binary search
     std::vector<VPartitionInfo*> _partition_infos;
 
     RuntimeProfile* _profile; // Allocated from _pool
     RuntimeProfile::Counter* _serialize_batch_timer;
+    RuntimeProfile::Counter* _partition_timer = nullptr;
+    // Time spent waiting for a free slot in the window of requests in flight
+    RuntimeProfile::Counter* _wait_brpc_timer = nullptr;
     RuntimeProfile::Counter* _bytes_sent_counter;
     RuntimeProfile::Counter* _uncompressed_bytes_counter;
     RuntimeProfile::Counter* _ignore_rows;
@@ -102,14 +120,16 @@ private:
 
     // Throughput per total time spent in sender
     RuntimeProfile::Counter* _overall_throughput;
-    // Used to counter send bytes under local data exchange
+    // Used to counter send bytes under local data exchange, which are neither serialized
+    // nor compressed
     RuntimeProfile::Counter* _local_bytes_send_counter;
+    RuntimeProfile::Counter* _local_blocks_send_counter = nullptr;
+    // Time spent handing the blocks of local data exchange to the receivers
+    RuntimeProfile::Counter* _local_send_timer = nullptr;
     // Identifier of the destination plan node.
     PlanNodeId _dest_node_id;
 };
 
-// TODO: support local exechange
-
 class VDataStreamSender::Channel {
 public:
     // Create channel to send data to particular ipaddress/port/query/node
@@ -139,8 +159,15 @@ public:
                 }
 
     virtual ~Channel() {
-        if (_closure != nullptr && _closure->unref()) {
-            delete _closure;
+        for (auto closure : _in_flight_closures) {
+            if (closure->unref()) {
+                delete closure;
+            }
+        }
+        for (auto closure : _idle_closures) {
+            if (closure->unref()) {
+                delete closure;
+            }
         }
         // release this before request desctruct
         _brpc_request.release_finst_id();
@@ -155,14 +182,18 @@ public:
     // Returns error status if any of the preceding rpcs failed, OK otherwise.
     //Status add_row(TupleRow* row);
 
-    // Asynchronously sends a row batch.
-    // Returns the status of the most recently finished transmit_data
-    // rpc (or OK if there wasn't one that hasn't been reported yet).
-    // if batch is nullptr, send the eof packet
+    // Asynchronously sends a row batch. Up to config::exchange_max_in_flight_requests
+    // requests of a channel are in flight, this waits for the oldest one when the window
+    // is full and returns its status.
+    // if batch is nullptr, send the eof packet, after all the requests in flight finished.
     Status send_block(PBlock* block, bool eos = false);
 
     Status add_row(Block* block, int row);
 
+    // Copies the rows of block at the positions in [row_begin, row_end) into this
+    // channel's output buffer and flushes the buffer if it reaches capacity.
+    Status add_rows(Block* block, const int* row_begin, const int* row_end);
+
     Status send_current_block(bool eos = false);
 
     Status send_local_block(bool eos = false);
@@ -191,17 +222,25 @@ public:
     bool is_local() { return _is_local; }
 
 private:
-    inline Status _wait_last_brpc() {
-        if (_closure == nullptr) return Status::OK();
-        auto cntl = &_closure->cntl;
-        auto call_id = _closure->cntl.call_id();
-        brpc::Join(call_id);
-        if (cntl->Failed()) {
-            std::string err = fmt::format(
-                    "failed to send brpc batch, error={}, error_text={}, client: {}",
-                    berror(cntl->ErrorCode()), cntl->ErrorText(), BackendOptions::get_localhost());
-            LOG(WARNING) << err;
-            return Status::ThriftRpcError(err);
+    // Waits for the oldest requests until at most max_in_flight are left in flight.
+    inline Status _wait_in_flight_brpc(size_t max_in_flight) {
+        while (_in_flight_closures.size() > max_in_flight) {
+            auto closure = _in_flight_closures.front();
+            _in_flight_closures.pop_front();
+            closure->join();
+            auto cntl = &closure->cntl;
+            if (cntl->Failed()) {
+                std::string err = fmt::format(
+                        "failed to send brpc batch, error={}, error_text={}, client: {}",
+                        berror(cntl->ErrorCode()), cntl->ErrorText(),
+                        BackendOptions::get_localhost());
+                LOG(WARNING) << err;
+                if (closure->unref()) {
+                    delete closure;
+                }
+                return Status::ThriftRpcError(err);
+            }
+            _idle_closures.push_back(closure);
         }
         return Status::OK();
     }
@@ -235,7 +274,10 @@ private:
     PBlock _pb_block;
     PTransmitDataParams _brpc_request;
     PBackendService_Stub* _brpc_stub = nullptr;
-    RefCountClosure<PTransmitDataResult>* _closure = nullptr;
+    // Requests sent and not waited for yet, in the order of their packet_seq.
+    std::deque<RefCountClosure<PTransmitDataResult>*> _in_flight_closures;
+    // Finished closures, reused by the next requests.
+    std::vector<RefCountClosure<PTransmitDataResult>*> _idle_closures;
     int32_t _brpc_timeout_ms = 500;
     // whether the dest can be treated as query statistics transfer chain.
     bool _is_transfer_chain;
@@ -244,5 +286,39 @@ private:
     size_t _capacity;
     bool _is_local;
 };
+
+template <typename Channels>
+Status VDataStreamSender::channel_add_rows(Channels& channels, Block* block) {
+    int num_channels = channels.size();
+    int rows = _hash_vals.size();
+
+    // Counting sort of the rows by their channel, so that every channel appends its rows a
+    // column at a time.
+    _channel_row_offsets.assign(num_channels + 1, 0);
+    for (int i = 0; i < rows; ++i) {
+        _hash_vals[i] %= num_channels;
+        ++_channel_row_offsets[_hash_vals[i] + 1];
+    }
+    for (int i = 0; i < num_channels; ++i) {
+        _channel_row_offsets[i + 1] += _channel_row_offsets[i];
+    }
+    _channel_rows.resize(rows);
+    for (int i = 0; i < rows; ++i) {
+        _channel_rows[_channel_row_offsets[_hash_vals[i]]++] = i;
+    }
+
+    // Each offset has been moved to the end of the rows of its channel.
+    int begin = 0;
+    for (int i = 0; i < num_channels; ++i) {
+        int end = _channel_row_offsets[i];
+        if (end > begin) {
+            RETURN_IF_ERROR(channels[i]->add_rows(block, _channel_rows.data() + begin,
+                                                  _channel_rows.data() + end));
+        }
+        begin = end;
+    }
+    return Status::OK();
+}
+
 } // namespace vectorized
 } // namespace doris
@@ -0,0 +1,109 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "vec/sink/vmemory_scratch_sink.h"
+
+#include <arrow/memory_pool.h>
+#include <arrow/record_batch.h>
+#include <fmt/format.h>
+
+#include "runtime/exec_env.h"
+#include "runtime/result_queue_mgr.h"
+#include "runtime/runtime_state.h"
+#include "util/arrow/block_convertor.h"
+#include "util/arrow/row_batch.h"
+#include "vec/exprs/vexpr.h"
+
+namespace doris {
+namespace vectorized {
+
+VMemoryScratchSink::VMemoryScratchSink(const RowDescriptor& row_desc,
+                                       const std::vector<TExpr>& t_output_expr,
+                                       const TMemoryScratchSink& sink)
+        : _row_desc(row_desc), _t_output_expr(t_output_expr) {
+    _name = "VMemoryScratchSink";
+}
+
+VMemoryScratchSink::~VMemoryScratchSink() = default;
+
+Status VMemoryScratchSink::prepare_exprs(RuntimeState* state) {
+    // From the thrift expressions create the real exprs.
+    RETURN_IF_ERROR(
+            VExpr::create_expr_trees(state->obj_pool(), _t_output_expr, &_output_vexpr_ctxs));
+    // Prepare the exprs to run.
+    RETURN_IF_ERROR(VExpr::prepare(_output_vexpr_ctxs, state, _row_desc, _expr_mem_tracker));
+    // generate the arrow schema
+    RETURN_IF_ERROR(convert_to_arrow_schema(_row_desc, &_arrow_schema));
+    return Status::OK();
+}
+
+Status VMemoryScratchSink::prepare(RuntimeState* state) {
+    RETURN_IF_ERROR(DataSink::prepare(state));
+    // prepare output_expr
+    RETURN_IF_ERROR(prepare_exprs(state));
+    // create queue
+    TUniqueId fragment_instance_id = state->fragment_instance_id();
+    state->exec_env()->result_queue_mgr()->create_queue(fragment_instance_id, &_queue);
+    auto title = fmt::format("VMemoryScratchSink (frag_id={:x}-{:x})", fragment_instance_id.hi,
+                             fragment_instance_id.lo);
+    // create profile
+    _profile = state->obj_pool()->add(new RuntimeProfile(title));
+    _convert_timer = ADD_TIMER(_profile, "ConvertBlockTime");
+    _sent_rows_counter = ADD_COUNTER(_profile, "NumSentRows", TUnit::UNIT);
+
+    return Status::OK();
+}
+
+Status VMemoryScratchSink::send(RuntimeState* state, RowBatch* batch) {
+    return Status::NotSupported("Not Implemented VMemoryScratchSink::send scalar");
+}
+
+Status VMemoryScratchSink::send(RuntimeState* state, Block* block) {
+    if (nullptr == block || 0 == block->rows()) {
+        return Status::OK();
+    }
+    std::shared_ptr<arrow::RecordBatch> result;
+    {
+        SCOPED_TIMER(_convert_timer);
+        RETURN_IF_ERROR(convert_to_arrow_batch(*block, _arrow_schema,
+                                               arrow::default_memory_pool(), &result));
+    }
+    _queue->blocking_put(result);
+    COUNTER_UPDATE(_sent_rows_counter, block->rows());
+    return Status::OK();
+}
+
+Status VMemoryScratchSink::open(RuntimeState* state) {
+    return VExpr::open(_output_vexpr_ctxs, state);
+}
+
+Status VMemoryScratchSink::close(RuntimeState* state, Status exec_status) {
+    if (_closed) {
+        return Status::OK();
+    }
+    // put sentinel
+    if (_queue != nullptr) {
+        _queue->blocking_put(nullptr);
+    }
+    VExpr::close(_output_vexpr_ctxs, state);
+    _closed = true;
+    return Status::OK();
+}
+
+} // namespace vectorized
+} // namespace doris
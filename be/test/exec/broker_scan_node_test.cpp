@@ -23,6 +23,7 @@
 #include <string>
 #include <vector>
 
+#include "common/config.h"
 #include "common/object_pool.h"
 #include "exec/local_file_reader.h"
 #include "exprs/cast_functions.h"
@@ -485,6 +486,69 @@ TEST_F(BrokerScanNodeTest, normal) {
     }
 }
 
+TEST_F(BrokerScanNodeTest, split_morsels) {
+    int64_t morsel_bytes = config::broker_scan_morsel_bytes;
+    config::broker_scan_morsel_bytes = 5;
+
+    BrokerScanNode scan_node(&_obj_pool, _tnode, *_desc_tbl);
+    scan_node.init(_tnode);
+    auto status = scan_node.prepare(&_runtime_state);
+    ASSERT_TRUE(status.ok());
+
+    // set scan range
+    std::vector<TScanRangeParams> scan_ranges;
+    {
+        TScanRangeParams scan_range_params;
+
+        TBrokerScanRange broker_scan_range;
+        broker_scan_range.params = _params;
+
+        TBrokerRangeDesc range;
+        range.path = "./be/test/exec/test_data/broker_scanner/normal.csv";
+        range.start_offset = 0;
+        range.size = 24;
+        range.file_type = TFileType::FILE_LOCAL;
+        range.format_type = TFileFormatType::FORMAT_CSV_PLAIN;
+        range.splittable = true;
+        std::vector<std::string> columns_from_path{"1"};
+        range.__set_columns_from_path(columns_from_path);
+        range.__set_num_of_columns_from_file(3);
+        broker_scan_range.ranges.push_back(range);
+
+        scan_range_params.scan_range.__set_broker_scan_range(broker_scan_range);
+
+        scan_ranges.push_back(scan_range_params);
+    }
+
+    scan_node.set_scan_ranges(scan_ranges);
+
+    status = scan_node.open(&_runtime_state);
+    ASSERT_TRUE(status.ok());
+
+    auto tracker = std::make_shared<MemTracker>();
+    RowBatch batch(scan_node.row_desc(), _runtime_state.batch_size(), tracker.get());
+
+    // The file is split into 5 morsels, 3 of them have a valid line
+    int num_batches = 0;
+    int num_rows = 0;
+    bool eos = false;
+    while (!eos) {
+        batch.reset();
+        status = scan_node.get_next(&_runtime_state, &batch, &eos);
+        ASSERT_TRUE(status.ok());
+        if (!eos) {
+            ASSERT_EQ(1, batch.num_rows());
+            ++num_batches;
+        }
+        num_rows += batch.num_rows();
+    }
+    ASSERT_EQ(3, num_batches);
+    ASSERT_EQ(3, num_rows);
+
+    scan_node.close(&_runtime_state);
+    config::broker_scan_morsel_bytes = morsel_bytes;
+}
+
 } // namespace doris
 
 int main(int argc, char** argv) {
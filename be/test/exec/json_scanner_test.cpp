@@ -18,17 +18,22 @@
 #include <gtest/gtest.h>
 #include <time.h>
 
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
 #include <map>
 #include <string>
 #include <vector>
 
 #include "common/object_pool.h"
 #include "exec/broker_scan_node.h"
+#include "exec/json_scanner.h"
 #include "exec/local_file_reader.h"
 #include "exprs/cast_functions.h"
 #include "gen_cpp/Descriptors_types.h"
 #include "gen_cpp/PlanNodes_types.h"
 #include "exprs/decimalv2_operators.h"
+#include "exprs/json_functions.h"
 #include "runtime/descriptors.h"
 #include "runtime/exec_env.h"
 #include "runtime/row_batch.h"
@@ -626,6 +631,219 @@ TEST_F(JsonScannerTest, normal_simple_arrayjson) {
     }
 }
 
+TEST_F(JsonScannerTest, fuzzy_parse_bad_first_element) {
+    // the column positions come from the first element which is an object
+    BrokerScanNode scan_node(&_obj_pool, _tnode, *_desc_tbl);
+    scan_node.init(_tnode);
+    auto status = scan_node.prepare(&_runtime_state);
+    ASSERT_TRUE(status.ok());
+
+    std::vector<TScanRangeParams> scan_ranges;
+    {
+        TScanRangeParams scan_range_params;
+
+        TBrokerScanRange broker_scan_range;
+        broker_scan_range.params = _params;
+        TBrokerRangeDesc range;
+        range.start_offset = 0;
+        range.size = -1;
+        range.format_type = TFileFormatType::FORMAT_JSON;
+        range.strip_outer_array = true;
+        range.fuzzy_parse = true;
+        range.__isset.strip_outer_array = true;
+        range.__isset.fuzzy_parse = true;
+        range.splittable = true;
+        range.path = "./be/test/exec/test_data/json_scanner/test_fuzzy_bad_first.json";
+        range.file_type = TFileType::FILE_LOCAL;
+        broker_scan_range.ranges.push_back(range);
+        scan_range_params.scan_range.__set_broker_scan_range(broker_scan_range);
+        scan_ranges.push_back(scan_range_params);
+    }
+
+    scan_node.set_scan_ranges(scan_ranges);
+    status = scan_node.open(&_runtime_state);
+    ASSERT_TRUE(status.ok());
+
+    MemTracker tracker;
+    RowBatch batch(scan_node.row_desc(), _runtime_state.batch_size(), &tracker);
+    bool eof = false;
+    status = scan_node.get_next(&_runtime_state, &batch, &eof);
+    ASSERT_TRUE(status.ok());
+    // the malformed element and the string element are filtered
+    ASSERT_EQ(2, batch.num_rows());
+    auto tuple_str =
+            batch.get_row(1)->get_tuple(0)->to_string(*scan_node.row_desc().tuple_descriptors()[0]);
+    ASSERT_FALSE(tuple_str.find("SwordofHonour") == tuple_str.npos);
+    batch.reset();
+
+    status = scan_node.get_next(&_runtime_state, &batch, &eof);
+    ASSERT_TRUE(status.ok());
+    ASSERT_EQ(0, batch.num_rows());
+    ASSERT_TRUE(eof);
+    scan_node.close(&_runtime_state);
+}
+
+class JsonReaderTest : public testing::Test {
+public:
+    JsonReaderTest() : _runtime_state(TQueryGlobals()), _profile("JsonReaderTest") {}
+
+protected:
+    // Streams the outer array of the data written to a file. Returns the elements printed by
+    // rapidjson, and "error" for each filtered element.
+    std::vector<std::string> stream_array(const std::string& data,
+                                          size_t* buf_capacity = nullptr) {
+        const std::string path = "./json_reader_test_stream_array.json";
+        {
+            std::ofstream out(path, std::ios::binary);
+            out << data;
+        }
+        LocalFileReader file_reader(path, 0);
+        EXPECT_TRUE(file_reader.open().ok());
+        ScannerCounter counter;
+        JsonReader reader(&_runtime_state, &counter, &_profile, true, false, false,
+                          &file_reader);
+        EXPECT_TRUE(reader.init("", "", true).ok());
+        EXPECT_TRUE(reader._handle_json_callback == &JsonReader::_handle_streaming_array_json);
+
+        std::vector<std::string> elements;
+        bool eof = false;
+        while (true) {
+            Status st = reader._parse_next_array_element(&eof);
+            if (st.is_data_quality_error()) {
+                elements.push_back("error");
+                continue;
+            }
+            EXPECT_TRUE(st.ok());
+            if (!st.ok() || eof) {
+                break;
+            }
+            elements.push_back(reader._print_json_value(reader._origin_json_doc));
+        }
+        EXPECT_EQ(std::count(elements.begin(), elements.end(), "error"),
+                  counter.num_rows_filtered);
+        if (buf_capacity != nullptr) {
+            *buf_capacity = reader._stream_buf_capacity;
+        }
+        std::remove(path.c_str());
+        return elements;
+    }
+
+    // The value written to a column, see JsonReader::_write_values_by_jsonpath()
+    std::string print_column_value(JsonReader* reader, rapidjson::Value* value) {
+        if (value == nullptr) {
+            return "<not found>";
+        }
+        if (value->IsArray() && value->Size() == 1) {
+            value = &((*value)[0]);
+        }
+        return reader->_print_json_value(*value);
+    }
+
+    RuntimeState _runtime_state;
+    RuntimeProfile _profile;
+};
+
+TEST_F(JsonReaderTest, stream_elements_across_buffers) {
+    // about 4MB of small elements, read through the 1MB buffer
+    std::string data = "[";
+    std::vector<std::string> expected;
+    for (int i = 0; i < 100000; ++i) {
+        expected.push_back("{\"k\":" + std::to_string(i) + ",\"v\":\"abcdefghijklmnopqrst\"}");
+        data += (i == 0 ? "" : ",\n  ") + expected.back();
+    }
+    data += "]";
+    size_t buf_capacity = 0;
+    ASSERT_EQ(expected, stream_array(data, &buf_capacity));
+    ASSERT_EQ(1024 * 1024, buf_capacity);
+}
+
+TEST_F(JsonReaderTest, stream_element_larger_than_buffer) {
+    // the buffer grows to hold the element
+    std::string large = "{\"v\":\"" + std::string(3 * 1024 * 1024, 'x') + "\"}";
+    std::vector<std::string> expected = {"{\"k\":1}", large, "{\"k\":2}"};
+    size_t buf_capacity = 0;
+    ASSERT_EQ(expected, stream_array("[{\"k\":1}," + large + ",{\"k\":2}]", &buf_capacity));
+    ASSERT_EQ(4 * 1024 * 1024, buf_capacity);
+}
+
+TEST_F(JsonReaderTest, stream_strings_with_brackets) {
+    std::string data = R"([{"a":"x\"]},["}, "\\", "[\"", {"b":"}{,"}, [1, [2]]])";
+    std::vector<std::string> expected = {R"({"a":"x\"]},["})", R"("\\")", R"("[\"")",
+                                         R"({"b":"}{,"})", "[1,[2]]"};
+    ASSERT_EQ(expected, stream_array(data));
+}
+
+TEST_F(JsonReaderTest, stream_malformed_elements) {
+    // a malformed element only filters itself
+    std::string data = R"([{"a":1}, {"a":}, {"a":2}, 3 4, {"a":3}}, {"a":4}])";
+    std::vector<std::string> expected = {"{\"a\":1}", "error", "{\"a\":2}",
+                                         "error",     "error", "{\"a\":4}"};
+    ASSERT_EQ(expected, stream_array(data));
+
+    expected = {"1", "2", "error"};
+    ASSERT_EQ(expected, stream_array("[1, 2"));
+    expected = {"error"};
+    ASSERT_EQ(expected, stream_array("{\"a\":1}"));
+}
+
+TEST_F(JsonReaderTest, stream_empty_array) {
+    std::vector<std::string> expected = {"error"};
+    ASSERT_EQ(expected, stream_array("[]"));
+    ASSERT_EQ(expected, stream_array(" [ \n ] "));
+    ASSERT_TRUE(stream_array("").empty());
+}
+
+TEST_F(JsonReaderTest, stream_empty_elements) {
+    std::vector<std::string> expected = {"1", "error", "2"};
+    ASSERT_EQ(expected, stream_array("[1,,2]"));
+    expected = {"error", "1"};
+    ASSERT_EQ(expected, stream_array("[,1]"));
+    expected = {"1", "error"};
+    ASSERT_EQ(expected, stream_array("[1, ]"));
+}
+
+TEST_F(JsonReaderTest, jsonpath_trie) {
+    ScannerCounter counter;
+    JsonReader reader(&_runtime_state, &counter, &_profile, true, false, false);
+    std::vector<std::string> jsonpaths = {"$.a.b", "$.a.c", "$.d",     "$.a",
+                                          "$.e[0]", "$.a.b.x", "$.a.*"};
+    std::string jsonpaths_str;
+    for (const std::string& jsonpath : jsonpaths) {
+        jsonpaths_str += (jsonpaths_str.empty() ? "[\"" : ", \"") + jsonpath + "\"";
+    }
+    ASSERT_TRUE(reader.init(jsonpaths_str + "]", "").ok());
+    std::vector<bool> in_trie = {true, true, true, true, false, true, false};
+    ASSERT_EQ(in_trie, reader._in_jsonpath_trie);
+
+    // the values matched by the trie are the ones of JsonFunctions
+    std::vector<std::string> docs = {R"({"a":{"b":1,"c":"s"},"d":[1,2],"e":[5]})",
+                                     R"({"a":{"b":{"x":[7]},"c":null},"d":[3]})",
+                                     R"({"a":1,"d":{"x":1}})", R"({"b":1})"};
+    for (const std::string& doc : docs) {
+        ASSERT_TRUE(reader._parse_json_str((const uint8_t*)doc.data(), doc.size()).ok());
+        rapidjson::Value* value = &reader._origin_json_doc;
+        ASSERT_TRUE(reader._match_jsonpath_trie(reader._jsonpath_trie, value)) << doc;
+        for (size_t i = 0; i < jsonpaths.size(); ++i) {
+            if (!in_trie[i]) {
+                continue;
+            }
+            rapidjson::Value* expected = JsonFunctions::get_json_array_from_parsed_json(
+                    reader._parsed_jsonpaths[i], value, reader._origin_json_doc.GetAllocator());
+            ASSERT_EQ(print_column_value(&reader, expected),
+                      print_column_value(&reader, reader._jsonpath_values[i]))
+                    << doc << " " << jsonpaths[i];
+        }
+    }
+
+    // the keys after an array are looked up by JsonFunctions
+    docs = {R"({"a":[{"b":1},{"b":2}]})", "[1,2]"};
+    for (const std::string& doc : docs) {
+        ASSERT_TRUE(reader._parse_json_str((const uint8_t*)doc.data(), doc.size()).ok());
+        ASSERT_FALSE(reader._match_jsonpath_trie(reader._jsonpath_trie, &reader._origin_json_doc))
+                << doc;
+    }
+}
+
 } // namespace doris
 
 int main(int argc, char** argv) {
@@ -0,0 +1,74 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "exec/min_max_predicate.h"
+
+#include <gtest/gtest.h>
+
+namespace doris {
+
+class MinMaxPredicateTest : public testing::Test {
+public:
+    MinMaxPredicateTest() {}
+};
+
+TEST_F(MinMaxPredicateTest, int_value) {
+    MinMaxPredicate eq(0, TExprOpcode::EQ, true, 4, 10);
+    ASSERT_TRUE(eq.may_match(0, 10));
+    ASSERT_TRUE(eq.may_match(10, 20));
+    ASSERT_FALSE(eq.may_match(0, 9));
+    ASSERT_FALSE(eq.may_match(11, 20));
+
+    MinMaxPredicate lt(0, TExprOpcode::LT, true, 4, 10);
+    ASSERT_TRUE(lt.may_match(9, 20));
+    ASSERT_FALSE(lt.may_match(10, 20));
+
+    MinMaxPredicate le(0, TExprOpcode::LE, true, 4, 10);
+    ASSERT_TRUE(le.may_match(10, 20));
+    ASSERT_FALSE(le.may_match(11, 20));
+
+    MinMaxPredicate gt(0, TExprOpcode::GT, true, 4, 10);
+    ASSERT_TRUE(gt.may_match(-5, 11));
+    ASSERT_FALSE(gt.may_match(-5, 10));
+
+    MinMaxPredicate ge(0, TExprOpcode::GE, true, 4, 10);
+    ASSERT_TRUE(ge.may_match(-5, 10));
+    ASSERT_FALSE(ge.may_match(-5, 9));
+}
+
+TEST_F(MinMaxPredicateTest, string_value) {
+    MinMaxPredicate eq(1, TExprOpcode::EQ, false, "beijing");
+    ASSERT_EQ(1, eq.src_slot_idx());
+    ASSERT_FALSE(eq.is_nullable());
+    ASSERT_EQ(MinMaxPredicate::STRING_VALUE, eq.value_type());
+    ASSERT_TRUE(eq.may_match("a", "c"));
+    ASSERT_TRUE(eq.may_match("beijing", "beijing"));
+    ASSERT_FALSE(eq.may_match("c", "z"));
+    ASSERT_FALSE(eq.may_match("a", "beiji"));
+
+    // compared as unsigned bytes
+    MinMaxPredicate gt(1, TExprOpcode::GT, false, "z");
+    ASSERT_TRUE(gt.may_match("a", "\xe4\xb8\xad"));
+    ASSERT_FALSE(gt.may_match("a", "y"));
+}
+
+} // namespace doris
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -123,6 +123,63 @@ TEST_F(PlainTextLineReaderTest, uncompressed_no_newline) {
     ASSERT_TRUE(eof);
 }
 
+TEST_F(PlainTextLineReaderTest, uncompressed_field_pos) {
+    LocalFileReader file_reader("./be/test/exec/test_data/plain_text_line_reader/no_newline.csv",
+                                0);
+    auto st = file_reader.open();
+    ASSERT_TRUE(st.ok());
+
+    PlainTextLineReader line_reader(&_profile, &file_reader, nullptr, -1, "\n", 1);
+    line_reader.save_field_pos(',');
+    const uint8_t* ptr;
+    size_t size;
+    bool eof;
+
+    // 1,2,3
+    st = line_reader.read_line(&ptr, &size, &eof);
+    ASSERT_TRUE(st.ok());
+    ASSERT_EQ(5, size);
+    ASSERT_EQ(std::vector<size_t>({1, 3}), *line_reader.field_pos());
+
+    // 4,5
+    st = line_reader.read_line(&ptr, &size, &eof);
+    ASSERT_TRUE(st.ok());
+    ASSERT_EQ(3, size);
+    ASSERT_EQ(std::vector<size_t>({1}), *line_reader.field_pos());
+}
+
+TEST_F(PlainTextLineReaderTest, uncompressed_field_pos_long_line) {
+    LocalFileReader file_reader("./be/test/exec/test_data/plain_text_line_reader/larger.txt", 0);
+    auto st = file_reader.open();
+    ASSERT_TRUE(st.ok());
+
+    PlainTextLineReader line_reader(&_profile, &file_reader, nullptr, -1, "\n", 1);
+    line_reader.save_field_pos('1');
+    const uint8_t* ptr;
+    size_t size;
+    bool eof;
+
+    // 11111111111111111120, longer than one 16 bytes chunk
+    st = line_reader.read_line(&ptr, &size, &eof);
+    ASSERT_TRUE(st.ok());
+    ASSERT_EQ(20, size);
+    std::vector<size_t> expected;
+    for (size_t i = 0; i < 18; ++i) {
+        expected.push_back(i);
+    }
+    ASSERT_EQ(expected, *line_reader.field_pos());
+
+    // 111111111111111111111111111130
+    st = line_reader.read_line(&ptr, &size, &eof);
+    ASSERT_TRUE(st.ok());
+    ASSERT_EQ(30, size);
+    expected.clear();
+    for (size_t i = 0; i < 28; ++i) {
+        expected.push_back(i);
+    }
+    ASSERT_EQ(expected, *line_reader.field_pos());
+}
+
 TEST_F(PlainTextLineReaderTest, uncompressed_test_limit) {
     LocalFileReader file_reader("./be/test/exec/test_data/plain_text_line_reader/limit.csv", 0);
     auto st = file_reader.open();
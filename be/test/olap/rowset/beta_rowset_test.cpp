@@ -21,6 +21,7 @@
 #include "gtest/gtest.h"
 #include "olap/comparison_predicate.h"
 #include "olap/data_dir.h"
+#include "olap/olap_cond.h"
 #include "olap/row_block.h"
 #include "olap/row_cursor.h"
 #include "olap/rowset/beta_rowset_reader.h"
@@ -28,6 +29,7 @@
 #include "olap/rowset/rowset_reader_context.h"
 #include "olap/rowset/rowset_writer.h"
 #include "olap/rowset/rowset_writer_context.h"
+#include "olap/segment_loader.h"
 #include "olap/storage_engine.h"
 #include "olap/tablet_schema.h"
 #include "olap/utils.h"
@@ -350,10 +352,150 @@ TEST_F(BetaRowsetTest, BasicFunctionTest) {
     }
 }
 
+TEST_F(BetaRowsetTest, SegmentCacheTest) {
+    TabletSchema tablet_schema;
+    create_tablet_schema(&tablet_schema);
+
+    RowsetSharedPtr rowset;
+    {
+        RowsetWriterContext writer_context;
+        create_rowset_writer_context(&tablet_schema, &writer_context);
+        std::unique_ptr<RowsetWriter> rowset_writer;
+        ASSERT_EQ(OLAP_SUCCESS, RowsetFactory::create_rowset_writer(writer_context, &rowset_writer));
+
+        RowCursor input_row;
+        input_row.init(tablet_schema);
+        auto tracker = std::make_shared<MemTracker>();
+        MemPool mem_pool(tracker.get());
+        for (uint32_t k = 0; k < 100; ++k) {
+            input_row.set_field_content(0, reinterpret_cast<char*>(&k), &mem_pool);
+            input_row.set_field_content(1, reinterpret_cast<char*>(&k), &mem_pool);
+            input_row.set_field_content(2, reinterpret_cast<char*>(&k), &mem_pool);
+            ASSERT_EQ(OLAP_SUCCESS, rowset_writer->add_row(input_row));
+        }
+        ASSERT_EQ(OLAP_SUCCESS, rowset_writer->flush());
+        rowset = rowset_writer->build();
+        ASSERT_TRUE(rowset != nullptr);
+    }
+    auto beta_rowset = std::dynamic_pointer_cast<BetaRowset>(rowset);
+
+    SegmentLoader loader(1 << 20);
+    SegmentCacheHandle handle1;
+    ASSERT_EQ(OLAP_SUCCESS, loader.load_segments(beta_rowset, &handle1));
+    ASSERT_EQ(1, handle1.segments().size());
+
+    // hit the cache
+    SegmentCacheHandle handle2;
+    ASSERT_EQ(OLAP_SUCCESS, loader.load_segments(beta_rowset, &handle2));
+    ASSERT_EQ(handle1.segments()[0].get(), handle2.segments()[0].get());
+
+    // the pinned segment is kept after erased, and reopened by the next load
+    loader.erase_segments(rowset->rowset_id(), rowset->num_segments());
+    SegmentCacheHandle handle3;
+    ASSERT_EQ(OLAP_SUCCESS, loader.load_segments(beta_rowset, &handle3));
+    ASSERT_NE(handle1.segments()[0].get(), handle3.segments()[0].get());
+    ASSERT_EQ(100, handle1.segments()[0]->num_rows());
+}
+
+TEST_F(BetaRowsetTest, StatisticsPruningTest) {
+    TabletSchema tablet_schema;
+    create_tablet_schema(&tablet_schema);
+
+    // segment "i" has rows with all columns in [i * 100, i * 100 + 99]
+    RowsetSharedPtr rowset;
+    const int num_segments = 3;
+    {
+        RowsetWriterContext writer_context;
+        create_rowset_writer_context(&tablet_schema, &writer_context);
+        std::unique_ptr<RowsetWriter> rowset_writer;
+        ASSERT_EQ(OLAP_SUCCESS, RowsetFactory::create_rowset_writer(writer_context, &rowset_writer));
+
+        RowCursor input_row;
+        input_row.init(tablet_schema);
+        auto tracker = std::make_shared<MemTracker>();
+        MemPool mem_pool(tracker.get());
+        for (int i = 0; i < num_segments; ++i) {
+            for (uint32_t k = i * 100; k < i * 100 + 100; ++k) {
+                input_row.set_field_content(0, reinterpret_cast<char*>(&k), &mem_pool);
+                input_row.set_field_content(1, reinterpret_cast<char*>(&k), &mem_pool);
+                input_row.set_field_content(2, reinterpret_cast<char*>(&k), &mem_pool);
+                ASSERT_EQ(OLAP_SUCCESS, rowset_writer->add_row(input_row));
+            }
+            ASSERT_EQ(OLAP_SUCCESS, rowset_writer->flush());
+        }
+        rowset = rowset_writer->build();
+        ASSERT_TRUE(rowset != nullptr);
+    }
+
+    auto& segment_statistics = rowset->rowset_meta()->segment_statistics();
+    ASSERT_EQ(num_segments, segment_statistics.size());
+    ASSERT_EQ(3, segment_statistics.Get(1).columns_size());
+    ASSERT_EQ("100", segment_statistics.Get(1).columns(0).min());
+    ASSERT_EQ("199", segment_statistics.Get(1).columns(0).max());
+    auto& column_statistics = rowset->rowset_meta()->column_statistics();
+    ASSERT_EQ(3, column_statistics.size());
+    ASSERT_EQ(1, column_statistics.Get(0).unique_id());
+    ASSERT_EQ("0", column_statistics.Get(0).min());
+    ASSERT_EQ("299", column_statistics.Get(0).max());
+    ASSERT_FALSE(column_statistics.Get(0).has_null());
+    ASSERT_TRUE(column_statistics.Get(0).has_not_null());
+
+    auto read_with_condition = [&](const std::string& op, const std::string& value,
+                                   OlapReaderStatistics* stats, uint32_t* num_rows_read) {
+        Conditions conditions;
+        conditions.set_tablet_schema(&tablet_schema);
+        TCondition condition;
+        condition.column_name = "k1";
+        condition.condition_op = op;
+        condition.condition_values.push_back(value);
+        ASSERT_EQ(OLAP_SUCCESS, conditions.append_condition(condition));
+
+        RowsetReaderContext reader_context;
+        reader_context.tablet_schema = &tablet_schema;
+        reader_context.need_ordered_result = false;
+        std::vector<uint32_t> return_columns = {0, 1};
+        reader_context.return_columns = &return_columns;
+        reader_context.seek_columns = &return_columns;
+        reader_context.conditions = &conditions;
+        reader_context.stats = stats;
+        RowsetReaderSharedPtr rowset_reader;
+        create_and_init_rowset_reader(rowset.get(), reader_context, &rowset_reader);
+
+        RowBlock* output_block;
+        OLAPStatus s;
+        *num_rows_read = 0;
+        while ((s = rowset_reader->next_block(&output_block)) == OLAP_SUCCESS) {
+            *num_rows_read += output_block->row_num();
+        }
+        ASSERT_EQ(OLAP_ERR_DATA_EOF, s);
+    };
+
+    // the first two segments are skipped by their statistics
+    {
+        OlapReaderStatistics stats;
+        uint32_t num_rows_read = 0;
+        read_with_condition(">=", "250", &stats, &num_rows_read);
+        ASSERT_EQ(num_segments, stats.total_segment_number);
+        ASSERT_EQ(2, stats.filtered_segment_number);
+        ASSERT_EQ(100, num_rows_read);
+    }
+
+    // the whole rowset is skipped by its statistics
+    {
+        OlapReaderStatistics stats;
+        uint32_t num_rows_read = 0;
+        read_with_condition(">", "299", &stats, &num_rows_read);
+        ASSERT_EQ(num_segments, stats.total_segment_number);
+        ASSERT_EQ(num_segments, stats.filtered_segment_number);
+        ASSERT_EQ(0, num_rows_read);
+    }
+}
+
 } // namespace doris
 
 int main(int argc, char** argv) {
     doris::StoragePageCache::create_global_cache(1 << 30, 0.1);
+    doris::SegmentLoader::create_global_instance(1 << 30);
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
 }
@@ -32,6 +32,7 @@
 #include "olap/rowset/rowset_reader_context.h"
 #include "olap/rowset/rowset_writer.h"
 #include "olap/rowset/rowset_writer_context.h"
+#include "olap/segment_loader.h"
 #include "olap/storage_engine.h"
 #include "olap/tablet_meta.h"
 #include "runtime/exec_env.h"
@@ -298,6 +299,7 @@ TEST_F(RowsetConverterTest, TestConvertBetaRowsetToAlpha) {
 
 int main(int argc, char** argv) {
     doris::StoragePageCache::create_global_cache(1 << 30, 0.1);
+    doris::SegmentLoader::create_global_instance(1 << 30);
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
 }
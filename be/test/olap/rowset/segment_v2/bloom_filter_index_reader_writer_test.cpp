@@ -287,6 +287,66 @@ TEST_F(BloomFilterIndexReaderWriterTest, test_decimal) {
     delete[] val;
 }
 
+TEST_F(BloomFilterIndexReaderWriterTest, test_ngram) {
+    FileUtils::create_dir(dname);
+    std::string fname = dname + "/bloom_filter_ngram";
+    std::vector<std::string> page_values[2];
+    for (int i = 0; i < 1024; ++i) {
+        page_values[0].push_back("hello world " + std::to_string(i));
+        page_values[1].push_back("apache doris " + std::to_string(i));
+    }
+    ColumnIndexMetaPB meta;
+    {
+        std::unique_ptr<fs::WritableBlock> wblock;
+        fs::CreateBlockOptions opts({fname});
+        Status st = fs::fs_util::block_manager()->create_block(opts, &wblock);
+        ASSERT_TRUE(st.ok()) << st.to_string();
+
+        BloomFilterOptions bf_options;
+        std::unique_ptr<BloomFilterIndexWriter> writer;
+        st = BloomFilterIndexWriter::create_ngram(
+                bf_options, get_type_info(OLAP_FIELD_TYPE_VARCHAR), &writer);
+        ASSERT_TRUE(st.ok()) << st.to_string();
+        for (auto& values : page_values) {
+            std::vector<Slice> slices(values.begin(), values.end());
+            writer->add_values(slices.data(), slices.size());
+            ASSERT_TRUE(writer->flush().ok());
+        }
+        st = writer->finish(wblock.get(), &meta);
+        ASSERT_TRUE(st.ok()) << st.to_string();
+        ASSERT_TRUE(wblock->close().ok());
+        ASSERT_EQ(NGRAM_BLOOM_FILTER_INDEX, meta.type());
+        ASSERT_EQ(bf_options.gram_size, meta.ngram_bloom_filter_index().gram_size());
+    }
+    // ngram bloom filter index is only built for string columns
+    std::unique_ptr<BloomFilterIndexWriter> int_writer;
+    ASSERT_FALSE(BloomFilterIndexWriter::create_ngram(BloomFilterOptions(),
+                                                      get_type_info(OLAP_FIELD_TYPE_INT),
+                                                      &int_writer)
+                         .ok());
+
+    BloomFilterIndexReader reader(fname, &meta.ngram_bloom_filter_index());
+    ASSERT_TRUE(reader.load(true, false).ok());
+    std::unique_ptr<BloomFilterIndexIterator> iter;
+    ASSERT_TRUE(reader.new_iterator(&iter).ok());
+    auto contains = [&](const std::unique_ptr<BloomFilter>& bf, const std::string& substr) {
+        for (size_t pos = 0; pos + 3 <= substr.size(); ++pos) {
+            if (!bf->test_hash(bf->hash(substr.data() + pos, 3))) {
+                return false;
+            }
+        }
+        return true;
+    };
+    std::unique_ptr<BloomFilter> bf;
+    ASSERT_TRUE(iter->read_bloom_filter(0, &bf).ok());
+    ASSERT_TRUE(contains(bf, "lo wor"));
+    ASSERT_TRUE(contains(bf, "d 1023"));
+    ASSERT_FALSE(contains(bf, "apache"));
+    ASSERT_TRUE(iter->read_bloom_filter(1, &bf).ok());
+    ASSERT_TRUE(contains(bf, "he dor"));
+    ASSERT_FALSE(contains(bf, "hello"));
+}
+
 } // namespace segment_v2
 } // namespace doris
 
@@ -19,6 +19,7 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <filesystem>
 #include <functional>
 #include <iostream>
@@ -35,6 +36,7 @@
 #include "olap/row_cursor.h"
 #include "olap/rowset/segment_v2/segment_iterator.h"
 #include "olap/rowset/segment_v2/segment_writer.h"
+#include "olap/substring_filter.h"
 #include "olap/tablet_schema.h"
 #include "olap/tablet_schema_helper.h"
 #include "olap/types.h"
@@ -1156,6 +1158,95 @@ TEST_F(SegmentReaderWriterTest, TestBloomFilterIndexUniqueModel) {
     ASSERT_TRUE(column_contains_index(seg2->footer().columns(3), BLOOM_FILTER_INDEX));
 }
 
+TEST_F(SegmentReaderWriterTest, TestNgramBloomFilterIndex) {
+    TabletColumn value_column;
+    value_column._unique_id = 2;
+    value_column._col_name = "2";
+    value_column._type = OLAP_FIELD_TYPE_VARCHAR;
+    value_column._is_key = false;
+    value_column._aggregation = OLAP_FIELD_AGGREGATION_NONE;
+    value_column._is_nullable = true;
+    value_column._length = 64;
+    value_column._index_length = 4;
+    value_column._has_ngram_bf_index = true;
+    TabletSchema schema = create_schema({create_int_key(1), value_column});
+
+    // "hello world <rid>" in the first half of the rows, "apache doris <rid>" in the second half
+    const int num_rows = 100000;
+    std::string value;
+    auto generator = [&](size_t rid, int cid, int block_id, RowCursorCell& cell) {
+        cell.set_not_null();
+        if (cid == 0) {
+            *(int*)cell.mutable_cell_ptr() = rid;
+        } else {
+            value = ((int)rid < num_rows / 2 ? "hello world " : "apache doris ");
+            value += std::to_string(rid);
+            *(Slice*)cell.mutable_cell_ptr() = Slice(value);
+        }
+    };
+    SegmentWriterOptions opts;
+    shared_ptr<Segment> segment;
+    build_segment(opts, schema, schema, num_rows, generator, &segment);
+    ASSERT_TRUE(column_contains_index(segment->footer().columns(1), NGRAM_BLOOM_FILTER_INDEX));
+
+    // the keys of the rows read with the substring filter on the value column
+    auto read_keys = [](const shared_ptr<Segment>& segment, const TabletSchema& tablet_schema,
+                        const std::string& substring, OlapReaderStatistics* stats) {
+        std::vector<SubstringFilter> substring_filters = {{"2", {substring}}};
+        Schema schema(tablet_schema);
+        StorageReadOptions read_opts;
+        read_opts.stats = stats;
+        read_opts.substring_filters = &substring_filters;
+        std::unique_ptr<RowwiseIterator> iter;
+        EXPECT_TRUE(segment->new_iterator(schema, read_opts, nullptr, &iter).ok());
+
+        std::vector<int> keys;
+        RowBlockV2 block(schema, 1024);
+        while (true) {
+            block.clear();
+            Status st = iter->next_batch(&block);
+            if (!st.ok()) {
+                EXPECT_TRUE(st.is_end_of_file());
+                break;
+            }
+            auto column_block = block.column_block(0);
+            for (int i = 0; i < block.num_rows(); ++i) {
+                keys.push_back(*(int*)column_block.cell_ptr(i));
+            }
+        }
+        return keys;
+    };
+
+    for (const std::string& substring : {"apache doris", "dor"}) {
+        OlapReaderStatistics stats;
+        std::vector<int> keys = read_keys(segment, schema, substring, &stats);
+        // the pages of "hello world" are skipped, the ones of "apache doris" are all read
+        ASSERT_GT(stats.rows_ngram_bf_filtered, 0);
+        ASSERT_EQ(num_rows, keys.size() + stats.rows_ngram_bf_filtered);
+        auto is_doris_row = [&](int key) { return key >= num_rows / 2; };
+        ASSERT_EQ(num_rows / 2, std::count_if(keys.begin(), keys.end(), is_doris_row));
+    }
+
+    // a substring shorter than the grams is not used
+    {
+        OlapReaderStatistics stats;
+        ASSERT_EQ(num_rows, read_keys(segment, schema, "do", &stats).size());
+        ASSERT_EQ(0, stats.rows_ngram_bf_filtered);
+    }
+
+    // the value columns of a unique table are only final after merging the versions
+    TabletSchema unique_schema = schema;
+    unique_schema._keys_type = UNIQUE_KEYS;
+    shared_ptr<Segment> unique_segment;
+    build_segment(opts, unique_schema, unique_schema, num_rows, generator, &unique_segment);
+    {
+        OlapReaderStatistics stats;
+        std::vector<int> keys = read_keys(unique_segment, unique_schema, "apache doris", &stats);
+        ASSERT_EQ(num_rows, keys.size());
+        ASSERT_EQ(0, stats.rows_ngram_bf_filtered);
+    }
+}
+
 } // namespace segment_v2
 } // namespace doris
 
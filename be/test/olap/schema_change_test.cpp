@@ -28,6 +28,7 @@
 #include "olap/rowset/column_writer.h"
 #include "olap/stream_name.h"
 #include "runtime/mem_pool.h"
+#include "runtime/mem_tracker.h"
 #include "runtime/vectorized_row_batch.h"
 #include "util/logging.h"
 
@@ -946,6 +947,123 @@ TEST_F(TestColumn, ConvertCharToCount) {
     auto dst = mv_row_cursor.cell_ptr(1);
     ASSERT_EQ(*(int64_t*)dst, 1);
 }
+
+// (k1 INT, v1 INT) with the key k1
+static void create_key_value_schema(TabletSchema* tablet_schema) {
+    TabletSchemaPB tablet_schema_pb;
+    tablet_schema_pb.set_keys_type(KeysType::DUP_KEYS);
+    tablet_schema_pb.set_num_short_key_columns(1);
+    tablet_schema_pb.set_num_rows_per_row_block(1024);
+    tablet_schema_pb.set_compress_kind(COMPRESS_NONE);
+    tablet_schema_pb.set_next_column_unique_id(3);
+
+    ColumnPB* column = tablet_schema_pb.add_column();
+    column->set_unique_id(1);
+    column->set_name("k1");
+    column->set_type("INT");
+    column->set_is_key(true);
+    column->set_length(4);
+    column->set_index_length(4);
+    column->set_is_nullable(false);
+
+    column = tablet_schema_pb.add_column();
+    column->set_unique_id(2);
+    column->set_name("v1");
+    column->set_type("INT");
+    column->set_is_key(false);
+    column->set_length(4);
+    column->set_is_nullable(false);
+    column->set_aggregation("NONE");
+
+    tablet_schema->init_from_pb(tablet_schema_pb);
+}
+
+TEST(RowBlockSorterTest, sort) {
+    TabletSchema tablet_schema;
+    create_key_value_schema(&tablet_schema);
+    std::shared_ptr<MemTracker> tracker = MemTracker::CreateTracker(-1, "RowBlockSorterTest");
+    RowBlockAllocator allocator(tablet_schema, tracker, 0);
+
+    std::vector<int32_t> keys = {3, 1, 2, 1, 3, 0};
+    RowBlock* row_block = nullptr;
+    ASSERT_EQ(OLAP_SUCCESS, allocator.allocate(&row_block, keys.size(), true));
+    ASSERT_TRUE(row_block != nullptr);
+    RowCursor row;
+    ASSERT_EQ(OLAP_SUCCESS, row.init(tablet_schema));
+    for (size_t i = 0; i < keys.size(); ++i) {
+        int32_t value = i;
+        row.set_field_content(0, reinterpret_cast<const char*>(&keys[i]), nullptr);
+        row.set_field_content(1, reinterpret_cast<const char*>(&value), nullptr);
+        row_block->set_row(i, row);
+    }
+    row_block->finalize(keys.size());
+
+    {
+        RowBlockSorter sorter(&allocator);
+        ASSERT_TRUE(sorter.sort(&row_block));
+    }
+    // the rows with equal keys keep their order
+    std::vector<int32_t> expected_keys = {0, 1, 1, 2, 3, 3};
+    std::vector<int32_t> expected_values = {5, 1, 3, 2, 0, 4};
+    ASSERT_EQ(keys.size(), row_block->row_block_info().row_num);
+    for (size_t i = 0; i < keys.size(); ++i) {
+        row_block->get_row(i, &row);
+        ASSERT_EQ(expected_keys[i], *reinterpret_cast<int32_t*>(row.cell_ptr(0)));
+        ASSERT_EQ(expected_values[i], *reinterpret_cast<int32_t*>(row.cell_ptr(1)));
+    }
+    allocator.release(row_block);
+    ASSERT_EQ(0, tracker->consumption());
+}
+
+TEST(RowBlockAllocatorTest, parent_limit) {
+    TabletSchema tablet_schema;
+    create_key_value_schema(&tablet_schema);
+    const int64_t block_size = tablet_schema.row_size() * 1024;
+    std::shared_ptr<MemTracker> budget =
+            MemTracker::CreateTracker(2 * block_size, "RowBlockAllocatorTest");
+    RowBlockAllocator allocator1(tablet_schema, budget, 0);
+    RowBlockAllocator allocator2(tablet_schema, budget, 0);
+
+    RowBlock* block1 = nullptr;
+    RowBlock* block2 = nullptr;
+    RowBlock* block3 = nullptr;
+    ASSERT_EQ(OLAP_SUCCESS, allocator1.allocate(&block1, 1024, true, true));
+    ASSERT_EQ(OLAP_SUCCESS, allocator1.allocate(&block2, 1024, true, true));
+    ASSERT_TRUE(block1 != nullptr && block2 != nullptr);
+
+    // the budget is shared by the allocators
+    ASSERT_EQ(OLAP_SUCCESS, allocator2.allocate(&block3, 1024, true, true));
+    ASSERT_TRUE(block3 == nullptr);
+    ASSERT_EQ(2 * block_size, budget->consumption());
+
+    // unless the limit is not checked
+    ASSERT_EQ(OLAP_SUCCESS, allocator2.allocate(&block3, 1024, true));
+    ASSERT_TRUE(block3 != nullptr);
+    ASSERT_EQ(3 * block_size, budget->consumption());
+
+    allocator1.release(block1);
+    allocator1.release(block2);
+    allocator2.release(block3);
+    ASSERT_EQ(0, budget->consumption());
+}
+
+TEST(RowBlockAllocatorTest, memory_limitation) {
+    TabletSchema tablet_schema;
+    create_key_value_schema(&tablet_schema);
+    const int64_t block_size = tablet_schema.row_size() * 1024;
+    std::shared_ptr<MemTracker> tracker = MemTracker::CreateTracker(-1, "RowBlockAllocatorTest");
+    RowBlockAllocator allocator(tablet_schema, tracker, block_size);
+
+    RowBlock* block1 = nullptr;
+    RowBlock* block2 = nullptr;
+    ASSERT_EQ(OLAP_SUCCESS, allocator.allocate(&block1, 1024, true));
+    ASSERT_TRUE(block1 != nullptr);
+    // memory_limitation is checked for all the blocks
+    ASSERT_EQ(OLAP_SUCCESS, allocator.allocate(&block2, 1, true));
+    ASSERT_TRUE(block2 == nullptr);
+    allocator.release(block1);
+}
+
 } // namespace doris
 
 int main(int argc, char** argv) {
@@ -0,0 +1,240 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/substring_filter.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "common/object_pool.h"
+#include "exec/olap_scan_node.h"
+#include "exprs/expr.h"
+#include "exprs/expr_context.h"
+#include "runtime/descriptors.h"
+#include "runtime/types.h"
+
+namespace doris {
+
+static std::vector<std::string> parse_like_pattern(const std::string& pattern) {
+    std::vector<std::string> literals;
+    SubstringFilter::parse_like_pattern(pattern, &literals);
+    return literals;
+}
+
+TEST(SubstringFilterTest, parse_like_pattern) {
+    using Literals = std::vector<std::string>;
+    ASSERT_EQ(Literals({"abc"}), parse_like_pattern("abc"));
+    ASSERT_EQ(Literals({"abc"}), parse_like_pattern("%abc%"));
+    ASSERT_EQ(Literals({"ab", "cd", "e"}), parse_like_pattern("ab%cd_e"));
+    ASSERT_EQ(Literals({"ab", "cd"}), parse_like_pattern("%%ab__cd%_"));
+    ASSERT_TRUE(parse_like_pattern("%_%").empty());
+    ASSERT_TRUE(parse_like_pattern("").empty());
+
+    // '\' escapes the wildcards and itself
+    ASSERT_EQ(Literals({"a%b_c"}), parse_like_pattern("a\\%b\\_c%"));
+    ASSERT_EQ(Literals({"a\\", "b"}), parse_like_pattern("a\\\\%b"));
+    ASSERT_EQ(Literals({"ab"}), parse_like_pattern("ab\\"));
+}
+
+// The substrings collected by OlapScanNode::build_substring_filters() from the conjuncts on
+// the tuple (name VARCHAR, id INT).
+class OlapScanNodeSubstringFilterTest : public testing::Test {
+public:
+    void SetUp() override {
+        TDescriptorTable t_desc_table;
+        TTupleDescriptor t_tuple_desc;
+        t_tuple_desc.id = 0;
+        t_tuple_desc.byteSize = 32;
+        t_tuple_desc.numNullBytes = 0;
+        t_desc_table.tupleDescriptors.push_back(t_tuple_desc);
+        t_desc_table.slotDescriptors.push_back(
+                create_slot_desc(0, TypeDescriptor::create_varchar_type(64), "name", 8));
+        t_desc_table.slotDescriptors.push_back(
+                create_slot_desc(1, TypeDescriptor(TYPE_INT), "id", 24));
+        t_desc_table.__isset.slotDescriptors = true;
+        ASSERT_TRUE(DescriptorTbl::create(&_pool, t_desc_table, &_desc_tbl).ok());
+    }
+
+protected:
+    TSlotDescriptor create_slot_desc(int id, const TypeDescriptor& type, const std::string& name,
+                                     int byte_offset) {
+        TSlotDescriptor slot_desc;
+        slot_desc.__set_id(id);
+        slot_desc.__set_parent(0);
+        slot_desc.__set_slotType(type.to_thrift());
+        slot_desc.__set_columnPos(id);
+        slot_desc.__set_byteOffset(byte_offset);
+        slot_desc.__set_nullIndicatorByte(0);
+        slot_desc.__set_nullIndicatorBit(-1);
+        slot_desc.__set_colName(name);
+        slot_desc.__set_slotIdx(id);
+        slot_desc.__set_isMaterialized(true);
+        return slot_desc;
+    }
+
+    TExprNode slot_ref(int slot_id, const TypeDescriptor& type) {
+        TExprNode node;
+        node.node_type = TExprNodeType::SLOT_REF;
+        node.type = type.to_thrift();
+        node.num_children = 0;
+        node.__isset.slot_ref = true;
+        node.slot_ref.slot_id = slot_id;
+        node.slot_ref.tuple_id = 0;
+        return node;
+    }
+
+    TExprNode name_ref() { return slot_ref(0, TypeDescriptor::create_varchar_type(64)); }
+
+    TExprNode string_literal(const std::string& value) {
+        TExprNode node;
+        node.node_type = TExprNodeType::STRING_LITERAL;
+        node.type = TypeDescriptor::create_varchar_type(value.size()).to_thrift();
+        node.num_children = 0;
+        node.__isset.string_literal = true;
+        node.string_literal.value = value;
+        return node;
+    }
+
+    TExprNode int_literal(PrimitiveType type, int64_t value) {
+        TExprNode node;
+        node.node_type = TExprNodeType::INT_LITERAL;
+        node.type = TypeDescriptor(type).to_thrift();
+        node.num_children = 0;
+        node.__isset.int_literal = true;
+        node.int_literal.value = value;
+        return node;
+    }
+
+    TExprNode function_call(const std::string& name, PrimitiveType type) {
+        TExprNode node;
+        node.node_type = TExprNodeType::FUNCTION_CALL;
+        node.type = TypeDescriptor(type).to_thrift();
+        node.num_children = 2;
+        node.__isset.fn = true;
+        node.fn.name.function_name = name;
+        return node;
+    }
+
+    TExprNode binary_pred(TExprOpcode::type op) {
+        TExprNode node;
+        node.node_type = TExprNodeType::BINARY_PRED;
+        node.type = TypeDescriptor(TYPE_BOOLEAN).to_thrift();
+        node.num_children = 2;
+        node.__set_opcode(op);
+        node.__set_child_type(TPrimitiveType::INT);
+        return node;
+    }
+
+    // name LIKE pattern
+    TExpr like(const std::string& pattern) {
+        TExpr expr;
+        expr.nodes = {function_call("like", TYPE_BOOLEAN), name_ref(), string_literal(pattern)};
+        return expr;
+    }
+
+    // instr(name, substr) op bound
+    TExpr instr(const std::string& substr, TExprOpcode::type op, PrimitiveType bound_type,
+                int64_t bound) {
+        TExpr expr;
+        expr.nodes = {binary_pred(op), function_call("instr", TYPE_INT), name_ref(),
+                      string_literal(substr), int_literal(bound_type, bound)};
+        return expr;
+    }
+
+    // bound op locate(substr, name)
+    TExpr reversed_locate(const std::string& substr, TExprOpcode::type op, int64_t bound) {
+        TExpr expr;
+        expr.nodes = {binary_pred(op), int_literal(TYPE_TINYINT, bound),
+                      function_call("locate", TYPE_INT), string_literal(substr), name_ref()};
+        return expr;
+    }
+
+    std::vector<SubstringFilter> build_substring_filters(const std::vector<TExpr>& conjuncts) {
+        TPlanNode tnode;
+        tnode.node_id = 0;
+        tnode.node_type = TPlanNodeType::OLAP_SCAN_NODE;
+        tnode.num_children = 0;
+        tnode.limit = -1;
+        tnode.row_tuples.push_back(0);
+        tnode.nullable_tuples.push_back(false);
+        tnode.__isset.olap_scan_node = true;
+        tnode.olap_scan_node.tuple_id = 0;
+
+        OlapScanNode scan_node(&_pool, tnode, *_desc_tbl);
+        scan_node._tuple_desc = _desc_tbl->get_tuple_descriptor(0);
+        for (const TExpr& conjunct : conjuncts) {
+            ExprContext* ctx = nullptr;
+            EXPECT_TRUE(Expr::create_expr_tree(&_pool, conjunct, &ctx).ok());
+            scan_node._conjunct_ctxs.push_back(ctx);
+        }
+        scan_node.build_substring_filters();
+        return scan_node._substring_filters;
+    }
+
+    ObjectPool _pool;
+    DescriptorTbl* _desc_tbl = nullptr;
+};
+
+TEST_F(OlapScanNodeSubstringFilterTest, contains_predicates) {
+    std::vector<TExpr> conjuncts = {
+            like("%ap\\_ache%doris_x%"),
+            instr("abc", TExprOpcode::GT, TYPE_TINYINT, 0),
+            instr("def", TExprOpcode::GE, TYPE_BIGINT, 1),
+            reversed_locate("ghi", TExprOpcode::LT, 0),
+            reversed_locate("jkl", TExprOpcode::LE, 1),
+    };
+    std::vector<SubstringFilter> filters = build_substring_filters(conjuncts);
+    ASSERT_EQ(1, filters.size());
+    ASSERT_EQ("name", filters[0].column_name);
+    std::vector<std::string> expected = {"ap_ache", "doris", "x", "abc", "def", "ghi", "jkl"};
+    ASSERT_EQ(expected, filters[0].substrings);
+}
+
+TEST_F(OlapScanNodeSubstringFilterTest, other_predicates) {
+    // the predicates which also hold for the strings without the substring
+    std::vector<TExpr> conjuncts = {
+            instr("abc", TExprOpcode::GE, TYPE_TINYINT, 0),
+            instr("abc", TExprOpcode::GT, TYPE_TINYINT, 1),
+            instr("abc", TExprOpcode::LT, TYPE_TINYINT, 1),
+            instr("abc", TExprOpcode::EQ, TYPE_TINYINT, 1),
+            reversed_locate("abc", TExprOpcode::GT, 0),
+            reversed_locate("abc", TExprOpcode::LE, 0),
+            like("%"),
+    };
+    ASSERT_TRUE(build_substring_filters(conjuncts).empty());
+
+    // locate(name, 'abc') > 0 looks for the name in 'abc'
+    TExpr locate;
+    locate.nodes = {binary_pred(TExprOpcode::GT), function_call("locate", TYPE_INT), name_ref(),
+                    string_literal("abc"), int_literal(TYPE_TINYINT, 0)};
+    ASSERT_TRUE(build_substring_filters({locate}).empty());
+
+    // only the string columns have the ngram bloom filter index
+    TExpr int_like;
+    int_like.nodes = {function_call("like", TYPE_BOOLEAN), slot_ref(1, TypeDescriptor(TYPE_INT)),
+                      string_literal("%12%")};
+    ASSERT_TRUE(build_substring_filters({int_like}).empty());
+}
+
+} // namespace doris
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -275,6 +275,50 @@ TEST_F(PartitionCacheTest, fetch_data_overdue) {
     clear();
 }
 
+TEST_F(PartitionCacheTest, fetch_newest_partition_overdue) {
+    init_default();
+    init_batch_data(1, 1, 3, CacheType::PARTITION_CACHE);
+
+    set_sql_key(_fetch_request->mutable_sql_key(), 1, 1);
+    for (int i = 1; i <= 3; i++) {
+        PCacheParam* p = _fetch_request->add_params();
+        p->set_partition_key(i);
+        p->set_last_version(i);
+        p->set_last_version_time(i);
+    }
+    // partition 3 got a new version after it was cached
+    _fetch_request->mutable_params(2)->set_last_version(4);
+    _cache->fetch(_fetch_request, _fetch_result);
+
+    ASSERT_TRUE(_fetch_result->status() == PCacheStatus::CACHE_OK);
+    ASSERT_EQ(_fetch_result->values_size(), 2);
+    ASSERT_EQ(_fetch_result->values(0).param().partition_key(), 1);
+    ASSERT_EQ(_fetch_result->values(1).param().partition_key(), 2);
+    clear();
+}
+
+TEST_F(PartitionCacheTest, update_same_partition) {
+    init_default();
+    set_sql_key(_update_request->mutable_sql_key(), 1, 1);
+    _update_request->set_cache_type(CacheType::PARTITION_CACHE);
+    PCacheValue* value = _update_request->add_values();
+    value->mutable_param()->set_partition_key(1);
+    value->mutable_param()->set_last_version(1);
+    value->mutable_param()->set_last_version_time(1);
+    value->add_rows("0123456789abcdef");
+    value->set_data_size(16);
+    _cache->update(_update_request, _update_response);
+    ASSERT_TRUE(_update_response->status() == PCacheStatus::CACHE_OK);
+
+    // a newer version replaces the cached rows of the partition instead of adding to its size
+    value->mutable_param()->set_last_version(2);
+    value->mutable_param()->set_last_version_time(2);
+    _cache->update(_update_request, _update_response);
+    ASSERT_TRUE(_update_response->status() == PCacheStatus::CACHE_OK);
+    ASSERT_EQ(_cache->get_cache_size(), 16);
+    clear();
+}
+
 TEST_F(PartitionCacheTest, prune_data) {
     init(1, 1);
     init_batch_data(LOOP_LESS_OR_MORE(10, 129), 1, 1024, CacheType::PARTITION_CACHE); // 16*1024*128=2M
@@ -19,6 +19,9 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <vector>
+
 #include "common/object_pool.h"
 #include "gen_cpp/Descriptors_types.h"
 #include "gen_cpp/PaloInternalService_types.h"
@@ -43,6 +46,10 @@ OLAPStatus open_status;
 OLAPStatus add_status;
 OLAPStatus close_status;
 int64_t wait_lock_time_ns;
+// tablet id -> bytes of the memtable being written
+std::unordered_map<int64_t, int64_t> memtable_consumptions;
+std::vector<int64_t> flushed_tablets;
+std::vector<int64_t> waited_tablets;
 
 // mock
 DeltaWriter::DeltaWriter(WriteRequest* req, const std::shared_ptr<MemTracker>& mem_tracker,
@@ -86,10 +93,12 @@ OLAPStatus DeltaWriter::cancel() {
 }
 
 OLAPStatus DeltaWriter::flush_memtable_and_wait(bool need_wait) {
+    flushed_tablets.push_back(_req.tablet_id);
     return OLAP_SUCCESS;
 }
 
 OLAPStatus DeltaWriter::wait_flush() {
+    waited_tablets.push_back(_req.tablet_id);
     return OLAP_SUCCESS;
 }
 
@@ -100,6 +109,10 @@ int64_t DeltaWriter::mem_consumption() const {
     return 1024L;
 }
 
+int64_t DeltaWriter::memtable_consumption() {
+    return memtable_consumptions[_req.tablet_id];
+}
+
 class LoadChannelMgrTest : public testing::Test {
 public:
     LoadChannelMgrTest() {}
@@ -110,6 +123,9 @@ public:
         add_status = OLAP_SUCCESS;
         close_status = OLAP_SUCCESS;
         config::streaming_load_rpc_max_alive_time_sec = 120;
+        memtable_consumptions.clear();
+        flushed_tablets.clear();
+        waited_tablets.clear();
     }
 
 private:
@@ -706,6 +722,114 @@ TEST_F(LoadChannelMgrTest, duplicate_packet) {
     ASSERT_EQ(_k_tablet_recorder[21], 1);
 }
 
+// opens a load of the tablets 20, 21, 22 and 23
+static void open_load(LoadChannelMgr* mgr, DescriptorTbl* desc_tbl, PUniqueId* load_id) {
+    PTabletWriterOpenRequest request;
+    request.set_allocated_id(load_id);
+    request.set_index_id(4);
+    request.set_txn_id(1);
+    create_schema(desc_tbl, request.mutable_schema());
+    for (int i = 0; i < 4; ++i) {
+        auto tablet = request.add_tablets();
+        tablet->set_partition_id(10 + i);
+        tablet->set_tablet_id(20 + i);
+    }
+    request.set_num_senders(1);
+    request.set_need_gen_rollup(false);
+    auto st = mgr->open(request);
+    request.release_id();
+    ASSERT_TRUE(st.ok());
+}
+
+TEST_F(LoadChannelMgrTest, soft_mem_limit) {
+    ExecEnv env;
+    LoadChannelMgr mgr;
+    // load mem limit is 800 bytes, and the soft limit 400 bytes
+    config::load_process_soft_mem_limit_percent = 50;
+    mgr.init(1000);
+    ASSERT_EQ(800, mgr._mem_tracker->limit());
+
+    auto tdesc_tbl = create_descriptor_table();
+    ObjectPool obj_pool;
+    DescriptorTbl* desc_tbl = nullptr;
+    DescriptorTbl::create(&obj_pool, tdesc_tbl, &desc_tbl);
+    PUniqueId load_id;
+    load_id.set_hi(2);
+    load_id.set_lo(3);
+    open_load(&mgr, desc_tbl, &load_id);
+    memtable_consumptions = {{20, 100}, {21, 300}, {22, 200}, {23, 0}};
+
+    // below the soft limit
+    mgr._mem_tracker->Consume(400);
+    mgr._handle_mem_exceed_limit();
+    ASSERT_TRUE(flushed_tablets.empty());
+
+    // the largest memtables are flushed until the others fit under the soft limit
+    mgr._mem_tracker->Consume(200);
+    mgr._handle_mem_exceed_limit();
+    std::sort(flushed_tablets.begin(), flushed_tablets.end());
+    ASSERT_EQ(std::vector<int64_t>({21}), flushed_tablets);
+    ASSERT_TRUE(waited_tablets.empty());
+
+    // a memtable in flush queue is not flushed again
+    memtable_consumptions = {{20, 100}, {21, 0}, {22, 200}, {23, 0}};
+    flushed_tablets.clear();
+    mgr._handle_mem_exceed_limit();
+    ASSERT_TRUE(flushed_tablets.empty());
+    memtable_consumptions = {{20, 250}, {21, 0}, {22, 250}, {23, 200}};
+    mgr._handle_mem_exceed_limit();
+    std::sort(flushed_tablets.begin(), flushed_tablets.end());
+    ASSERT_EQ(std::vector<int64_t>({20, 22}), flushed_tablets);
+    ASSERT_TRUE(waited_tablets.empty());
+
+    mgr._mem_tracker->Release(600);
+    config::load_process_soft_mem_limit_percent = 80;
+}
+
+TEST_F(LoadChannelMgrTest, hard_mem_limit) {
+    ExecEnv env;
+    LoadChannelMgr mgr;
+    config::load_process_soft_mem_limit_percent = 50;
+    mgr.init(1000);
+
+    auto tdesc_tbl = create_descriptor_table();
+    ObjectPool obj_pool;
+    DescriptorTbl* desc_tbl = nullptr;
+    DescriptorTbl::create(&obj_pool, tdesc_tbl, &desc_tbl);
+    PUniqueId load_id;
+    load_id.set_hi(2);
+    load_id.set_lo(3);
+    open_load(&mgr, desc_tbl, &load_id);
+
+    // the requests wait for the memtables they flush
+    memtable_consumptions = {{20, 100}, {21, 300}, {22, 200}, {23, 0}};
+    mgr._mem_tracker->Consume(900);
+    mgr._handle_mem_exceed_limit();
+    std::sort(flushed_tablets.begin(), flushed_tablets.end());
+    ASSERT_EQ(std::vector<int64_t>({21}), flushed_tablets);
+    ASSERT_EQ(std::vector<int64_t>({21}), waited_tablets);
+
+    // at least one memtable is flushed
+    memtable_consumptions = {{20, 100}, {21, 0}, {22, 0}, {23, 0}};
+    flushed_tablets.clear();
+    waited_tablets.clear();
+    mgr._handle_mem_exceed_limit();
+    ASSERT_EQ(std::vector<int64_t>({20}), flushed_tablets);
+    ASSERT_EQ(std::vector<int64_t>({20}), waited_tablets);
+
+    // or the memtables in flush queue are waited for
+    memtable_consumptions = {{20, 0}, {21, 0}, {22, 0}, {23, 0}};
+    flushed_tablets.clear();
+    waited_tablets.clear();
+    mgr._handle_mem_exceed_limit();
+    ASSERT_TRUE(flushed_tablets.empty());
+    std::sort(waited_tablets.begin(), waited_tablets.end());
+    ASSERT_EQ(std::vector<int64_t>({20, 21, 22, 23}), waited_tablets);
+
+    mgr._mem_tracker->Release(900);
+    config::load_process_soft_mem_limit_percent = 80;
+}
+
 } // namespace doris
 
 int main(int argc, char* argv[]) {
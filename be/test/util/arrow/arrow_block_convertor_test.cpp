@@ -0,0 +1,99 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "util/arrow/block_convertor.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#define ARROW_UTIL_LOGGING_H
+#include <arrow/array.h>
+#include <arrow/memory_pool.h>
+#include <arrow/record_batch.h>
+#include <arrow/type.h>
+
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/column_string.h"
+#include "vec/columns/column_vector.h"
+#include "vec/core/block.h"
+#include "vec/data_types/data_type_nullable.h"
+#include "vec/data_types/data_type_number.h"
+#include "vec/data_types/data_type_string.h"
+
+namespace doris {
+
+TEST(ArrowBlockConvertorTest, ConvertToArrowBatch) {
+    auto int_column = vectorized::ColumnInt32::create();
+    auto null_map = vectorized::ColumnUInt8::create();
+    auto string_column = vectorized::ColumnString::create();
+    for (int i = 0; i < 100; ++i) {
+        int_column->insert_value(i);
+        null_map->insert_value(i % 3 == 0);
+        auto str = std::to_string(i);
+        string_column->insert_data(str.data(), str.size());
+    }
+    const int32_t* int_data = int_column->get_data().data();
+
+    vectorized::Block block(
+            {{vectorized::ColumnNullable::create(std::move(int_column), std::move(null_map)),
+              vectorized::make_nullable(std::make_shared<vectorized::DataTypeInt32>()), "k1"},
+             {std::move(string_column), std::make_shared<vectorized::DataTypeString>(), "k2"}});
+
+    auto schema = arrow::schema({arrow::field("k1", arrow::int32(), true),
+                                 arrow::field("k2", arrow::utf8(), false)});
+    std::shared_ptr<arrow::RecordBatch> record_batch;
+    auto st = convert_to_arrow_batch(block, schema, arrow::default_memory_pool(), &record_batch);
+    ASSERT_TRUE(st.ok());
+    // release the block, record batch should keep the shared columns alive
+    block.clear();
+
+    ASSERT_EQ(100, record_batch->num_rows());
+    auto int_array = std::static_pointer_cast<arrow::Int32Array>(record_batch->column(0));
+    auto string_array = std::static_pointer_cast<arrow::StringArray>(record_batch->column(1));
+    // fixed-width values are not copied
+    ASSERT_EQ(int_data, int_array->raw_values());
+    ASSERT_EQ(34, int_array->null_count());
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_EQ(i % 3 == 0, int_array->IsNull(i));
+        if (i % 3 != 0) {
+            ASSERT_EQ(i, int_array->Value(i));
+        }
+        ASSERT_EQ(std::to_string(i), string_array->GetString(i));
+    }
+}
+
+TEST(ArrowBlockConvertorTest, FieldsNotMatch) {
+    auto int_column = vectorized::ColumnInt32::create();
+    int_column->insert_value(1);
+    vectorized::Block block(
+            {{std::move(int_column), std::make_shared<vectorized::DataTypeInt32>(), "k1"}});
+
+    auto schema = arrow::schema({arrow::field("k1", arrow::int32(), false),
+                                 arrow::field("k2", arrow::int32(), false)});
+    std::shared_ptr<arrow::RecordBatch> record_batch;
+    auto st = convert_to_arrow_batch(block, schema, arrow::default_memory_pool(), &record_batch);
+    ASSERT_FALSE(st.ok());
+}
+
+} // namespace doris
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -15,18 +15,49 @@
 // specific language governing permissions and limitations
 // under the License.
 
+#include <cmath>
+#include <memory>
 #include <string>
+#include <tuple>
 
 #include "gtest/gtest.h"
 #include "vec/aggregate_functions/aggregate_function.h"
 #include "vec/aggregate_functions/aggregate_function_simple_factory.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/column_string.h"
 #include "vec/columns/column_vector.h"
+#include "vec/columns/columns_number.h"
+#include "vec/common/assert_cast.h"
+#include "vec/common/string_buffer.hpp"
 #include "vec/data_types/data_type.h"
+#include "vec/data_types/data_type_nullable.h"
 #include "vec/data_types/data_type_number.h"
+#include "vec/data_types/data_type_string.h"
 
 namespace doris::vectorized {
 // declare function
 void register_aggregate_function_sum(AggregateFunctionSimpleFactory& factory);
+void register_aggregate_function_stddev_variance(AggregateFunctionSimpleFactory& factory);
+void register_aggregate_function_group_concat(AggregateFunctionSimpleFactory& factory);
+void register_aggregate_function_approx_count_distinct(AggregateFunctionSimpleFactory& factory);
+void register_aggregate_function_percentile_approx(AggregateFunctionSimpleFactory& factory);
+void register_aggregate_function_topn(AggregateFunctionSimpleFactory& factory);
+
+// serialize the state of rhs and merge it into place, as the merge phase does
+static void serialize_and_merge(const AggregateFunctionPtr& agg_function, AggregateDataPtr place,
+                                AggregateDataPtr rhs) {
+    auto column = ColumnString::create();
+    VectorBufferWriter writer(*column);
+    agg_function->serialize(rhs, writer);
+    writer.commit();
+
+    std::unique_ptr<char[]> deserialized(new char[agg_function->size_of_data()]);
+    agg_function->create(deserialized.get());
+    VectorBufferReader reader(column->get_data_at(0));
+    agg_function->deserialize(deserialized.get(), reader, nullptr);
+    agg_function->merge(place, deserialized.get(), nullptr);
+    agg_function->destroy(deserialized.get());
+}
 
 TEST(AggTest, basic_test) {
     auto column_vector_int32 = ColumnVector<Int32>::create();
@@ -53,6 +84,266 @@ TEST(AggTest, basic_test) {
     ASSERT_EQ(ans, *(int32_t*)place);
     agg_function->destroy(place);
 }
+
+TEST(AggTest, variance_test) {
+    auto column = ColumnVector<Float64>::create();
+    for (int i = 1; i <= 8; i++) {
+        column->insert_value(i);
+    }
+    AggregateFunctionSimpleFactory factory;
+    register_aggregate_function_stddev_variance(factory);
+    DataTypes data_types = {std::make_shared<DataTypeFloat64>()};
+    auto var_pop = factory.get("var_pop", data_types, {});
+    auto stddev_samp = factory.get("stddev_samp", data_types, {});
+
+    for (const auto& agg_function : {var_pop, stddev_samp}) {
+        std::unique_ptr<char[]> place(new char[agg_function->size_of_data()]);
+        std::unique_ptr<char[]> rhs(new char[agg_function->size_of_data()]);
+        agg_function->create(place.get());
+        agg_function->create(rhs.get());
+        // add half of the values to each state, then merge them
+        const IColumn* columns[1] = {column.get()};
+        for (int i = 0; i < 8; i++) {
+            agg_function->add(i < 3 ? place.get() : rhs.get(), columns, i, nullptr);
+        }
+        serialize_and_merge(agg_function, place.get(), rhs.get());
+
+        auto result = ColumnVector<Float64>::create();
+        agg_function->insert_result_into(place.get(), *result);
+        if (agg_function == var_pop) {
+            ASSERT_DOUBLE_EQ(5.25, result->get_data()[0]);
+        } else {
+            ASSERT_DOUBLE_EQ(std::sqrt(6.0), result->get_data()[0]);
+        }
+        agg_function->destroy(place.get());
+        agg_function->destroy(rhs.get());
+    }
+}
+
+TEST(AggTest, variance_null_result_test) {
+    AggregateFunctionSimpleFactory factory;
+    register_aggregate_function_stddev_variance(factory);
+    DataTypePtr nullable_type = make_nullable(std::make_shared<DataTypeFloat64>());
+
+    // one value and one NULL
+    auto column = ColumnNullable::create(ColumnVector<Float64>::create(), ColumnUInt8::create());
+    column->insert(Field(1.0));
+    column->insert_default();
+    const IColumn* columns[1] = {column.get()};
+
+    for (const auto& name : {"stddev_samp", "variance_samp", "stddev"}) {
+        auto agg_function = factory.get(name, {nullable_type}, {}, true);
+        ASSERT_TRUE(agg_function->get_return_type()->is_nullable());
+        std::unique_ptr<char[]> place(new char[agg_function->size_of_data()]);
+        agg_function->create(place.get());
+        agg_function->add_batch_single_place(2, place.get(), columns, nullptr);
+
+        auto result = agg_function->get_return_type()->create_column();
+        agg_function->insert_result_into(place.get(), *result);
+        // the sample variance of a single value is NULL, like the row engine
+        if (std::string(name) == "stddev") {
+            ASSERT_FALSE(result->is_null_at(0));
+            ASSERT_DOUBLE_EQ(0, assert_cast<const ColumnNullable&>(*result)
+                                        .get_nested_column()
+                                        .get_float64(0));
+        } else {
+            ASSERT_TRUE(result->is_null_at(0));
+        }
+        agg_function->destroy(place.get());
+    }
+
+    // no value at all with a not nullable argument
+    auto agg_function = factory.get("stddev", {std::make_shared<DataTypeFloat64>()}, {}, true);
+    std::unique_ptr<char[]> place(new char[agg_function->size_of_data()]);
+    agg_function->create(place.get());
+    auto result = agg_function->get_return_type()->create_column();
+    agg_function->insert_result_into(place.get(), *result);
+    ASSERT_TRUE(result->is_null_at(0));
+    agg_function->destroy(place.get());
+}
+
+TEST(AggTest, group_concat_test) {
+    auto column = ColumnString::create();
+    for (std::string value : {"a", "b", "c"}) {
+        column->insert_data(value.data(), value.size());
+    }
+    AggregateFunctionSimpleFactory factory;
+    register_aggregate_function_group_concat(factory);
+    DataTypes data_types = {std::make_shared<DataTypeString>()};
+    auto agg_function = factory.get("group_concat", data_types, {});
+
+    std::unique_ptr<char[]> place(new char[agg_function->size_of_data()]);
+    std::unique_ptr<char[]> rhs(new char[agg_function->size_of_data()]);
+    agg_function->create(place.get());
+    agg_function->create(rhs.get());
+    const IColumn* columns[1] = {column.get()};
+    agg_function->add(place.get(), columns, 0, nullptr);
+    agg_function->add(rhs.get(), columns, 1, nullptr);
+    agg_function->add(rhs.get(), columns, 2, nullptr);
+    serialize_and_merge(agg_function, place.get(), rhs.get());
+
+    auto result = ColumnString::create();
+    agg_function->insert_result_into(place.get(), *result);
+    ASSERT_EQ("a, b, c", result->get_data_at(0).to_string());
+    agg_function->destroy(place.get());
+    agg_function->destroy(rhs.get());
+}
+
+TEST(AggTest, group_concat_empty_test) {
+    AggregateFunctionSimpleFactory factory;
+    register_aggregate_function_group_concat(factory);
+    auto agg_function =
+            factory.get("group_concat", {std::make_shared<DataTypeString>()}, {}, true);
+    ASSERT_TRUE(agg_function->get_return_type()->is_nullable());
+
+    std::unique_ptr<char[]> place(new char[agg_function->size_of_data()]);
+    agg_function->create(place.get());
+    auto result = agg_function->get_return_type()->create_column();
+    // the result of an empty group is NULL, like the row engine
+    agg_function->insert_result_into(place.get(), *result);
+    ASSERT_TRUE(result->is_null_at(0));
+    agg_function->destroy(place.get());
+}
+
+TEST(AggTest, ndv_test) {
+    AggregateFunctionSimpleFactory factory;
+    register_aggregate_function_approx_count_distinct(factory);
+    auto agg_function = factory.get("ndv", {std::make_shared<DataTypeInt32>()}, {});
+
+    // {distinct values of place, distinct values of rhs, distinct values of both}
+    for (auto [place_end, rhs_begin, rhs_end] :
+         {std::tuple {80, 40, 120}, std::tuple {6000, 4000, 10000}}) {
+        auto column = ColumnVector<Int32>::create();
+        for (int i = 0; i < rhs_end; i++) {
+            column->insert_value(i);
+        }
+        std::unique_ptr<char[]> place(new char[agg_function->size_of_data()]);
+        std::unique_ptr<char[]> rhs(new char[agg_function->size_of_data()]);
+        agg_function->create(place.get());
+        agg_function->create(rhs.get());
+        const IColumn* columns[1] = {column.get()};
+        for (int i = 0; i < place_end; i++) {
+            agg_function->add(place.get(), columns, i, nullptr);
+            // duplicates are counted once
+            agg_function->add(place.get(), columns, i, nullptr);
+        }
+        for (int i = rhs_begin; i < rhs_end; i++) {
+            agg_function->add(rhs.get(), columns, i, nullptr);
+        }
+        serialize_and_merge(agg_function, place.get(), rhs.get());
+
+        auto result = ColumnVector<Int64>::create();
+        agg_function->insert_result_into(place.get(), *result);
+        if (rhs_end <= 160) {
+            // few values are counted exactly
+            ASSERT_EQ(rhs_end, result->get_data()[0]);
+        } else {
+            ASSERT_NEAR(rhs_end, result->get_data()[0], rhs_end * 0.05);
+        }
+        agg_function->destroy(place.get());
+        agg_function->destroy(rhs.get());
+    }
+}
+
+TEST(AggTest, percentile_approx_test) {
+    auto values = ColumnVector<Float64>::create();
+    auto quantiles = ColumnVector<Float64>::create();
+    for (int i = 1; i <= 100; i++) {
+        values->insert_value(i);
+        quantiles->insert_value(0.9);
+    }
+    AggregateFunctionSimpleFactory factory;
+    register_aggregate_function_percentile_approx(factory);
+    DataTypes data_types = {std::make_shared<DataTypeFloat64>(),
+                            std::make_shared<DataTypeFloat64>()};
+    auto agg_function = factory.get("percentile_approx", data_types, {});
+
+    std::unique_ptr<char[]> place(new char[agg_function->size_of_data()]);
+    std::unique_ptr<char[]> rhs(new char[agg_function->size_of_data()]);
+    std::unique_ptr<char[]> empty(new char[agg_function->size_of_data()]);
+    agg_function->create(place.get());
+    agg_function->create(rhs.get());
+    agg_function->create(empty.get());
+    const IColumn* columns[2] = {values.get(), quantiles.get()};
+    for (int i = 0; i < 100; i++) {
+        agg_function->add(i % 2 == 0 ? place.get() : rhs.get(), columns, i, nullptr);
+    }
+    serialize_and_merge(agg_function, place.get(), rhs.get());
+    // a state without any row changes nothing
+    serialize_and_merge(agg_function, place.get(), empty.get());
+
+    auto result = ColumnVector<Float64>::create();
+    agg_function->insert_result_into(place.get(), *result);
+    ASSERT_NEAR(90.5, result->get_data()[0], 1);
+
+    // the quantile of an empty state is taken from the merged state
+    serialize_and_merge(agg_function, empty.get(), place.get());
+    agg_function->insert_result_into(empty.get(), *result);
+    ASSERT_NEAR(90.5, result->get_data()[1], 1);
+
+    agg_function->destroy(place.get());
+    agg_function->destroy(rhs.get());
+    agg_function->destroy(empty.get());
+}
+
+TEST(AggTest, percentile_approx_empty_test) {
+    AggregateFunctionSimpleFactory factory;
+    register_aggregate_function_percentile_approx(factory);
+    DataTypes data_types = {std::make_shared<DataTypeFloat64>(),
+                            std::make_shared<DataTypeFloat64>()};
+    auto agg_function = factory.get("percentile_approx", data_types, {}, true);
+    ASSERT_TRUE(agg_function->get_return_type()->is_nullable());
+
+    std::unique_ptr<char[]> place(new char[agg_function->size_of_data()]);
+    agg_function->create(place.get());
+    auto result = agg_function->get_return_type()->create_column();
+    // the result of an empty group is NULL, like the row engine
+    agg_function->insert_result_into(place.get(), *result);
+    ASSERT_TRUE(result->is_null_at(0));
+    agg_function->destroy(place.get());
+}
+
+TEST(AggTest, topn_test) {
+    auto values = ColumnString::create();
+    auto top_nums = ColumnVector<Int32>::create();
+    for (std::string value : {"a", "b", "a", "c", "a", "b", "d", "a", "b", "a"}) {
+        values->insert_data(value.data(), value.size());
+        top_nums->insert_value(2);
+    }
+    AggregateFunctionSimpleFactory factory;
+    register_aggregate_function_topn(factory);
+    DataTypes data_types = {std::make_shared<DataTypeString>(),
+                            std::make_shared<DataTypeInt32>()};
+    auto agg_function = factory.get("topn", data_types, {});
+
+    std::unique_ptr<char[]> place(new char[agg_function->size_of_data()]);
+    std::unique_ptr<char[]> rhs(new char[agg_function->size_of_data()]);
+    std::unique_ptr<char[]> other(new char[agg_function->size_of_data()]);
+    agg_function->create(place.get());
+    agg_function->create(rhs.get());
+    agg_function->create(other.get());
+    const IColumn* columns[2] = {values.get(), top_nums.get()};
+    for (int i = 0; i < 10; i++) {
+        agg_function->add(i < 4 ? place.get() : rhs.get(), columns, i, nullptr);
+    }
+    serialize_and_merge(agg_function, place.get(), rhs.get());
+
+    auto result = ColumnString::create();
+    agg_function->insert_result_into(place.get(), *result);
+    ASSERT_EQ("{\"a\":5,\"b\":3}", result->get_data_at(0).to_string());
+
+    // a state merged in memory is left unchanged
+    agg_function->merge(other.get(), rhs.get(), nullptr);
+    agg_function->insert_result_into(other.get(), *result);
+    agg_function->insert_result_into(rhs.get(), *result);
+    ASSERT_EQ("{\"a\":3,\"b\":2}", result->get_data_at(1).to_string());
+    ASSERT_EQ("{\"a\":3,\"b\":2}", result->get_data_at(2).to_string());
+
+    agg_function->destroy(place.get());
+    agg_function->destroy(rhs.get());
+    agg_function->destroy(other.get());
+}
+
 } // namespace doris::vectorized
 
 int main(int argc, char** argv) {
@@ -301,6 +301,61 @@ TEST(BlockTest, dump_data) {
             {test_int, test_string, test_decimal, test_nullable_int32, test_date, test_datetime});
     EXPECT_GT(block.dump_data().size(), 1);
 }
+
+TEST(BlockTest, add_rows) {
+    auto vec = vectorized::ColumnVector<Int32>::create();
+    auto strcol = vectorized::ColumnString::create();
+    auto nullable = vectorized::make_nullable(vectorized::ColumnVector<Int32>::create());
+    auto mutable_nullable = std::move(*nullable).mutate();
+    for (int i = 0; i < 1024; ++i) {
+        vec->insert_value(i);
+        std::string is = std::to_string(i);
+        strcol->insert_data(is.c_str(), is.size());
+        if (i % 3 == 0) {
+            mutable_nullable->insert_default();
+        } else {
+            mutable_nullable->insert(vectorized::cast_to_nearest_field_type(i));
+        }
+    }
+
+    // The same values hash the same in a nullable and in a not nullable column.
+    std::vector<uint32_t> hashes(1024, 0);
+    std::vector<uint32_t> nullable_hashes(1024, 0);
+    vec->update_hashes_with_value(hashes.data());
+    mutable_nullable->update_hashes_with_value(nullable_hashes.data());
+    for (int i = 0; i < 1024; ++i) {
+        if (i % 3 == 0) {
+            EXPECT_EQ(0, nullable_hashes[i]);
+        } else {
+            EXPECT_EQ(hashes[i], nullable_hashes[i]);
+        }
+    }
+
+    vectorized::DataTypePtr int32_type(std::make_shared<vectorized::DataTypeInt32>());
+    vectorized::DataTypePtr string_type(std::make_shared<vectorized::DataTypeString>());
+    auto nint32_type = vectorized::make_nullable(std::make_shared<vectorized::DataTypeInt32>());
+    vectorized::Block block({{vec->get_ptr(), int32_type, "test_int"},
+                             {strcol->get_ptr(), string_type, "test_string"},
+                             {mutable_nullable->get_ptr(), nint32_type, "test_nullable_int32"}});
+
+    std::vector<int> rows;
+    for (int i = 1023; i >= 0; i -= 2) {
+        rows.push_back(i);
+    }
+    auto empty_block = block.clone_empty();
+    vectorized::MutableBlock mutable_block(empty_block.mutate_columns(),
+                                           empty_block.get_data_types());
+    mutable_block.add_rows(&block, rows.data(), rows.data() + rows.size());
+    mutable_block.add_rows(&block, rows.data(), rows.data());
+    auto result = mutable_block.to_block();
+    ASSERT_EQ(rows.size(), result.rows());
+    for (int i = 0; i < rows.size(); ++i) {
+        for (int j = 0; j < 3; ++j) {
+            EXPECT_EQ(block.get_by_position(j).column->get_data_at(rows[i]),
+                      result.get_by_position(j).column->get_data_at(i));
+        }
+    }
+}
 } // namespace doris
 
 int main(int argc, char** argv) {
@@ -0,0 +1,132 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/common/thread_mem_tracker.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <thread>
+
+#include "runtime/mem_tracker.h"
+#include "vec/common/allocator.h"
+#include "vec/common/exception.h"
+
+namespace doris::vectorized {
+
+TEST(ThreadMemTrackerTest, free_in_other_thread) {
+    auto tracker = MemTracker::CreateTracker(-1, "ThreadMemTrackerTest");
+    Allocator<false> allocator;
+    const size_t size = 4 * ThreadMemTracker::BATCH_BYTES;
+
+    // allocated by a scanner thread, freed by the fragment thread
+    void* buf = nullptr;
+    std::thread scanner([&]() {
+        ScopedThreadMemTracker scoped_tracker(tracker, false);
+        buf = allocator.alloc(size);
+    });
+    scanner.join();
+    ASSERT_EQ(size, tracker->consumption());
+
+    {
+        ScopedThreadMemTracker scoped_tracker(tracker);
+        allocator.free(buf, size);
+    }
+    ASSERT_EQ(0, tracker->consumption());
+}
+
+TEST(ThreadMemTrackerTest, small_allocations_are_batched) {
+    auto tracker = MemTracker::CreateTracker(-1, "ThreadMemTrackerTest");
+    Allocator<false> allocator;
+    {
+        ScopedThreadMemTracker scoped_tracker(tracker);
+        void* buf = allocator.alloc(1024);
+        ASSERT_EQ(0, tracker->consumption());
+        allocator.free(buf, 1024);
+        buf = allocator.alloc(2048);
+        ASSERT_EQ(0, tracker->consumption());
+        allocator.free(buf, 2048);
+    }
+    // flushed when the tracker is detached
+    ASSERT_EQ(0, tracker->consumption());
+}
+
+TEST(ThreadMemTrackerTest, limit) {
+    auto tracker =
+            MemTracker::CreateTracker(ThreadMemTracker::BATCH_BYTES, "ThreadMemTrackerTest");
+    Allocator<false> allocator;
+    const size_t size = 2 * ThreadMemTracker::BATCH_BYTES;
+
+    {
+        ScopedThreadMemTracker scoped_tracker(tracker);
+        ASSERT_THROW((void)allocator.alloc(size), Exception);
+        ASSERT_EQ(0, tracker->consumption());
+    }
+
+    // threads which can not fail the query only account the memory
+    void* buf = nullptr;
+    std::thread rpc([&]() {
+        ScopedThreadMemTracker scoped_tracker(tracker, false);
+        buf = allocator.alloc(size);
+        allocator.free(buf, size);
+    });
+    rpc.join();
+    ASSERT_EQ(0, tracker->consumption());
+}
+
+TEST(ThreadMemTrackerTest, chunk_cache_size) {
+    const size_t size = CHUNK_CACHE_MIN_SIZE + 1;
+    ASSERT_TRUE(in_chunk_cache(size));
+
+    // the power of two chunk is charged, not the requested size
+    auto tracker = MemTracker::CreateTracker(-1, "ThreadMemTrackerTest");
+    Allocator<false> allocator;
+    void* buf = nullptr;
+    {
+        ScopedThreadMemTracker scoped_tracker(tracker);
+        buf = allocator.alloc(size);
+        buf = allocator.realloc(buf, size, size + 1024);
+    }
+    ASSERT_EQ(2 * CHUNK_CACHE_MIN_SIZE, tracker->consumption());
+    {
+        ScopedThreadMemTracker scoped_tracker(tracker);
+        allocator.free(buf, size + 1024);
+    }
+    ASSERT_EQ(0, tracker->consumption());
+}
+
+TEST(ThreadMemTrackerTest, chunk_cache_bounds) {
+    // smaller buffers are left to malloc, larger ones to malloc or mmap
+    ASSERT_TRUE(in_chunk_cache(CHUNK_CACHE_MIN_SIZE));
+    ASSERT_FALSE(in_chunk_cache(CHUNK_CACHE_MIN_SIZE - 1));
+    ASSERT_FALSE(in_chunk_cache(CHUNK_CACHE_MAX_SIZE));
+
+    // a large zeroed buffer is not served from the cache
+    Allocator<true> allocator;
+    const size_t size = 4 * CHUNK_CACHE_MAX_SIZE;
+    auto* buf = reinterpret_cast<char*>(allocator.alloc(size));
+    ASSERT_EQ(size, allocated_size(size));
+    ASSERT_TRUE(std::all_of(buf, buf + size, [](char c) { return c == 0; }));
+    allocator.free(buf, size);
+}
+
+} // namespace doris::vectorized
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,351 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/exec/vaggregation_node.h"
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "common/object_pool.h"
+#include "gen_cpp/Descriptors_types.h"
+#include "gen_cpp/PlanNodes_types.h"
+#include "runtime/descriptors.h"
+#include "runtime/exec_env.h"
+#include "runtime/runtime_state.h"
+#include "runtime/thread_resource_mgr.h"
+#include "vec/columns/column_string.h"
+#include "vec/columns/columns_number.h"
+#include "vec/common/assert_cast.h"
+#include "vec/common/string_buffer.hpp"
+#include "vec/core/block.h"
+#include "vec/data_types/data_type_number.h"
+
+namespace doris {
+
+namespace vectorized {
+
+// Returns the given blocks one by one, then eos with an empty block.
+class MockBlockNode : public ExecNode {
+public:
+    MockBlockNode(ObjectPool* pool, const TPlanNode& tnode, const DescriptorTbl& descs,
+                  std::vector<Block> blocks)
+            : ExecNode(pool, tnode, descs), _blocks(std::move(blocks)) {}
+
+    Status get_next(RuntimeState* state, RowBatch* row_batch, bool* eos) override {
+        return Status::NotSupported("Not Implemented MockBlockNode::get_next scalar");
+    }
+
+    Status get_next(RuntimeState* state, Block* block, bool* eos) override {
+        *eos = _next == _blocks.size();
+        if (!*eos) {
+            block->swap(_blocks[_next++]);
+        }
+        return Status::OK();
+    }
+
+private:
+    std::vector<Block> _blocks;
+    size_t _next = 0;
+};
+
+class TestAggregationNode : public AggregationNode {
+public:
+    TestAggregationNode(ObjectPool* pool, const TPlanNode& tnode, const DescriptorTbl& descs)
+            : AggregationNode(pool, tnode, descs) {}
+
+    void add_child(ExecNode* child) { _children.push_back(child); }
+};
+
+// (k, v) of the input
+using InputRow = std::pair<int32_t, int32_t>;
+
+static constexpr int INPUT_TUPLE = 0;
+static constexpr int INTERMEDIATE_TUPLE = 1;
+static constexpr int OUTPUT_TUPLE = 2;
+static constexpr int INPUT_KEY_SLOT = 0;
+static constexpr int INPUT_VALUE_SLOT = 1;
+
+// Rows of a block, the hash table of the aggregation starts with room for 128 groups
+static constexpr int BLOCK_ROWS = 100;
+
+class VAggregationNodeTest : public testing::Test {
+public:
+    void SetUp() override {
+        _env = ExecEnv::GetInstance();
+        _env->_thread_mgr = new ThreadResourceMgr();
+
+        // input tuple: k INT, v INT
+        // intermediate and output tuples: k INT, sum(v) BIGINT
+        _desc_tbl = create_desc_tbl(
+                {{TYPE_INT, TYPE_INT}, {TYPE_INT, TYPE_BIGINT}, {TYPE_INT, TYPE_BIGINT}});
+    }
+
+    void TearDown() override { SAFE_DELETE(_env->_thread_mgr); }
+
+protected:
+    // Every slot is not nullable, tuples[t][i] is the type of the i-th slot of tuple t.
+    // Slot ids increase across tuples.
+    DescriptorTbl* create_desc_tbl(const std::vector<std::vector<PrimitiveType>>& tuples) {
+        TDescriptorTable thrift_desc_tbl;
+        int slot_id = 0;
+        for (int tuple_id = 0; tuple_id < tuples.size(); ++tuple_id) {
+            const auto& types = tuples[tuple_id];
+            int byte_offset = 0;
+            for (int i = 0; i < types.size(); ++i) {
+                TypeDescriptor type(types[i]);
+                TSlotDescriptor slot_desc;
+                slot_desc.__set_id(slot_id++);
+                slot_desc.__set_parent(tuple_id);
+                slot_desc.__set_slotType(type.to_thrift());
+                slot_desc.__set_byteOffset(byte_offset);
+                slot_desc.__set_nullIndicatorByte(0);
+                slot_desc.__set_nullIndicatorBit(-1);
+                slot_desc.__set_slotIdx(i);
+                slot_desc.__set_isMaterialized(true);
+                thrift_desc_tbl.slotDescriptors.push_back(slot_desc);
+                byte_offset += type.get_slot_size();
+            }
+            TTupleDescriptor tuple_desc;
+            tuple_desc.__set_id(tuple_id);
+            tuple_desc.__set_byteSize(byte_offset);
+            tuple_desc.__set_numNullBytes(0);
+            thrift_desc_tbl.tupleDescriptors.push_back(tuple_desc);
+        }
+        thrift_desc_tbl.__isset.slotDescriptors = true;
+
+        DescriptorTbl* desc_tbl = nullptr;
+        EXPECT_TRUE(DescriptorTbl::create(&_pool, thrift_desc_tbl, &desc_tbl).ok());
+        return desc_tbl;
+    }
+
+    static TExprNode create_slot_ref_node(int slot_id, int tuple_id) {
+        TExprNode slot_ref;
+        slot_ref.node_type = TExprNodeType::SLOT_REF;
+        slot_ref.type = TypeDescriptor(TYPE_INT).to_thrift();
+        slot_ref.num_children = 0;
+        slot_ref.__set_is_nullable(false);
+        slot_ref.__isset.slot_ref = true;
+        slot_ref.slot_ref.slot_id = slot_id;
+        slot_ref.slot_ref.tuple_id = tuple_id;
+        return slot_ref;
+    }
+
+    // sum(v) of the input tuple
+    static TExpr create_sum_expr() {
+        TFunctionName fn_name;
+        fn_name.function_name = "sum";
+        TFunction fn;
+        fn.name = fn_name;
+        fn.binary_type = TFunctionBinaryType::BUILTIN;
+        fn.arg_types.push_back(TypeDescriptor(TYPE_INT).to_thrift());
+        fn.ret_type = TypeDescriptor(TYPE_BIGINT).to_thrift();
+        fn.has_var_args = false;
+        fn.__isset.aggregate_fn = true;
+        fn.aggregate_fn.intermediate_type = TypeDescriptor(TYPE_BIGINT).to_thrift();
+
+        TExprNode agg_expr;
+        agg_expr.node_type = TExprNodeType::AGG_EXPR;
+        agg_expr.type = TypeDescriptor(TYPE_BIGINT).to_thrift();
+        agg_expr.num_children = 1;
+        agg_expr.__set_is_nullable(false);
+        agg_expr.__set_fn(fn);
+        agg_expr.__isset.agg_expr = true;
+        agg_expr.agg_expr.is_merge_agg = false;
+
+        TExpr expr;
+        expr.nodes.push_back(agg_expr);
+        expr.nodes.push_back(create_slot_ref_node(INPUT_VALUE_SLOT, INPUT_TUPLE));
+        return expr;
+    }
+
+    // The streaming preaggregation of sum(v) group by k
+    static TPlanNode create_agg_tnode() {
+        TExpr grouping_expr;
+        grouping_expr.nodes.push_back(create_slot_ref_node(INPUT_KEY_SLOT, INPUT_TUPLE));
+
+        TPlanNode tnode;
+        tnode.node_id = 0;
+        tnode.node_type = TPlanNodeType::AGGREGATION_NODE;
+        tnode.num_children = 1;
+        tnode.limit = -1;
+        tnode.row_tuples.push_back(OUTPUT_TUPLE);
+        tnode.nullable_tuples.push_back(false);
+        tnode.__isset.agg_node = true;
+        tnode.agg_node.__set_grouping_exprs({grouping_expr});
+        tnode.agg_node.aggregate_functions.push_back(create_sum_expr());
+        tnode.agg_node.intermediate_tuple_id = INTERMEDIATE_TUPLE;
+        tnode.agg_node.output_tuple_id = OUTPUT_TUPLE;
+        tnode.agg_node.need_finalize = false;
+        tnode.agg_node.__set_use_streaming_preaggregation(true);
+        return tnode;
+    }
+
+    static TPlanNode create_child_tnode() {
+        TPlanNode tnode;
+        tnode.node_id = 1;
+        tnode.node_type = TPlanNodeType::OLAP_SCAN_NODE;
+        tnode.num_children = 0;
+        tnode.limit = -1;
+        tnode.row_tuples.push_back(INPUT_TUPLE);
+        tnode.nullable_tuples.push_back(false);
+        return tnode;
+    }
+
+    static Block create_block(const std::vector<InputRow>& rows) {
+        auto k = ColumnInt32::create();
+        auto v = ColumnInt32::create();
+        for (const auto& row : rows) {
+            k->insert_value(row.first);
+            v->insert_value(row.second);
+        }
+        return Block({{std::move(k), std::make_shared<DataTypeInt32>(), "k"},
+                      {std::move(v), std::make_shared<DataTypeInt32>(), "v"}});
+    }
+
+    // Adds the sums of the serialized states of an output block to sums
+    static void add_output_block(AggregationNode* node, const Block& block,
+                                 std::map<int32_t, int64_t>* sums) {
+        ASSERT_EQ(2, block.columns());
+        const auto& keys = assert_cast<const ColumnInt32&>(*block.get_by_position(0).column);
+        const auto& states = assert_cast<const ColumnString&>(*block.get_by_position(1).column);
+        auto function = node->_aggregate_evaluators[0]->function();
+        std::unique_ptr<char[]> place(new char[function->size_of_data()]);
+        for (size_t i = 0; i < block.rows(); ++i) {
+            function->create(place.get());
+            VectorBufferReader reader(states.get_data_at(i));
+            function->deserialize(place.get(), reader, nullptr);
+            auto result = function->get_return_type()->create_column();
+            function->insert_result_into(place.get(), *result);
+            function->destroy(place.get());
+            (*sums)[keys.get_element(i)] += result->get_int(0);
+        }
+    }
+
+    ObjectPool _pool;
+    ExecEnv* _env = nullptr;
+    DescriptorTbl* _desc_tbl = nullptr;
+};
+
+TEST_F(VAggregationNodeTest, streaming_preagg_mode_switch) {
+    static constexpr int HIGH_CARDINALITY_BLOCKS = 20;
+    static constexpr int LOW_CARDINALITY_BLOCKS = 20;
+    static constexpr int LOW_CARDINALITY_KEYS = 5;
+
+    // every key of the high cardinality blocks is new, the low cardinality blocks repeat
+    // a few keys
+    std::vector<Block> blocks;
+    std::map<int32_t, int64_t> expected;
+    int32_t next_key = 0;
+    for (int block_idx = 0; block_idx < HIGH_CARDINALITY_BLOCKS + LOW_CARDINALITY_BLOCKS;
+         ++block_idx) {
+        std::vector<InputRow> rows;
+        for (int i = 0; i < BLOCK_ROWS; ++i) {
+            int32_t k = block_idx < HIGH_CARDINALITY_BLOCKS ? next_key++
+                                                            : i % LOW_CARDINALITY_KEYS;
+            rows.emplace_back(k, block_idx * BLOCK_ROWS + i);
+            expected[k] += rows.back().second;
+        }
+        blocks.push_back(create_block(rows));
+    }
+
+    RuntimeState state(TUniqueId(), TQueryOptions(), TQueryGlobals(), _env);
+    state.init_instance_mem_tracker();
+    state.set_desc_tbl(_desc_tbl);
+
+    TPlanNode tnode = create_agg_tnode();
+    auto node = _pool.add(new TestAggregationNode(&_pool, tnode, *_desc_tbl));
+    TPlanNode child_tnode = create_child_tnode();
+    auto child = _pool.add(new MockBlockNode(&_pool, child_tnode, *_desc_tbl, std::move(blocks)));
+    ASSERT_TRUE(child->init(child_tnode, &state).ok());
+    node->add_child(child);
+
+    ASSERT_TRUE(node->init(tnode, &state).ok());
+    ASSERT_TRUE(node->prepare(&state).ok());
+    // the table stops growing as soon as it is full, whatever the cache sizes of this
+    // machine, as long as the input does not reduce by 1.1
+    node->_streaming_ht_min_mem[1] = 0;
+    ASSERT_TRUE(node->open(&state).ok());
+
+    // one child block per call until the child is exhausted
+    std::map<int32_t, int64_t> sums;
+    int64_t output_rows = 0;
+    auto next_block = [&]() {
+        Block block;
+        bool eos = false;
+        EXPECT_TRUE(node->get_next(&state, &block, &eos).ok());
+        add_output_block(node, block, &sums);
+        output_rows += block.rows();
+        return eos;
+    };
+
+    // the first block fills the table, the second one does not fit and is passed through
+    // as the first one did not reduce
+    ASSERT_FALSE(next_block());
+    ASSERT_EQ(AggregationNode::HASH, node->_preagg_mode);
+    ASSERT_EQ(0, output_rows);
+    ASSERT_FALSE(next_block());
+    ASSERT_EQ(AggregationNode::PASS_THROUGH, node->_preagg_mode);
+    ASSERT_EQ(BLOCK_ROWS, output_rows);
+
+    // the sampled 16th block flushes the first one and does not reduce either, it stays
+    // in the table
+    for (int i = 2; i < HIGH_CARDINALITY_BLOCKS; ++i) {
+        ASSERT_FALSE(next_block());
+        ASSERT_EQ(AggregationNode::PASS_THROUGH, node->_preagg_mode);
+    }
+    ASSERT_EQ((HIGH_CARDINALITY_BLOCKS - 1) * BLOCK_ROWS, output_rows);
+
+    // low cardinality blocks are passed through until the sampled 32nd block, which
+    // flushes the 16th one and switches back to hashing
+    for (int i = HIGH_CARDINALITY_BLOCKS; i < 31; ++i) {
+        ASSERT_FALSE(next_block());
+        ASSERT_EQ(AggregationNode::PASS_THROUGH, node->_preagg_mode);
+    }
+    ASSERT_FALSE(next_block());
+    ASSERT_EQ(AggregationNode::BOUNDED_HASH, node->_preagg_mode);
+    int64_t passed_through = (HIGH_CARDINALITY_BLOCKS - 2 + 31 - HIGH_CARDINALITY_BLOCKS) *
+                            BLOCK_ROWS;
+    ASSERT_EQ(passed_through, node->_preagg_passthrough_rows->value());
+    ASSERT_EQ(passed_through + 2 * BLOCK_ROWS, output_rows);
+
+    // the rest is aggregated into the bounded table and returned at the end
+    for (int i = 32; i < HIGH_CARDINALITY_BLOCKS + LOW_CARDINALITY_BLOCKS; ++i) {
+        ASSERT_FALSE(next_block());
+        ASSERT_EQ(AggregationNode::BOUNDED_HASH, node->_preagg_mode);
+    }
+    ASSERT_EQ(passed_through + 2 * BLOCK_ROWS, output_rows);
+    while (!next_block()) {
+    }
+    ASSERT_EQ(passed_through + 2 * BLOCK_ROWS + LOW_CARDINALITY_KEYS, output_rows);
+    ASSERT_EQ(passed_through, node->_preagg_passthrough_rows->value());
+    ASSERT_EQ(2, node->_preagg_flush_counter->value());
+
+    // every input row is in exactly one output row
+    ASSERT_EQ(expected, sums);
+    ASSERT_TRUE(node->close(&state).ok());
+}
+
+} // namespace vectorized
+} // namespace doris
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,316 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/exec/vcross_join_node.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "common/object_pool.h"
+#include "runtime/descriptors.h"
+#include "runtime/exec_env.h"
+#include "runtime/runtime_state.h"
+#include "runtime/thread_resource_mgr.h"
+#include "testutil/desc_tbl_builder.h"
+#include "vec/columns/columns_number.h"
+#include "vec/core/block.h"
+#include "vec/data_types/data_type_number.h"
+
+namespace doris {
+
+namespace vectorized {
+
+// Returns the given blocks one by one.
+class MockBlockNode : public ExecNode {
+public:
+    MockBlockNode(ObjectPool* pool, const TPlanNode& tnode, const DescriptorTbl& descs,
+                  std::vector<Block> blocks)
+            : ExecNode(pool, tnode, descs), _blocks(std::move(blocks)) {}
+
+    Status get_next(RuntimeState* state, RowBatch* row_batch, bool* eos) override {
+        return Status::NotSupported("Not Implemented MockBlockNode::get_next scalar");
+    }
+
+    Status get_next(RuntimeState* state, Block* block, bool* eos) override {
+        if (_next < _blocks.size()) {
+            block->swap(_blocks[_next++]);
+        }
+        *eos = _next == _blocks.size();
+        return Status::OK();
+    }
+
+private:
+    std::vector<Block> _blocks;
+    size_t _next = 0;
+};
+
+class TestCrossJoinNode : public VCrossJoinNode {
+public:
+    TestCrossJoinNode(ObjectPool* pool, const TPlanNode& tnode, const DescriptorTbl& descs)
+            : VCrossJoinNode(pool, tnode, descs) {}
+
+    void add_child(ExecNode* child) { _children.push_back(child); }
+};
+
+class VCrossJoinNodeTest : public testing::Test {
+public:
+    void SetUp() override {
+        _env = ExecEnv::GetInstance();
+        _env->_thread_mgr = new ThreadResourceMgr();
+
+        // tuple 0 is the left child (k1), tuple 1 the right child (k2)
+        DescriptorTblBuilder builder(&_pool);
+        builder.declare_tuple() << TYPE_INT;
+        builder.declare_tuple() << TYPE_INT;
+        _desc_tbl = builder.build();
+    }
+
+    void TearDown() override { SAFE_DELETE(_env->_thread_mgr); }
+
+protected:
+    TTypeDesc create_type(TPrimitiveType::type type) {
+        TTypeDesc type_desc;
+        TTypeNode type_node;
+        type_node.type = TTypeNodeType::SCALAR;
+        TScalarType scalar_type;
+        scalar_type.__set_type(type);
+        type_node.__set_scalar_type(scalar_type);
+        type_desc.types.push_back(type_node);
+        return type_desc;
+    }
+
+    TExprNode create_slot_ref(int slot_id, int tuple_id) {
+        TExprNode slot_ref;
+        slot_ref.node_type = TExprNodeType::SLOT_REF;
+        slot_ref.type = create_type(TPrimitiveType::INT);
+        slot_ref.num_children = 0;
+        slot_ref.__set_is_nullable(false);
+        slot_ref.__isset.slot_ref = true;
+        slot_ref.slot_ref.slot_id = slot_id;
+        slot_ref.slot_ref.tuple_id = tuple_id;
+        return slot_ref;
+    }
+
+    // k1 < k2
+    TExpr create_join_conjunct() {
+        TExprNode less;
+        less.node_type = TExprNodeType::BINARY_PRED;
+        less.type = create_type(TPrimitiveType::BOOLEAN);
+        less.num_children = 2;
+        less.__set_is_nullable(false);
+        less.__isset.fn = true;
+        less.fn.name.function_name = "lt";
+
+        TExpr conjunct;
+        conjunct.nodes.push_back(less);
+        conjunct.nodes.push_back(create_slot_ref(0, 0));
+        conjunct.nodes.push_back(create_slot_ref(1, 1));
+        return conjunct;
+    }
+
+    TPlanNode create_child_tnode(int node_id, int tuple_id) {
+        TPlanNode tnode;
+        tnode.node_id = node_id;
+        tnode.node_type = TPlanNodeType::OLAP_SCAN_NODE;
+        tnode.num_children = 0;
+        tnode.limit = -1;
+        tnode.row_tuples.push_back(tuple_id);
+        tnode.nullable_tuples.push_back(false);
+        return tnode;
+    }
+
+    // join_op is not set for a plain cross join, like the planner does
+    TPlanNode create_join_tnode(const TJoinOp::type* join_op, bool with_conjunct) {
+        TPlanNode tnode;
+        tnode.node_id = 2;
+        tnode.node_type = TPlanNodeType::CROSS_JOIN_NODE;
+        tnode.num_children = 2;
+        tnode.limit = -1;
+        tnode.row_tuples.push_back(0);
+        tnode.nullable_tuples.push_back(false);
+        // semi and anti joins only output the left tuple
+        if (join_op == nullptr ||
+            (*join_op != TJoinOp::LEFT_SEMI_JOIN && *join_op != TJoinOp::LEFT_ANTI_JOIN)) {
+            tnode.row_tuples.push_back(1);
+            tnode.nullable_tuples.push_back(join_op != nullptr &&
+                                            *join_op == TJoinOp::LEFT_OUTER_JOIN);
+        }
+        if (join_op != nullptr) {
+            tnode.__isset.cross_join_node = true;
+            tnode.cross_join_node.__set_join_op(*join_op);
+            if (with_conjunct) {
+                tnode.cross_join_node.__set_vjoin_conjunct(create_join_conjunct());
+            }
+        }
+        return tnode;
+    }
+
+    Block create_block(const std::vector<int32_t>& values, const std::string& name) {
+        auto column = ColumnInt32::create();
+        for (int32_t value : values) {
+            column->insert_value(value);
+        }
+        return Block({{std::move(column), std::make_shared<DataTypeInt32>(), name}});
+    }
+
+    std::vector<Block> create_blocks(const std::vector<std::vector<int32_t>>& values,
+                                     const std::string& name) {
+        std::vector<Block> blocks;
+        for (const auto& block_values : values) {
+            blocks.push_back(create_block(block_values, name));
+        }
+        return blocks;
+    }
+
+    // Runs the join and returns its output rows as sorted "k1,k2" strings, or "k1" for the
+    // semi and anti joins.
+    std::vector<std::string> run_join(const TJoinOp::type* join_op, bool with_conjunct,
+                                      std::vector<Block> left_blocks,
+                                      std::vector<Block> right_blocks, int batch_size = 1024) {
+        TQueryOptions query_options;
+        query_options.batch_size = batch_size;
+        RuntimeState state(TUniqueId(), query_options, TQueryGlobals(), _env);
+        state.init_instance_mem_tracker();
+        state.set_desc_tbl(_desc_tbl);
+
+        TPlanNode left_tnode = create_child_tnode(0, 0);
+        auto left = _pool.add(
+                new MockBlockNode(&_pool, left_tnode, *_desc_tbl, std::move(left_blocks)));
+        TPlanNode right_tnode = create_child_tnode(1, 1);
+        auto right = _pool.add(
+                new MockBlockNode(&_pool, right_tnode, *_desc_tbl, std::move(right_blocks)));
+        TPlanNode tnode = create_join_tnode(join_op, with_conjunct);
+        auto node = _pool.add(new TestCrossJoinNode(&_pool, tnode, *_desc_tbl));
+        node->add_child(left);
+        node->add_child(right);
+        EXPECT_TRUE(left->init(left_tnode, &state).ok());
+        EXPECT_TRUE(right->init(right_tnode, &state).ok());
+        EXPECT_TRUE(node->init(tnode, &state).ok());
+        EXPECT_TRUE(node->prepare(&state).ok());
+        EXPECT_TRUE(node->open(&state).ok());
+
+        std::vector<std::string> result;
+        bool eos = false;
+        while (!eos) {
+            Block block;
+            EXPECT_TRUE(node->get_next(&state, &block, &eos).ok());
+            EXPECT_LE(block.rows(), batch_size);
+            for (size_t i = 0; i < block.rows(); ++i) {
+                std::string row;
+                for (size_t j = 0; j < block.columns(); ++j) {
+                    const auto& column = block.get_by_position(j);
+                    row += (j == 0 ? "" : ",") + column.type->to_string(*column.column, i);
+                }
+                result.push_back(row);
+            }
+        }
+        EXPECT_TRUE(node->close(&state).ok());
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    ObjectPool _pool;
+    ExecEnv* _env = nullptr;
+    DescriptorTbl* _desc_tbl = nullptr;
+};
+
+TEST_F(VCrossJoinNodeTest, cross_join) {
+    std::vector<std::string> expected = {"1,3", "1,6", "5,3", "5,6", "9,3", "9,6"};
+    ASSERT_EQ(expected, run_join(nullptr, false, create_blocks({{1, 5}, {9}}, "k1"),
+                                 create_blocks({{3}, {6}}, "k2")));
+}
+
+TEST_F(VCrossJoinNodeTest, inner_join) {
+    TJoinOp::type join_op = TJoinOp::INNER_JOIN;
+    std::vector<std::string> expected = {"1,3", "1,6", "5,6"};
+    ASSERT_EQ(expected, run_join(&join_op, true, create_blocks({{1, 5}, {9}}, "k1"),
+                                 create_blocks({{3}, {6}}, "k2")));
+}
+
+TEST_F(VCrossJoinNodeTest, left_outer_join) {
+    TJoinOp::type join_op = TJoinOp::LEFT_OUTER_JOIN;
+    std::vector<std::string> expected = {"1,3", "1,6", "5,6", "9,\\N"};
+    ASSERT_EQ(expected, run_join(&join_op, true, create_blocks({{1, 5}, {9}}, "k1"),
+                                 create_blocks({{3}, {6}}, "k2")));
+}
+
+TEST_F(VCrossJoinNodeTest, left_semi_join) {
+    TJoinOp::type join_op = TJoinOp::LEFT_SEMI_JOIN;
+    std::vector<std::string> expected = {"1", "5"};
+    ASSERT_EQ(expected, run_join(&join_op, true, create_blocks({{1, 5}, {9}}, "k1"),
+                                 create_blocks({{3}, {6}}, "k2")));
+}
+
+TEST_F(VCrossJoinNodeTest, left_anti_join) {
+    TJoinOp::type join_op = TJoinOp::LEFT_ANTI_JOIN;
+    std::vector<std::string> expected = {"9"};
+    ASSERT_EQ(expected, run_join(&join_op, true, create_blocks({{1, 5}, {9}}, "k1"),
+                                 create_blocks({{3}, {6}}, "k2")));
+}
+
+TEST_F(VCrossJoinNodeTest, empty_build_side) {
+    std::vector<std::vector<int32_t>> empty = {std::vector<int32_t>()};
+
+    TJoinOp::type join_op = TJoinOp::LEFT_OUTER_JOIN;
+    std::vector<std::string> expected = {"1,\\N", "5,\\N"};
+    ASSERT_EQ(expected, run_join(&join_op, true, create_blocks({{1, 5}}, "k1"),
+                                 create_blocks(empty, "k2")));
+
+    join_op = TJoinOp::LEFT_ANTI_JOIN;
+    expected = {"1", "5"};
+    ASSERT_EQ(expected, run_join(&join_op, true, create_blocks({{1, 5}}, "k1"),
+                                 create_blocks(empty, "k2")));
+
+    join_op = TJoinOp::LEFT_SEMI_JOIN;
+    ASSERT_TRUE(run_join(&join_op, true, create_blocks({{1, 5}}, "k1"),
+                         create_blocks(empty, "k2"))
+                        .empty());
+}
+
+TEST_F(VCrossJoinNodeTest, small_batch_size) {
+    // the pairs of tiles span several output blocks of batch_size rows
+    std::vector<int32_t> left_values;
+    std::vector<int32_t> right_values;
+    for (int32_t i = 0; i < 10; ++i) {
+        left_values.push_back(i);
+        right_values.push_back(i);
+    }
+
+    TJoinOp::type join_op = TJoinOp::LEFT_OUTER_JOIN;
+    std::vector<std::string> result = run_join(&join_op, true, create_blocks({left_values}, "k1"),
+                                               create_blocks({right_values}, "k2"), 4);
+    // every k1 < 9 matches the k2 in (k1, 9], k1 = 9 is null-extended
+    ASSERT_EQ(9 * 10 / 2 + 1, result.size());
+    ASSERT_EQ("9,\\N", result.back());
+
+    join_op = TJoinOp::LEFT_ANTI_JOIN;
+    std::vector<std::string> expected = {"9"};
+    ASSERT_EQ(expected, run_join(&join_op, true, create_blocks({left_values}, "k1"),
+                                 create_blocks({right_values}, "k2"), 4));
+}
+
+} // namespace vectorized
+
+} // namespace doris
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,355 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/exec/join/vhash_join_node.h"
+
+#include <gtest/gtest.h>
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "common/object_pool.h"
+#include "gen_cpp/Descriptors_types.h"
+#include "gen_cpp/PlanNodes_types.h"
+#include "runtime/descriptors.h"
+#include "runtime/exec_env.h"
+#include "runtime/runtime_state.h"
+#include "runtime/thread_resource_mgr.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/columns_number.h"
+#include "vec/core/block.h"
+#include "vec/data_types/data_type_nullable.h"
+#include "vec/data_types/data_type_number.h"
+
+namespace doris {
+
+namespace vectorized {
+
+// Returns the given blocks one by one, then eos with an empty block.
+class MockBlockNode : public ExecNode {
+public:
+    MockBlockNode(ObjectPool* pool, const TPlanNode& tnode, const DescriptorTbl& descs,
+                  std::vector<Block> blocks)
+            : ExecNode(pool, tnode, descs), _blocks(std::move(blocks)) {}
+
+    Status get_next(RuntimeState* state, RowBatch* row_batch, bool* eos) override {
+        return Status::NotSupported("Not Implemented MockBlockNode::get_next scalar");
+    }
+
+    Status get_next(RuntimeState* state, Block* block, bool* eos) override {
+        *eos = _next == _blocks.size();
+        if (!*eos) {
+            block->swap(_blocks[_next++]);
+        }
+        return Status::OK();
+    }
+
+private:
+    std::vector<Block> _blocks;
+    size_t _next = 0;
+};
+
+class TestHashJoinNode : public HashJoinNode {
+public:
+    TestHashJoinNode(ObjectPool* pool, const TPlanNode& tnode, const DescriptorTbl& descs)
+            : HashJoinNode(pool, tnode, descs) {}
+
+    void add_child(ExecNode* child) { _children.push_back(child); }
+};
+
+using Value = std::optional<int32_t>;
+// (k, v) of the probe side
+using ProbeRow = std::pair<Value, int32_t>;
+// (k, a, b) of the build side
+using BuildRow = std::tuple<Value, Value, int32_t>;
+
+static constexpr int PROBE_TUPLE = 0;
+static constexpr int BUILD_TUPLE = 1;
+static constexpr int PROBE_KEY_SLOT = 0;
+static constexpr int BUILD_KEY_SLOT = 2;
+
+class VHashJoinNodeTest : public testing::Test {
+public:
+    void SetUp() override {
+        _env = ExecEnv::GetInstance();
+        _env->_thread_mgr = new ThreadResourceMgr();
+
+        // probe tuple: k nullable INT, v INT
+        // build tuple: k nullable INT, a nullable INT, b INT
+        // so that both the nullable and the fixed size build columns are gathered
+        _desc_tbl = create_desc_tbl({{true, false}, {true, true, false}});
+    }
+
+    void TearDown() override { SAFE_DELETE(_env->_thread_mgr); }
+
+protected:
+    // Every slot is an INT, tuples[t][i] tells whether the i-th slot of tuple t is nullable.
+    // Slot ids increase across tuples.
+    DescriptorTbl* create_desc_tbl(const std::vector<std::vector<bool>>& tuples) {
+        TDescriptorTable thrift_desc_tbl;
+        int slot_id = 0;
+        for (int tuple_id = 0; tuple_id < tuples.size(); ++tuple_id) {
+            const auto& nullables = tuples[tuple_id];
+            int num_null_bytes = (nullables.size() + 7) / 8;
+            int byte_offset = num_null_bytes;
+            for (int i = 0; i < nullables.size(); ++i) {
+                TSlotDescriptor slot_desc;
+                slot_desc.__set_id(slot_id++);
+                slot_desc.__set_parent(tuple_id);
+                slot_desc.__set_slotType(TypeDescriptor(TYPE_INT).to_thrift());
+                slot_desc.__set_byteOffset(byte_offset);
+                slot_desc.__set_nullIndicatorByte(nullables[i] ? i / 8 : 0);
+                slot_desc.__set_nullIndicatorBit(nullables[i] ? i % 8 : -1);
+                slot_desc.__set_slotIdx(i);
+                slot_desc.__set_isMaterialized(true);
+                thrift_desc_tbl.slotDescriptors.push_back(slot_desc);
+                byte_offset += sizeof(int32_t);
+            }
+            TTupleDescriptor tuple_desc;
+            tuple_desc.__set_id(tuple_id);
+            tuple_desc.__set_byteSize(byte_offset);
+            tuple_desc.__set_numNullBytes(num_null_bytes);
+            thrift_desc_tbl.tupleDescriptors.push_back(tuple_desc);
+        }
+        thrift_desc_tbl.__isset.slotDescriptors = true;
+
+        DescriptorTbl* desc_tbl = nullptr;
+        EXPECT_TRUE(DescriptorTbl::create(&_pool, thrift_desc_tbl, &desc_tbl).ok());
+        return desc_tbl;
+    }
+
+    TExpr create_slot_ref(int slot_id, int tuple_id) {
+        TTypeDesc type_desc;
+        TTypeNode type_node;
+        type_node.type = TTypeNodeType::SCALAR;
+        TScalarType scalar_type;
+        scalar_type.__set_type(TPrimitiveType::INT);
+        type_node.__set_scalar_type(scalar_type);
+        type_desc.types.push_back(type_node);
+
+        TExprNode slot_ref;
+        slot_ref.node_type = TExprNodeType::SLOT_REF;
+        slot_ref.type = type_desc;
+        slot_ref.num_children = 0;
+        slot_ref.__set_is_nullable(true);
+        slot_ref.__isset.slot_ref = true;
+        slot_ref.slot_ref.slot_id = slot_id;
+        slot_ref.slot_ref.tuple_id = tuple_id;
+
+        TExpr expr;
+        expr.nodes.push_back(slot_ref);
+        return expr;
+    }
+
+    TPlanNode create_child_tnode(int node_id, int tuple_id) {
+        TPlanNode tnode;
+        tnode.node_id = node_id;
+        tnode.node_type = TPlanNodeType::OLAP_SCAN_NODE;
+        tnode.num_children = 0;
+        tnode.limit = -1;
+        tnode.row_tuples.push_back(tuple_id);
+        tnode.nullable_tuples.push_back(false);
+        return tnode;
+    }
+
+    TPlanNode create_join_tnode() {
+        TEqJoinCondition eq_join_condition;
+        eq_join_condition.left = create_slot_ref(PROBE_KEY_SLOT, PROBE_TUPLE);
+        eq_join_condition.right = create_slot_ref(BUILD_KEY_SLOT, BUILD_TUPLE);
+
+        TPlanNode tnode;
+        tnode.node_id = 0;
+        tnode.node_type = TPlanNodeType::HASH_JOIN_NODE;
+        tnode.num_children = 2;
+        tnode.limit = -1;
+        tnode.row_tuples.push_back(PROBE_TUPLE);
+        tnode.row_tuples.push_back(BUILD_TUPLE);
+        tnode.nullable_tuples.push_back(false);
+        tnode.nullable_tuples.push_back(false);
+        tnode.__isset.hash_join_node = true;
+        tnode.hash_join_node.join_op = TJoinOp::INNER_JOIN;
+        tnode.hash_join_node.eq_join_conjuncts.push_back(eq_join_condition);
+        return tnode;
+    }
+
+    static ColumnPtr create_nullable_column(const std::vector<Value>& values) {
+        auto nested = ColumnInt32::create();
+        auto null_map = ColumnUInt8::create();
+        for (const auto& value : values) {
+            nested->insert_value(value.value_or(0));
+            null_map->insert_value(!value.has_value());
+        }
+        return ColumnNullable::create(std::move(nested), std::move(null_map));
+    }
+
+    static ColumnPtr create_column(const std::vector<int32_t>& values) {
+        auto column = ColumnInt32::create();
+        for (auto value : values) {
+            column->insert_value(value);
+        }
+        return column;
+    }
+
+    static Block create_probe_block(const std::vector<ProbeRow>& rows) {
+        std::vector<Value> k;
+        std::vector<int32_t> v;
+        for (const auto& row : rows) {
+            k.push_back(row.first);
+            v.push_back(row.second);
+        }
+        auto nullable_type = make_nullable(std::make_shared<DataTypeInt32>());
+        return Block({{create_nullable_column(k), nullable_type, "k"},
+                      {create_column(v), std::make_shared<DataTypeInt32>(), "v"}});
+    }
+
+    static Block create_build_block(const std::vector<BuildRow>& rows) {
+        std::vector<Value> k;
+        std::vector<Value> a;
+        std::vector<int32_t> b;
+        for (const auto& row : rows) {
+            k.push_back(std::get<0>(row));
+            a.push_back(std::get<1>(row));
+            b.push_back(std::get<2>(row));
+        }
+        auto nullable_type = make_nullable(std::make_shared<DataTypeInt32>());
+        return Block({{create_nullable_column(k), nullable_type, "k"},
+                      {create_nullable_column(a), nullable_type, "a"},
+                      {create_column(b), std::make_shared<DataTypeInt32>(), "b"}});
+    }
+
+    // Joins the probe blocks with the build blocks on k, and returns the output rows in
+    // output order as "probe k,v,build k,a,b".
+    std::vector<std::string> join(const std::vector<std::vector<ProbeRow>>& probe_blocks,
+                                  const std::vector<std::vector<BuildRow>>& build_blocks,
+                                  int batch_size = 1024) {
+        TQueryOptions query_options;
+        query_options.batch_size = batch_size;
+        RuntimeState state(TUniqueId(), query_options, TQueryGlobals(), _env);
+        state.init_instance_mem_tracker();
+        state.set_desc_tbl(_desc_tbl);
+
+        TPlanNode tnode = create_join_tnode();
+        auto node = _pool.add(new TestHashJoinNode(&_pool, tnode, *_desc_tbl));
+
+        std::vector<Block> blocks;
+        for (const auto& rows : probe_blocks) {
+            blocks.push_back(create_probe_block(rows));
+        }
+        TPlanNode probe_tnode = create_child_tnode(1, PROBE_TUPLE);
+        auto probe = _pool.add(
+                new MockBlockNode(&_pool, probe_tnode, *_desc_tbl, std::move(blocks)));
+        EXPECT_TRUE(probe->init(probe_tnode, &state).ok());
+        node->add_child(probe);
+
+        blocks.clear();
+        for (const auto& rows : build_blocks) {
+            blocks.push_back(create_build_block(rows));
+        }
+        TPlanNode build_tnode = create_child_tnode(2, BUILD_TUPLE);
+        auto build = _pool.add(
+                new MockBlockNode(&_pool, build_tnode, *_desc_tbl, std::move(blocks)));
+        EXPECT_TRUE(build->init(build_tnode, &state).ok());
+        node->add_child(build);
+
+        EXPECT_TRUE(node->init(tnode, &state).ok());
+        EXPECT_TRUE(node->prepare(&state).ok());
+        EXPECT_TRUE(node->open(&state).ok());
+
+        std::vector<std::string> result;
+        bool eos = false;
+        while (!eos) {
+            Block block;
+            EXPECT_TRUE(node->get_next(&state, &block, &eos).ok());
+            for (size_t i = 0; i < block.rows(); ++i) {
+                std::string row;
+                for (size_t j = 0; j < block.columns(); ++j) {
+                    const auto& column = block.get_by_position(j);
+                    row += (j == 0 ? "" : ",") + column.type->to_string(*column.column, i);
+                }
+                result.push_back(row);
+            }
+        }
+        EXPECT_TRUE(node->close(&state).ok());
+        return result;
+    }
+
+    ObjectPool _pool;
+    ExecEnv* _env = nullptr;
+    DescriptorTbl* _desc_tbl = nullptr;
+};
+
+TEST_F(VHashJoinNodeTest, several_build_blocks) {
+    std::vector<std::vector<BuildRow>> build_blocks = {
+            {{1, 10, 100}, {2, 20, 200}, {std::nullopt, 30, 300}, {1, std::nullopt, 400}},
+            {{3, 40, 500}, {1, 50, 600}},
+            {},
+            {{2, std::nullopt, 700}, {std::nullopt, 60, 800}, {1, 70, 900}}};
+    std::vector<std::vector<ProbeRow>> probe_blocks = {
+            {{1, 1}, {std::nullopt, 2}, {4, 3}}, {{2, 4}, {3, 5}, {1, 6}}};
+
+    // every probe row is followed by the build rows of its key in build order, the rows with
+    // a NULL key match nothing
+    std::vector<std::string> expected = {
+            "1,1,1,10,100", "1,1,1,\\N,400", "1,1,1,50,600", "1,1,1,70,900",
+            "2,4,2,20,200", "2,4,2,\\N,700", "3,5,3,40,500", "1,6,1,10,100",
+            "1,6,1,\\N,400", "1,6,1,50,600", "1,6,1,70,900"};
+    ASSERT_EQ(expected, join(probe_blocks, build_blocks));
+
+    // the matches of a probe block are returned over several blocks
+    ASSERT_EQ(expected, join(probe_blocks, build_blocks, 3));
+}
+
+TEST_F(VHashJoinNodeTest, many_rows_per_key) {
+    // more matches per key than the gather prefetches ahead
+    std::vector<std::vector<BuildRow>> build_blocks;
+    for (int block_idx = 0; block_idx < 3; ++block_idx) {
+        std::vector<BuildRow> rows;
+        for (int i = 0; i < 40; ++i) {
+            Value a = i % 3 == 0 ? std::nullopt : Value(i);
+            rows.emplace_back(i % 2, a, block_idx * 100 + i);
+        }
+        build_blocks.push_back(rows);
+    }
+    std::vector<std::vector<ProbeRow>> probe_blocks = {{{0, 0}, {1, 1}, {2, 2}, {0, 3}}};
+
+    std::vector<std::string> expected;
+    for (const auto& probe_row : probe_blocks[0]) {
+        for (const auto& rows : build_blocks) {
+            for (const auto& [k, a, b] : rows) {
+                if (k == probe_row.first) {
+                    expected.push_back(std::to_string(*probe_row.first) + "," +
+                                       std::to_string(probe_row.second) + "," +
+                                       std::to_string(*k) + "," +
+                                       (a.has_value() ? std::to_string(*a) : "\\N") + "," +
+                                       std::to_string(b));
+                }
+            }
+        }
+    }
+    ASSERT_EQ(180, expected.size());
+    ASSERT_EQ(expected, join(probe_blocks, build_blocks));
+    ASSERT_EQ(expected, join(probe_blocks, build_blocks, 16));
+}
+
+} // namespace vectorized
+} // namespace doris
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,320 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/exec/vset_operation_node.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "common/object_pool.h"
+#include "runtime/descriptors.h"
+#include "runtime/exec_env.h"
+#include "runtime/runtime_state.h"
+#include "runtime/thread_resource_mgr.h"
+#include "testutil/desc_tbl_builder.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/columns_number.h"
+#include "vec/core/block.h"
+#include "vec/data_types/data_type_nullable.h"
+#include "vec/data_types/data_type_number.h"
+#include "vec/exec/vexcept_node.h"
+#include "vec/exec/vintersect_node.h"
+
+namespace doris {
+
+namespace vectorized {
+
+// Returns the given blocks one by one.
+class MockBlockNode : public ExecNode {
+public:
+    MockBlockNode(ObjectPool* pool, const TPlanNode& tnode, const DescriptorTbl& descs,
+                  std::vector<Block> blocks)
+            : ExecNode(pool, tnode, descs), _blocks(std::move(blocks)) {}
+
+    Status get_next(RuntimeState* state, RowBatch* row_batch, bool* eos) override {
+        return Status::NotSupported("Not Implemented MockBlockNode::get_next scalar");
+    }
+
+    Status get_next(RuntimeState* state, Block* block, bool* eos) override {
+        if (_next < _blocks.size()) {
+            block->swap(_blocks[_next++]);
+        }
+        *eos = _next == _blocks.size();
+        return Status::OK();
+    }
+
+private:
+    std::vector<Block> _blocks;
+    size_t _next = 0;
+};
+
+template <class SetNode>
+class TestSetNode : public SetNode {
+public:
+    TestSetNode(ObjectPool* pool, const TPlanNode& tnode, const DescriptorTbl& descs)
+            : SetNode(pool, tnode, descs) {}
+
+    void add_child(ExecNode* child) { this->_children.push_back(child); }
+};
+
+using Values = std::vector<std::optional<int32_t>>;
+
+static constexpr int MAX_CHILDREN = 4;
+
+class VSetOperationNodeTest : public testing::Test {
+public:
+    void SetUp() override {
+        _env = ExecEnv::GetInstance();
+        _env->_thread_mgr = new ThreadResourceMgr();
+
+        // tuple 0 is the output row, tuple i + 1 the row of child i, each with one nullable
+        // INT slot whose id is the tuple id
+        DescriptorTblBuilder builder(&_pool);
+        for (int i = 0; i <= MAX_CHILDREN; ++i) {
+            builder.declare_tuple() << TYPE_INT;
+        }
+        _desc_tbl = builder.build();
+    }
+
+    void TearDown() override { SAFE_DELETE(_env->_thread_mgr); }
+
+protected:
+    TExpr create_slot_ref(int slot_id, int tuple_id) {
+        TTypeDesc type_desc;
+        TTypeNode type_node;
+        type_node.type = TTypeNodeType::SCALAR;
+        TScalarType scalar_type;
+        scalar_type.__set_type(TPrimitiveType::INT);
+        type_node.__set_scalar_type(scalar_type);
+        type_desc.types.push_back(type_node);
+
+        TExprNode slot_ref;
+        slot_ref.node_type = TExprNodeType::SLOT_REF;
+        slot_ref.type = type_desc;
+        slot_ref.num_children = 0;
+        slot_ref.__set_is_nullable(true);
+        slot_ref.__isset.slot_ref = true;
+        slot_ref.slot_ref.slot_id = slot_id;
+        slot_ref.slot_ref.tuple_id = tuple_id;
+
+        TExpr expr;
+        expr.nodes.push_back(slot_ref);
+        return expr;
+    }
+
+    TPlanNode create_child_tnode(int child_idx) {
+        TPlanNode tnode;
+        tnode.node_id = child_idx + 1;
+        tnode.node_type = TPlanNodeType::OLAP_SCAN_NODE;
+        tnode.num_children = 0;
+        tnode.limit = -1;
+        tnode.row_tuples.push_back(child_idx + 1);
+        tnode.nullable_tuples.push_back(false);
+        return tnode;
+    }
+
+    TPlanNode create_set_tnode(TPlanNodeType::type node_type, int num_children) {
+        std::vector<std::vector<TExpr>> result_expr_lists;
+        for (int i = 0; i < num_children; ++i) {
+            result_expr_lists.push_back({create_slot_ref(i + 1, i + 1)});
+        }
+
+        TPlanNode tnode;
+        tnode.node_id = 0;
+        tnode.node_type = node_type;
+        tnode.num_children = num_children;
+        tnode.limit = -1;
+        tnode.row_tuples.push_back(0);
+        tnode.nullable_tuples.push_back(false);
+        if (node_type == TPlanNodeType::INTERSECT_NODE) {
+            tnode.__isset.intersect_node = true;
+            tnode.intersect_node.tuple_id = 0;
+            tnode.intersect_node.result_expr_lists = result_expr_lists;
+        } else {
+            tnode.__isset.except_node = true;
+            tnode.except_node.tuple_id = 0;
+            tnode.except_node.result_expr_lists = result_expr_lists;
+        }
+        return tnode;
+    }
+
+    Block create_block(const Values& values) {
+        auto nested = ColumnInt32::create();
+        auto null_map = ColumnUInt8::create();
+        for (const auto& value : values) {
+            nested->insert_value(value.value_or(0));
+            null_map->insert_value(!value.has_value());
+        }
+        return Block({{ColumnNullable::create(std::move(nested), std::move(null_map)),
+                       make_nullable(std::make_shared<DataTypeInt32>()), "k"}});
+    }
+
+    // Runs the set operation over children made of the given blocks, and returns its output
+    // rows sorted.
+    template <class SetNode>
+    std::vector<std::string> run(TPlanNodeType::type node_type,
+                                 const std::vector<std::vector<Values>>& children,
+                                 int batch_size = 1024) {
+        TQueryOptions query_options;
+        query_options.batch_size = batch_size;
+        RuntimeState state(TUniqueId(), query_options, TQueryGlobals(), _env);
+        state.init_instance_mem_tracker();
+        state.set_desc_tbl(_desc_tbl);
+
+        TPlanNode tnode = create_set_tnode(node_type, children.size());
+        auto node = _pool.add(new TestSetNode<SetNode>(&_pool, tnode, *_desc_tbl));
+        for (int i = 0; i < children.size(); ++i) {
+            std::vector<Block> blocks;
+            for (const auto& values : children[i]) {
+                blocks.push_back(create_block(values));
+            }
+            TPlanNode child_tnode = create_child_tnode(i);
+            auto child = _pool.add(
+                    new MockBlockNode(&_pool, child_tnode, *_desc_tbl, std::move(blocks)));
+            EXPECT_TRUE(child->init(child_tnode, &state).ok());
+            node->add_child(child);
+        }
+        EXPECT_TRUE(node->init(tnode, &state).ok());
+        EXPECT_TRUE(node->prepare(&state).ok());
+        EXPECT_TRUE(node->open(&state).ok());
+
+        std::vector<std::string> result;
+        bool eos = false;
+        while (!eos) {
+            Block block;
+            EXPECT_TRUE(node->get_next(&state, &block, &eos).ok());
+            EXPECT_LE(block.rows(), batch_size);
+            for (size_t i = 0; i < block.rows(); ++i) {
+                const auto& column = block.get_by_position(0);
+                result.push_back(column.type->to_string(*column.column, i));
+            }
+        }
+        EXPECT_TRUE(node->close(&state).ok());
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    std::vector<std::string> intersect(const std::vector<std::vector<Values>>& children,
+                                       int batch_size = 1024) {
+        return run<VIntersectNode>(TPlanNodeType::INTERSECT_NODE, children, batch_size);
+    }
+
+    std::vector<std::string> except(const std::vector<std::vector<Values>>& children,
+                                    int batch_size = 1024) {
+        return run<VExceptNode>(TPlanNodeType::EXCEPT_NODE, children, batch_size);
+    }
+
+    ObjectPool _pool;
+    ExecEnv* _env = nullptr;
+    DescriptorTbl* _desc_tbl = nullptr;
+};
+
+TEST_F(VSetOperationNodeTest, intersect_duplicate_rows) {
+    // the result is distinct whatever the number of duplicates in each child
+    std::vector<std::string> expected = {"1", "3"};
+    ASSERT_EQ(expected, intersect({{{1, 1, 2}, {3, 1}}, {{3, 3, 1, 1, 4}}}));
+}
+
+TEST_F(VSetOperationNodeTest, intersect_null_keys) {
+    // NULLs are equal to each other in set operations
+    std::vector<std::string> expected = {"1", "\\N"};
+    ASSERT_EQ(expected, intersect({{{1, std::nullopt, std::nullopt, 2}}, {{std::nullopt, 1}}}));
+
+    expected = {"1"};
+    ASSERT_EQ(expected, intersect({{{1, std::nullopt, 2}}, {{1, 3}}}));
+}
+
+TEST_F(VSetOperationNodeTest, intersect_more_children) {
+    // a key of the result is found in every child
+    std::vector<std::string> expected = {"1", "\\N"};
+    ASSERT_EQ(expected, intersect({{{1, 1, 2, std::nullopt, 3}},
+                                   {{std::nullopt, 1, 3, 3, 5}},
+                                   {{3, std::nullopt, 1}},
+                                   {{1, std::nullopt, 2}}}));
+}
+
+TEST_F(VSetOperationNodeTest, intersect_empty_children) {
+    ASSERT_TRUE(intersect({{}, {{1, 2}}}).empty());
+    ASSERT_TRUE(intersect({{{1, 2}}, {}}).empty());
+    ASSERT_TRUE(intersect({{{1, 2}}, {{1}}, {}}).empty());
+    // a child made of empty blocks
+    ASSERT_TRUE(intersect({{{1, 2}}, {{}, {}}}).empty());
+}
+
+TEST_F(VSetOperationNodeTest, except_duplicate_rows) {
+    std::vector<std::string> expected = {"1", "4"};
+    ASSERT_EQ(expected, except({{{1, 1, 2}, {4, 2, 1}}, {{2, 2, 3}}}));
+}
+
+TEST_F(VSetOperationNodeTest, except_null_keys) {
+    std::vector<std::string> expected = {"2"};
+    ASSERT_EQ(expected, except({{{std::nullopt, 2, std::nullopt}}, {{std::nullopt}}}));
+
+    expected = {"2", "\\N"};
+    ASSERT_EQ(expected, except({{{std::nullopt, 2, 3}}, {{3, 4}}}));
+}
+
+TEST_F(VSetOperationNodeTest, except_more_children) {
+    // a key of the result is found in no other child
+    std::vector<std::string> expected = {"1", "4"};
+    ASSERT_EQ(expected, except({{{1, 1, 2, std::nullopt, 3, 4}},
+                                {{2}},
+                                {{std::nullopt, 5}},
+                                {{3, 3}}}));
+}
+
+TEST_F(VSetOperationNodeTest, except_empty_children) {
+    ASSERT_TRUE(except({{}, {{1, 2}}}).empty());
+
+    std::vector<std::string> expected = {"1", "2", "\\N"};
+    ASSERT_EQ(expected, except({{{1, 2, 2, std::nullopt}}, {}}));
+    ASSERT_EQ(expected, except({{{1, 2, std::nullopt}}, {{}, {}}, {}}));
+}
+
+TEST_F(VSetOperationNodeTest, small_batch_size) {
+    // the kept keys are returned over several blocks of batch_size rows
+    Values first;
+    Values second;
+    std::vector<std::string> expected_intersect;
+    std::vector<std::string> expected_except;
+    for (int32_t i = 0; i < 100; ++i) {
+        first.push_back(i);
+        first.push_back(i);
+        if (i % 3 == 0) {
+            second.push_back(i);
+            expected_intersect.push_back(std::to_string(i));
+        } else {
+            expected_except.push_back(std::to_string(i));
+        }
+    }
+    std::sort(expected_intersect.begin(), expected_intersect.end());
+    std::sort(expected_except.begin(), expected_except.end());
+    ASSERT_EQ(expected_intersect, intersect({{first}, {second}}, 4));
+    ASSERT_EQ(expected_except, except({{first}, {second}}, 4));
+}
+
+} // namespace vectorized
+} // namespace doris
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,254 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/exec/vtopn_node.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "common/object_pool.h"
+#include "olap/topn_filter.h"
+#include "runtime/descriptors.h"
+#include "runtime/runtime_state.h"
+#include "testutil/desc_tbl_builder.h"
+#include "vec/columns/columns_number.h"
+#include "vec/core/block.h"
+#include "vec/data_types/data_type_number.h"
+
+namespace doris {
+
+namespace vectorized {
+
+// Returns the given blocks one by one.
+class MockBlockNode : public ExecNode {
+public:
+    MockBlockNode(ObjectPool* pool, const TPlanNode& tnode, const DescriptorTbl& descs,
+                  std::vector<Block> blocks)
+            : ExecNode(pool, tnode, descs), _blocks(std::move(blocks)) {}
+
+    Status get_next(RuntimeState* state, RowBatch* row_batch, bool* eos) override {
+        return Status::NotSupported("Not Implemented MockBlockNode::get_next scalar");
+    }
+
+    Status get_next(RuntimeState* state, Block* block, bool* eos) override {
+        if (_next < _blocks.size()) {
+            block->swap(_blocks[_next++]);
+        }
+        *eos = _next == _blocks.size();
+        return Status::OK();
+    }
+
+private:
+    std::vector<Block> _blocks;
+    size_t _next = 0;
+};
+
+class TestTopNNode : public VTopNNode {
+public:
+    TestTopNNode(ObjectPool* pool, const TPlanNode& tnode, const DescriptorTbl& descs)
+            : VTopNNode(pool, tnode, descs) {}
+
+    void add_child(ExecNode* child) { _children.push_back(child); }
+};
+
+class VTopNNodeTest : public testing::Test {
+public:
+    void SetUp() override {
+        DescriptorTblBuilder builder(&_pool);
+        builder.declare_tuple() << TYPE_INT << TYPE_INT;
+        _desc_tbl = builder.build();
+
+        TQueryOptions query_options;
+        query_options.batch_size = 1024;
+        _state.reset(new RuntimeState(TUniqueId(), query_options, TQueryGlobals(), nullptr));
+        _state->init_instance_mem_tracker();
+        _state->set_desc_tbl(_desc_tbl);
+    }
+
+protected:
+    TPlanNode create_child_tnode() {
+        TPlanNode tnode;
+        tnode.node_id = 0;
+        tnode.node_type = TPlanNodeType::OLAP_SCAN_NODE;
+        tnode.num_children = 0;
+        tnode.limit = -1;
+        tnode.row_tuples.push_back(0);
+        tnode.nullable_tuples.push_back(false);
+        return tnode;
+    }
+
+    // ORDER BY k1 [ASC|DESC] LIMIT limit OFFSET offset
+    TPlanNode create_topn_tnode(bool is_asc, int64_t limit, int64_t offset) {
+        TTypeDesc int_type;
+        TTypeNode type_node;
+        type_node.type = TTypeNodeType::SCALAR;
+        TScalarType scalar_type;
+        scalar_type.__set_type(TPrimitiveType::INT);
+        type_node.__set_scalar_type(scalar_type);
+        int_type.types.push_back(type_node);
+
+        TExprNode slot_ref;
+        slot_ref.node_type = TExprNodeType::SLOT_REF;
+        slot_ref.type = int_type;
+        slot_ref.num_children = 0;
+        slot_ref.__isset.slot_ref = true;
+        slot_ref.slot_ref.slot_id = 0;
+        slot_ref.slot_ref.tuple_id = 0;
+        TExpr ordering_expr;
+        ordering_expr.nodes.push_back(slot_ref);
+
+        TPlanNode tnode;
+        tnode.node_id = 1;
+        tnode.node_type = TPlanNodeType::SORT_NODE;
+        tnode.num_children = 1;
+        tnode.limit = limit;
+        tnode.row_tuples.push_back(0);
+        tnode.nullable_tuples.push_back(false);
+        tnode.sort_node.sort_info.ordering_exprs.push_back(ordering_expr);
+        tnode.sort_node.sort_info.is_asc_order.push_back(is_asc);
+        tnode.sort_node.sort_info.nulls_first.push_back(false);
+        tnode.sort_node.use_top_n = true;
+        tnode.sort_node.__set_offset(offset);
+        tnode.__isset.sort_node = true;
+        return tnode;
+    }
+
+    // a block of (k1, k1 * 10) rows
+    Block create_block(const std::vector<int32_t>& values) {
+        auto k1 = ColumnInt32::create();
+        auto v1 = ColumnInt32::create();
+        for (int32_t value : values) {
+            k1->insert_value(value);
+            v1->insert_value(value * 10);
+        }
+        auto type = std::make_shared<DataTypeInt32>();
+        return Block({{std::move(k1), type, "k1"}, {std::move(v1), type, "v1"}});
+    }
+
+    // Runs the TopN over the blocks and returns the k1 values of its output.
+    std::vector<int32_t> run_topn(bool is_asc, int64_t limit, int64_t offset,
+                                  std::vector<Block> blocks) {
+        std::vector<int32_t> result;
+        TPlanNode child_tnode = create_child_tnode();
+        auto child = _pool.add(
+                new MockBlockNode(&_pool, child_tnode, *_desc_tbl, std::move(blocks)));
+        TPlanNode tnode = create_topn_tnode(is_asc, limit, offset);
+        auto node = _pool.add(new TestTopNNode(&_pool, tnode, *_desc_tbl));
+        node->add_child(child);
+        EXPECT_TRUE(child->init(child_tnode, _state.get()).ok());
+        EXPECT_TRUE(node->init(tnode, _state.get()).ok());
+        EXPECT_TRUE(node->prepare(_state.get()).ok());
+        EXPECT_TRUE(node->open(_state.get()).ok());
+
+        bool eos = false;
+        while (!eos) {
+            Block block;
+            EXPECT_TRUE(node->get_next(_state.get(), &block, &eos).ok());
+            for (size_t i = 0; i < block.rows(); ++i) {
+                int32_t k1 = block.get_by_position(0).column->get_int(i);
+                EXPECT_EQ(k1 * 10, block.get_by_position(1).column->get_int(i));
+                result.push_back(k1);
+            }
+        }
+        EXPECT_TRUE(node->close(_state.get()).ok());
+        return result;
+    }
+
+    ObjectPool _pool;
+    DescriptorTbl* _desc_tbl = nullptr;
+    std::unique_ptr<RuntimeState> _state;
+};
+
+TEST_F(VTopNNodeTest, asc) {
+    std::vector<Block> blocks;
+    blocks.push_back(create_block({9, 3, 7, 1}));
+    // can not beat the heap top once the heap is full, the block is dropped
+    blocks.push_back(create_block({10, 11, 12}));
+    blocks.push_back(create_block({5, 2, 8, 0, 6}));
+    blocks.push_back(create_block({4}));
+    std::vector<int32_t> expected = {0, 1, 2, 3};
+    ASSERT_EQ(expected, run_topn(true, 4, 0, std::move(blocks)));
+}
+
+TEST_F(VTopNNodeTest, desc_with_offset) {
+    std::vector<Block> blocks;
+    blocks.push_back(create_block({1, 5, 3}));
+    blocks.push_back(create_block({9, 2, 9, 7}));
+    blocks.push_back(create_block({8, 4, 6}));
+    std::vector<int32_t> expected = {9, 8, 7};
+    ASSERT_EQ(expected, run_topn(false, 3, 1, std::move(blocks)));
+}
+
+TEST_F(VTopNNodeTest, fewer_rows_than_limit) {
+    std::vector<Block> blocks;
+    blocks.push_back(create_block({3, 1}));
+    blocks.push_back(create_block({2}));
+    std::vector<int32_t> expected = {2, 3};
+    ASSERT_EQ(expected, run_topn(true, 10, 1, std::move(blocks)));
+}
+
+TEST_F(VTopNNodeTest, compact_heap_blocks) {
+    // every block holds one row of the heap, until they are compacted into one block
+    std::vector<Block> blocks;
+    std::vector<int32_t> expected;
+    for (int32_t i = 100; i > 0; --i) {
+        blocks.push_back(create_block({i, i + 1000}));
+    }
+    for (int32_t i = 1; i <= 5; ++i) {
+        expected.push_back(i);
+    }
+    ASSERT_EQ(expected, run_topn(true, 5, 0, std::move(blocks)));
+}
+
+TEST(TopNFilterTest, condition) {
+    TopNFilter asc_filter("k1", true);
+    TCondition condition;
+    ASSERT_FALSE(asc_filter.get_condition(&condition));
+
+    asc_filter.update("10");
+    asc_filter.update("5");
+    ASSERT_TRUE(asc_filter.get_condition(&condition));
+    ASSERT_EQ("k1", condition.column_name);
+    ASSERT_EQ("<=", condition.condition_op);
+    ASSERT_EQ(std::vector<std::string>({"5"}), condition.condition_values);
+
+    TopNFilter desc_filter("k1", false);
+    desc_filter.update("5");
+    ASSERT_TRUE(desc_filter.get_condition(&condition));
+    ASSERT_EQ(">=", condition.condition_op);
+}
+
+TEST(TopNFilterTest, supported_type) {
+    ASSERT_TRUE(TopNFilter::is_supported_type(TYPE_INT));
+    ASSERT_TRUE(TopNFilter::is_supported_type(TYPE_LARGEINT));
+    ASSERT_TRUE(TopNFilter::is_supported_type(TYPE_DATETIME));
+    ASSERT_TRUE(TopNFilter::is_supported_type(TYPE_DECIMALV2));
+    ASSERT_TRUE(TopNFilter::is_supported_type(TYPE_VARCHAR));
+    // the bound of a floating point column is rounded when printed
+    ASSERT_FALSE(TopNFilter::is_supported_type(TYPE_FLOAT));
+    ASSERT_FALSE(TopNFilter::is_supported_type(TYPE_DOUBLE));
+}
+
+} // namespace vectorized
+
+} // namespace doris
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -1,12 +1,24 @@
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
 #include "bthread/id.h"
+#include "common/logging.h"
 #include "common/object_pool.h"
 #include "gen_cpp/internal_service.pb.h"
 #include "google/protobuf/descriptor.h"
 #include "google/protobuf/service.h"
 #include "gtest/gtest.h"
 #include "runtime/exec_env.h"
+#include "runtime/raw_value.h"
 #include "testutil/desc_tbl_builder.h"
+#include "util/runtime_profile.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/column_string.h"
 #include "vec/columns/columns_number.h"
+#include "vec/data_types/data_type_number.h"
+#include "vec/data_types/data_type_string.h"
 #include "vec/runtime/vdata_stream_mgr.h"
 #include "vec/runtime/vdata_stream_recvr.h"
 #include "vec/sink/vdata_stream_sender.h"
@@ -152,6 +164,268 @@ TEST_F(VDataStreamTest, BasicTest) {
     sender.close(&runtime_stat, exec_status);
     recv->close();
 }
+class CountingClosure : public google::protobuf::Closure {
+public:
+    void Run() override { ++_run_count; }
+    int run_count() const { return _run_count; }
+
+private:
+    int _run_count = 0;
+};
+
+TEST_F(VDataStreamTest, OutOfOrderBlocks) {
+    doris::DescriptorTblBuilder builder(&_object_pool);
+    builder.declare_tuple() << doris::TYPE_INT;
+    doris::DescriptorTbl* desc_tbl = builder.build();
+    auto tuple_desc = const_cast<doris::TupleDescriptor*>(desc_tbl->get_tuple_descriptor(0));
+    doris::RowDescriptor row_desc(tuple_desc, false);
+
+    doris::RuntimeState runtime_stat(doris::TUniqueId(), doris::TQueryOptions(),
+                                     doris::TQueryGlobals(), nullptr);
+    runtime_stat.init_instance_mem_tracker();
+    runtime_stat.set_desc_tbl(desc_tbl);
+
+    // every block exceeds the buffer limit
+    int buffer_size = 1;
+    RuntimeProfile profile("profile");
+    std::shared_ptr<QueryStatisticsRecvr> statistics = std::make_shared<QueryStatisticsRecvr>();
+    auto recv = _instance.create_recvr(&runtime_stat, row_desc, TUniqueId(), 1, 1, buffer_size,
+                                       &profile, false, statistics);
+
+    auto create_pblock = [](int32_t value) {
+        auto vec = vectorized::ColumnVector<Int32>::create();
+        vec->get_data().push_back(value);
+        vectorized::DataTypePtr data_type(std::make_shared<vectorized::DataTypeInt32>());
+        vectorized::Block block({{vec->get_ptr(), data_type, "test_int"}});
+        PBlock pblock;
+        block.serialize(&pblock);
+        return pblock;
+    };
+
+    // packet 1 arrives ahead of packet 0, its response is delayed like the one of a queued
+    // block
+    CountingClosure closure_1;
+    google::protobuf::Closure* done = &closure_1;
+    recv->add_block(create_pblock(1), 0, 1, 1, &done);
+    ASSERT_EQ(nullptr, done);
+    ASSERT_GT(recv->_num_buffered_bytes, 0);
+
+    CountingClosure closure_0;
+    done = &closure_0;
+    recv->add_block(create_pblock(0), 0, 1, 0, &done);
+    ASSERT_EQ(nullptr, done);
+
+    // every fetched block releases one delayed response
+    Block block;
+    bool eos = false;
+    ASSERT_TRUE(recv->get_next(&block, &eos).ok());
+    ASSERT_EQ(0, block.get_by_position(0).column->get_int(0));
+    ASSERT_EQ(1, closure_1.run_count());
+    ASSERT_EQ(0, closure_0.run_count());
+
+    // the bytes of the blocks left are released on close
+    CountingClosure closure_3;
+    done = &closure_3;
+    recv->add_block(create_pblock(3), 0, 1, 3, &done);
+    recv->close();
+    ASSERT_EQ(0, recv->_num_buffered_bytes);
+    ASSERT_EQ(1, closure_0.run_count());
+    ASSERT_EQ(1, closure_3.run_count());
+}
+
+// Records the rows channel_add_rows() hands to a channel.
+class RowsRecordingChannel {
+public:
+    Status add_rows(Block* block, const int* row_begin, const int* row_end) {
+        rows.insert(rows.end(), row_begin, row_end);
+        ++add_rows_calls;
+        return Status::OK();
+    }
+
+    std::vector<int> rows;
+    int add_rows_calls = 0;
+};
+
+// Appends the rows like VDataStreamSender::Channel, without sending the full blocks.
+class BlockBuildingChannel {
+public:
+    Status add_rows(Block* block, const int* row_begin, const int* row_end) {
+        if (_mutable_block->rows() == 0) {
+            auto empty_block = block->clone_empty();
+            _mutable_block.reset(
+                    new MutableBlock(empty_block.mutate_columns(), empty_block.get_data_types()));
+        }
+        _mutable_block->add_rows(block, row_begin, row_end);
+        if (_mutable_block->rows() >= 4096) {
+            _mutable_block->clear();
+        }
+        return Status::OK();
+    }
+
+private:
+    std::unique_ptr<MutableBlock> _mutable_block = std::make_unique<MutableBlock>();
+};
+
+static TDataStreamSink create_hash_partitioned_sink() {
+    TDataStreamSink sink;
+    sink.output_partition.type = TPartitionType::HASH_PARTITIONED;
+    sink.dest_node_id = 1;
+    return sink;
+}
+
+static std::vector<TPlanFragmentDestination> create_destinations() {
+    TPlanFragmentDestination dest;
+    TNetworkAddress addr;
+    addr.__set_hostname("127.0.0.1");
+    addr.__set_port(8888);
+    dest.__set_brpc_server(addr);
+    dest.__set_fragment_instance_id(TUniqueId());
+    dest.__set_server(addr);
+    return {dest};
+}
+
+TEST_F(VDataStreamTest, ChannelAddRows) {
+    doris::DescriptorTblBuilder builder(&_object_pool);
+    builder.declare_tuple() << doris::TYPE_INT;
+    doris::DescriptorTbl* desc_tbl = builder.build();
+    doris::RowDescriptor row_desc(desc_tbl->get_tuple_descriptor(0), false);
+    VDataStreamSender sender(&_object_pool, 1, row_desc, create_hash_partitioned_sink(),
+                             create_destinations(), 1024 * 1024, false);
+    Block block;
+
+    RowsRecordingChannel channel_0, channel_1, channel_2;
+    std::vector<RowsRecordingChannel*> channels {&channel_0, &channel_1, &channel_2};
+    sender._hash_vals = {5, 2, 7, 0, 3, 10, 8};
+    ASSERT_TRUE(sender.channel_add_rows(channels, &block).ok());
+    // every channel gets its rows in one call, in the order of the block
+    ASSERT_EQ(std::vector<int>({3, 4}), channel_0.rows);
+    ASSERT_EQ(std::vector<int>({2, 5}), channel_1.rows);
+    ASSERT_EQ(std::vector<int>({0, 1, 6}), channel_2.rows);
+    ASSERT_EQ(1, channel_0.add_rows_calls);
+    ASSERT_EQ(1, channel_1.add_rows_calls);
+    ASSERT_EQ(1, channel_2.add_rows_calls);
+
+    // a channel without rows is skipped, and the buffers are reset for the next block
+    sender._hash_vals = {3, 6};
+    ASSERT_TRUE(sender.channel_add_rows(channels, &block).ok());
+    ASSERT_EQ(std::vector<int>({3, 4, 0, 1}), channel_0.rows);
+    ASSERT_EQ(1, channel_1.add_rows_calls);
+    ASSERT_EQ(1, channel_2.add_rows_calls);
+
+    // an empty block
+    sender._hash_vals.clear();
+    ASSERT_TRUE(sender.channel_add_rows(channels, &block).ok());
+    ASSERT_EQ(2, channel_0.add_rows_calls);
+}
+
+TEST_F(VDataStreamTest, BucketShuffleCrcWithNulls) {
+    doris::DescriptorTblBuilder builder(&_object_pool);
+    builder.declare_tuple() << doris::TYPE_INT;
+    doris::DescriptorTbl* desc_tbl = builder.build();
+    doris::RowDescriptor row_desc(desc_tbl->get_tuple_descriptor(0), false);
+    VDataStreamSender sender(&_object_pool, 1, row_desc, create_hash_partitioned_sink(),
+                             create_destinations(), 1024 * 1024, false);
+
+    const std::vector<std::optional<int32_t>> ints {1, std::nullopt, -7, 42, std::nullopt, 0};
+    const std::vector<std::optional<std::string>> strings {"doris", "",     std::nullopt,
+                                                           "a",     "doris", std::nullopt};
+    auto int_column = ColumnNullable::create(ColumnInt32::create(), ColumnUInt8::create());
+    auto string_column = ColumnNullable::create(ColumnString::create(), ColumnUInt8::create());
+    for (size_t i = 0; i < ints.size(); ++i) {
+        if (ints[i].has_value()) {
+            int_column->insert(Field(Int64(*ints[i])));
+        } else {
+            int_column->insert_default();
+        }
+        if (strings[i].has_value()) {
+            string_column->insert_data(strings[i]->data(), strings[i]->size());
+        } else {
+            string_column->insert_default();
+        }
+    }
+
+    TypeDescriptor int_type(TYPE_INT);
+    TypeDescriptor string_type = TypeDescriptor::create_varchar_type(10);
+    sender._hash_vals.assign(ints.size(), 0);
+    VDataStreamSender::update_crcs_with_column(*int_column, int_type, sender._hash_vals.data());
+    VDataStreamSender::update_crcs_with_column(*string_column, string_type,
+                                               sender._hash_vals.data());
+
+    // the hashes are the ones of the row-based sender, which hashes a NULL as nullptr
+    std::vector<uint32_t> expected(ints.size());
+    for (size_t i = 0; i < ints.size(); ++i) {
+        uint32_t hash = 0;
+        hash = RawValue::zlib_crc32(ints[i].has_value() ? &*ints[i] : nullptr, int_type, hash);
+        StringValue value;
+        if (strings[i].has_value()) {
+            value = StringValue(const_cast<char*>(strings[i]->data()), strings[i]->size());
+        }
+        hash = RawValue::zlib_crc32(strings[i].has_value() ? &value : nullptr, string_type,
+                                    hash);
+        expected[i] = hash;
+    }
+    ASSERT_EQ(expected, sender._hash_vals);
+
+    // and every row is routed to the bucket of its hash
+    RowsRecordingChannel channel_0, channel_1, channel_2, channel_3;
+    std::vector<RowsRecordingChannel*> channels {&channel_0, &channel_1, &channel_2, &channel_3};
+    Block block;
+    ASSERT_TRUE(sender.channel_add_rows(channels, &block).ok());
+    for (size_t i = 0; i < channels.size(); ++i) {
+        for (int row : channels[i]->rows) {
+            ASSERT_EQ(i, expected[row] % channels.size());
+        }
+    }
+    size_t total_rows = 0;
+    for (auto channel : channels) {
+        total_rows += channel->rows.size();
+    }
+    ASSERT_EQ(ints.size(), total_rows);
+}
+
+// Run with --gtest_also_run_disabled_tests to time the partitioning of a block.
+TEST_F(VDataStreamTest, DISABLED_PartitionBenchmark) {
+    doris::DescriptorTblBuilder builder(&_object_pool);
+    builder.declare_tuple() << doris::TYPE_INT;
+    doris::DescriptorTbl* desc_tbl = builder.build();
+    doris::RowDescriptor row_desc(desc_tbl->get_tuple_descriptor(0), false);
+    VDataStreamSender sender(&_object_pool, 1, row_desc, create_hash_partitioned_sink(),
+                             create_destinations(), 1024 * 1024, false);
+
+    const int rows = 4096;
+    auto int_column = ColumnInt32::create();
+    auto string_column = ColumnString::create();
+    for (int i = 0; i < rows; ++i) {
+        int_column->insert_value(i);
+        std::string value = std::to_string(i * 7919);
+        string_column->insert_data(value.data(), value.size());
+    }
+    Block block({{int_column->get_ptr(), std::make_shared<DataTypeInt32>(), "k1"},
+                 {string_column->get_ptr(), std::make_shared<DataTypeString>(), "k2"}});
+
+    for (int num_channels : {1, 10, 100, 1000}) {
+        std::vector<BlockBuildingChannel> channel_objects(num_channels);
+        std::vector<BlockBuildingChannel*> channels;
+        for (auto& channel : channel_objects) {
+            channels.push_back(&channel);
+        }
+        int64_t partition_ns = 0;
+        {
+            SCOPED_RAW_TIMER(&partition_ns);
+            for (int i = 0; i < 100; ++i) {
+                sender._hash_vals.assign(rows, 0);
+                block.get_by_position(0).column->update_hashes_with_value(
+                        sender._hash_vals.data());
+                block.get_by_position(1).column->update_hashes_with_value(
+                        sender._hash_vals.data());
+                ASSERT_TRUE(sender.channel_add_rows(channels, &block).ok());
+            }
+        }
+        LOG(INFO) << "partition 100 blocks of " << rows << " rows to " << num_channels
+                  << " channels use:" << partition_ns << "ns";
+    }
+}
+
 } // namespace doris::vectorized
 
 int main(int argc, char** argv) {
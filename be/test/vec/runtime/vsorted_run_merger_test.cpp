@@ -0,0 +1,339 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/runtime/vsorted_run_merger.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "common/object_pool.h"
+#include "runtime/descriptors.h"
+#include "runtime/mem_tracker.h"
+#include "runtime/query_statistics.h"
+#include "runtime/runtime_state.h"
+#include "testutil/desc_tbl_builder.h"
+#include "util/runtime_profile.h"
+#include "vec/columns/columns_number.h"
+#include "vec/core/block.h"
+#include "vec/data_types/data_type_number.h"
+#include "vec/exprs/vexpr.h"
+#include "vec/exprs/vexpr_context.h"
+#include "vec/runtime/vdata_stream_mgr.h"
+#include "vec/runtime/vdata_stream_recvr.h"
+
+namespace doris::vectorized {
+
+using Values = std::vector<int32_t>;
+
+// A sorted run made of the given blocks, which counts how many times it is pulled.
+class SortedRun {
+public:
+    explicit SortedRun(const std::vector<Values>& blocks) {
+        for (const auto& values : blocks) {
+            _blocks.push_back(create_block(values));
+        }
+    }
+
+    Status get_block(Block** block) {
+        ++pulled;
+        *block = _next < _blocks.size() ? &_blocks[_next++] : nullptr;
+        return Status::OK();
+    }
+
+    BlockSupplier supplier() {
+        return std::bind(std::mem_fn(&SortedRun::get_block), this, std::placeholders::_1);
+    }
+
+    static Block create_block(const Values& values) {
+        auto column = ColumnInt32::create();
+        for (auto value : values) {
+            column->insert_value(value);
+        }
+        return Block({{column->get_ptr(), std::make_shared<DataTypeInt32>(), "k"}});
+    }
+
+    std::atomic<int> pulled {0};
+
+private:
+    std::vector<Block> _blocks;
+    size_t _next = 0;
+};
+
+class VSortedRunMergerTest : public testing::Test {
+public:
+    void SetUp() override {
+        DescriptorTblBuilder builder(&_pool);
+        builder.declare_tuple() << TYPE_INT;
+        _desc_tbl = builder.build();
+        _row_desc.reset(new RowDescriptor(_desc_tbl->get_tuple_descriptor(0), false));
+
+        _state.reset(new RuntimeState(TUniqueId(), TQueryOptions(), TQueryGlobals(), nullptr));
+        _state->init_instance_mem_tracker();
+        _state->set_desc_tbl(_desc_tbl);
+
+        // order by the INT slot
+        TTypeDesc type_desc;
+        TTypeNode type_node;
+        type_node.type = TTypeNodeType::SCALAR;
+        TScalarType scalar_type;
+        scalar_type.__set_type(TPrimitiveType::INT);
+        type_node.__set_scalar_type(scalar_type);
+        type_desc.types.push_back(type_node);
+
+        TExprNode slot_ref;
+        slot_ref.node_type = TExprNodeType::SLOT_REF;
+        slot_ref.type = type_desc;
+        slot_ref.num_children = 0;
+        slot_ref.__isset.slot_ref = true;
+        slot_ref.slot_ref.slot_id = 0;
+        slot_ref.slot_ref.tuple_id = 0;
+        TExpr expr;
+        expr.nodes.push_back(slot_ref);
+
+        VExprContext* ctx = nullptr;
+        ASSERT_TRUE(VExpr::create_expr_tree(&_pool, expr, &ctx).ok());
+        _ordering_expr.push_back(ctx);
+        ASSERT_TRUE(VExpr::prepare(_ordering_expr, _state.get(), *_row_desc,
+                                   MemTracker::CreateTracker(-1, "VSortedRunMergerTest"))
+                            .ok());
+        ASSERT_TRUE(VExpr::open(_ordering_expr, _state.get()).ok());
+    }
+
+    void TearDown() override { VExpr::close(_ordering_expr, _state.get()); }
+
+protected:
+    std::unique_ptr<VSortedRunMerger> create_merger(size_t batch_size, int64_t limit = -1,
+                                                    size_t offset = 0) {
+        return std::make_unique<VSortedRunMerger>(_ordering_expr, _is_asc_order, _nulls_first,
+                                                  batch_size, limit, offset, &_profile);
+    }
+
+    // Reads the merged rows until eos.
+    static Values read_all(VSortedRunMerger* merger) {
+        Values result;
+        bool eos = false;
+        while (!eos) {
+            Block block;
+            EXPECT_TRUE(merger->get_next(&block, &eos).ok());
+            for (size_t i = 0; i < block.rows(); ++i) {
+                result.push_back(block.get_by_position(0).column->get_int(i));
+            }
+        }
+        return result;
+    }
+
+    // Splits num_runs runs of random sorted values into blocks of random sizes, and returns
+    // all the values sorted.
+    static Values create_runs(int num_runs, int rows_per_run,
+                              std::vector<std::vector<Values>>* runs) {
+        std::mt19937 rng(num_runs * rows_per_run);
+        std::uniform_int_distribution<int32_t> value_dist(0, rows_per_run);
+        std::uniform_int_distribution<size_t> size_dist(1, 8);
+        Values expected;
+        for (int r = 0; r < num_runs; ++r) {
+            Values values(rows_per_run);
+            for (auto& value : values) {
+                value = value_dist(rng);
+            }
+            std::sort(values.begin(), values.end());
+            expected.insert(expected.end(), values.begin(), values.end());
+
+            std::vector<Values> blocks;
+            for (size_t begin = 0; begin < values.size();) {
+                size_t end = std::min(values.size(), begin + size_dist(rng));
+                blocks.emplace_back(values.begin() + begin, values.begin() + end);
+                begin = end;
+            }
+            runs->push_back(blocks);
+        }
+        std::sort(expected.begin(), expected.end());
+        return expected;
+    }
+
+    ObjectPool _pool;
+    DescriptorTbl* _desc_tbl = nullptr;
+    std::unique_ptr<RowDescriptor> _row_desc;
+    std::unique_ptr<RuntimeState> _state;
+    RuntimeProfile _profile {"VSortedRunMergerTest"};
+    std::vector<VExprContext*> _ordering_expr;
+    std::vector<bool> _is_asc_order {true};
+    std::vector<bool> _nulls_first {false};
+};
+
+TEST_F(VSortedRunMergerTest, parallel_merge_order) {
+    std::vector<std::vector<Values>> blocks;
+    Values expected = create_runs(4, 100, &blocks);
+
+    for (auto [limit, offset] : {std::pair<int64_t, size_t> {-1, 0}, {20, 5}, {1000, 390}}) {
+        std::vector<std::unique_ptr<SortedRun>> runs;
+        std::vector<BlockSupplier> suppliers;
+        for (const auto& run_blocks : blocks) {
+            runs.emplace_back(new SortedRun(run_blocks));
+            suppliers.push_back(runs.back()->supplier());
+        }
+        auto merger = create_merger(7, limit, offset);
+        ASSERT_TRUE(merger->prepare(suppliers, true).ok());
+
+        Values result = read_all(merger.get());
+        size_t end = limit < 0 ? expected.size() : std::min(expected.size(), offset + limit);
+        ASSERT_EQ(Values(expected.begin() + offset, expected.begin() + end), result);
+    }
+}
+
+TEST_F(VSortedRunMergerTest, parallel_merge_empty_runs) {
+    SortedRun empty_run(std::vector<Values> {});
+    SortedRun run({{1, 3}, {5}});
+    auto merger = create_merger(2);
+    ASSERT_TRUE(merger->prepare({empty_run.supplier(), run.supplier()}, true).ok());
+    ASSERT_EQ(Values({1, 3, 5}), read_all(merger.get()));
+}
+
+TEST_F(VSortedRunMergerTest, parallel_merge_early_close) {
+    // long runs of interleaved values
+    std::vector<std::unique_ptr<SortedRun>> runs;
+    std::vector<BlockSupplier> suppliers;
+    for (int r = 0; r < 3; ++r) {
+        std::vector<Values> run_blocks;
+        for (int i = 0; i < 100; ++i) {
+            Values values;
+            for (int j = 0; j < 10; ++j) {
+                values.push_back((i * 10 + j) * 3 + r);
+            }
+            run_blocks.push_back(values);
+        }
+        runs.emplace_back(new SortedRun(run_blocks));
+        suppliers.push_back(runs.back()->supplier());
+    }
+
+    auto merger = create_merger(10, 15);
+    ASSERT_TRUE(merger->prepare(suppliers, true).ok());
+    Values expected;
+    for (int i = 0; i < 15; ++i) {
+        expected.push_back(i);
+    }
+    ASSERT_EQ(expected, read_all(merger.get()));
+
+    // closing the merger stops the pull threads waiting for a free slot, instead of
+    // draining the runs
+    merger.reset();
+    for (const auto& run : runs) {
+        // the block of the cursor, the queued blocks and the one being pulled
+        ASSERT_LE(run->pulled.load(), 4);
+    }
+
+    // or before any row is read
+    merger = create_merger(10);
+    ASSERT_TRUE(merger->prepare(suppliers, true).ok());
+    merger.reset();
+}
+
+class VDataStreamRecvrMergeTest : public VSortedRunMergerTest {
+protected:
+    std::shared_ptr<VDataStreamRecvr> create_recvr(int num_senders) {
+        return _stream_mgr.create_recvr(_state.get(), *_row_desc, TUniqueId(), 1, num_senders,
+                                        1024 * 1024 * 1024, &_profile, true,
+                                        std::make_shared<QueryStatisticsRecvr>());
+    }
+
+    VDataStreamMgr _stream_mgr;
+};
+
+TEST_F(VDataStreamRecvrMergeTest, parallel_merger_order) {
+    // enough senders for the queues to be split between several child mergers
+    std::vector<std::vector<Values>> blocks;
+    Values expected = create_runs(7, 50, &blocks);
+
+    for (auto [limit, offset] : {std::pair<int64_t, size_t> {-1, 0}, {30, 10}}) {
+        auto recvr = create_recvr(blocks.size());
+        for (int sender_id = 0; sender_id < blocks.size(); ++sender_id) {
+            for (const auto& values : blocks[sender_id]) {
+                Block block = SortedRun::create_block(values);
+                recvr->add_block(&block, sender_id, true);
+            }
+            recvr->remove_sender(sender_id, sender_id);
+        }
+        ASSERT_TRUE(recvr->create_parallel_merger(_ordering_expr, _is_asc_order, _nulls_first, 7,
+                                                  limit, offset)
+                            .ok());
+        ASSERT_EQ(2, recvr->_child_mergers.size());
+
+        Values result;
+        bool eos = false;
+        while (!eos) {
+            Block block;
+            ASSERT_TRUE(recvr->get_next(&block, &eos).ok());
+            for (size_t i = 0; i < block.rows(); ++i) {
+                result.push_back(block.get_by_position(0).column->get_int(i));
+            }
+        }
+        size_t end = limit < 0 ? expected.size() : offset + limit;
+        ASSERT_EQ(Values(expected.begin() + offset, expected.begin() + end), result);
+        recvr->close();
+    }
+}
+
+TEST_F(VDataStreamRecvrMergeTest, parallel_merger_cancel) {
+    // sender s sends s, s + 6, s + 12, s + 18 and is not done yet, the queues are split into
+    // [0, 4) and [4, 6)
+    const int num_senders = 6;
+    auto recvr = create_recvr(num_senders);
+    for (int sender_id = 0; sender_id < num_senders; ++sender_id) {
+        Values values;
+        for (int i = 0; i < 4; ++i) {
+            values.push_back(sender_id + i * num_senders);
+        }
+        Block block = SortedRun::create_block(values);
+        recvr->add_block(&block, sender_id, true);
+    }
+    ASSERT_TRUE(recvr->create_parallel_merger(_ordering_expr, _is_asc_order, _nulls_first, 2, -1,
+                                              0)
+                        .ok());
+
+    // the rows below 16 are merged without waiting for the senders
+    Values result;
+    for (int i = 0; i < 3; ++i) {
+        Block block;
+        bool eos = false;
+        ASSERT_TRUE(recvr->get_next(&block, &eos).ok());
+        ASSERT_FALSE(eos);
+        for (size_t j = 0; j < block.rows(); ++j) {
+            result.push_back(block.get_by_position(0).column->get_int(j));
+        }
+    }
+    ASSERT_EQ(Values({0, 1, 2, 3, 4, 5}), result);
+
+    // the child mergers are now waiting for the next blocks of the senders, closing the
+    // receiver cancels the queues and joins the pull threads
+    auto closed = std::async(std::launch::async, [&recvr]() { recvr->close(); });
+    ASSERT_EQ(std::future_status::ready, closed.wait_for(std::chrono::seconds(10)));
+    ASSERT_TRUE(recvr->_merger == nullptr);
+    ASSERT_TRUE(recvr->_child_mergers.empty());
+}
+
+} // namespace doris::vectorized
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,252 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/sink/mysql_result_writer.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "common/object_pool.h"
+#include "exprs/expr.h"
+#include "exprs/expr_context.h"
+#include "gen_cpp/PaloInternalService_types.h"
+#include "runtime/buffer_control_block.h"
+#include "runtime/datetime_value.h"
+#include "runtime/decimalv2_value.h"
+#include "runtime/descriptors.h"
+#include "runtime/mem_tracker.h"
+#include "runtime/mysql_result_writer.h"
+#include "runtime/row_batch.h"
+#include "runtime/runtime_state.h"
+#include "runtime/string_value.h"
+#include "runtime/tuple.h"
+#include "runtime/tuple_row.h"
+#include "testutil/desc_tbl_builder.h"
+#include "util/runtime_profile.h"
+#include "vec/core/block.h"
+#include "vec/exprs/vexpr.h"
+#include "vec/exprs/vexpr_context.h"
+
+namespace doris::vectorized {
+
+// The values of a row, as strings, nullopt for NULL
+using Row = std::vector<std::optional<std::string>>;
+
+class MysqlResultWriterTest : public testing::Test {
+public:
+    void SetUp() override {
+        DescriptorTblBuilder builder(&_pool);
+        // the slots of the builder are nullable
+        builder.declare_tuple() << TYPE_INT << TYPE_LARGEINT
+                                << TypeDescriptor::create_decimalv2_type(27, 9) << TYPE_DATE
+                                << TYPE_DATETIME << TypeDescriptor::create_varchar_type(32);
+        _desc_tbl = builder.build();
+        _tuple_desc = _desc_tbl->get_tuple_descriptor(0);
+        _row_desc.reset(new RowDescriptor(_tuple_desc, false));
+
+        _state.reset(new RuntimeState(TUniqueId(), TQueryOptions(), TQueryGlobals(), nullptr));
+        _state->init_instance_mem_tracker();
+        _state->set_desc_tbl(_desc_tbl);
+        _mem_tracker = MemTracker::CreateTracker(-1, "MysqlResultWriterTest");
+
+        for (auto slot_desc : _tuple_desc->slots()) {
+            TExprNode slot_ref;
+            slot_ref.node_type = TExprNodeType::SLOT_REF;
+            slot_ref.type = slot_desc->type().to_thrift();
+            slot_ref.num_children = 0;
+            slot_ref.__isset.slot_ref = true;
+            slot_ref.slot_ref.slot_id = slot_desc->id();
+            slot_ref.slot_ref.tuple_id = 0;
+            _output_exprs.emplace_back();
+            _output_exprs.back().nodes.push_back(slot_ref);
+        }
+    }
+
+protected:
+    // Fills a row batch with the rows, a column of a row is converted from its string
+    RowBatch* create_row_batch(const std::vector<Row>& rows) {
+        _batches.emplace_back(new RowBatch(*_row_desc, rows.size(), _mem_tracker.get()));
+        RowBatch* batch = _batches.back().get();
+        for (const auto& values : rows) {
+            auto tuple = reinterpret_cast<Tuple*>(
+                    batch->tuple_data_pool()->allocate(_tuple_desc->byte_size()));
+            memset(tuple, 0, _tuple_desc->byte_size());
+            for (int i = 0; i < values.size(); ++i) {
+                auto slot_desc = _tuple_desc->slots()[i];
+                if (!values[i].has_value()) {
+                    tuple->set_null(slot_desc->null_indicator_offset());
+                    continue;
+                }
+                const std::string& value = *values[i];
+                void* slot = tuple->get_slot(slot_desc->tuple_offset());
+                switch (slot_desc->type().type) {
+                case TYPE_INT: {
+                    int32_t int_value = std::stoi(value);
+                    memcpy(slot, &int_value, sizeof(int_value));
+                    break;
+                }
+                case TYPE_LARGEINT: {
+                    __int128 largeint_value = 0;
+                    bool negative = value[0] == '-';
+                    for (size_t j = negative; j < value.size(); ++j) {
+                        largeint_value = largeint_value * 10 + (value[j] - '0');
+                    }
+                    if (negative) {
+                        largeint_value = -largeint_value;
+                    }
+                    memcpy(slot, &largeint_value, sizeof(largeint_value));
+                    break;
+                }
+                case TYPE_DECIMALV2: {
+                    DecimalV2Value decimal_value(value);
+                    memcpy(slot, &decimal_value, sizeof(decimal_value));
+                    break;
+                }
+                case TYPE_DATE:
+                case TYPE_DATETIME: {
+                    DateTimeValue datetime_value;
+                    datetime_value.from_date_str(value.data(), value.size());
+                    if (slot_desc->type().type == TYPE_DATE) {
+                        datetime_value.cast_to_date();
+                    }
+                    memcpy(slot, &datetime_value, sizeof(datetime_value));
+                    break;
+                }
+                default: {
+                    char* ptr = reinterpret_cast<char*>(
+                            batch->tuple_data_pool()->allocate(value.size()));
+                    memcpy(ptr, value.data(), value.size());
+                    StringValue string_value(ptr, value.size());
+                    memcpy(slot, &string_value, sizeof(string_value));
+                    break;
+                }
+                }
+            }
+            int row_idx = batch->add_row();
+            batch->get_row(row_idx)->set_tuple(0, tuple);
+            batch->commit_last_row();
+        }
+        return batch;
+    }
+
+    // The mysql rows of the batches written by one row based writer
+    std::vector<std::string> write_row_batches(const std::vector<RowBatch*>& batches) {
+        std::vector<ExprContext*> ctxs;
+        EXPECT_TRUE(Expr::create_expr_trees(&_pool, _output_exprs, &ctxs).ok());
+        EXPECT_TRUE(Expr::prepare(ctxs, _state.get(), *_row_desc, _mem_tracker).ok());
+        EXPECT_TRUE(Expr::open(ctxs, _state.get()).ok());
+
+        BufferControlBlock sinker(TUniqueId(), 1024);
+        EXPECT_TRUE(sinker.init().ok());
+        RuntimeProfile profile("RowWriter");
+        doris::MysqlResultWriter writer(&sinker, ctxs, &profile);
+        EXPECT_TRUE(writer.init(_state.get()).ok());
+        for (auto batch : batches) {
+            EXPECT_TRUE(writer.append_row_batch(batch).ok());
+        }
+        EXPECT_TRUE(writer.close().ok());
+        Expr::close(ctxs, _state.get());
+        return get_rows(&sinker, batches.size());
+    }
+
+    // The mysql rows of the batches converted to blocks, written by one vectorized writer
+    std::vector<std::string> write_blocks(const std::vector<RowBatch*>& batches) {
+        std::vector<VExprContext*> ctxs;
+        EXPECT_TRUE(VExpr::create_expr_trees(&_pool, _output_exprs, &ctxs).ok());
+        EXPECT_TRUE(VExpr::prepare(ctxs, _state.get(), *_row_desc, _mem_tracker).ok());
+        EXPECT_TRUE(VExpr::open(ctxs, _state.get()).ok());
+
+        BufferControlBlock sinker(TUniqueId(), 1024);
+        EXPECT_TRUE(sinker.init().ok());
+        RuntimeProfile profile("BlockWriter");
+        MysqlResultWriter writer(&sinker, ctxs, &profile);
+        EXPECT_TRUE(writer.init(_state.get()).ok());
+        for (auto batch : batches) {
+            Block block = batch->convert_to_vec_block();
+            EXPECT_TRUE(writer.append_block(block).ok());
+        }
+        EXPECT_TRUE(writer.close().ok());
+        VExpr::close(ctxs, _state.get());
+        return get_rows(&sinker, batches.size());
+    }
+
+    static std::vector<std::string> get_rows(BufferControlBlock* sinker, int num_batches) {
+        std::vector<std::string> rows;
+        for (int i = 0; i < num_batches; ++i) {
+            TFetchDataResult result;
+            EXPECT_TRUE(sinker->get_batch(&result).ok());
+            rows.insert(rows.end(), result.result_batch.rows.begin(),
+                        result.result_batch.rows.end());
+        }
+        return rows;
+    }
+
+    ObjectPool _pool;
+    DescriptorTbl* _desc_tbl = nullptr;
+    TupleDescriptor* _tuple_desc = nullptr;
+    std::unique_ptr<RowDescriptor> _row_desc;
+    std::unique_ptr<RuntimeState> _state;
+    std::shared_ptr<MemTracker> _mem_tracker;
+    std::vector<TExpr> _output_exprs;
+    std::vector<std::unique_ptr<RowBatch>> _batches;
+};
+
+TEST_F(MysqlResultWriterTest, same_rows_as_row_writer) {
+    std::vector<Row> rows = {
+            {"1", "170141183460469231731687303715884105727", "123.456", "2021-10-16",
+             "2021-10-16 12:34:56", "doris"},
+            {std::nullopt, std::nullopt, std::nullopt, std::nullopt, std::nullopt,
+             std::nullopt},
+            {"-2147483648", "-170141183460469231731687303715884105727", "-0.000000001",
+             "1970-01-01", "9999-12-31 23:59:59", ""},
+            {"0", "0", "0", std::nullopt, "2000-02-29 00:00:00", std::nullopt},
+            {std::nullopt, "-1", "99999999999999999.999999999", "2000-02-29", std::nullopt,
+             "\xe4\xb8\xad\xe6\x96\x87"},
+    };
+    std::vector<RowBatch*> batches = {create_row_batch(rows)};
+
+    std::vector<std::string> expected = write_row_batches(batches);
+    ASSERT_EQ(rows.size(), expected.size());
+    ASSERT_EQ(expected, write_blocks(batches));
+}
+
+TEST_F(MysqlResultWriterTest, column_buffers_reused_across_blocks) {
+    // a smaller block after a larger one leaves no row of the larger one behind
+    std::vector<RowBatch*> batches = {
+            create_row_batch({{"1", "2", "3.5", "2021-01-01", "2021-01-01 01:02:03",
+                               "a long string value"},
+                              {"4", "5", "6.25", "2021-01-02", "2021-01-02 04:05:06",
+                               "another long string value"}}),
+            create_row_batch({{std::nullopt, "7", std::nullopt, "2021-01-03", std::nullopt,
+                               "b"}})};
+
+    std::vector<std::string> expected = write_row_batches(batches);
+    ASSERT_EQ(3, expected.size());
+    ASSERT_EQ(expected, write_blocks(batches));
+}
+
+} // namespace doris::vectorized
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
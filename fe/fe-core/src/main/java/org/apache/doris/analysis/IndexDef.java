@@ -49,9 +49,10 @@ public class IndexDef {
     }
 
     public void analyze() throws AnalysisException {
-        if (indexType == IndexDef.IndexType.BITMAP) {
+        if (indexType == IndexDef.IndexType.BITMAP || indexType == IndexDef.IndexType.NGRAM_BF) {
             if (columns == null || columns.size() != 1) {
-                throw new AnalysisException("bitmap index can only apply to a single column.");
+                throw new AnalysisException(indexType.toString().toLowerCase()
+                        + " index can only apply to a single column.");
             }
             if (Strings.isNullOrEmpty(indexName)) {
                 throw new AnalysisException("index name cannot be blank.");
@@ -120,7 +121,8 @@ public class IndexDef {
 
     public enum IndexType {
         BITMAP,
-
+        // bloom filter of the n-grams in each data page, used by LIKE '%substr%'
+        NGRAM_BF,
     }
 
     public void checkColumn(Column column, KeysType keysType) throws AnalysisException {
@@ -136,13 +138,26 @@ public class IndexDef {
                         "BITMAP index only used in columns of DUP_KEYS/UNIQUE_KEYS table or key columns of"
                                 + " AGG_KEYS table. invalid column: " + indexColName);
             }
+        } else if (indexType == IndexType.NGRAM_BF) {
+            String indexColName = column.getName();
+            PrimitiveType colType = column.getDataType();
+            if (!colType.isCharFamily()) {
+                throw new AnalysisException(colType + " is not supported in ngram_bf index. "
+                        + "invalid column: " + indexColName);
+            } else if (keysType != KeysType.DUP_KEYS && !column.isKey()) {
+                // the values of an AGG_KEYS/UNIQUE_KEYS table are only final after the versions
+                // are merged, so the BE can not skip pages by the index of a value column
+                throw new AnalysisException(
+                        "NGRAM_BF index only used in columns of DUP_KEYS table or key columns of"
+                                + " AGG_KEYS/UNIQUE_KEYS table. invalid column: " + indexColName);
+            }
         } else {
             throw new AnalysisException("Unsupported index type: " + indexType);
         }
     }
 
     public void checkColumns(List<Column> columns, KeysType keysType) throws AnalysisException {
-        if (indexType == IndexType.BITMAP) {
+        if (indexType == IndexType.BITMAP || indexType == IndexType.NGRAM_BF) {
             for (Column col : columns) {
                 checkColumn(col, keysType);
             }
@@ -18,9 +18,12 @@
 package org.apache.doris.planner;
 
 import org.apache.doris.analysis.Analyzer;
+import org.apache.doris.analysis.Expr;
+import org.apache.doris.analysis.JoinOperator;
 import org.apache.doris.analysis.TableRef;
 import org.apache.doris.common.CheckedMath;
 import org.apache.doris.common.UserException;
+import org.apache.doris.thrift.TCrossJoinNode;
 import org.apache.doris.thrift.TExplainLevel;
 import org.apache.doris.thrift.TPlanNode;
 import org.apache.doris.thrift.TPlanNodeType;
@@ -29,9 +32,16 @@ import org.apache.logging.log4j.LogManager;
 import org.apache.logging.log4j.Logger;
 
 import com.google.common.base.MoreObjects;
+import com.google.common.base.Preconditions;
+import com.google.common.collect.Lists;
+
+import java.util.List;
 
 /**
  * Cross join between left child and right child.
+ * The vectorized engine also runs the LEFT OUTER, LEFT SEMI and LEFT ANTI joins without any
+ * equi-join conjunct as a nested loop join here, which evaluates the join conjuncts on every
+ * pair of rows.
  */
 public class CrossJoinNode extends PlanNode {
     private final static Logger LOG = LogManager.getLogger(CrossJoinNode.class);
@@ -40,12 +50,27 @@ public class CrossJoinNode extends PlanNode {
     // TODO: Come up with a more useful heuristic (e.g., based on scanned partitions).
     private final static long DEFAULT_PER_HOST_MEM = 2L * 1024L * 1024L * 1024L;
     private final TableRef innerRef_;
+    private final JoinOperator joinOp;
+    // conjuncts of the ON clause of a LEFT OUTER, LEFT SEMI or LEFT ANTI join
+    private List<Expr> joinConjuncts;
+    private Expr vJoinConjunct;
 
     public CrossJoinNode(PlanNodeId id, PlanNode outer, PlanNode inner, TableRef innerRef) {
+        this(id, outer, inner, innerRef, Lists.newArrayList());
+    }
+
+    public CrossJoinNode(PlanNodeId id, PlanNode outer, PlanNode inner, TableRef innerRef,
+                         List<Expr> joinConjuncts) {
         super(id, "CROSS JOIN");
+        Preconditions.checkArgument(joinConjuncts != null);
         innerRef_ = innerRef;
+        joinOp = innerRef.getJoinOp();
+        this.joinConjuncts = joinConjuncts;
         tupleIds.addAll(outer.getTupleIds());
-        tupleIds.addAll(inner.getTupleIds());
+        // semi and anti joins only output the rows of the left child
+        if (!isLeftSemiAntiJoin()) {
+            tupleIds.addAll(inner.getTupleIds());
+        }
         tblRefIds.addAll(outer.getTblRefIds());
         tblRefIds.addAll(inner.getTblRefIds());
         children.add(outer);
@@ -55,17 +80,37 @@ public class CrossJoinNode extends PlanNode {
         // Mark tuples that form the "nullable" side of the outer join as nullable.
         nullableTupleIds.addAll(outer.getNullableTupleIds());
         nullableTupleIds.addAll(inner.getNullableTupleIds());
+        if (joinOp == JoinOperator.LEFT_OUTER_JOIN) {
+            nullableTupleIds.addAll(inner.getTupleIds());
+        }
     }
 
     public TableRef getInnerRef() {
         return innerRef_;
     }
 
+    private boolean isLeftSemiAntiJoin() {
+        return joinOp == JoinOperator.LEFT_SEMI_JOIN || joinOp == JoinOperator.LEFT_ANTI_JOIN;
+    }
+
+    // Plain cross and inner joins evaluate their predicates as the conjuncts of the node.
+    private boolean hasJoinOp() {
+        return joinOp == JoinOperator.LEFT_OUTER_JOIN || isLeftSemiAntiJoin();
+    }
+
     @Override
     public void init(Analyzer analyzer) throws UserException {
         super.init(analyzer);
         assignedConjuncts = analyzer.getAssignedConjuncts();
+        // outSmap replace in outer join may cause NULL be replace by literal
+        // so need replace the outsmap in nullableTupleID
+        if (joinOp.isOuterJoin()) {
+            replaceOutputSmapForOuterJoin();
+        }
         computeStats(analyzer);
+
+        joinConjuncts = Expr.substituteList(joinConjuncts, getCombinedChildWithoutTupleIsNullSmap(),
+                analyzer, false);
     }
 
     @Override
@@ -104,9 +149,25 @@ public class CrossJoinNode extends PlanNode {
         return MoreObjects.toStringHelper(this).addValue(super.debugString()).toString();
     }
 
+    @Override
+    void convertToVectoriezd() {
+        if (!joinConjuncts.isEmpty()) {
+            vJoinConjunct = convertConjunctsToAndCompoundPredicate(joinConjuncts);
+            initCompoundPredicate(vJoinConjunct);
+        }
+        super.convertToVectoriezd();
+    }
+
     @Override
     protected void toThrift(TPlanNode msg) {
         msg.node_type = TPlanNodeType.CROSS_JOIN_NODE;
+        if (hasJoinOp()) {
+            msg.cross_join_node = new TCrossJoinNode();
+            msg.cross_join_node.setJoinOp(joinOp.toThrift());
+            if (vJoinConjunct != null) {
+                msg.cross_join_node.setVjoinConjunct(vJoinConjunct.treeToThrift());
+            }
+        }
     }
 
     @Override
@@ -115,6 +176,13 @@ public class CrossJoinNode extends PlanNode {
             return "";
         }
         StringBuilder output = new StringBuilder().append(detailPrefix + "cross join:" + "\n");
+        if (hasJoinOp()) {
+            output.append(detailPrefix + "join op: ").append(joinOp.toString() + "\n");
+            if (!joinConjuncts.isEmpty()) {
+                output.append(detailPrefix + "join predicates: ")
+                        .append(getExplainString(joinConjuncts) + "\n");
+            }
+        }
         if (!conjuncts.isEmpty()) {
             output.append(detailPrefix + "predicates: ").append(getExplainString(conjuncts) + "\n");
         } else {
@@ -144,7 +144,9 @@ public class HashJoinNode extends PlanNode {
         assignedConjuncts = analyzer.getAssignedConjuncts();
         // outSmap replace in outer join may cause NULL be replace by literal
         // so need replace the outsmap in nullableTupleID
-        replaceOutputSmapForOuterJoin();
+        if (joinOp.isOuterJoin()) {
+            replaceOutputSmapForOuterJoin();
+        }
         computeStats(analyzer);
 
         ExprSubstitutionMap combinedChildSmap = getCombinedChildWithoutTupleIsNullSmap();
@@ -157,30 +159,6 @@ public class HashJoinNode extends PlanNode {
                 Expr.substituteList(otherJoinConjuncts, combinedChildSmap, analyzer, false);
     }
 
-    private void replaceOutputSmapForOuterJoin() {
-        if (joinOp.isOuterJoin()) {
-            List<Expr> lhs = new ArrayList<>();
-            List<Expr> rhs = new ArrayList<>();
-
-            for (int i = 0; i < outputSmap.size(); i++) {
-                Expr expr = outputSmap.getLhs().get(i);
-                boolean isInNullableTuple = false;
-                for (TupleId tupleId : nullableTupleIds) {
-                    if (expr.isBound(tupleId)) {
-                        isInNullableTuple = true;
-                        break;
-                    }
-                }
-
-                if (!isInNullableTuple) {
-                    lhs.add(outputSmap.getLhs().get(i));
-                    rhs.add(outputSmap.getRhs().get(i));
-                }
-            }
-            outputSmap = new ExprSubstitutionMap(lhs, rhs);
-        }
-    }
-
     /**
      * Holds the source scan slots of a <SlotRef> = <SlotRef> join predicate.
      * The underlying table and column on both sides have stats.
@@ -297,7 +297,7 @@ abstract public class PlanNode extends TreeNode<PlanNode> {
         return conjuncts;
     }
 
-    private void initCompoundPredicate(Expr expr) {
+    protected void initCompoundPredicate(Expr expr) {
         if (expr instanceof CompoundPredicate) {
             CompoundPredicate compoundPredicate = (CompoundPredicate) expr;
             compoundPredicate.setType(Type.BOOLEAN);
@@ -314,7 +314,7 @@ abstract public class PlanNode extends TreeNode<PlanNode> {
         }
     }
 
-    private Expr convertConjunctsToAndCompoundPredicate() {
+    protected Expr convertConjunctsToAndCompoundPredicate(List<Expr> conjuncts) {
         List<Expr> targetConjuncts = Lists.newArrayList(conjuncts);
         while (targetConjuncts.size() > 1) {
             List<Expr> newTargetConjuncts = Lists.newArrayList();
@@ -594,6 +594,30 @@ abstract public class PlanNode extends TreeNode<PlanNode> {
         analyzer.markConjunctsAssigned(unassigned);
     }
 
+    // Removes the exprs of the nullable tuples of an outer join from the output smap, whose
+    // replacement may turn a NULL of the outer join into a literal.
+    protected void replaceOutputSmapForOuterJoin() {
+        List<Expr> lhs = new ArrayList<>();
+        List<Expr> rhs = new ArrayList<>();
+
+        for (int i = 0; i < outputSmap.size(); i++) {
+            Expr expr = outputSmap.getLhs().get(i);
+            boolean isInNullableTuple = false;
+            for (TupleId tupleId : nullableTupleIds) {
+                if (expr.isBound(tupleId)) {
+                    isInNullableTuple = true;
+                    break;
+                }
+            }
+
+            if (!isInNullableTuple) {
+                lhs.add(outputSmap.getLhs().get(i));
+                rhs.add(outputSmap.getRhs().get(i));
+            }
+        }
+        outputSmap = new ExprSubstitutionMap(lhs, rhs);
+    }
+
     /**
      * Returns an smap that combines the children's smaps.
      */
@@ -858,7 +882,7 @@ abstract public class PlanNode extends TreeNode<PlanNode> {
 
     void convertToVectoriezd() {
         if (!conjuncts.isEmpty()) {
-            vconjunct = convertConjunctsToAndCompoundPredicate();
+            vconjunct = convertConjunctsToAndCompoundPredicate(conjuncts);
             initCompoundPredicate(vconjunct);
         }
 
@@ -59,6 +59,7 @@ import org.apache.doris.common.FeConstants;
 import org.apache.doris.common.Pair;
 import org.apache.doris.common.Reference;
 import org.apache.doris.common.UserException;
+import org.apache.doris.common.util.VectorizedUtil;
 
 import com.google.common.base.Preconditions;
 import com.google.common.base.Predicate;
@@ -1787,9 +1788,27 @@ public class SingleNodePlanner {
                 eqJoinConjuncts, errMsg, innerRef.getJoinOp());
         if (eqJoinConjuncts.isEmpty()) {
 
+            JoinOperator joinOp = innerRef.getJoinOp();
+            // the vectorized nested loop join also runs the left outer, semi and anti joins
+            if (VectorizedUtil.isVectorized() && (joinOp == JoinOperator.LEFT_OUTER_JOIN
+                    || joinOp == JoinOperator.LEFT_SEMI_JOIN
+                    || joinOp == JoinOperator.LEFT_ANTI_JOIN)) {
+                List<Expr> joinConjuncts;
+                if (joinOp.isOuterJoin()) {
+                    joinConjuncts = analyzer.getUnassignedOjConjuncts(innerRef);
+                } else {
+                    joinConjuncts = analyzer.getUnassignedConjuncts(innerRef.getAllTupleIds(), false);
+                }
+                analyzer.markConjunctsAssigned(joinConjuncts);
+                CrossJoinNode result = new CrossJoinNode(ctx_.getNextNodeId(), outer, inner,
+                        innerRef, joinConjuncts);
+                result.init(analyzer);
+                return result;
+            }
+
             // only inner join can change to cross join
-            if (innerRef.getJoinOp().isOuterJoin() || innerRef.getJoinOp().isSemiAntiJoin()) {
-                throw new AnalysisException("non-equal " + innerRef.getJoinOp().toString()
+            if (joinOp.isOuterJoin() || joinOp.isSemiAntiJoin()) {
+                throw new AnalysisException("non-equal " + joinOp.toString()
                         + " is not supported");
             }
 
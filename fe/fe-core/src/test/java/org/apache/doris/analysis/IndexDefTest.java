@@ -17,6 +17,11 @@
 
 package org.apache.doris.analysis;
 
+import org.apache.doris.catalog.AggregateType;
+import org.apache.doris.catalog.Column;
+import org.apache.doris.catalog.KeysType;
+import org.apache.doris.catalog.PrimitiveType;
+import org.apache.doris.catalog.ScalarType;
 import org.apache.doris.common.AnalysisException;
 
 import com.google.common.collect.Lists;
@@ -63,6 +68,35 @@ public class IndexDefTest {
         }
     }
 
+    @Test
+    public void testNgramBfCheckColumn() throws AnalysisException {
+        IndexDef ngramDef = new IndexDef("index1", Lists.newArrayList("col1"),
+                IndexDef.IndexType.NGRAM_BF, "balabala");
+        Column key = new Column("col1", ScalarType.createVarchar(10), true, null, "", "");
+        Column value = new Column("col1", ScalarType.createVarchar(10), false,
+                AggregateType.NONE, "", "");
+        ngramDef.checkColumn(key, KeysType.DUP_KEYS);
+        ngramDef.checkColumn(value, KeysType.DUP_KEYS);
+        ngramDef.checkColumn(key, KeysType.UNIQUE_KEYS);
+        ngramDef.checkColumn(key, KeysType.AGG_KEYS);
+        for (KeysType keysType : new KeysType[] {KeysType.UNIQUE_KEYS, KeysType.AGG_KEYS}) {
+            try {
+                ngramDef.checkColumn(value, keysType);
+                Assert.fail("No exception throws.");
+            } catch (AnalysisException e) {
+                Assert.assertTrue(e.getMessage().contains("NGRAM_BF index only used"));
+            }
+        }
+        try {
+            Column intKey = new Column("col1", ScalarType.createType(PrimitiveType.INT), true,
+                    null, "", "");
+            ngramDef.checkColumn(intKey, KeysType.DUP_KEYS);
+            Assert.fail("No exception throws.");
+        } catch (AnalysisException e) {
+            Assert.assertTrue(e.getMessage().contains("is not supported in ngram_bf index"));
+        }
+    }
+
     @Test
     public void toSql() {
         Assert.assertEquals("INDEX index1 (`col1`) USING BITMAP COMMENT 'balabala'", def.toSql());
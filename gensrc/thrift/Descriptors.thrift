@@ -100,7 +100,8 @@ enum THdfsCompression {
 }
 
 enum TIndexType {
-  BITMAP
+  BITMAP,
+  NGRAM_BF
 }
 
 // Mapping from names defined by Avro to the enum.
@@ -388,6 +388,17 @@ struct THashJoinNode {
   4: optional bool add_probe_filters
 }
 
+// Nested loop join, used when a join has no equi-join predicate
+struct TCrossJoinNode {
+  // CROSS_JOIN if not set, otherwise INNER_JOIN, LEFT_OUTER_JOIN, LEFT_SEMI_JOIN or
+  // LEFT_ANTI_JOIN
+  1: optional TJoinOp join_op
+
+  // conjuncts of the ON clause, evaluated on the joined rows before the null-extension of
+  // an outer join. Combined into one expr tree like TPlanNode.vconjunct
+  2: optional Exprs.TExpr vjoin_conjunct
+}
+
 struct TMergeJoinNode {
   // anything from the ON, USING or WHERE clauses that's an equi-join predicate
   1: required list<TEqJoinCondition> cmp_conjuncts
@@ -769,6 +780,7 @@ struct TPlanNode {
   35: optional TOdbcScanNode odbc_scan_node
   // Runtime filters assigned to this plan node, exist in HashJoinNode and ScanNode
   36: optional list<TRuntimeFilterDesc> runtime_filters
+  37: optional TCrossJoinNode cross_join_node
 
   40: optional Exprs.TExpr vconjunct
 }